@@ -275,6 +275,52 @@ FUNCTION(LL_ADD_INTEGRATION_TEST
 
 ENDFUNCTION(LL_ADD_INTEGRATION_TEST)
 
+#*****************************************************************************
+#   LL_ADD_BENCHMARK
+#*****************************************************************************
+FUNCTION(LL_ADD_BENCHMARK
+        name
+        source_files
+        library_dependencies
+        )
+  # Builds a test source once more as BENCHMARK_${name}, with LL_BENCHMARK
+  # defined so the tests it guards with #if LL_BENCHMARK are compiled in.
+  # Those time things and log the numbers instead of checking anything, so
+  # they are only built when LL_BENCHMARKS is on and never run by the build:
+  # run the executable from the staging directory, e.g. with --group=<name>.
+  if (NOT LL_BENCHMARKS)
+    return()
+  endif ()
+
+  add_executable(BENCHMARK_${name}
+          ${source_files}
+          ${CMAKE_SOURCE_DIR}/test/test.cpp
+          ${CMAKE_SOURCE_DIR}/test/lltut.cpp
+          )
+  set_target_properties(BENCHMARK_${name}
+          PROPERTIES
+          RUNTIME_OUTPUT_DIRECTORY "${EXE_STAGING_DIR}"
+          COMPILE_DEFINITIONS "LL_TEST=${name};LL_TEST_${name};LL_BENCHMARK=1"
+          )
+
+  if (WINDOWS)
+    set_target_properties(BENCHMARK_${name}
+            PROPERTIES
+            LINK_FLAGS "/debug /NODEFAULTLIB:LIBCMT /SUBSYSTEM:CONSOLE"
+            )
+  endif ()
+
+  if (DARWIN)
+    # test binaries always need to be signed for local development
+    set_target_properties(BENCHMARK_${name}
+            PROPERTIES
+            XCODE_ATTRIBUTE_CODE_SIGN_IDENTITY "-")
+  endif ()
+
+  target_link_libraries(BENCHMARK_${name} ${library_dependencies})
+  target_include_directories (BENCHMARK_${name} PRIVATE ${LIBS_OPEN_DIR}/test )
+ENDFUNCTION(LL_ADD_BENCHMARK)
+
 #*****************************************************************************
 #   SET_TEST_PATH
 #*****************************************************************************
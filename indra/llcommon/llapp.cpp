@@ -344,6 +344,9 @@ void LLApp::setErrorHandler(LLAppErrorHandler handler)
 // static
 void LLApp::runErrorHandler()
 {
+    // get records still queued for an async log writer into the log file
+    LLError::flushLogs();
+
     if (LLApp::sErrorHandler)
     {
         LLApp::sErrorHandler();
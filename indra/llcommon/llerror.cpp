@@ -35,7 +35,12 @@
 #ifdef __GNUC__
 # include <cxxabi.h>
 #endif // __GNUC__
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <sstream>
+#include <thread>
 #if !LL_WINDOWS
 # include <syslog.h>
 # include <unistd.h>
@@ -50,6 +55,7 @@
 #include "llapr.h"
 #include "llfile.h"
 #include "lllivefile.h"
+#include "lllockfreequeue.h"
 #include "llsd.h"
 #include "llsdserialize.h"
 #include "llsingleton.h"
@@ -130,8 +136,17 @@ namespace {
     class RecordToFile : public LLError::Recorder
     {
     public:
-        RecordToFile(const std::string& filename):
-            mName(filename)
+        // Records waiting for the writer thread in async mode.  When the
+        // writer falls this far behind new records are dropped and counted.
+        static constexpr U32 ASYNC_QUEUE_SIZE = 8192;
+        // The writer wakes at least this often even if nobody nudged it
+        static constexpr std::chrono::milliseconds ASYNC_FLUSH_INTERVAL{ 100 };
+
+        RecordToFile(const std::string& filename, bool async = false):
+            mName(filename),
+            mDropped(0),
+            mWakePending(false),
+            mStopping(false)
         {
             // <FS:Ansariel> Don't screw up log file output
             this->showMultiline(true);
@@ -146,11 +161,27 @@ namespace {
                 {
                     mFile.sync_with_stdio(false);
                 }
+
+                if (async)
+                {
+                    mQueue.reset(new LLLockFreeQueue<std::string>(ASYNC_QUEUE_SIZE));
+                    mWriter = std::thread([this]() { writerLoop(); });
+                }
             }
         }
 
         ~RecordToFile()
         {
+            if (mWriter.joinable())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mWakeMutex);
+                    mStopping = true;
+                }
+                mWakeCond.notify_one();
+                mWriter.join();
+            }
+            flush();
             mFile.close();
         }
 
@@ -171,6 +202,26 @@ namespace {
                                     const std::string& message) override
         {
             LL_PROFILE_ZONE_SCOPED_CATEGORY_LOGGING;
+            if (mQueue)
+            {
+                if (!mQueue->tryPush(message))
+                {
+                    mDropped.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                if (level == LLError::LEVEL_ERROR)
+                {
+                    // about to crash, get everything on disk from this thread
+                    flush();
+                }
+                else if (!mWakePending.exchange(true, std::memory_order_acq_rel))
+                {
+                    // one notification per batch, not per record
+                    mWakeCond.notify_one();
+                }
+                return;
+            }
+
             if (LLError::getAlwaysFlush())
             {
                 mFile << message << std::endl;
@@ -181,9 +232,78 @@ namespace {
             }
         }
 
+        // Write out everything queued so far on the calling thread.  Safe to
+        // call while crashing: gives up rather than waiting long on a writer
+        // that may itself be stuck.
+        void flush()
+        {
+            std::unique_lock<std::timed_mutex> lock(mWriteMutex, std::chrono::milliseconds(200));
+            if (lock)
+            {
+                writeQueued();
+            }
+        }
+
     private:
+        void writerLoop()
+        {
+            std::unique_lock<std::mutex> wake_lock(mWakeMutex);
+            while (!mStopping)
+            {
+                mWakeCond.wait_for(wake_lock, ASYNC_FLUSH_INTERVAL);
+                mWakePending.store(false, std::memory_order_release);
+                wake_lock.unlock();
+                {
+                    std::lock_guard<std::timed_mutex> lock(mWriteMutex);
+                    writeQueued();
+                }
+                wake_lock.lock();
+            }
+        }
+
+        // mWriteMutex must be held
+        void writeQueued()
+        {
+            if (!mQueue)
+            {
+                mFile.flush();
+                return;
+            }
+
+            bool wrote = false;
+            std::string message;
+            while (mQueue->tryPop(message))
+            {
+                mFile << message << "\n";
+                wrote = true;
+            }
+
+            const U32 dropped = mDropped.exchange(0, std::memory_order_relaxed);
+            if (dropped)
+            {
+                mFile << "*** " << dropped << " log messages dropped, log writer fell behind ***\n";
+                wrote = true;
+            }
+
+            if (wrote)
+            {
+                // one flush per batch is what makes async mode cheap
+                mFile.flush();
+            }
+        }
+
         const std::string mName;
         llofstream mFile;
+
+        // async mode only
+        std::unique_ptr<LLLockFreeQueue<std::string>> mQueue;
+        std::atomic<U32> mDropped;
+        std::atomic<bool> mWakePending;
+        bool mStopping;
+        std::mutex mWakeMutex;
+        std::condition_variable mWakeCond;
+        std::timed_mutex mWriteMutex;
+        std::thread mWriter;
     };
 
 
@@ -500,6 +620,8 @@ namespace
 
         bool                                mLogAlwaysFlush;
 
+        bool                                mLogAsync;
+
         U32                                 mEnabledLogTypesMask;
 
         LevelMap                            mFunctionLevelMap;
@@ -526,6 +648,7 @@ namespace
         : LLRefCount(),
         mDefaultLevel(LLError::LEVEL_DEBUG),
         mLogAlwaysFlush(true),
+        mLogAsync(false),
         mEnabledLogTypesMask(255),
         mFunctionLevelMap(),
         mClassLevelMap(),
@@ -840,6 +963,18 @@ namespace LLError
         return s->mLogAlwaysFlush;
     }
 
+    void setAsyncLogging(bool async)
+    {
+        SettingsConfigPtr s = Globals::getInstance()->getSettingsConfig();
+        s->mLogAsync = async;
+    }
+
+    bool getAsyncLogging()
+    {
+        SettingsConfigPtr s = Globals::getInstance()->getSettingsConfig();
+        return s->mLogAsync;
+    }
+
     void setEnabledLogTypesMask(U32 mask)
     {
         SettingsConfigPtr s = Globals::getInstance()->getSettingsConfig();
@@ -940,6 +1075,10 @@ namespace LLError
         {
             setAlwaysFlush(config["log-always-flush"]);
         }
+        if (config.has("log-async"))
+        {
+            setAsyncLogging(config["log-async"]);
+        }
         if (config.has("enabled-log-types-mask"))
         {
             setEnabledLogTypesMask(config["enabled-log-types-mask"].asInteger());
@@ -1145,7 +1284,7 @@ namespace LLError
 
         if (!file_name.empty())
         {
-            std::shared_ptr<RecordToFile> recordToFile(new RecordToFile(file_name));
+            std::shared_ptr<RecordToFile> recordToFile(new RecordToFile(file_name, getAsyncLogging()));
             if (recordToFile->okay())
             {
                 addRecorder(recordToFile);
@@ -1153,6 +1292,17 @@ namespace LLError
         }
     }
 
+    void flushLogs()
+    {
+        // the recorder mutex is recursive, so this also works from inside a
+        // log call on the crashing thread
+        auto found = findRecorder<RecordToFile>();
+        if (found)
+        {
+            found->flush();
+        }
+    }
+
     std::string logFileName()
     {
         auto found = findRecorder<RecordToFile>();
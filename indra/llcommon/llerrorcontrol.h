@@ -75,6 +75,14 @@ namespace LLError
     LL_COMMON_API ELevel getDefaultLevel();
     LL_COMMON_API void setAlwaysFlush(bool flush);
     LL_COMMON_API bool getAlwaysFlush();
+
+    LL_COMMON_API void setAsyncLogging(bool async);
+    LL_COMMON_API bool getAsyncLogging();
+        // When set before logToFile(), the log file recorder only queues
+        // messages and a background thread writes them in batches.  If the
+        // writer falls far behind, messages are dropped and the count is
+        // written to the log.  LL_ERRS and flushLogs() write the queue out
+        // on the calling thread.
     LL_COMMON_API void setEnabledLogTypesMask(U32 mask);
     LL_COMMON_API U32 getEnabledLogTypesMask();
     LL_COMMON_API void setFunctionLevel(const std::string& function_name, LLError::ELevel);
@@ -226,6 +234,9 @@ namespace LLError
         // Passing the empty string or NULL to just removes any prior.
     LL_COMMON_API std::string logFileName();
         // returns name of current logging file, empty string if none
+    LL_COMMON_API void flushLogs();
+        // writes out anything the log file recorder still has queued,
+        // for crash handlers
 
 
     /*
@@ -0,0 +1,155 @@
+/**
+ * @file   lllockfreequeue.h
+ * @brief  Bounded multi producer, multi consumer lock free queue.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#if ! defined(LL_LLLOCKFREEQUEUE_H)
+#define LL_LLLOCKFREEQUEUE_H
+
+#include "stdtypes.h"
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+/**
+ * Fixed capacity ring buffer that any number of threads may push to and pop
+ * from without taking a lock (Vyukov's bounded MPMC queue). Each slot carries
+ * a sequence number telling producers and consumers whose turn it is, so a
+ * push or pop is a single compare-and-swap on the shared position plus the
+ * move of the value.
+ *
+ * tryPush() fails instead of blocking when the queue is full; callers decide
+ * whether to drop, retry or fall back to a slower path. Capacity is rounded
+ * up to a power of two.
+ */
+template <typename T>
+class LLLockFreeQueue
+{
+public:
+    explicit LLLockFreeQueue(U32 capacity)
+    {
+        U32 size = 2;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        mMask = size - 1;
+        mSlots.reset(new Slot[size]);
+        for (U32 i = 0; i < size; ++i)
+        {
+            mSlots[i].mSequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LLLockFreeQueue(const LLLockFreeQueue&) = delete;
+    LLLockFreeQueue& operator=(const LLLockFreeQueue&) = delete;
+
+    U32 capacity() const { return (U32)(mMask + 1); }
+
+    template <typename U>
+    bool tryPush(U&& value)
+    {
+        Slot* slot;
+        size_t pos = mPushPos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            slot = &mSlots[pos & mMask];
+            const size_t seq = slot->mSequence.load(std::memory_order_acquire);
+            const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0)
+            {
+                if (mPushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            { // slot still holds a value from the previous lap: full
+                return false;
+            }
+            else
+            {
+                pos = mPushPos.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->mValue = std::forward<U>(value);
+        slot->mSequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& value)
+    {
+        Slot* slot;
+        size_t pos = mPopPos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            slot = &mSlots[pos & mMask];
+            const size_t seq = slot->mSequence.load(std::memory_order_acquire);
+            const intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (diff == 0)
+            {
+                if (mPopPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            { // nothing published in this slot yet: empty
+                return false;
+            }
+            else
+            {
+                pos = mPopPos.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(slot->mValue);
+        slot->mSequence.store(pos + mMask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate while other threads are pushing or popping
+    bool empty() const
+    {
+        return mPopPos.load(std::memory_order_relaxed) >= mPushPos.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> mSequence;
+        T mValue;
+    };
+
+    std::unique_ptr<Slot[]> mSlots;
+    size_t mMask;
+    // producers and consumers hammer different positions, keep them on
+    // separate cache lines
+    alignas(64) std::atomic<size_t> mPushPos{ 0 };
+    alignas(64) std::atomic<size_t> mPopPos{ 0 };
+};
+
+#endif /* ! defined(LL_LLLOCKFREEQUEUE_H) */
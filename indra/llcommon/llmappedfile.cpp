@@ -0,0 +1,157 @@
+/**
+ * @file   llmappedfile.cpp
+ * @brief  Implementation for llmappedfile.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "llmappedfile.h"
+// STL headers
+// std headers
+#if LL_WINDOWS
+#include "llwin32headers.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+// external library headers
+// other Linden headers
+#include "llstring.h"
+
+LLMappedFile::LLMappedFile()
+:   mData(NULL),
+    mSize(0),
+    mOpen(false)
+#if LL_WINDOWS
+    , mFile(INVALID_HANDLE_VALUE),
+    mMapping(NULL)
+#endif
+{
+}
+
+LLMappedFile::~LLMappedFile()
+{
+    close();
+}
+
+bool LLMappedFile::open(const std::string& filename)
+{
+    close();
+
+#if LL_WINDOWS
+    llutf16string utf16filename = utf8str_to_utf16str(filename);
+    // let the writer keep appending to the transcript while we look at it
+    HANDLE file = CreateFileW(utf16filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+    mFile = file;
+    mSize = (size_t)size.QuadPart;
+    if (mSize)
+    {
+        // the mapping object is sized to the file as it is now
+        HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!mapping)
+        {
+            close();
+            return false;
+        }
+        mMapping = mapping;
+        mData = (const U8*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!mData)
+        {
+            close();
+            return false;
+        }
+    }
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    mSize = (size_t)st.st_size;
+    if (mSize)
+    {
+        void* data = mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(fd);
+            mSize = 0;
+            return false;
+        }
+        mData = (const U8*)data;
+    }
+    // the mapping keeps its own reference to the file
+    ::close(fd);
+#endif
+
+    mOpen = true;
+    return true;
+}
+
+void LLMappedFile::close()
+{
+#if LL_WINDOWS
+    if (mData)
+    {
+        UnmapViewOfFile(mData);
+    }
+    if (mMapping)
+    {
+        CloseHandle((HANDLE)mMapping);
+        mMapping = NULL;
+    }
+    if (mFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle((HANDLE)mFile);
+        mFile = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (mData)
+    {
+        munmap((void*)mData, mSize);
+    }
+#endif
+    mData = NULL;
+    mSize = 0;
+    mOpen = false;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file   llmappedfile.h
+ * @brief  Read-only memory mapped view of a whole file.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#if ! defined(LL_LLMAPPEDFILE_H)
+#define LL_LLMAPPEDFILE_H
+
+#include "stdtypes.h"
+
+#include <string>
+
+/**
+ * Maps a file read-only into the address space so callers can scan or slice
+ * it in place instead of copying it through stdio buffers. Only the pages
+ * actually touched are read from disk, which makes it cheap to look at the
+ * tail of a large file.
+ *
+ * The mapping is a snapshot as far as the caller is concerned: the file must
+ * not be truncated while it is open. An empty file opens successfully with a
+ * null data() and a size() of 0.
+ */
+class LL_COMMON_API LLMappedFile
+{
+public:
+    LLMappedFile();
+    ~LLMappedFile();
+
+    LLMappedFile(const LLMappedFile&) = delete;
+    LLMappedFile& operator=(const LLMappedFile&) = delete;
+
+    // UTF-8 filename; closes any previous mapping first
+    bool open(const std::string& filename);
+    void close();
+
+    bool isOpen() const { return mOpen; }
+    const U8* data() const { return mData; }
+    size_t size() const { return mSize; }
+
+    const U8* begin() const { return mData; }
+    const U8* end() const { return mData + mSize; }
+
+private:
+    const U8* mData;
+    size_t mSize;
+    bool mOpen;
+#if LL_WINDOWS
+    void* mFile;
+    void* mMapping;
+#endif
+};
+
+#endif /* ! defined(LL_LLMAPPEDFILE_H) */
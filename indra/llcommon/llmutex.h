@@ -34,6 +34,7 @@
 #include "mutex.h"
 #include <shared_mutex>
 #include <unordered_map>
+#include <chrono>
 #include <condition_variable>
 
 //============================================================================
@@ -148,6 +149,16 @@ public:
     void signal();
     void broadcast();
 
+    // Blocks until pred() holds or the timeout passes, returns pred().  pred
+    // is checked under the condition's mutex, so a waker that changes its
+    // state and then briefly takes lock() before signal() can't be missed.
+    template <typename Rep, typename Period, typename PRED>
+    bool waitFor(const std::chrono::duration<Rep, Period>& timeout, PRED pred)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        return mCond.wait_for(lock, timeout, pred);
+    }
+
 protected:
     std::condition_variable mCond;
 };
@@ -0,0 +1,116 @@
+/**
+ * @file   llradixsort.h
+ * @brief  Stable LSD radix sort on 32 bit keys, and float to key mapping.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#if ! defined(LL_LLRADIXSORT_H)
+#define LL_LLRADIXSORT_H
+
+#include "stdtypes.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+/**
+ * Map a float to an unsigned key with the same ordering, so floats can be
+ * radix sorted. Negative values have all bits flipped, positive values only
+ * the sign bit. For a descending sort, use the complement of the key.
+ */
+inline U32 ll_float_sort_key(F32 value)
+{
+    U32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+/**
+ * Stable ascending sort of items[0, count) by key_of(item), a U32.
+ *
+ * Three 11 bit passes over (key, item) pairs held in scratch, which callers
+ * sorting every frame should keep around to avoid reallocating it. Passes
+ * where every key has the same digit are skipped, so keys clustered in a
+ * narrow range (e.g. depths in one scene) cost fewer than three passes.
+ */
+template <typename T, typename KEY_OF>
+void ll_radix_sort(T* items, size_t count, KEY_OF&& key_of, std::vector<std::pair<U32, T>>& scratch)
+{
+    if (count < 2)
+    {
+        return;
+    }
+
+    constexpr U32 RADIX_BITS = 11;
+    constexpr U32 RADIX_SIZE = 1 << RADIX_BITS;
+    constexpr U32 RADIX_MASK = RADIX_SIZE - 1;
+
+    scratch.resize(count * 2);
+    std::pair<U32, T>* src = scratch.data();
+    std::pair<U32, T>* dst = src + count;
+
+    U32 histogram[3][RADIX_SIZE];
+    memset(histogram, 0, sizeof(histogram));
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const U32 key = key_of(items[i]);
+        src[i] = std::make_pair(key, items[i]);
+        ++histogram[0][key & RADIX_MASK];
+        ++histogram[1][(key >> RADIX_BITS) & RADIX_MASK];
+        ++histogram[2][key >> (RADIX_BITS * 2)];
+    }
+
+    for (U32 pass = 0; pass < 3; ++pass)
+    {
+        const U32 shift = pass * RADIX_BITS;
+        U32* counts = histogram[pass];
+
+        if (counts[(src[0].first >> shift) & RADIX_MASK] == count)
+        { // every key shares this digit, order is unchanged
+            continue;
+        }
+
+        U32 offset = 0;
+        for (U32 i = 0; i < RADIX_SIZE; ++i)
+        {
+            const U32 n = counts[i];
+            counts[i] = offset;
+            offset += n;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            dst[counts[(src[i].first >> shift) & RADIX_MASK]++] = src[i];
+        }
+
+        std::swap(src, dst);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        items[i] = src[i].second;
+    }
+}
+
+#endif /* ! defined(LL_LLRADIXSORT_H) */
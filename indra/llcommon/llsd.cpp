@@ -34,9 +34,12 @@
 #include "llerror.h"
 #include "../llmath/llmath.h"
 #include "llformat.h"
+#include "llmemory.h"
 #include "llsdserialize.h"
 #include "stringize.h"
 
+#include <atomic>
+#include <functional>
 #include <limits>
 
 // Defend against a caller forcibly passing a negative number into an unsigned
@@ -73,6 +76,102 @@ namespace llsd
 // statics
 S32 sLLSDAllocationCount = 0;
 S32 sLLSDNetObjects = 0;
+U32 sMapIndexThreshold = 32;
+
+// Bump allocator behind ArenaScope. Only the thread that opened the scope
+// allocates from it, but nodes may be released on any thread: each node
+// holds a reference, as does the scope, and the last release frees the
+// blocks.
+class Arena
+{
+public:
+    static constexpr size_t BLOCK_SIZE = 16 * 1024;
+    static constexpr size_t ALIGN = 16;
+    // each node is preceded by a pointer back to its arena
+    static constexpr size_t PREFIX = ALIGN;
+
+    Arena() : mRefs(1), mUsed(BLOCK_SIZE), mLast(nullptr) {}
+
+    // larger nodes go to the heap rather than waste the rest of a block
+    static bool fits(size_t size) { return size + PREFIX <= BLOCK_SIZE / 8; }
+
+    void* allocate(size_t size)
+    {
+        size = (PREFIX + size + ALIGN - 1) & ~(ALIGN - 1);
+        if (mUsed + size > BLOCK_SIZE)
+        {
+            mBlocks.push_back(static_cast<char*>(ll_aligned_malloc_16(BLOCK_SIZE)));
+            ++sBlockCount;
+            mUsed = 0;
+        }
+        char* base = mBlocks.back() + mUsed;
+        mUsed += size;
+        *reinterpret_cast<Arena**>(base) = this;
+        mRefs.fetch_add(1, std::memory_order_relaxed);
+        mLast = base + PREFIX;
+        return mLast;
+    }
+
+    // true for the most recent allocation, i.e. while it is being constructed
+    bool isLast(const void* p) const { return p == mLast; }
+
+    static Arena* owner(const void* p)
+    {
+        return *reinterpret_cast<Arena* const*>(static_cast<const char*>(p) - PREFIX);
+    }
+
+    void release()
+    {
+        if (mRefs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete this;
+        }
+    }
+
+    static thread_local Arena* sCurrent;
+    static std::atomic<U32> sBlockCount;
+
+private:
+    ~Arena()
+    {
+        for (char* block : mBlocks)
+        {
+            ll_aligned_free_16(block);
+        }
+        sBlockCount -= (U32)mBlocks.size();
+    }
+
+    std::atomic<U32> mRefs;
+    std::vector<char*> mBlocks;
+    size_t mUsed;
+    void* mLast;
+};
+
+thread_local Arena* Arena::sCurrent = nullptr;
+std::atomic<U32> Arena::sBlockCount(0);
+
+ArenaScope::ArenaScope(bool enable)
+    : mArena(enable ? new Arena : nullptr), mPrevious(Arena::sCurrent)
+{
+    if (mArena)
+    {
+        Arena::sCurrent = mArena;
+    }
+}
+
+ArenaScope::~ArenaScope()
+{
+    if (mArena)
+    {
+        Arena::sCurrent = mPrevious;
+        mArena->release();
+    }
+}
+
+U32 arenaBlockCount()
+{
+    return Arena::sBlockCount;
+}
 
 } // namespace llsd
 
@@ -100,9 +199,17 @@ protected:
 
     bool shared() const                         { return (mUseCount > 1) && (mUseCount != STATIC_USAGE_COUNT); }
 
+    static void destroy(Impl* impl);
+        ///< delete impl, or hand its memory back to the arena it came from
+
     U32 mUseCount;
+    bool mInArena;
 
 public:
+    static void* operator new(size_t size);
+    static void operator delete(void* p);
+        ///< take nodes from the thread's llsd::ArenaScope when there is one
+
     static void reset(Impl*& var, Impl* impl);
         ///< safely set var to refer to the new impl (possibly shared)
 
@@ -435,8 +542,28 @@ namespace
 
         DataMap mData;
 
+        // Open addressing (linear probe) index into mData, only present
+        // once the map grows past llsd::sMapIndexThreshold. std::map nodes
+        // never move, so the slots hold iterators; mData stays the storage
+        // and keeps its sorted iteration order.
+        enum { SLOT_EMPTY = 0, SLOT_FULL, SLOT_ERASED };
+        struct IndexSlot
+        {
+            U32 mState = SLOT_EMPTY;
+            U32 mHash = 0;
+            DataMap::iterator mIter;
+        };
+        std::vector<IndexSlot> mIndex;
+        size_t mIndexUsed = 0; // full and erased slots
+
+        static U32 hashKey(std::string_view k) { return (U32)std::hash<std::string_view>()(k); }
+        IndexSlot* findSlot(std::string_view k, U32 hash) const;
+        void indexAdd(DataMap::iterator it);
+        void added(DataMap::iterator it);
+        void rebuildIndex();
+
     protected:
-        ImplMap(const DataMap& data) : mData(data) { }
+        ImplMap(const DataMap& data) : mData(data) { rebuildIndex(); }
 
     public:
         ImplMap() { }
@@ -481,6 +608,10 @@ namespace
 
         virtual void dumpStats() const;
         virtual void calcStats(S32 type_counts[], S32 share_counts[]) const;
+
+    private:
+        DataMap::iterator find(std::string_view k);
+        DataMap::const_iterator find(std::string_view k) const;
     };
 
     ImplMap& ImplMap::makeMap(LLSD::Impl*& var)
@@ -498,17 +629,114 @@ namespace
         }
     }
 
+    ImplMap::IndexSlot* ImplMap::findSlot(std::string_view k, U32 hash) const
+    {
+        const size_t mask = mIndex.size() - 1;
+        for (size_t i = hash & mask; ; i = (i + 1) & mask)
+        {
+            const IndexSlot& slot = mIndex[i];
+            if (slot.mState == SLOT_EMPTY)
+            {
+                return NULL;
+            }
+            if (slot.mState == SLOT_FULL && slot.mHash == hash && slot.mIter->first == k)
+            {
+                return const_cast<IndexSlot*>(&slot);
+            }
+        }
+    }
+
+    void ImplMap::indexAdd(DataMap::iterator it)
+    {
+        const U32 hash = hashKey(it->first);
+        const size_t mask = mIndex.size() - 1;
+        size_t i = hash & mask;
+        while (mIndex[i].mState == SLOT_FULL)
+        {
+            i = (i + 1) & mask;
+        }
+        if (mIndex[i].mState == SLOT_EMPTY)
+        {
+            ++mIndexUsed;
+        }
+        mIndex[i].mState = SLOT_FULL;
+        mIndex[i].mHash = hash;
+        mIndex[i].mIter = it;
+    }
+
+    void ImplMap::rebuildIndex()
+    {
+        mIndex.clear();
+        mIndexUsed = 0;
+        if (!llsd::sMapIndexThreshold || mData.size() <= llsd::sMapIndexThreshold)
+        {
+            return;
+        }
+
+        // at most half full after a rebuild, so probes stay short
+        size_t capacity = 16;
+        while (capacity < mData.size() * 2)
+        {
+            capacity <<= 1;
+        }
+        mIndex.resize(capacity);
+        for (DataMap::iterator it = mData.begin(); it != mData.end(); ++it)
+        {
+            indexAdd(it);
+        }
+    }
+
+    // call after a new entry went into mData
+    void ImplMap::added(DataMap::iterator it)
+    {
+        if (mIndex.empty())
+        {
+            if (llsd::sMapIndexThreshold && mData.size() > llsd::sMapIndexThreshold)
+            {
+                rebuildIndex();
+            }
+        }
+        else if ((mIndexUsed + 1) * 4 > mIndex.size() * 3)
+        {
+            rebuildIndex();
+        }
+        else
+        {
+            indexAdd(it);
+        }
+    }
+
+    ImplMap::DataMap::iterator ImplMap::find(std::string_view k)
+    {
+        if (mIndex.empty())
+        {
+            return mData.find(k);
+        }
+        IndexSlot* slot = findSlot(k, hashKey(k));
+        return slot ? slot->mIter : mData.end();
+    }
+
+    ImplMap::DataMap::const_iterator ImplMap::find(std::string_view k) const
+    {
+        if (mIndex.empty())
+        {
+            return mData.find(k);
+        }
+        IndexSlot* slot = findSlot(k, hashKey(k));
+        return slot ? DataMap::const_iterator(slot->mIter) : mData.end();
+    }
+
     bool ImplMap::has(const std::string_view k) const
     {
         LL_PROFILE_ZONE_SCOPED_CATEGORY_LLSD;
-        DataMap::const_iterator i = mData.find(k);
+        DataMap::const_iterator i = find(k);
         return i != mData.end();
     }
 
     LLSD ImplMap::get(const std::string_view k) const
     {
         LL_PROFILE_ZONE_SCOPED_CATEGORY_LLSD;
-        DataMap::const_iterator i = mData.find(k);
+        DataMap::const_iterator i = find(k);
         return (i != mData.end()) ? i->second : LLSD();
     }
 
@@ -528,21 +756,50 @@ namespace
     void ImplMap::insert(std::string_view k, const LLSD& v)
     {
         LL_PROFILE_ZONE_SCOPED_CATEGORY_LLSD;
-        mData.emplace(k, v);
+        std::pair<DataMap::iterator, bool> result = mData.emplace(k, v);
+        if (result.second)
+        {
+            added(result.first);
+        }
     }
 
     void ImplMap::erase(const LLSD::String& k)
     {
         LL_PROFILE_ZONE_SCOPED_CATEGORY_LLSD;
-        mData.erase(k);
+        if (mIndex.empty())
+        {
+            mData.erase(k);
+            return;
+        }
+        IndexSlot* slot = findSlot(k, hashKey(k));
+        if (slot)
+        {
+            // leave a tombstone so later probes keep going
+            mData.erase(slot->mIter);
+            slot->mState = SLOT_ERASED;
+            slot->mIter = mData.end();
+        }
     }
 
     LLSD& ImplMap::ref(std::string_view k)
     {
+        if (!mIndex.empty())
+        {
+            DataMap::iterator i = find(k);
+            if (i != mData.end())
+            {
+                return i->second;
+            }
+            i = mData.emplace(k, LLSD()).first;
+            added(i);
+            return i->second;
+        }
+
         DataMap::iterator i = mData.lower_bound(k);
         if (i == mData.end() || mData.key_comp()(k, i->first))
         {
-            return mData.emplace_hint(i, std::make_pair(k, LLSD()))->second;
+            i = mData.emplace_hint(i, std::make_pair(k, LLSD()));
+            added(i);
         }
 
         return i->second;
@@ -550,8 +807,8 @@ namespace
 
     const LLSD& ImplMap::ref(std::string_view k) const
     {
-        DataMap::const_iterator i = mData.lower_bound(k);
-        if (i == mData.end() || mData.key_comp()(k, i->first))
+        DataMap::const_iterator i = find(k);
+        if (i == mData.end())
         {
             return undef();
         }
@@ -747,15 +1004,57 @@ namespace
 }
 
 LLSD::Impl::Impl()
-    : mUseCount(0)
+    : mUseCount(0),
+      mInArena(llsd::Arena::sCurrent && llsd::Arena::sCurrent->isLast(this))
 {
     ++sAllocationCount;
     ++sOutstandingCount;
 }
 
 LLSD::Impl::Impl(StaticAllocationMarker)
-    : mUseCount(0)
+    : mUseCount(0),
+      mInArena(false)
+{
+}
+
+// static
+void* LLSD::Impl::operator new(size_t size)
 {
+    llsd::Arena* arena = llsd::Arena::sCurrent;
+    if (arena && llsd::Arena::fits(size))
+    {
+        return arena->allocate(size);
+    }
+    return ::operator new(size);
+}
+
+// static
+void LLSD::Impl::operator delete(void* p)
+{
+    // arena nodes only get here when their constructor threw, destroy()
+    // handles them otherwise
+    llsd::Arena* arena = llsd::Arena::sCurrent;
+    if (arena && arena->isLast(p))
+    {
+        arena->release();
+        return;
+    }
+    ::operator delete(p);
+}
+
+// static
+void LLSD::Impl::destroy(Impl* impl)
+{
+    if (impl->mInArena)
+    {
+        llsd::Arena* arena = llsd::Arena::owner(impl);
+        impl->~Impl();
+        arena->release();
+    }
+    else
+    {
+        delete impl;
+    }
 }
 
 LLSD::Impl::~Impl()
@@ -771,7 +1070,7 @@ void LLSD::Impl::reset(Impl*& var, Impl* impl)
     }
     if (var  &&  var->mUseCount != STATIC_USAGE_COUNT && --var->mUseCount == 0)
     {
-        delete var;
+        destroy(var);
     }
     var = impl;
 }
@@ -780,7 +1079,7 @@ void LLSD::Impl::move(Impl*& var, Impl*& impl)
 {
     if (var && var->mUseCount != STATIC_USAGE_COUNT && --var->mUseCount == 0)
     {
-        delete var; // destroy var if usage falls to 0 and not static
+        destroy(var); // destroy var if usage falls to 0 and not static
     }
     var = impl; // Steal impl to var without incrementing use since this is a move
     impl = nullptr; // null out old-impl pointer
@@ -512,6 +512,36 @@ LL_COMMON_API std::ostream& operator<<(std::ostream& s, const LLSD& llsd);
 
 namespace llsd
 {
+    /// Maps holding more than this many keys also keep a hash index of
+    /// them, so lookups no longer walk the tree of string compares.
+    /// Iteration order is unaffected. 0 disables the index.
+    LL_COMMON_API extern U32 sMapIndexThreshold;
+
+    class Arena;
+
+    /// While one of these is alive, the LLSD nodes created on its thread are
+    /// carved out of a shared list of blocks instead of being allocated one
+    /// by one. The strings, map and array storage the nodes own still come
+    /// from the heap. The blocks are freed once the scope has ended and the
+    /// last of its nodes is gone, so holding on to one value from a parsed
+    /// document keeps the whole document's blocks. Scopes may nest; one
+    /// constructed with enable false changes nothing.
+    class LL_COMMON_API ArenaScope
+    {
+    public:
+        explicit ArenaScope(bool enable = true);
+        ~ArenaScope();
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+    private:
+        Arena* mArena;
+        Arena* mPrevious;
+    };
+
+    /// Arena blocks currently allocated, across all threads.
+    LL_COMMON_API U32 arenaBlockCount();
 
 #ifdef LLSD_DEBUG_INFO
 /** @name Unit Testing Interface */
@@ -380,7 +380,7 @@ static const char BINARY_FALSE_SERIAL = '0';
  * LLSDParser
  */
 LLSDParser::LLSDParser()
-    : mCheckLimits(true), mMaxBytesLeft(0), mParseLines(false)
+    : mCheckLimits(true), mMaxBytesLeft(0), mParseLines(false), mUseArena(false)
 {
 }
 
@@ -392,6 +392,7 @@ S32 LLSDParser::parse(std::istream& istr, LLSD& data, llssize max_bytes, S32 max
 {
     mCheckLimits = LLSDSerialize::SIZE_UNLIMITED != max_bytes;
     mMaxBytesLeft = max_bytes;
+    llsd::ArenaScope arena(mUseArena);
     return doParse(istr, data, max_depth);
 }
 
@@ -401,6 +402,7 @@ S32 LLSDParser::parseLines(std::istream& istr, LLSD& data)
 {
     mCheckLimits = false;
     mParseLines = true;
+    llsd::ArenaScope arena(mUseArena);
     return doParse(istr, data);
 }
 
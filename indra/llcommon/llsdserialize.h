@@ -90,6 +90,15 @@ public:
      */
     void reset()    { doReset();    };
 
+    /**
+     * @brief Allocate the parsed nodes from a per-document arena.
+     *
+     * Fewer, larger allocations for big documents that are consumed and
+     * dropped as a whole. Not worth it when only a few values are kept
+     * around, since they keep the whole arena alive. See llsd::ArenaScope.
+     */
+    void setUseArena(bool use_arena) { mUseArena = use_arena; }
+
 
 protected:
     /**
@@ -211,6 +220,11 @@ protected:
      * @brief Use line-based reading to get text
      */
     bool mParseLines;
+
+    /**
+     * @brief Parse into an llsd::ArenaScope
+     */
+    bool mUseArena;
 };
 
 /**
@@ -0,0 +1,132 @@
+/**
+ * @file   lltimerwheel.h
+ * @brief  Hashed timer wheel for values deferred until a deadline.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#if ! defined(LL_LLTIMERWHEEL_H)
+#define LL_LLTIMERWHEEL_H
+
+#include "stdtypes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+/**
+ * Holds values until a deadline passes, e.g. requests waiting out a retry
+ * backoff. Deadlines are rounded up to whole ticks and hashed into a ring of
+ * slots, so scheduling is constant time and advance() only visits the slots
+ * for the ticks that went by, instead of the owner re-checking every
+ * deferred value on each pass. Deadlines more than one turn of the wheel
+ * away wait in their slot for the right lap.
+ *
+ * Values come out no earlier than their deadline and at most one tick late,
+ * those due in the same tick in the order they were scheduled. Times are
+ * seconds on whatever clock the owner passes to advance().
+ *
+ * Not thread safe, meant to be owned by one worker thread.
+ */
+template <typename T>
+class LLTimerWheel
+{
+public:
+    LLTimerWheel(F64 tick_seconds, U32 slots)
+        : mTickSeconds(tick_seconds), mSlots(slots), mCurrentTick(0), mSize(0)
+    {
+    }
+
+    void schedule(F64 due_seconds, T value)
+    {
+        U64 tick = (U64)std::ceil(std::max(due_seconds, 0.0) / mTickSeconds);
+        if (tick <= mCurrentTick)
+        {
+            tick = mCurrentTick + 1;
+        }
+        mSlots[tick % mSlots.size()].push_back(Entry{ tick, std::move(value) });
+        ++mSize;
+    }
+
+    // Calls fn(T&&) for every value due by now_seconds, returns how many.
+    // fn may schedule() more values.
+    template <typename FN>
+    U32 advance(F64 now_seconds, FN&& fn)
+    {
+        const U64 now_tick = (U64)(std::max(now_seconds, 0.0) / mTickSeconds);
+        if (now_tick <= mCurrentTick)
+        {
+            return 0;
+        }
+
+        U32 fired = 0;
+        // a full turn visits every slot, no need to go further after a long gap
+        const U64 last = std::min<U64>(now_tick, mCurrentTick + mSlots.size());
+        for (U64 tick = mCurrentTick + 1; tick <= last && mSize; ++tick)
+        {
+            mCurrentTick = tick;
+            std::vector<Entry>& slot = mSlots[tick % mSlots.size()];
+            if (slot.empty())
+            {
+                continue;
+            }
+
+            mFiring.swap(slot);
+            for (Entry& entry : mFiring)
+            {
+                if (entry.mTick <= now_tick)
+                {
+                    --mSize;
+                    ++fired;
+                    fn(std::move(entry.mValue));
+                }
+                else
+                {
+                    slot.push_back(std::move(entry));
+                }
+            }
+            mFiring.clear();
+        }
+        mCurrentTick = now_tick;
+        return fired;
+    }
+
+    size_t size() const         { return mSize; }
+    bool empty() const          { return mSize == 0; }
+    F64 getTickSeconds() const  { return mTickSeconds; }
+
+private:
+    struct Entry
+    {
+        U64 mTick;
+        T mValue;
+    };
+
+    F64 mTickSeconds;
+    std::vector<std::vector<Entry>> mSlots;
+    std::vector<Entry> mFiring;
+    U64 mCurrentTick;
+    size_t mSize;
+};
+
+#endif /* ! defined(LL_LLTIMERWHEEL_H) */
@@ -0,0 +1,137 @@
+/**
+ * @file   parallelfor.cpp
+ * @brief  Implementation for parallelfor.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "parallelfor.h"
+// STL headers
+#include <atomic>
+#include <memory>
+#include <thread>
+// std headers
+// external library headers
+// other Linden headers
+#include "threadpool.h"
+#include "workqueue.h"
+
+const std::string LL::PARALLEL_POOL_NAME("Parallel");
+
+namespace
+{
+    // Split the range into a few chunks per participating thread, so that
+    // uneven per-index cost still balances across threads.
+    constexpr size_t CHUNKS_PER_THREAD = 4;
+
+    // State shared between the caller and the helper tasks it posts. A helper
+    // task can be dequeued long after the caller has finished every chunk and
+    // returned, so the state lives in a shared_ptr, and mFunc is only touched
+    // after successfully claiming a chunk -- which can't happen once the
+    // caller has returned.
+    struct ParallelState
+    {
+        ParallelState(const LL::ParallelRange& func, size_t count, size_t chunk_size, size_t chunks):
+            mFunc(&func),
+            mCount(count),
+            mChunkSize(chunk_size),
+            mChunks(chunks)
+        {}
+
+        void drain()
+        {
+            for (size_t chunk = mNext++; chunk < mChunks; chunk = mNext++)
+            {
+                size_t begin = chunk * mChunkSize;
+                size_t end = llmin(begin + mChunkSize, mCount);
+                (*mFunc)(begin, end);
+                ++mDone;
+            }
+        }
+
+        const LL::ParallelRange* mFunc;
+        const size_t mCount;
+        const size_t mChunkSize;
+        const size_t mChunks;
+        std::atomic<size_t> mNext{ 0 };
+        std::atomic<size_t> mDone{ 0 };
+    };
+} // anonymous namespace
+
+void LL::parallel_for(size_t count, size_t min_chunk, const ParallelRange& func,
+                      const std::string& pool)
+{
+    if (!count)
+    {
+        return;
+    }
+
+    min_chunk = llmax(min_chunk, (size_t)1);
+
+    WorkQueue::ptr_t queue;
+    size_t width = 0;
+    if (count >= min_chunk * 2)
+    {
+        queue = WorkQueue::getInstance(pool);
+        if (queue && !queue->isClosed())
+        {
+            width = ThreadPoolBase::getWidth(pool, 0);
+        }
+    }
+
+    if (!width)
+    {
+        func(0, count);
+        return;
+    }
+
+    LL_PROFILE_ZONE_SCOPED;
+
+    size_t chunks = llmin(count / min_chunk, (width + 1) * CHUNKS_PER_THREAD);
+    size_t chunk_size = (count + chunks - 1) / chunks;
+    chunks = (count + chunk_size - 1) / chunk_size;
+
+    auto state = std::make_shared<ParallelState>(func, count, chunk_size, chunks);
+
+    // the calling thread takes one share of the work itself
+    size_t helpers = llmin(width, chunks - 1);
+    for (size_t i = 0; i < helpers; ++i)
+    {
+        if (!queue->post([state]() { state->drain(); }))
+        {
+            // queue closed under us, the remaining chunks fall to this thread
+            break;
+        }
+    }
+
+    state->drain();
+
+    // Every chunk has been claimed by now; wait for helpers still working on
+    // theirs. This is at most one chunk's worth of work per helper.
+    while (state->mDone.load() < chunks)
+    {
+        std::this_thread::yield();
+    }
+}
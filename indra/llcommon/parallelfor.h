@@ -0,0 +1,62 @@
+/**
+ * @file   parallelfor.h
+ * @brief  parallel_for() splits an index range across the threads of a
+ *         ThreadPool, with the calling thread taking part in the work.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#if ! defined(LL_PARALLELFOR_H)
+#define LL_PARALLELFOR_H
+
+#include <functional>
+#include <string>
+
+namespace LL
+{
+    /// name of the ThreadPool parallel_for() uses unless told otherwise
+    extern LL_COMMON_API const std::string PARALLEL_POOL_NAME;
+
+    using ParallelRange = std::function<void(size_t begin, size_t end)>;
+
+    /**
+     * parallel_for() splits the index range [0, count) into contiguous chunks
+     * of at least min_chunk indices and calls func(begin, end) once per chunk.
+     * Chunks are claimed by the calling thread and by the threads of the
+     * named ThreadPool; parallel_for() returns once every chunk is done.
+     *
+     * If the named pool doesn't exist or has been closed, or if count is too
+     * small to be worth splitting, func(0, count) is simply called on the
+     * calling thread. Since the calling thread drains chunks itself, it's
+     * safe (if pointless) to call parallel_for() from a thread of the same
+     * pool: it can never deadlock waiting on work nobody will pick up.
+     *
+     * func must be safe to call concurrently for disjoint ranges, and must
+     * not throw.
+     */
+    LL_COMMON_API void parallel_for(size_t count, size_t min_chunk,
+                                    const ParallelRange& func,
+                                    const std::string& pool = PARALLEL_POOL_NAME);
+
+} // namespace LL
+
+#endif /* ! defined(LL_PARALLELFOR_H) */
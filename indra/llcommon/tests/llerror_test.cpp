@@ -35,7 +35,11 @@
 #include "../llerrorcontrol.h"
 #include "../llsd.h"
 
+#include "../lltimer.h"
+#include "../llfile.h"
 #include "../test/lltut.h"
+#include "../test/namedtempfile.h"
+#include "stringize.h"
 
 enum LogFieldIndex
 {
@@ -921,13 +925,70 @@ namespace tut
     }
 }
 
+namespace tut
+{
+    template<> template<>
+    void ErrorTestObject::test<19>()
+        // file recorder, synchronous and async, with the cost per call
+    {
+        LLError::setDefaultLevel(LLError::LEVEL_INFO);
+        LLError::removeRecorder(mRecorder);
+
+        const int count = 20000;
+        F64 per_call[2];
+        for (int async = 0; async < 2; ++async)
+        {
+            NamedTempFile log("llerror", "");
+            LLError::setAsyncLogging(async != 0);
+            LLError::logToFile(log.getName());
+
+            LLTimer timer;
+            for (int i = 0; i < count; ++i)
+            {
+                LL_INFOS("AsyncLog") << "message " << i << LL_ENDL;
+            }
+            per_call[async] = timer.getElapsedTimeF64() * 1000000.0 / count;
+
+            LLError::flushLogs();
+            LLError::logToFile("");
+
+            llifstream in(log.getName().c_str());
+            int lines = 0;
+            int dropped = 0;
+            std::string line;
+            while (std::getline(in, line))
+            {
+                if (line.find("log messages dropped") != std::string::npos)
+                {
+                    // "*** N log messages dropped ..."
+                    dropped += atoi(line.c_str() + 4);
+                }
+                else if (line.find("message ") != std::string::npos)
+                {
+                    ++lines;
+                }
+            }
+            ensure_equals(STRINGIZE((async ? "async" : "sync") << " messages written or counted as dropped"),
+                          lines + dropped, count);
+            if (!async)
+            {
+                ensure_equals("sync recorder never drops", dropped, 0);
+            }
+        }
+        LLError::setAsyncLogging(false);
+        LLError::addRecorder(mRecorder);
+
+        // not a pass/fail check, timing depends on the machine and disk
+        LL_INFOS() << "log to file, us per call: sync " << per_call[0] << ", async " << per_call[1] << LL_ENDL;
+    }
+}
+
 /* Tests left:
     handling of classes without LOG_CLASS
 
     live update of filtering from file
 
     syslog recorder
-    file recorder
     cerr/stderr recorder
     fixed buffer recorder
     windows recorder
@@ -0,0 +1,159 @@
+/**
+ * @file   lllockfreequeue_test.cpp
+ * @brief  Test for lllockfreequeue.h.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "lllockfreequeue.h"
+// STL headers
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+// std headers
+// external library headers
+// other Linden headers
+#include "../test/lltut.h"
+#include "stringize.h"
+
+/*****************************************************************************
+*   TUT
+*****************************************************************************/
+namespace tut
+{
+    struct lllockfreequeue_data
+    {
+    };
+    typedef test_group<lllockfreequeue_data> lllockfreequeue_group;
+    typedef lllockfreequeue_group::object object;
+    lllockfreequeue_group lllockfreequeuegrp("lllockfreequeue");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("fifo, full and empty");
+        LLLockFreeQueue<std::string> queue(5);
+        ensure_equals("capacity rounded up", queue.capacity(), 8u);
+        ensure("starts empty", queue.empty());
+
+        std::string value;
+        ensure("pop from empty", !queue.tryPop(value));
+
+        for (U32 lap = 0; lap < 3; ++lap)
+        {
+            for (U32 i = 0; i < 8; ++i)
+            {
+                ensure(STRINGIZE("push " << i), queue.tryPush(STRINGIZE(lap << ':' << i)));
+            }
+            ensure("push to full", !queue.tryPush(std::string("extra")));
+
+            for (U32 i = 0; i < 8; ++i)
+            {
+                ensure(STRINGIZE("pop " << i), queue.tryPop(value));
+                ensure_equals("fifo order", value, STRINGIZE(lap << ':' << i));
+            }
+            ensure("drained", queue.empty());
+        }
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("concurrent producers and consumers");
+        const U32 producers = 4;
+        const U32 consumers = 2;
+        const U32 per_producer = 50000;
+        LLLockFreeQueue<U32> queue(256);
+
+        std::atomic<U32> producing(producers);
+        std::vector<std::vector<U32>> received(consumers);
+        std::vector<std::thread> threads;
+
+        for (U32 p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&queue, &producing, p, per_producer]()
+            {
+                for (U32 i = 0; i < per_producer; ++i)
+                {
+                    while (!queue.tryPush(p * per_producer + i))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                --producing;
+            });
+        }
+        for (U32 c = 0; c < consumers; ++c)
+        {
+            threads.emplace_back([&queue, &producing, &received, c]()
+            {
+                U32 value;
+                for (;;)
+                {
+                    if (queue.tryPop(value))
+                    {
+                        received[c].push_back(value);
+                    }
+                    else if (!producing)
+                    {
+                        // producers are done, take whatever is left
+                        while (queue.tryPop(value))
+                        {
+                            received[c].push_back(value);
+                        }
+                        break;
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        std::vector<U32> seen(producers * per_producer, 0);
+        for (const std::vector<U32>& values : received)
+        {
+            // each consumer sees any one producer's values in push order
+            std::vector<S64> last(producers, -1);
+            for (U32 value : values)
+            {
+                ++seen[value];
+                const U32 p = value / per_producer;
+                ensure(STRINGIZE("producer " << p << " order"), (S64)value > last[p]);
+                last[p] = value;
+            }
+        }
+        for (size_t i = 0; i < seen.size(); ++i)
+        {
+            ensure_equals(STRINGIZE("value " << i << " delivered once"), seen[i], 1u);
+        }
+    }
+}
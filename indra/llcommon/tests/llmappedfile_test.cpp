@@ -0,0 +1,78 @@
+/**
+ * @file   llmappedfile_test.cpp
+ * @brief  Test for llmappedfile.h.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "llmappedfile.h"
+// STL headers
+#include <string>
+// std headers
+// external library headers
+// other Linden headers
+#include "../test/lltut.h"
+#include "../test/namedtempfile.h"
+#include "stringize.h"
+
+/*****************************************************************************
+*   TUT
+*****************************************************************************/
+namespace tut
+{
+    struct llmappedfile_data
+    {
+    };
+    typedef test_group<llmappedfile_data> llmappedfile_group;
+    typedef llmappedfile_group::object object;
+    llmappedfile_group llmappedfilegrp("llmappedfile");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("map contents, empty and missing files");
+        std::string contents;
+        for (U32 i = 0; i < 10000; ++i)
+        {
+            contents += STRINGIZE("line " << i << '\n');
+        }
+        NamedTempFile file("mapped", contents);
+
+        LLMappedFile mapped;
+        ensure("starts closed", !mapped.isOpen());
+        ensure("open", mapped.open(file.getName()));
+        ensure_equals("size", mapped.size(), contents.size());
+        ensure("contents", std::string((const char*)mapped.data(), mapped.size()) == contents);
+
+        NamedTempFile empty("mapped", "");
+        ensure("open empty", mapped.open(empty.getName()));
+        ensure("empty is open", mapped.isOpen());
+        ensure_equals("empty size", mapped.size(), (size_t)0);
+        ensure("empty range", mapped.begin() == mapped.end());
+
+        ensure("missing file", !mapped.open(file.getName() + ".missing"));
+        ensure("closed after failure", !mapped.isOpen());
+    }
+}
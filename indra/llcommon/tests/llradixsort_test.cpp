@@ -0,0 +1,129 @@
+/**
+ * @file   llradixsort_test.cpp
+ * @brief  Test for llradixsort.h.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "llradixsort.h"
+// STL headers
+#include <algorithm>
+#include <vector>
+// std headers
+// external library headers
+// other Linden headers
+#include "../test/lltut.h"
+#include "stringize.h"
+
+/*****************************************************************************
+*   TUT
+*****************************************************************************/
+namespace tut
+{
+    struct llradixsort_data
+    {
+        struct Item
+        {
+            F32 mDepth;
+            U32 mId;
+        };
+
+        // deterministic pseudo random values so failures are reproducible
+        U32 mSeed = 1;
+        F32 next(F32 lo, F32 hi)
+        {
+            mSeed = mSeed * 1664525u + 1013904223u;
+            return lo + (hi - lo) * ((mSeed >> 8) / 16777216.f);
+        }
+    };
+    typedef test_group<llradixsort_data> llradixsort_group;
+    typedef llradixsort_group::object object;
+    llradixsort_group llradixsortgrp("llradixsort");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("float keys preserve ordering");
+        const F32 values[] = { -1.0e30f, -512.f, -1.f, -0.5f, -1.0e-30f, 0.f, 1.0e-30f, 0.5f, 1.f, 512.f, 1.0e30f };
+        for (size_t i = 1; i < sizeof(values) / sizeof(values[0]); ++i)
+        {
+            ensure(STRINGIZE(values[i - 1] << " sorts before " << values[i]),
+                   ll_float_sort_key(values[i - 1]) < ll_float_sort_key(values[i]));
+        }
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("matches stable_sort, descending depth");
+        std::vector<Item> items;
+        for (U32 i = 0; i < 5000; ++i)
+        {
+            // quantize some depths so there are plenty of ties to check stability
+            F32 depth = next(-100.f, 1000.f);
+            if (i % 3 == 0)
+            {
+                depth = (F32)(S32)depth;
+            }
+            items.push_back({ depth, i });
+        }
+
+        std::vector<Item> expected = items;
+        std::stable_sort(expected.begin(), expected.end(),
+                         [](const Item& lhs, const Item& rhs) { return lhs.mDepth > rhs.mDepth; });
+
+        std::vector<std::pair<U32, Item>> scratch;
+        ll_radix_sort(items.data(), items.size(),
+                      [](const Item& item) { return ~ll_float_sort_key(item.mDepth); }, scratch);
+
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            ensure_equals(STRINGIZE("item " << i), items[i].mId, expected[i].mId);
+        }
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("narrow key range skips passes");
+        // all keys share their upper digits, only the lowest pass reorders
+        std::vector<U32> values;
+        for (U32 i = 0; i < 300; ++i)
+        {
+            values.push_back(0x12345000u + ((i * 37u) & 0x7ffu));
+        }
+        std::vector<U32> expected = values;
+        std::stable_sort(expected.begin(), expected.end());
+
+        std::vector<std::pair<U32, U32>> scratch;
+        ll_radix_sort(values.data(), values.size(), [](U32 v) { return v; }, scratch);
+        ensure("sorted", values == expected);
+
+        // trivially short input is left alone
+        U32 one = 42;
+        ll_radix_sort(&one, 1, [](U32 v) { return v; }, scratch);
+        ensure_equals("single item", one, 42u);
+    }
+}
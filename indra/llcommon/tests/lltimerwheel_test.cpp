@@ -0,0 +1,135 @@
+/**
+ * @file   lltimerwheel_test.cpp
+ * @brief  Test for lltimerwheel.h.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "lltimerwheel.h"
+// STL headers
+#include <vector>
+// std headers
+// external library headers
+// other Linden headers
+#include "../test/lltut.h"
+#include "stringize.h"
+
+/*****************************************************************************
+*   TUT
+*****************************************************************************/
+namespace tut
+{
+    struct lltimerwheel_data
+    {
+        struct Fired
+        {
+            U32 mId;
+            F64 mAt;
+        };
+    };
+    typedef test_group<lltimerwheel_data> lltimerwheel_group;
+    typedef lltimerwheel_group::object object;
+    lltimerwheel_group lltimerwheelgrp("lltimerwheel");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("deadlines, including ones past a full turn");
+        const F64 tick = 0.25;
+        LLTimerWheel<U32> wheel(tick, 16);
+        const F64 start = 1000.0;
+        wheel.advance(start, [](U32) {});
+
+        // 16 slots of 0.25s is one turn every 4s, go well past that
+        std::vector<F64> due;
+        for (U32 i = 0; i < 200; ++i)
+        {
+            due.push_back(start + 0.5 + i * 0.113);
+            wheel.schedule(due.back(), i);
+        }
+        ensure_equals("all scheduled", wheel.size(), (size_t)200);
+
+        std::vector<Fired> fired;
+        for (F64 now = start; now < start + 30.0; now += 0.05)
+        {
+            wheel.advance(now, [&](U32 id) { fired.push_back({ id, now }); });
+        }
+
+        ensure("wheel drained", wheel.empty());
+        ensure_equals("everything fired", fired.size(), (size_t)200);
+        for (size_t i = 0; i < fired.size(); ++i)
+        {
+            const Fired& f = fired[i];
+            ensure(STRINGIZE("value " << f.mId << " not early"), f.mAt >= due[f.mId]);
+            ensure(STRINGIZE("value " << f.mId << " at most a tick late"), f.mAt < due[f.mId] + tick + 0.05);
+            // deadlines increase with the id, so ids come out in order
+            ensure_equals("deadline order", f.mId, (U32)i);
+        }
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("same tick keeps order, long gaps, rescheduling");
+        LLTimerWheel<U32> wheel(1.0, 8);
+        for (U32 i = 0; i < 5; ++i)
+        {
+            wheel.schedule(3.0, i);
+        }
+        wheel.schedule(50.0, 99);
+
+        std::vector<U32> fired;
+        ensure_equals("nothing due yet", wheel.advance(2.5, [&](U32 id) { fired.push_back(id); }), 0u);
+        ensure_equals("same tick fires together", wheel.advance(3.0, [&](U32 id) { fired.push_back(id); }), 5u);
+        for (U32 i = 0; i < 5; ++i)
+        {
+            ensure_equals("scheduling order", fired[i], i);
+        }
+
+        // a value that keeps backing off, rescheduled from the callback
+        wheel.schedule(4.0, 7);
+        U32 retries = 0;
+        for (F64 now = 4.0; now < 40.0; now += 1.0)
+        {
+            wheel.advance(now, [&](U32 id)
+                {
+                    if (id == 7 && ++retries < 4)
+                    {
+                        wheel.schedule(now + (1 << retries), id);
+                    }
+                });
+        }
+        ensure_equals("rescheduled value came back", retries, 4u);
+        ensure_equals("far deadline still waiting", wheel.size(), (size_t)1);
+
+        // a gap of many turns still finds it, and a past deadline fires next tick
+        fired.clear();
+        wheel.advance(1000.0, [&](U32 id) { fired.push_back(id); });
+        ensure("far deadline fired after the gap", fired.size() == 1 && fired[0] == 99);
+        wheel.schedule(10.0, 5);
+        ensure_equals("past deadline waits for the next tick", wheel.advance(1000.5, [](U32) {}), 0u);
+        ensure_equals("past deadline fires", wheel.advance(1001.0, [](U32) {}), 1u);
+    }
+}
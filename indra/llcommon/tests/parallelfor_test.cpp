@@ -0,0 +1,125 @@
+/**
+ * @file   parallelfor_test.cpp
+ * @brief  Test for parallelfor.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "parallelfor.h"
+// STL headers
+#include <atomic>
+#include <vector>
+// std headers
+// external library headers
+// other Linden headers
+#include "../test/lltut.h"
+#include "stringize.h"
+#include "threadpool.h"
+
+/*****************************************************************************
+*   TUT
+*****************************************************************************/
+namespace tut
+{
+    struct parallelfor_data
+    {
+        // check that every index in [0, count) was visited exactly once
+        static void check_coverage(const std::string& desc, const std::vector<std::atomic<int>>& visits)
+        {
+            for (size_t i = 0; i < visits.size(); ++i)
+            {
+                ensure_equals(STRINGIZE(desc << " index " << i), visits[i].load(), 1);
+            }
+        }
+    };
+    typedef test_group<parallelfor_data> parallelfor_group;
+    typedef parallelfor_group::object object;
+    parallelfor_group parallelforgrp("parallelfor");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("no pool runs serially");
+        std::vector<std::atomic<int>> visits(1000);
+        size_t calls = 0;
+        LL::parallel_for(visits.size(), 10,
+                         [&visits, &calls](size_t begin, size_t end)
+                         {
+                             ++calls;
+                             for (size_t i = begin; i < end; ++i)
+                             {
+                                 ++visits[i];
+                             }
+                         },
+                         "parallelfor_test_nonexistent");
+        ensure_equals("serial fallback should make one call", calls, size_t(1));
+        check_coverage("serial", visits);
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("pool covers every index once");
+        LL::ThreadPool pool("parallelfor_test", 3);
+        pool.start();
+
+        for (size_t count : { 1, 7, 64, 1000, 4097 })
+        {
+            std::vector<std::atomic<int>> visits(count);
+            LL::parallel_for(count, 16,
+                             [&visits](size_t begin, size_t end)
+                             {
+                                 for (size_t i = begin; i < end; ++i)
+                                 {
+                                     ++visits[i];
+                                 }
+                             },
+                             "parallelfor_test");
+            check_coverage(STRINGIZE("count " << count), visits);
+        }
+        pool.close();
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("closed pool runs serially");
+        LL::ThreadPool pool("parallelfor_test_closed", 2);
+        pool.start();
+        pool.close();
+
+        std::vector<std::atomic<int>> visits(500);
+        LL::parallel_for(visits.size(), 1,
+                         [&visits](size_t begin, size_t end)
+                         {
+                             for (size_t i = begin; i < end; ++i)
+                             {
+                                 ++visits[i];
+                             }
+                         },
+                         "parallelfor_test_closed");
+        check_coverage("closed", visits);
+    }
+} // namespace tut
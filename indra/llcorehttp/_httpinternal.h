@@ -160,9 +160,17 @@ constexpr long HTTP_THROTTLE_RATE_DEFAULT = 0L;
 // Tuning parameters
 
 // Time worker thread sleeps after a pass through the
-// request, ready and active queues.
+// request, ready and active queues.  With libcurl 7.68
+// and later, the thread waits on request sockets instead
+// and this only applies to older libraries.
 constexpr int HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS = 2;
 
+// Longest time the worker thread waits for socket activity
+// while requests are active or queued.  New requests, libcurl
+// timeouts and shutdown end the wait early; this bounds the
+// latency of retries and throttle windows.
+constexpr int HTTP_SERVICE_LOOP_WAIT_MAX_MS = 20;
+
 // Block allocation size (a tuning parameter) is found
 // in bufferarray.h.
 
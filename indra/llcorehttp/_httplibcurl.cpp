@@ -30,8 +30,10 @@
 #include "bufferarray.h"
 #include "_httpoprequest.h"
 #include "_httppolicy.h"
+#include "httpstats.h"
 
 #include "llhttpconstants.h"
+#include "lltimer.h"
 
 namespace
 {
@@ -51,6 +53,99 @@ void check_curl_multi_setopt(CURLM* handle, CURLMoption option, ARG argument)
 
 static const char * const LOG_CORE("CoreHttp");
 
+// curl_multi_poll() and curl_multi_wakeup() arrived in 7.66 and 7.68
+#if LIBCURL_VERSION_NUM >= 0x074400
+#define LLCORE_CURL_HAS_WAKEUP 1
+#else
+#define LLCORE_CURL_HAS_WAKEUP 0
+#endif
+
+// Append the sockets libcurl is waiting on in a multi handle to @fds
+// in the form curl_multi_wait() wants for extra descriptors.  Sockets
+// numbered above FD_SETSIZE aren't reported by curl_multi_fdset(), so
+// waits must always be bounded by a timeout.
+void append_wait_fds(CURLM * multi_handle, std::vector<curl_waitfd> & fds)
+{
+    fd_set read_fds, write_fds, exc_fds;
+    FD_ZERO(&read_fds);
+    FD_ZERO(&write_fds);
+    FD_ZERO(&exc_fds);
+    int max_fd(-1);
+
+    if (CURLM_OK != curl_multi_fdset(multi_handle, &read_fds, &write_fds, &exc_fds, &max_fd)
+        || max_fd < 0)
+    {
+        return;
+    }
+
+#if LL_WINDOWS
+    // Winsock fd_sets are socket lists rather than bitmaps
+    for (u_int i(0); i < read_fds.fd_count; ++i)
+    {
+        fds.push_back({ read_fds.fd_array[i], CURL_WAIT_POLLIN, 0 });
+    }
+    for (u_int i(0); i < write_fds.fd_count; ++i)
+    {
+        fds.push_back({ write_fds.fd_array[i], CURL_WAIT_POLLOUT, 0 });
+    }
+    for (u_int i(0); i < exc_fds.fd_count; ++i)
+    {
+        fds.push_back({ exc_fds.fd_array[i], CURL_WAIT_POLLPRI, 0 });
+    }
+#else
+    for (int fd(0); fd <= max_fd; ++fd)
+    {
+        short events(0);
+        if (FD_ISSET(fd, &read_fds))
+        {
+            events |= CURL_WAIT_POLLIN;
+        }
+        if (FD_ISSET(fd, &write_fds))
+        {
+            events |= CURL_WAIT_POLLOUT;
+        }
+        if (FD_ISSET(fd, &exc_fds))
+        {
+            events |= CURL_WAIT_POLLPRI;
+        }
+        if (events)
+        {
+            fds.push_back({ fd, events, 0 });
+        }
+    }
+#endif
+}
+
+// Feed connection reuse, handshake and throughput figures of a
+// finished transfer to HTTPStats.  New connections are those libcurl
+// had to open for this transfer, a multiplexed transfer is one that
+// ran as an HTTP/2 stream.
+void record_transfer_stats(CURL * handle)
+{
+    long new_connections(0);
+    double handshake(0.0), connect(0.0), bytes(0.0), total(0.0);
+
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &new_connections);
+    curl_easy_getinfo(handle, CURLINFO_APPCONNECT_TIME, &handshake);
+    curl_easy_getinfo(handle, CURLINFO_CONNECT_TIME, &connect);
+    curl_easy_getinfo(handle, CURLINFO_SIZE_DOWNLOAD, &bytes);
+    curl_easy_getinfo(handle, CURLINFO_TOTAL_TIME, &total);
+
+    bool multiplexed(false);
+#if LIBCURL_VERSION_NUM >= 0x073200
+    long http_version(CURL_HTTP_VERSION_NONE);
+    if (CURLE_OK == curl_easy_getinfo(handle, CURLINFO_HTTP_VERSION, &http_version))
+    {
+        multiplexed = (http_version == CURL_HTTP_VERSION_2_0);
+    }
+#endif
+
+    // Plain http has no TLS handshake, use the TCP connect instead
+    LLCore::HTTPStats::instance().recordTransfer(S32(new_connections),
+                                                 handshake > 0.0 ? handshake : connect,
+                                                 multiplexed, bytes, total);
+}
+
 } // end anonymous namespace
 
 
@@ -64,14 +159,31 @@ HttpLibcurl::HttpLibcurl(HttpService * service)
       mPolicyCount(0),
       mMultiHandles(NULL),
       mActiveHandles(NULL),
-      mDirtyPolicy(NULL)
-{}
+      mDirtyPolicy(NULL),
+      mSharedHandle(NULL),
+      mWaitHandle(NULL)
+{
+    // Never has requests added, it only provides the wait and wakeup
+    // mechanism for waitForActivity() across all policy classes.
+    mWaitHandle = curl_multi_init();
+    if (! mWaitHandle)
+    {
+        LL_WARNS(LOG_CORE) << "Failed to allocate wait handle in libcurl, falling back to polling."
+                           << LL_ENDL;
+    }
+}
 
 
 HttpLibcurl::~HttpLibcurl()
 {
     shutdown();
 
+    if (mWaitHandle)
+    {
+        curl_multi_cleanup(mWaitHandle);
+        mWaitHandle = NULL;
+    }
+
     mService = NULL;
 }
 
@@ -90,11 +202,17 @@ void HttpLibcurl::shutdown()
     {
         for (unsigned int policy_class(0); policy_class < mPolicyCount; ++policy_class)
         {
-            if (mMultiHandles[policy_class])
+            if (mMultiHandles[policy_class] && mMultiHandles[policy_class] != mSharedHandle)
             {
                 curl_multi_cleanup(mMultiHandles[policy_class]);
-                mMultiHandles[policy_class] = 0;
             }
+            mMultiHandles[policy_class] = 0;
+        }
+
+        if (mSharedHandle)
+        {
+            curl_multi_cleanup(mSharedHandle);
+            mSharedHandle = NULL;
         }
 
         delete [] mMultiHandles;
@@ -122,9 +240,33 @@ void HttpLibcurl::start(int policy_count)
     mActiveHandles = new int [mPolicyCount];
     mDirtyPolicy = new bool [mPolicyCount];
 
+    const HttpPolicyGlobal & gpolicy(mService->getPolicy().getGlobalOptions());
+    if (gpolicy.mHttp2Multiplex)
+    {
+        // One handle for all classes so that, say, texture and mesh
+        // requests to the same CDN host share a connection as streams.
+        // The global connection limit bounds the connections, class
+        // limits are applied to streams by HttpPolicy.
+        if (NULL == (mSharedHandle = curl_multi_init()))
+        {
+            LL_ERRS(LOG_CORE) << "Failed to allocate multi handle in libcurl."
+                              << LL_ENDL;
+        }
+        check_curl_multi_setopt(mSharedHandle,
+                                 CURLMOPT_PIPELINING,
+                                 long(CURLPIPE_MULTIPLEX));
+        check_curl_multi_setopt(mSharedHandle,
+                                 CURLMOPT_MAX_TOTAL_CONNECTIONS,
+                                 long(gpolicy.mConnectionLimit));
+    }
+
     for (unsigned int policy_class(0); policy_class < mPolicyCount; ++policy_class)
     {
-        if (NULL == (mMultiHandles[policy_class] = curl_multi_init()))
+        if (mSharedHandle)
+        {
+            mMultiHandles[policy_class] = mSharedHandle;
+        }
+        else if (NULL == (mMultiHandles[policy_class] = curl_multi_init()))
         {
             LL_ERRS(LOG_CORE) << "Failed to allocate multi handle in libcurl."
                               << LL_ENDL;
@@ -148,72 +290,171 @@ HttpService::ELoopSpeed HttpLibcurl::processTransport()
     HttpService::ELoopSpeed ret(HttpService::REQUEST_SLEEP);
 
     // Give libcurl some cycles to do I/O & callbacks
-    for (unsigned int policy_class(0); policy_class < mPolicyCount; ++policy_class)
+    if (mSharedHandle)
     {
-        if (! mMultiHandles[policy_class])
+        // Every class runs on the same handle, a single pass covers all
+        if (! mActiveOps.empty() && processMulti(mSharedHandle))
         {
-            // No handle, nothing to do.
-            continue;
+            ret = HttpService::IMMEDIATE;
         }
-        if (! mActiveHandles[policy_class])
+    }
+    else
+    {
+        for (unsigned int policy_class(0); policy_class < mPolicyCount; ++policy_class)
         {
-            // If we've gone quiet and there's a dirty update, apply it,
-            // otherwise we're done.
-            if (mDirtyPolicy[policy_class])
+            if (! mMultiHandles[policy_class])
             {
-                policyUpdated(policy_class);
+                // No handle, nothing to do.
+                continue;
+            }
+            if (! mActiveHandles[policy_class])
+            {
+                // If we've gone quiet and there's a dirty update, apply it,
+                // otherwise we're done.
+                if (mDirtyPolicy[policy_class])
+                {
+                    policyUpdated(policy_class);
+                }
+                continue;
             }
-            continue;
-        }
 
-        int running(0);
-        CURLMcode status(CURLM_CALL_MULTI_PERFORM);
-        do
-        {
-            LL_PROFILE_ZONE_NAMED_CATEGORY_NETWORK("httppt - curl_multi_perform");
-            running = 0;
-            status = curl_multi_perform(mMultiHandles[policy_class], &running);
+            if (processMulti(mMultiHandles[policy_class]))
+            {
+                ret = HttpService::IMMEDIATE;   // If anything completes, we may have a free slot.
+                                                // Turning around quickly reduces connection gap by 7-10mS.
+            }
         }
-        while (0 != running && CURLM_CALL_MULTI_PERFORM == status);
+    }
 
-        // Run completion on anything done
-        CURLMsg * msg(NULL);
-        int msgs_in_queue(0);
+    if (! mActiveOps.empty())
+    {
+        ret = (std::min)(ret, HttpService::NORMAL);
+    }
+    return ret;
+}
+
+
+bool HttpLibcurl::processMulti(CURLM * multi_handle)
+{
+    bool completed(false);
+
+    int running(0);
+    CURLMcode status(CURLM_CALL_MULTI_PERFORM);
+    do
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_NETWORK("httppt - curl_multi_perform");
+        running = 0;
+        status = curl_multi_perform(multi_handle, &running);
+    }
+    while (0 != running && CURLM_CALL_MULTI_PERFORM == status);
+
+    // Run completion on anything done
+    CURLMsg * msg(NULL);
+    int msgs_in_queue(0);
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_NETWORK("httppt - curl_multi_info_read");
+        while ((msg = curl_multi_info_read(multi_handle, &msgs_in_queue)))
         {
-            LL_PROFILE_ZONE_NAMED_CATEGORY_NETWORK("httppt - curl_multi_info_read");
-            while ((msg = curl_multi_info_read(mMultiHandles[policy_class], &msgs_in_queue)))
+            if (CURLMSG_DONE == msg->msg)
             {
-                if (CURLMSG_DONE == msg->msg)
-                {
-                    CURL* handle(msg->easy_handle);
-                    CURLcode result(msg->data.result);
+                CURL* handle(msg->easy_handle);
+                CURLcode result(msg->data.result);
 
-                    completeRequest(mMultiHandles[policy_class], handle, result);
-                    handle = NULL;                  // No longer valid on return
-                    ret = HttpService::NORMAL;      // If anything completes, we may have a free slot.
-                                                    // Turning around quickly reduces connection gap by 7-10mS.
-                }
-                else if (CURLMSG_NONE == msg->msg)
-                {
-                    // Ignore this... it shouldn't mean anything.
-                    ;
-                }
-                else
-                {
-                    LL_WARNS_ONCE(LOG_CORE) << "Unexpected message from libcurl.  Msg code:  "
-                        << msg->msg
-                        << LL_ENDL;
-                }
-                msgs_in_queue = 0;
+                completeRequest(multi_handle, handle, result);
+                handle = NULL;                  // No longer valid on return
+                completed = true;
+            }
+            else if (CURLMSG_NONE == msg->msg)
+            {
+                // Ignore this... it shouldn't mean anything.
+                ;
             }
+            else
+            {
+                LL_WARNS_ONCE(LOG_CORE) << "Unexpected message from libcurl.  Msg code:  "
+                    << msg->msg
+                    << LL_ENDL;
+            }
+            msgs_in_queue = 0;
         }
     }
 
-    if (! mActiveOps.empty())
+    return completed;
+}
+
+
+void HttpLibcurl::waitForActivity(int timeout_ms)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
+
+#if ! LLCORE_CURL_HAS_WAKEUP
+    // New requests can't interrupt the wait, keep it as short
+    // as the polling sleep it replaces.
+    timeout_ms = (std::min)(timeout_ms, HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS);
+#endif
+
+    if (! mWaitHandle)
     {
-        ret = HttpService::NORMAL;
+        ms_sleep(timeout_ms);
+        return;
     }
-    return ret;
+
+    long timeout(timeout_ms);
+    mWaitFds.clear();
+    for (unsigned int policy_class(0); policy_class < mPolicyCount; ++policy_class)
+    {
+        if (! mMultiHandles[policy_class] || ! mActiveHandles[policy_class])
+        {
+            continue;
+        }
+
+        long curl_timeout(-1);
+        if (CURLM_OK == curl_multi_timeout(mMultiHandles[policy_class], &curl_timeout)
+            && curl_timeout >= 0)
+        {
+            timeout = (std::min)(timeout, curl_timeout);
+        }
+
+        append_wait_fds(mMultiHandles[policy_class], mWaitFds);
+
+        if (mSharedHandle)
+        {
+            // Every class uses the same handle, one pass collects all
+            break;
+        }
+    }
+
+    if (timeout <= 0)
+    {
+        // libcurl wants to be run now
+        return;
+    }
+
+    int numfds(0);
+#if LLCORE_CURL_HAS_WAKEUP
+    curl_multi_poll(mWaitHandle, mWaitFds.data(), (unsigned int) mWaitFds.size(), int(timeout), &numfds);
+#else
+    if (mWaitFds.empty())
+    {
+        // curl_multi_wait() doesn't sleep when it has nothing to wait on
+        ms_sleep(int(timeout));
+    }
+    else
+    {
+        curl_multi_wait(mWaitHandle, mWaitFds.data(), (unsigned int) mWaitFds.size(), int(timeout), &numfds);
+    }
+#endif
+}
+
+
+void HttpLibcurl::wakeup()
+{
+#if LLCORE_CURL_HAS_WAKEUP
+    if (mWaitHandle)
+    {
+        curl_multi_wakeup(mWaitHandle);
+    }
+#endif
 }
 
 
@@ -463,6 +704,11 @@ bool HttpLibcurl::completeRequest(CURLM * multi_handle, CURL * handle, CURLcode
     }
     // /</FS:ND>
 
+    if (handle)
+    {
+        record_transfer_stats(handle);
+    }
+
     if (multi_handle && handle)
     {
         // Detach from multi and recycle handle
@@ -517,6 +763,16 @@ void HttpLibcurl::policyUpdated(unsigned int policy_class)
 
     HttpPolicy & policy(mService->getPolicy());
 
+    if (mSharedHandle)
+    {
+        // Class options only shape how HttpPolicy issues requests, the
+        // shared handle keeps the settings made in start() so there is
+        // nothing to stall for.
+        policy.stallPolicy(policy_class, false);
+        mDirtyPolicy[policy_class] = false;
+        return;
+    }
+
     if (! mActiveHandles[policy_class])
     {
         // Clear to set options.  As of libcurl 7.37.0, if a pipelining
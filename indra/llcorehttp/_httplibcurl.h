@@ -77,6 +77,22 @@ public:
     /// Threading:  called by worker thread.
     HttpService::ELoopSpeed processTransport();
 
+    /// Block until a socket of an active request is ready, libcurl
+    /// asks to be called for a timeout, wakeup() is called or
+    /// @timeout_ms elapses, whichever comes first.  Returns at
+    /// once if libcurl already wants attention.
+    ///
+    /// Threading:  called by worker thread.
+    void waitForActivity(int timeout_ms);
+
+    /// End a waitForActivity() call in progress or, if there is
+    /// none, make the next one return immediately.  Only effective
+    /// with libcurl 7.68 or later, older versions wait out a short
+    /// timeout instead.
+    ///
+    /// Threading:  callable by any thread.
+    void wakeup();
+
     /// Add request to the active list.  Caller is expected to have
     /// provided us with a reference count on the op to hold the
     /// request.  (No additional references will be added.)
@@ -148,6 +164,11 @@ protected:
     /// to completion and we need to move the request to a new state.
     bool completeRequest(CURLM * multi_handle, CURL * handle, CURLcode status);
 
+    /// Run I/O on one multi handle and complete any finished requests.
+    ///
+    /// @return         True if at least one request completed.
+    bool processMulti(CURLM * multi_handle);
+
     /// Invoked to cancel an active request, mainly during shutdown
     /// and destroy.
     void cancelRequest(const opReqPtr_t &op);
@@ -212,9 +233,12 @@ protected:
     HandleCache         mHandleCache;       // Handle allocator, owner
     active_set_t        mActiveOps;
     unsigned int        mPolicyCount;
-    CURLM **            mMultiHandles;      // One handle per policy class
+    CURLM **            mMultiHandles;      // One handle per policy class, or all mSharedHandle
+    CURLM *             mSharedHandle;      // HTTP/2 multiplexing handle used by every class, if enabled
     int *               mActiveHandles;     // Active count per policy class
     bool *              mDirtyPolicy;       // Dirty policy update waiting for stall (per pc)
+    CURLM *             mWaitHandle;        // Request-free multi handle for waits and wakeups
+    std::vector<curl_waitfd> mWaitFds;      // Sockets of all policy classes for waitForActivity()
 
 }; // end class HttpLibcurl
 
@@ -764,6 +764,15 @@ HttpStatus HttpOpRequest::prepareRequest(HttpService * service)
 /******************************/
         check_curl_easy_setopt(mCurlHandle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_0);
     }
+    if (gpolicy.mHttp2Multiplex)
+    {
+        // Shared multiplexing multi handle.  Negotiate HTTP/2 on TLS
+        // connections and have the request wait for a connection that
+        // is still being set up to its host rather than opening one of
+        // its own, so streams to a CDN end up on a single connection.
+        check_curl_easy_setopt(mCurlHandle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        check_curl_easy_setopt(mCurlHandle, CURLOPT_PIPEWAIT, 1L);
+    }
     // *DEBUG:  Enable following override for timeout handling and "[curl:bugs] #1420" tests
     //if (cpolicy.mPipelining)
     //{
@@ -249,7 +249,10 @@ HttpService::ELoopSpeed HttpPolicy::processReadyQueue()
         }
 
         int active(transport.getActiveCountInClass(policy_class));
-        int active_limit(state.mOptions.mPipelining > 1L
+        // When classes share a multiplexing handle, the class connection
+        // limit counts concurrent streams and the transport decides how
+        // few connections carry them.
+        int active_limit((state.mOptions.mPipelining > 1L && ! mGlobalOptions.mHttp2Multiplex)
                          ? (state.mOptions.mPerHostConnectionLimit
                             * state.mOptions.mPipelining)
                          : state.mOptions.mConnectionLimit);
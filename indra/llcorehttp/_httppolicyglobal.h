@@ -72,6 +72,7 @@ public:
     std::string         mHttpProxy;
     long                mTrace;
     long                mUseLLProxy;
+    long                mHttp2Multiplex;
     HttpRequest::policyCallback_t   mSslCtxCallback;
 };  // end class HttpPolicyGlobal
 
@@ -81,6 +81,10 @@ HttpStatus HttpRequestQueue::addOp(const HttpRequestQueue::opPtr_t &op)
         }
         wake = mQueue.empty();
         mQueue.push_back(op);
+        if (wake && mWakeupHook)
+        {
+            mWakeupHook();
+        }
     }
     if (wake)
     {
@@ -142,11 +146,24 @@ void HttpRequestQueue::wakeAll()
 }
 
 
+void HttpRequestQueue::setWakeupHook(const wakeup_hook_t & hook)
+{
+    HttpScopedLock lock(mQueueMutex);
+
+    mWakeupHook = hook;
+}
+
+
 bool HttpRequestQueue::stopQueue()
 {
     {
         HttpScopedLock lock(mQueueMutex);
 
+        if (mWakeupHook)
+        {
+            mWakeupHook();
+        }
+
         if (!mQueueStopped)
         {
             mQueueStopped = true;
@@ -30,6 +30,8 @@
 
 #include <vector>
 
+#include <boost/function.hpp>
+
 #include "httpcommon.h"
 #include "_refcounted.h"
 #include "_mutex.h"
@@ -116,6 +118,17 @@ public:
     /// Threading:  callable by any thread.
     void wakeAll();
 
+    /// Install a function to be called whenever a request lands
+    /// on an empty queue or the queue is stopped.  The service
+    /// thread uses this to interrupt waits in the transport,
+    /// which the queue's condition variable can't reach.  The
+    /// hook runs with the queue locked and must not call back
+    /// into the queue.  Pass an empty function to remove it.
+    ///
+    /// Threading:  callable by any thread.
+    typedef boost::function<void ()> wakeup_hook_t;
+    void setWakeupHook(const wakeup_hook_t & hook);
+
     /// Disallow further request queuing.  Callers to @addOp will
     /// get a failure status (LLCORE, HE_SHUTTING_DOWN).  Callers
     /// to @fetchAll or @fetchOp will get requests that are on the
@@ -134,6 +147,7 @@ protected:
     LLCoreInt::HttpMutex                mQueueMutex;
     LLCoreInt::HttpConditionVariable    mQueueCV;
     bool                                mQueueStopped;
+    wakeup_hook_t                       mWakeupHook;
 
 }; // end class HttpRequestQueue
 
@@ -63,7 +63,8 @@ const HttpService::OptionDescriptor HttpService::sOptionDesc[] =
     {   true,       true,       true,       false,      false   },      // PO_TRACE
     {   true,       true,       false,      true,       false   },      // PO_ENABLE_PIPELINING
     {   true,       true,       false,      true,       false   },      // PO_THROTTLE_RATE
-    {   false,      false,      true,       false,      true    }       // PO_SSL_VERIFY_CALLBACK
+    {   false,      false,      true,       false,      true    },      // PO_SSL_VERIFY_CALLBACK
+    {   true,       false,      true,       false,      false   }       // PO_HTTP2_MULTIPLEX
 };
 HttpService * HttpService::sInstance(NULL);
 volatile HttpService::EState HttpService::sState(NOT_INITIALIZED);
@@ -112,6 +113,8 @@ HttpService::~HttpService()
 
     if (mRequestQueue)
     {
+        // Queue may outlive us, stop it calling into the transport
+        mRequestQueue->setWakeupHook(HttpRequestQueue::wakeup_hook_t());
         mRequestQueue->release();
         mRequestQueue = NULL;
     }
@@ -141,6 +144,7 @@ void HttpService::init(HttpRequestQueue * queue)
     sInstance->mRequestQueue = queue;
     sInstance->mPolicy = new HttpPolicy(sInstance);
     sInstance->mTransport = new HttpLibcurl(sInstance);
+    queue->setWakeupHook(boost::bind(&HttpLibcurl::wakeup, sInstance->mTransport));
     sState = INITIALIZED;
 }
 
@@ -278,9 +282,9 @@ void HttpService::shutdown()
 
 // Working thread loop-forever method.  Gives time to
 // each of the request queue, policy layer and transport
-// layer pieces and then either sleeps for a small time
-// or waits for a request to come in.  Repeats until
-// requested to stop.
+// layer pieces and then either waits for activity on the
+// transport's sockets or waits for a request to come in.
+// Repeats until requested to stop.
 void HttpService::threadRun(LLCoreInt::HttpThread * thread)
 {
     LL_PROFILER_SET_THREAD_NAME("HttpService");
@@ -305,10 +309,11 @@ void HttpService::threadRun(LLCoreInt::HttpThread * thread)
             new_loop = mTransport->processTransport();
             loop = (std::min)(loop, new_loop);
 
-            // Determine whether to spin, sleep briefly or sleep for next request
-            if (REQUEST_SLEEP != loop)
+            // Determine whether to spin, wait on the transport or sleep for next request.
+            // A request queued during the wait wakes the transport, see HttpRequestQueue::setWakeupHook().
+            if (NORMAL == loop)
             {
-                ms_sleep(HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS);
+                mTransport->waitForActivity(HTTP_SERVICE_LOOP_WAIT_MAX_MS);
             }
         }
         catch (const LLContinueError&)
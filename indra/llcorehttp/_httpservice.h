@@ -104,7 +104,8 @@ public:
     // requests.
     enum ELoopSpeed
     {
-        NORMAL,                 ///< continuous polling of request, ready, active queues
+        IMMEDIATE,              ///< run the next pass at once, e.g. a completion freed a slot
+        NORMAL,                 ///< wait for transport activity or a new request, then poll queues
         REQUEST_SLEEP           ///< can sleep indefinitely waiting for request queue write
     };
 
@@ -232,6 +232,17 @@ public:
         /// Global only
         PO_SSL_VERIFY_CALLBACK,
 
+        /// Long value that if non-zero has all policy classes share a
+        /// single multi handle that negotiates HTTP/2 and multiplexes
+        /// requests to the same host over one connection.  Class
+        /// connection limits then cap concurrent streams rather than
+        /// TCP/TLS connections, and the global connection limit caps
+        /// the connections of the shared handle.  Zero, the default,
+        /// keeps one HTTP/1.1 multi handle per class.
+        ///
+        /// Global only, must be set before the worker thread starts
+        PO_HTTP2_MULTIPLEX,
+
         PO_LAST  // Always at end
     };
 
@@ -45,6 +45,11 @@ void HTTPStats::resetStats()
     mDataDown.reset();
     mDataUp.reset();
     mRequests = 0;
+    mTransfers = 0;
+    mConnections = 0;
+    mMultiplexedTransfers = 0;
+    mHandshakeTime.reset();
+    mThroughput.reset();
 }
 
 
@@ -61,6 +66,25 @@ void HTTPStats::recordResultCode(S32 code)
 
 }
 
+void HTTPStats::recordTransfer(S32 new_connections, F64 handshake_secs, bool multiplexed,
+                               F64 bytes, F64 transfer_secs)
+{
+    ++mTransfers;
+    if (new_connections > 0)
+    {
+        mConnections += new_connections;
+        mHandshakeTime.push((F32)(handshake_secs * 1000.0));
+    }
+    if (multiplexed)
+    {
+        ++mMultiplexedTransfers;
+    }
+    if (bytes > 0.0 && transfer_secs > 0.0)
+    {
+        mThroughput.push((F32)(bytes / 1024.0 / transfer_secs));
+    }
+}
+
 namespace
 {
     std::string byte_count_converter(F32 bytes)
@@ -94,6 +118,24 @@ void HTTPStats::dumpStats()
     out << "Data Recv: " << byte_count_converter(mDataDown.getSum()) << "   (" << mDataDown.getSum() << ")" << std::endl;
     out << "Total requests: " << mRequests << "(request objects created)" << std::endl;
     out << std::endl;
+    out << "Connections:" << std::endl;
+    out << "Transfers: " << mTransfers << "   multiplexed: " << mMultiplexedTransfers << std::endl;
+    out << "Connections opened: " << mConnections;
+    if (mTransfers > 0)
+    {
+        out << "   (" << std::setprecision(3) << (F32)mConnections / (F32)mTransfers << " per transfer)";
+    }
+    out << std::endl;
+    if (mHandshakeTime.getCount() > 0)
+    {
+        out << "Handshake ms: mean " << mHandshakeTime.getMean() << "   max " << mHandshakeTime.getMaxValue() << std::endl;
+    }
+    if (mThroughput.getCount() > 0)
+    {
+        out << "Throughput KB/s per transfer: mean " << mThroughput.getMean()
+            << "   max " << mThroughput.getMaxValue() << std::endl;
+    }
+    out << std::endl;
     out << "Result Codes:" << std::endl << "--- -----" << std::endl;
 
     for (std::map<S32, S32>::iterator it = mResutCodes.begin(); it != mResutCodes.end(); ++it)
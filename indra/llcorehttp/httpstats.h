@@ -59,6 +59,12 @@ namespace LLCore
 
         void    recordResultCode(S32 code);
 
+        /// Record a finished transfer.  @new_connections is the number
+        /// of connections opened for it (zero when one was reused), and
+        /// @handshake_secs the time to a usable connection when one was.
+        void    recordTransfer(S32 new_connections, F64 handshake_secs, bool multiplexed,
+                               F64 bytes, F64 transfer_secs);
+
         void    dumpStats();
     private:
         StatsAccumulator mDataDown;
@@ -66,6 +72,12 @@ namespace LLCore
 
         S32              mRequests;
 
+        S32              mTransfers;
+        S32              mConnections;
+        S32              mMultiplexedTransfers;
+        StatsAccumulator mHandshakeTime;    // Milliseconds, new connections only
+        StatsAccumulator mThroughput;       // KB/s per transfer
+
         std::map<S32, S32> mResutCodes;
     };
 
@@ -32,13 +32,17 @@
 #include "httpheaders.h"
 #include "httpresponse.h"
 #include "httpoptions.h"
+#include "httpstats.h"
 #include "_httpservice.h"
 #include "_httprequestqueue.h"
 
 #include <curl/curl.h>
 #include <boost/regex.hpp>
+#include <iostream>
 #include <sstream>
 
+#include "lltimer.h"
+
 #include "llcorehttp_test.h"
 
 
@@ -3036,6 +3040,247 @@ void HttpRequestTestObjectType::test<23>()
 }
 
 
+template <> template <>
+void HttpRequestTestObjectType::test<24>()
+{
+    ScopedCurlInit ready;
+
+    set_test_name("HttpRequest GET latency with a transfer in progress");
+
+    // Measures request-to-completion time of small GETs while a
+    // slow request keeps the service loop out of its idle sleep.
+    // That is where the worker thread used to poll with a fixed
+    // sleep; with the event-driven loop a new request starts as
+    // soon as it is queued.  Timings are reported, not enforced.
+
+    // Handler can be stack-allocated *if* there are no dangling
+    // references to it after completion of this method.
+    TestHandler2 handler(this, "handler");
+    LLCore::HttpHandler::ptr_t handlerp(&handler, NoOpDeletor);
+    // Background request isn't counted or status-checked
+    TestHandler2 background_handler(NULL, "background_handler");
+    LLCore::HttpHandler::ptr_t background_handlerp(&background_handler, NoOpDeletor);
+    std::string url_base(get_base_url());
+    mHandlerCalls = 0;
+
+    HttpRequest * req = NULL;
+    HttpOptions::ptr_t opts;
+
+    try
+    {
+        // Get singletons created
+        HttpRequest::createService();
+
+        // Start threading early so that thread memory is invariant
+        // over the test.
+        HttpRequest::startThread();
+
+        // create a new ref counted object with an implicit reference
+        req = new HttpRequest();
+
+        // Keep one transfer active for the whole measurement
+        opts = HttpOptions::ptr_t(new HttpOptions());
+        opts->setTimeout(20);
+        opts->setRetries(0);
+        HttpHandle handle = req->requestGet(HttpRequest::DEFAULT_POLICY_ID,
+                                            url_base + "/sleep/",
+                                            opts,
+                                            HttpHeaders::ptr_t(),
+                                            background_handlerp);
+        ensure("Valid handle returned for background request", handle != LLCORE_HTTP_HANDLE_INVALID);
+        usleep(100000);
+
+        mStatus = HttpStatus(200);
+        const int request_count(20);
+        U64 total_usec(0);
+        U64 max_usec(0);
+        for (int i(0); i < request_count; ++i)
+        {
+            const U64 start(totalTime());
+            handle = req->requestGet(HttpRequest::DEFAULT_POLICY_ID,
+                                     url_base,
+                                     HttpOptions::ptr_t(),
+                                     HttpHeaders::ptr_t(),
+                                     handlerp);
+            ensure("Valid handle returned for request", handle != LLCORE_HTTP_HANDLE_INVALID);
+
+            // Pump tightly so the measurement isn't dominated by our own sleep
+            int count(0);
+            int limit(LOOP_COUNT_LONG * 100);
+            while (count++ < limit && mHandlerCalls < i + 1)
+            {
+                req->update(0);
+                usleep(LOOP_SLEEP_INTERVAL / 100);
+            }
+            ensure("Request executed in reasonable time", count < limit);
+
+            const U64 elapsed(totalTime() - start);
+            total_usec += elapsed;
+            max_usec = (std::max)(max_usec, elapsed);
+        }
+        ensure("One handler invocation per request", mHandlerCalls == request_count);
+
+        std::cout << "GET latency with active transfer over " << request_count << " requests:  mean "
+                  << (total_usec / request_count) << " usec, max " << max_usec << " usec" << std::endl;
+
+        // Okay, request a shutdown of the servicing thread
+        mStatus = HttpStatus();
+        handle = req->requestStopThread(handlerp);
+        ensure("Valid handle returned for stop request", handle != LLCORE_HTTP_HANDLE_INVALID);
+
+        // Run the notification pump again
+        int count(0);
+        int limit(LOOP_COUNT_LONG);
+        while (count++ < limit && mHandlerCalls < request_count + 1)
+        {
+            req->update(1000000);
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Stop request executed in reasonable time", count < limit);
+
+        // See that we actually shutdown the thread
+        count = 0;
+        limit = LOOP_COUNT_SHORT;
+        while (count++ < limit && ! HttpService::isStopped())
+        {
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Thread actually stopped running", HttpService::isStopped());
+
+        // release options
+        opts.reset();
+
+        // release the request object
+        delete req;
+        req = NULL;
+
+        // Shut down service
+        HttpRequest::destroyService();
+    }
+    catch (...)
+    {
+        stop_thread(req);
+        opts.reset();
+        delete req;
+        HttpRequest::destroyService();
+        throw;
+    }
+}
+
+
+template <> template <>
+void HttpRequestTestObjectType::test<25>()
+{
+    ScopedCurlInit ready;
+
+    set_test_name("HttpRequest GETs from two classes on a shared multiplexing handle");
+
+    // The local test server only speaks HTTP/1.1 so this checks that
+    // requests of several classes complete correctly on the shared
+    // handle.  Connection counts, handshake times and whether streams
+    // were multiplexed are written out by HTTPStats::dumpStats().
+
+    // Handler can be stack-allocated *if* there are no dangling
+    // references to it after completion of this method.
+    TestHandler2 handler(this, "handler");
+    LLCore::HttpHandler::ptr_t handlerp(&handler, NoOpDeletor);
+    std::string url_base(get_base_url());
+    mHandlerCalls = 0;
+
+    HttpRequest * req = NULL;
+
+    try
+    {
+        // Get singletons created
+        HttpRequest::createService();
+
+        HttpStatus status = HttpRequest::setStaticPolicyOption(HttpRequest::PO_HTTP2_MULTIPLEX,
+                                                               HttpRequest::GLOBAL_POLICY_ID,
+                                                               1L, NULL);
+        ensure("Multiplexing option accepted", bool(status));
+
+        // Only a global option
+        status = HttpRequest::setStaticPolicyOption(HttpRequest::PO_HTTP2_MULTIPLEX,
+                                                    HttpRequest::DEFAULT_POLICY_ID,
+                                                    1L, NULL);
+        ensure("Multiplexing option rejected for a class", ! status);
+
+        HttpRequest::policy_t other_class(HttpRequest::createPolicyClass());
+        HttpRequest::setStaticPolicyOption(HttpRequest::PO_CONNECTION_LIMIT, other_class, 2L, NULL);
+
+        // Start threading early so that thread memory is invariant
+        // over the test.
+        HttpRequest::startThread();
+
+        // create a new ref counted object with an implicit reference
+        req = new HttpRequest();
+
+        mStatus = HttpStatus(200);
+        const int request_count(12);
+        for (int i(0); i < request_count; ++i)
+        {
+            HttpHandle handle = req->requestGet((i & 1) ? other_class : HttpRequest::DEFAULT_POLICY_ID,
+                                                url_base,
+                                                HttpOptions::ptr_t(),
+                                                HttpHeaders::ptr_t(),
+                                                handlerp);
+            ensure("Valid handle returned for request", handle != LLCORE_HTTP_HANDLE_INVALID);
+        }
+
+        // Run the notification pump.
+        int count(0);
+        int limit(LOOP_COUNT_LONG);
+        while (count++ < limit && mHandlerCalls < request_count)
+        {
+            req->update(1000000);
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Requests executed in reasonable time", count < limit);
+        ensure("One handler invocation per request", mHandlerCalls == request_count);
+
+        HTTPStats::instance().dumpStats();
+
+        // Okay, request a shutdown of the servicing thread
+        mStatus = HttpStatus();
+        HttpHandle handle = req->requestStopThread(handlerp);
+        ensure("Valid handle returned for stop request", handle != LLCORE_HTTP_HANDLE_INVALID);
+
+        // Run the notification pump again
+        count = 0;
+        limit = LOOP_COUNT_LONG;
+        while (count++ < limit && mHandlerCalls < request_count + 1)
+        {
+            req->update(1000000);
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Stop request executed in reasonable time", count < limit);
+
+        // See that we actually shutdown the thread
+        count = 0;
+        limit = LOOP_COUNT_SHORT;
+        while (count++ < limit && ! HttpService::isStopped())
+        {
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Thread actually stopped running", HttpService::isStopped());
+
+        // release the request object
+        delete req;
+        req = NULL;
+
+        // Shut down service
+        HttpRequest::destroyService();
+    }
+    catch (...)
+    {
+        stop_thread(req);
+        delete req;
+        HttpRequest::destroyService();
+        throw;
+    }
+}
+
+
 }  // end namespace tut
 
 namespace
@@ -39,6 +39,7 @@
 #include "llimagejpeg.h"
 #include "llimagepng.h"
 #include "llimagedxt.h"
+#include "llimagealpha.h"
 #include "llmemory.h"
 
 #include <boost/preprocessor.hpp>
@@ -870,6 +871,7 @@ LLImageRaw::~LLImageRaw()
 U8* LLImageRaw::allocateData(S32 size)
 {
     LLImageDataLock lock(this);
+    mAlphaInfo.reset();
 
     U8* res = LLImageBase::allocateData(size);
     return res;
@@ -879,6 +881,7 @@ U8* LLImageRaw::allocateData(S32 size)
 U8* LLImageRaw::reallocateData(S32 size)
 {
     LLImageDataLock lock(this);
+    mAlphaInfo.reset();
 
     U8* res = LLImageBase::reallocateData(size);
     return res;
@@ -887,6 +890,7 @@ U8* LLImageRaw::reallocateData(S32 size)
 void LLImageRaw::releaseData()
 {
     LLImageDataLock lock(this);
+    mAlphaInfo.reset();
 
     LLImageBase::setSize(0, 0, 0);
     LLImageBase::setDataAndSize(nullptr, 0);
@@ -896,6 +900,7 @@ void LLImageRaw::releaseData()
 void LLImageRaw::deleteData()
 {
     LLImageDataLock lock(this);
+    mAlphaInfo.reset();
 
     LLImageBase::deleteData();
 }
@@ -903,6 +908,7 @@ void LLImageRaw::deleteData()
 void LLImageRaw::setDataAndSize(U8 *data, S32 width, S32 height, S8 components)
 {
     LLImageDataLock lock(this);
+    mAlphaInfo.reset();
 
     if(data == getData())
     {
@@ -935,6 +941,7 @@ bool LLImageRaw::setSubImage(U32 x_pos, U32 y_pos, U32 width, U32 height,
                              const U8 *data, U32 stride, bool reverse_y)
 {
     LLImageDataLock lock(this);
+    mAlphaInfo.reset();
 
     if (!getData())
     {
@@ -965,6 +972,7 @@ void LLImageRaw::clear(U8 r, U8 g, U8 b, U8 a)
     llassert( getComponents() <= 4 );
 
     LLImageDataLock lock(this);
+    mAlphaInfo.reset();
 
     // This is fairly bogus, but it'll do for now.
     if (isBufferInvalid())
@@ -1007,6 +1015,7 @@ void LLImageRaw::clear(U8 r, U8 g, U8 b, U8 a)
 void LLImageRaw::verticalFlip()
 {
     LLImageDataLock lock(this);
+    mAlphaInfo.reset();
 
     S32 row_bytes = getWidth() * getComponents();
     llassert(row_bytes > 0);
@@ -1048,6 +1057,7 @@ bool LLImageRaw::checkHasTransparentPixels()
 bool LLImageRaw::optimizeAwayAlpha()
 {
     LLImageDataLock lock(this);
+    mAlphaInfo.reset();
 
     if (getComponents() == 4)
     {
@@ -1086,6 +1096,9 @@ bool LLImageRaw::optimizeAwayAlpha()
 
 bool LLImageRaw::makeAlpha()
 {
+    LLImageDataLock lock(this);
+    mAlphaInfo.reset();
+
     if (getComponents() == 3)
     {
         U8* data = getData();
@@ -1112,6 +1125,46 @@ bool LLImageRaw::makeAlpha()
     return false;
 }
 
+void LLImageRaw::analyzeAlpha()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    LLImageDataLock lock(this);
+
+    mAlphaInfo.reset();
+
+    const S8 components = getComponents();
+    if (isBufferInvalid() || (components != 1 && components != 2 && components != 4))
+    {
+        return; // no alpha channel, or not one LLImageGL looks at
+    }
+
+    auto info = std::make_unique<LLImageAlphaInfo>();
+    info->mData = getData();
+    info->mWidth = getWidth();
+    info->mHeight = getHeight();
+    info->mComponents = components;
+    // alpha is the last byte of each texel, LLImageGL analyzes luminance in
+    // its place for single channel images
+    info->mIsMask = LLImageAlpha::isMask(info->mData, info->mWidth, info->mHeight, components, components - 1);
+    if (components == 4)
+    {
+        info->mPickMask.resize(LLImageAlpha::getPickMaskSize(info->mWidth, info->mHeight), 0);
+        LLImageAlpha::createPickMask(info->mData, info->mWidth, info->mHeight, info->mPickMask.data());
+    }
+    mAlphaInfo = std::move(info);
+}
+
+const LLImageAlphaInfo* LLImageRaw::getAlphaInfo() const
+{
+    const LLImageAlphaInfo* info = mAlphaInfo.get();
+    if (info && (info->mData != getData() || info->mWidth != getWidth() || info->mHeight != getHeight()
+                 || info->mComponents != getComponents()))
+    {
+        return NULL;
+    }
+    return info;
+}
+
 void LLImageRaw::expandToPowerOfTwo(S32 max_dim, bool scale_image)
 {
     LLImageDataLock lock(this);
@@ -1200,6 +1253,7 @@ void LLImageRaw::composite( const LLImageRaw* src )
 
     LLImageDataSharedLock lockIn(src);
     LLImageDataLock lockOut(this);
+    mAlphaInfo.reset();
 
     if (!validateSrcAndDst("LLImageRaw::composite", src, dst))
     {
@@ -1336,6 +1390,7 @@ void LLImageRaw::copyUnscaledAlphaMask( const LLImageRaw* src, const LLColor4U&
 
     LLImageDataSharedLock lockIn(src);
     LLImageDataLock lockOut(this);
+    mAlphaInfo.reset();
 
     if (!validateSrcAndDst("LLImageRaw::copyUnscaledAlphaMask", src, dst))
     {
@@ -1365,6 +1420,7 @@ void LLImageRaw::copyUnscaledAlphaMask( const LLImageRaw* src, const LLColor4U&
 void LLImageRaw::fill( const LLColor4U& color )
 {
     LLImageDataLock lock(this);
+    mAlphaInfo.reset();
 
     if (isBufferInvalid())
     {
@@ -1398,6 +1454,9 @@ void LLImageRaw::fill( const LLColor4U& color )
 
 void LLImageRaw::tint( const LLColor3& color )
 {
+    LLImageDataLock lock(this);
+    mAlphaInfo.reset();
+
     llassert( (3 == getComponents()) || (4 == getComponents()) );
     if (isBufferInvalid())
     {
@@ -1441,6 +1500,7 @@ void LLImageRaw::copy(const LLImageRaw* src)
 
     LLImageDataSharedLock lockIn(src);
     LLImageDataLock lockOut(this);
+    mAlphaInfo.reset();
 
     if (!validateSrcAndDst("LLImageRaw::copy", src, dst))
     {
@@ -1492,6 +1552,7 @@ void LLImageRaw::copyUnscaled(const LLImageRaw* src)
     LLImageRaw* dst = this;  // Just for clarity.
 
     LLImageDataLock lock(this);
+    mAlphaInfo.reset();
 
     llassert( (1 == src->getComponents()) || (3 == src->getComponents()) || (4 == src->getComponents()) );
     llassert( src->getComponents() == dst->getComponents() );
@@ -1531,6 +1592,7 @@ void LLImageRaw::copyUnscaled4onto3( const LLImageRaw* src )
     LLImageRaw* dst = this;  // Just for clarity.
 
     LLImageDataLock lock(this);
+    mAlphaInfo.reset();
 
     llassert( (3 == dst->getComponents()) && (4 == src->getComponents()) );
     llassert( (src->getWidth() == dst->getWidth()) && (src->getHeight() == dst->getHeight()) );
@@ -1555,6 +1617,7 @@ void LLImageRaw::copyUnscaled3onto4( const LLImageRaw* src )
     LLImageRaw* dst = this;  // Just for clarity.
 
     LLImageDataLock lock(this);
+    mAlphaInfo.reset();
 
     llassert( 3 == src->getComponents() );
     llassert( 4 == dst->getComponents() );
@@ -1582,6 +1645,7 @@ void LLImageRaw::copyScaled( const LLImageRaw* src )
 
     LLImageDataSharedLock lockIn(src);
     LLImageDataLock lockOut(this);
+    mAlphaInfo.reset();
 
     if (!validateSrcAndDst("LLImageRaw::copyScaled", src, dst))
     {
@@ -1625,6 +1689,7 @@ void LLImageRaw::copyScaled( const LLImageRaw* src )
 bool LLImageRaw::scale( S32 new_width, S32 new_height, bool scale_image_data )
 {
     LLImageDataLock lock(this);
+    mAlphaInfo.reset();
 
     S32 components = getComponents();
     if (components != 1 && components != 3 && components != 4)
@@ -1974,6 +2039,10 @@ void LLImageRaw::addEmissive(LLImageRaw* src)
 {
     LLImageRaw* dst = this;  // Just for clarity.
 
+    LLImageDataSharedLock lockIn(src);
+    LLImageDataLock lockOut(this);
+    mAlphaInfo.reset();
+
     if (!validateSrcAndDst(__FUNCTION__, src, dst))
     {
         return;
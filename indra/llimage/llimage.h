@@ -71,6 +71,7 @@ constexpr S32 HTTP_PACKET_SIZE = 1496;
 class LLImageFormatted;
 class LLImageRaw;
 class LLColor4U;
+struct LLImageAlphaInfo;
 class LLColor3;
 
 typedef enum e_image_codec
@@ -241,6 +242,14 @@ public:
     // Create an alpha channel if this image doesn't have one
     bool makeAlpha();
 
+    // Work out whether the alpha channel is a 1 bit mask and build the pick
+    // mask, as LLImageGL would when creating a texture from this image. Done
+    // on the decode thread so the texture doesn't have to scan it again.
+    void analyzeAlpha();
+    // Result of analyzeAlpha(), NULL if it wasn't run or the data has been
+    // changed through LLImageRaw since
+    const LLImageAlphaInfo* getAlphaInfo() const;
+
     static S32 biasedDimToPowerOfTwo(S32 curr_dim, S32 max_dim = MAX_IMAGE_SIZE);
     static S32 expandDimToPowerOfTwo(S32 curr_dim, S32 max_dim = MAX_IMAGE_SIZE);
     static S32 contractDimToPowerOfTwo(S32 curr_dim, S32 min_dim = MIN_IMAGE_SIZE);
@@ -324,6 +333,8 @@ public:
 
 private:
     static bool validateSrcAndDst(std::string func, const LLImageRaw* src, const LLImageRaw* dst);
+
+    std::unique_ptr<LLImageAlphaInfo> mAlphaInfo;
 };
 
 // Compressed representation of image.
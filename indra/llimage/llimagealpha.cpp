@@ -0,0 +1,388 @@
+/**
+ * @file llimagealpha.cpp
+ * @brief Alpha mask classification and pick masks for decoded images.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llimagealpha.h"
+
+#include <emmintrin.h>
+
+namespace
+{
+    // samples are counted the way the histogram of the old LLImageGL code
+    // binned them: 16 bins of 16 alpha values, box sums in bins of 64
+    constexpr U32 MIDRANGE_MIN = 2 * 16;        // bins 2 to 12
+    constexpr U32 MIDRANGE_END = 13 * 16;
+    constexpr U32 UPPER_HALF_MIN = 8 * 16;      // bins 8 to 15
+    constexpr U32 PICK_ALPHA_MIN = 32;          // exclusive
+
+    bool is_mask(U32 midrange_total, U32 lower_half_total, U32 upper_half_total, U32 length, U32 alpha_total)
+    {
+        // if more than 1/16th of alpha samples are mid-range, this
+        // shouldn't be treated as a 1-bit mask
+
+        // also, if all of the alpha samples are clumped on one half
+        // of the range (but not at an absolute extreme), then consider
+        // this to be an intentional effect and don't treat as a mask.
+        return !(midrange_total > length / 48 || // lots of midrange, or
+                 (lower_half_total == length && alpha_total != 0) || // all close to transparent but not all totally transparent, or
+                 (upper_half_total == length && alpha_total != 255 * length)); // all close to opaque but not all totally opaque
+    }
+
+    // Running totals for isMask(), for one texel or one 2x2 box at a time
+    struct AlphaCounts
+    {
+        U64 mTotal = 0;
+        U32 mMidrange = 0;
+        U32 mLowerHalf = 0;
+        U32 mBoxMidrange = 0;
+        U32 mBoxLowerHalf = 0;
+        U32 mBoxes = 0;
+
+        void addTexel(U32 s)
+        {
+            mTotal += s;
+            mMidrange += (s >= MIDRANGE_MIN && s < MIDRANGE_END) ? 1 : 0;
+            mLowerHalf += (s < UPPER_HALF_MIN) ? 1 : 0;
+        }
+
+        void addBox(U32 s1, U32 s2, U32 s3, U32 s4)
+        {
+            addTexel(s1);
+            addTexel(s2);
+            addTexel(s3);
+            addTexel(s4);
+            const U32 asum = s1 + s2 + s3 + s4;
+            mBoxMidrange += (asum >= MIDRANGE_MIN * 4 && asum < MIDRANGE_END * 4) ? 1 : 0;
+            mBoxLowerHalf += (asum < UPPER_HALF_MIN * 4) ? 1 : 0;
+            ++mBoxes;
+        }
+    };
+
+    // Alpha bytes of 16 consecutive 4 byte texels, alpha at byte offset
+    // (shift_left is 8 * (3 - offset))
+    inline __m128i load_alpha16(const U8* texels, __m128i shift_left)
+    {
+        const __m128i shift_right = _mm_cvtsi32_si128(24);
+        const __m128i a0 = _mm_srl_epi32(_mm_sll_epi32(_mm_loadu_si128((const __m128i*)texels), shift_left), shift_right);
+        const __m128i a1 = _mm_srl_epi32(_mm_sll_epi32(_mm_loadu_si128((const __m128i*)(texels + 16)), shift_left), shift_right);
+        const __m128i a2 = _mm_srl_epi32(_mm_sll_epi32(_mm_loadu_si128((const __m128i*)(texels + 32)), shift_left), shift_right);
+        const __m128i a3 = _mm_srl_epi32(_mm_sll_epi32(_mm_loadu_si128((const __m128i*)(texels + 48)), shift_left), shift_right);
+        return _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(a2, a3));
+    }
+
+    inline U64 horizontal_sum_epi64(__m128i v)
+    {
+        alignas(16) U64 lanes[2];
+        _mm_store_si128((__m128i*)lanes, v);
+        return lanes[0] + lanes[1];
+    }
+
+    inline U32 horizontal_sum_epu8(__m128i v)
+    {
+        return (U32)horizontal_sum_epi64(_mm_sad_epu8(v, _mm_setzero_si128()));
+    }
+
+    inline U32 horizontal_sum_epu16(__m128i v)
+    {
+        alignas(16) U16 lanes[8];
+        _mm_store_si128((__m128i*)lanes, v);
+        U32 sum = 0;
+        for (U16 lane : lanes)
+        {
+            sum += lane;
+        }
+        return sum;
+    }
+
+    // Every other bit of a 16 bit movemask, packed into 8 bits
+    inline U32 even_bits(U32 mask)
+    {
+        mask &= 0x5555;
+        mask = (mask | (mask >> 1)) & 0x3333;
+        mask = (mask | (mask >> 2)) & 0x0F0F;
+        mask = (mask | (mask >> 4)) & 0x00FF;
+        return mask;
+    }
+
+    inline void set_pick_bits(U8* mask, U32 first_bit, U32 bits)
+    {
+        const U32 shift = first_bit % 8;
+        mask[first_bit / 8] |= (U8)(bits << shift);
+        if (shift)
+        {
+            mask[first_bit / 8 + 1] |= (U8)(bits >> (8 - shift));
+        }
+    }
+} // anonymous namespace
+
+//static
+bool LLImageAlpha::isMaskScalar(const U8* data, U32 w, U32 h, U32 stride, U32 offset)
+{
+    U32 length = w * h;
+    U32 alphatotal = 0;
+
+    U32 sample[16];
+    memset(sample, 0, sizeof(U32)*16);
+
+    // generate histogram of quantized alpha.
+    // also add-in the histogram of a 2x2 box-sampled version.  The idea is
+    // this will mid-skew the data (and thus increase the chances of not
+    // being used as a mask) from high-frequency alpha maps which
+    // suffer the worst from aliasing when used as alpha masks.
+    if (w >= 2 && h >= 2)
+    {
+        llassert(w % 2 == 0);
+        llassert(h % 2 == 0);
+        const U8* rowstart = data + offset;
+        for (U32 y = 0; y < h; y += 2)
+        {
+            const U8* current = rowstart;
+            for (U32 x = 0; x < w; x += 2)
+            {
+                const U32 s1 = current[0];
+                alphatotal += s1;
+                const U32 s2 = current[w * stride];
+                alphatotal += s2;
+                current += stride;
+                const U32 s3 = current[0];
+                alphatotal += s3;
+                const U32 s4 = current[w * stride];
+                alphatotal += s4;
+                current += stride;
+
+                ++sample[s1/16];
+                ++sample[s2/16];
+                ++sample[s3/16];
+                ++sample[s4/16];
+
+                const U32 asum = (s1+s2+s3+s4);
+                alphatotal += asum;
+                sample[asum/(16*4)] += 4;
+            }
+
+            rowstart += 2 * w * stride;
+        }
+        length *= 2; // we sampled everything twice, essentially
+    }
+    else
+    {
+        const U8* current = data + offset;
+        for (U32 i = 0; i < length; i++)
+        {
+            const U32 s1 = *current;
+            alphatotal += s1;
+            ++sample[s1/16];
+            current += stride;
+        }
+    }
+
+    U32 midrangetotal = 0;
+    for (U32 i = 2; i < 13; i++)
+    {
+        midrangetotal += sample[i];
+    }
+    U32 lowerhalftotal = 0;
+    for (U32 i = 0; i < 8; i++)
+    {
+        lowerhalftotal += sample[i];
+    }
+    U32 upperhalftotal = 0;
+    for (U32 i = 8; i < 16; i++)
+    {
+        upperhalftotal += sample[i];
+    }
+
+    return is_mask(midrangetotal, lowerhalftotal, upperhalftotal, length, alphatotal);
+}
+
+//static
+bool LLImageAlpha::isMask(const U8* data, U32 w, U32 h, U32 stride, U32 offset)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+
+    // Only 4 byte texels are worth vectorizing, the 1 and 2 channel formats
+    // are rare and small
+    if (stride != 4 || offset > 3 || w < 2 || h < 2)
+    {
+        return isMaskScalar(data, w, h, stride, offset);
+    }
+    llassert(w % 2 == 0);
+    llassert(h % 2 == 0);
+
+    // The histogram bins that decide the outcome only need a handful of
+    // counts, which are kept in byte (texels) and 16 bit (boxes) lanes and
+    // flushed before they can overflow.
+    const __m128i shift_left = _mm_cvtsi32_si128(8 * (3 - offset));
+    const __m128i midrange_min = _mm_set1_epi8((char)MIDRANGE_MIN);
+    const __m128i midrange_span = _mm_set1_epi8((char)(MIDRANGE_END - MIDRANGE_MIN - 1));
+    const __m128i all_ones = _mm_set1_epi8(-1);
+    const __m128i low_bytes = _mm_set1_epi16(0x00FF);
+    const __m128i box_midrange_min = _mm_set1_epi16(MIDRANGE_MIN * 4 - 1);
+    const __m128i box_midrange_end = _mm_set1_epi16(MIDRANGE_END * 4);
+    const __m128i box_upper_half_min = _mm_set1_epi16(UPPER_HALF_MIN * 4);
+
+    AlphaCounts counts;
+    __m128i total = _mm_setzero_si128();
+    __m128i midrange = _mm_setzero_si128();
+    __m128i lower_half = _mm_setzero_si128();
+    __m128i box_midrange = _mm_setzero_si128();
+    __m128i box_lower_half = _mm_setzero_si128();
+    U32 pending = 0;
+
+    const U32 row_bytes = w * stride;
+    const U32 simd_width = w & ~15u;
+    for (U32 y = 0; y < h; y += 2)
+    {
+        const U8* row0 = data + y * row_bytes;
+        const U8* row1 = row0 + row_bytes;
+        for (U32 x = 0; x < simd_width; x += 16)
+        {
+            const __m128i r0 = load_alpha16(row0 + x * stride, shift_left);
+            const __m128i r1 = load_alpha16(row1 + x * stride, shift_left);
+
+            total = _mm_add_epi64(total, _mm_add_epi64(_mm_sad_epu8(r0, _mm_setzero_si128()), _mm_sad_epu8(r1, _mm_setzero_si128())));
+
+            // a - MIDRANGE_MIN wraps around for small values, so one
+            // unsigned compare checks both ends of the range
+            const __m128i m0 = _mm_sub_epi8(r0, midrange_min);
+            const __m128i m1 = _mm_sub_epi8(r1, midrange_min);
+            midrange = _mm_sub_epi8(midrange, _mm_cmpeq_epi8(_mm_min_epu8(m0, midrange_span), m0));
+            midrange = _mm_sub_epi8(midrange, _mm_cmpeq_epi8(_mm_min_epu8(m1, midrange_span), m1));
+            // below 128 is a non-negative signed byte
+            lower_half = _mm_sub_epi8(lower_half, _mm_cmpgt_epi8(r0, all_ones));
+            lower_half = _mm_sub_epi8(lower_half, _mm_cmpgt_epi8(r1, all_ones));
+
+            // 2x2 box sums, 8 per 16 texels
+            const __m128i asum = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(r0, low_bytes), _mm_srli_epi16(r0, 8)),
+                                               _mm_add_epi16(_mm_and_si128(r1, low_bytes), _mm_srli_epi16(r1, 8)));
+            box_midrange = _mm_sub_epi16(box_midrange, _mm_and_si128(_mm_cmpgt_epi16(asum, box_midrange_min),
+                                                                     _mm_cmplt_epi16(asum, box_midrange_end)));
+            box_lower_half = _mm_sub_epi16(box_lower_half, _mm_cmplt_epi16(asum, box_upper_half_min));
+            counts.mBoxes += 8;
+
+            // byte lanes gain up to 2 per iteration
+            if (++pending == 127)
+            {
+                counts.mMidrange += horizontal_sum_epu8(midrange);
+                counts.mLowerHalf += horizontal_sum_epu8(lower_half);
+                counts.mBoxMidrange += horizontal_sum_epu16(box_midrange);
+                counts.mBoxLowerHalf += horizontal_sum_epu16(box_lower_half);
+                midrange = lower_half = box_midrange = box_lower_half = _mm_setzero_si128();
+                pending = 0;
+            }
+        }
+
+        for (U32 x = simd_width; x < w; x += 2)
+        {
+            const U8* current = row0 + x * stride + offset;
+            counts.addBox(current[0], current[row_bytes], current[stride], current[row_bytes + stride]);
+        }
+    }
+    counts.mMidrange += horizontal_sum_epu8(midrange);
+    counts.mLowerHalf += horizontal_sum_epu8(lower_half);
+    counts.mBoxMidrange += horizontal_sum_epu16(box_midrange);
+    counts.mBoxLowerHalf += horizontal_sum_epu16(box_lower_half);
+    counts.mTotal += horizontal_sum_epi64(total);
+
+    // every texel is sampled once and every box counts as four samples,
+    // the box sums are added to the total too, hence all the doubling
+    const U32 lower_half_total = counts.mLowerHalf + 4 * counts.mBoxLowerHalf;
+    return is_mask(counts.mMidrange + 4 * counts.mBoxMidrange,
+                   lower_half_total,
+                   8 * counts.mBoxes - lower_half_total,
+                   2 * w * h,
+                   (U32)(2 * counts.mTotal));
+}
+
+//static
+U32 LLImageAlpha::getPickMaskSize(S32 width, S32 height)
+{
+    U32 pick_width = width/2 + 1;
+    U32 pick_height = height/2 + 1;
+    return (pick_width * pick_height + 7) / 8; // pixelcount-to-bits
+}
+
+//static
+void LLImageAlpha::createPickMaskScalar(const U8* data_in, S32 width, S32 height, U8* mask)
+{
+    U32 pick_bit = 0;
+
+    for (S32 y = 0; y < height; y += 2)
+    {
+        for (S32 x = 0; x < width; x += 2)
+        {
+            U8 alpha = data_in[(y*width+x)*4+3];
+
+            if (alpha > PICK_ALPHA_MIN)
+            {
+                U32 pick_idx = pick_bit/8;
+                U32 pick_offset = pick_bit%8;
+
+                mask[pick_idx] |= 1 << pick_offset;
+            }
+
+            ++pick_bit;
+        }
+    }
+}
+
+//static
+void LLImageAlpha::createPickMask(const U8* data_in, S32 width, S32 height, U8* mask)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+
+    // unsigned alpha > 32 as a signed compare of the biased values
+    const __m128i shift_left = _mm_cvtsi32_si128(0);
+    const __m128i bias = _mm_set1_epi8((char)0x80);
+    const __m128i threshold = _mm_set1_epi8((char)(PICK_ALPHA_MIN ^ 0x80));
+
+    const S32 simd_width = width & ~15;
+    U32 pick_bit = 0;
+    for (S32 y = 0; y < height; y += 2)
+    {
+        const U8* row = data_in + (size_t)y * width * 4;
+        S32 x = 0;
+        for (; x < simd_width; x += 16)
+        {
+            const __m128i alpha = _mm_xor_si128(load_alpha16(row + x * 4, shift_left), bias);
+            const U32 bits = even_bits(_mm_movemask_epi8(_mm_cmpgt_epi8(alpha, threshold)));
+            if (bits)
+            {
+                set_pick_bits(mask, pick_bit, bits);
+            }
+            pick_bit += 8;
+        }
+        for (; x < width; x += 2)
+        {
+            if (row[x * 4 + 3] > PICK_ALPHA_MIN)
+            {
+                mask[pick_bit / 8] |= 1 << (pick_bit % 8);
+            }
+            ++pick_bit;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * @file llimagealpha.h
+ * @brief Alpha mask classification and pick masks for decoded images.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLIMAGEALPHA_H
+#define LL_LLIMAGEALPHA_H
+
+#include <vector>
+
+// What LLImageRaw::analyzeAlpha() found, along with the image it looked at
+// so that a stale result can be told apart.
+struct LLImageAlphaInfo
+{
+    const U8*       mData = NULL;
+    S32             mWidth = 0;
+    S32             mHeight = 0;
+    S8              mComponents = 0;
+
+    bool            mIsMask = false;
+    std::vector<U8> mPickMask;      // empty unless the image has 4 components
+};
+
+// The per texel passes LLImageGL runs over new textures. The SSE2 versions
+// are used by default, the scalar ones are the reference they must match.
+class LLImageAlpha
+{
+public:
+    // True if the alpha values at data + offset, every stride bytes, look
+    // like a 1 bit mask: few mid-range values and not clumped near one end.
+    static bool isMask(const U8* data, U32 width, U32 height, U32 stride, U32 offset);
+    static bool isMaskScalar(const U8* data, U32 width, U32 height, U32 stride, U32 offset);
+
+    // Size in bytes of the pick mask of a width x height image
+    static U32 getPickMaskSize(S32 width, S32 height);
+
+    // One bit per 2x2 block of an RGBA image, set where the alpha of the
+    // block's first texel is above 32. mask must hold getPickMaskSize()
+    // bytes and be zeroed.
+    static void createPickMask(const U8* rgba, S32 width, S32 height, U8* mask);
+    static void createPickMaskScalar(const U8* rgba, S32 width, S32 height, U8* mask);
+};
+
+#endif // LL_LLIMAGEALPHA_H
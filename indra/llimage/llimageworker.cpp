@@ -205,6 +205,12 @@ bool ImageRequest::processRequest()
 
         // some decoders are removing data when task is complete and there were errors
         mDecodedRaw = done && mDecodedImageRaw->getData();
+        if (mDecodedRaw)
+        {
+            // while the texels are still in cache, and off the thread that
+            // creates the GL texture
+            mDecodedImageRaw->analyzeAlpha();
+        }
 
         // Pick up errors from decoding
         mErrorString = LLImage::getLastThreadError();
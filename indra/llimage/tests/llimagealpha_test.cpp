@@ -0,0 +1,123 @@
+/**
+ * @file llimagealpha_test.cpp
+ * @brief LLImageAlpha test cases.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llimagealpha.h"
+
+#include "llrand.h"
+#include "stringize.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+    struct llimagealpha_data
+    {
+        // width x height texels of stride bytes, the alpha byte of each
+        // texel at offset drawn from one of several distributions
+        std::vector<U8> makeImage(U32 width, U32 height, U32 stride, U32 offset, U32 kind)
+        {
+            std::vector<U8> data(width * height * stride);
+            for (U8& byte : data)
+            {
+                byte = (U8)ll_rand(256);
+            }
+            for (U32 i = 0; i < width * height; ++i)
+            {
+                U8 alpha = 0;
+                const U32 r = (U32)ll_rand();
+                switch (kind % 8)
+                {
+                case 0: alpha = 0; break;                                       // fully transparent
+                case 1: alpha = 255; break;                                     // fully opaque
+                case 2: alpha = (r % 2) ? 255 : 0; break;                       // hard mask
+                case 3: alpha = (U8)r; break;                                   // noise
+                case 4: alpha = (U8)(200 + r % 56); break;                      // nearly opaque
+                case 5: alpha = (U8)(r % 20); break;                            // nearly transparent
+                case 6: alpha = (r % 64 == 0) ? (U8)(30 + r % 180) : ((r & 256) ? 255 : 0); break; // mask with a little midrange
+                default: alpha = (U8)((i % width) * 255 / width); break;        // gradient
+                }
+                data[i * stride + offset] = alpha;
+            }
+            return data;
+        }
+    };
+    typedef test_group<llimagealpha_data> llimagealpha_test;
+    typedef llimagealpha_test::object llimagealpha_object;
+    tut::llimagealpha_test tllimagealpha("LLImageAlpha");
+
+    template<> template<>
+    void llimagealpha_object::test<1>()
+    {
+        set_test_name("isMask matches the scalar version");
+
+        const U32 sizes[][2] = { { 1, 1 }, { 1, 64 }, { 64, 1 }, { 2, 2 }, { 4, 4 }, { 8, 2 }, { 16, 16 }, { 18, 6 },
+                                 { 34, 34 }, { 48, 8 }, { 64, 64 }, { 130, 2 }, { 256, 128 }, { 512, 512 } };
+        const U32 layouts[][2] = { { 4, 3 }, { 4, 0 }, { 4, 1 }, { 2, 1 }, { 1, 0 } };
+        U32 masks = 0, checked = 0;
+        for (const auto& size : sizes)
+        {
+            for (const auto& layout : layouts)
+            {
+                for (U32 kind = 0; kind < 16; ++kind)
+                {
+                    const std::vector<U8> data = makeImage(size[0], size[1], layout[0], layout[1], kind);
+                    const bool expected = LLImageAlpha::isMaskScalar(data.data(), size[0], size[1], layout[0], layout[1]);
+                    ensure_equals(STRINGIZE(size[0] << "x" << size[1] << " stride " << layout[0] << " offset "
+                                            << layout[1] << " kind " << kind),
+                                  LLImageAlpha::isMask(data.data(), size[0], size[1], layout[0], layout[1]), expected);
+                    masks += expected ? 1 : 0;
+                    ++checked;
+                }
+            }
+        }
+        // both outcomes must have come up for the comparison to mean anything
+        ensure("some masks", masks > 0);
+        ensure("some not masks", masks < checked);
+    }
+
+    template<> template<>
+    void llimagealpha_object::test<2>()
+    {
+        set_test_name("createPickMask matches the scalar version");
+
+        const U32 sizes[][2] = { { 1, 1 }, { 2, 2 }, { 3, 5 }, { 16, 2 }, { 18, 18 }, { 30, 4 }, { 32, 32 },
+                                 { 34, 2 }, { 50, 10 }, { 256, 256 }, { 1024, 16 } };
+        for (const auto& size : sizes)
+        {
+            for (U32 kind = 0; kind < 8; ++kind)
+            {
+                const std::vector<U8> data = makeImage(size[0], size[1], 4, 3, kind);
+                const U32 mask_size = LLImageAlpha::getPickMaskSize(size[0], size[1]);
+                std::vector<U8> expected(mask_size, 0), mask(mask_size, 0);
+                LLImageAlpha::createPickMaskScalar(data.data(), size[0], size[1], expected.data());
+                LLImageAlpha::createPickMask(data.data(), size[0], size[1], mask.data());
+                ensure(STRINGIZE(size[0] << "x" << size[1] << " kind " << kind), mask == expected);
+            }
+        }
+    }
+}
@@ -29,6 +29,8 @@
 #include "linden_common.h"
 // Class to test
 #include "../llimageworker.h"
+// For the LLImageRaw stubs
+#include "../llimagealpha.h"
 // For timer class
 #include "../llcommon/lltimer.h"
 // for lltrace class
@@ -66,6 +68,7 @@ LLImageRaw::~LLImageRaw() { }
 void LLImageRaw::deleteData() { }
 U8* LLImageRaw::allocateData(S32 size) { return NULL; }
 U8* LLImageRaw::reallocateData(S32 size) { return NULL; }
+void LLImageRaw::analyzeAlpha() { }
 const U8* LLImageBase::getData() const { return NULL; }
 U8* LLImageBase::getData() { return NULL; }
 const std::string& LLImage::getLastThreadError() { static std::string msg; return msg; }
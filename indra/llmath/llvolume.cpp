@@ -52,6 +52,9 @@
 #include "llmeshoptimizer.h"
 #include "lltimer.h"
 #include "llvolumeoctree.h"
+#include "llvolumebvh.h"
+#include "hbxxh.h"
+#include "llmutex.h"
 
 #include "mikktspace/mikktspace.hh"
 
@@ -4342,71 +4345,37 @@ S32 LLVolume::lineSegmentIntersect(const LLVector4a& start, const LLVector4a& en
                                 *intersection = intersect;
                             }
 
-
-                            if (tex_coord != NULL)
-                            {
-                                LLVector2* tc = (LLVector2*) face.mTexCoords;
-                                *tex_coord = ((1.f - a - b)  * tc[idx0] +
-                                    a              * tc[idx1] +
-                                    b              * tc[idx2]);
-
-                            }
-
-                            if (normal!= NULL)
-                            {
-                                LLVector4a* norm = face.mNormals;
-
-                                LLVector4a n1,n2,n3;
-                                n1 = norm[idx0];
-                                n1.mul(1.f-a-b);
-
-                                n2 = norm[idx1];
-                                n2.mul(a);
-
-                                n3 = norm[idx2];
-                                n3.mul(b);
-
-                                n1.add(n2);
-                                n1.add(n3);
-
-                                *normal     = n1;
-                            }
-
-                            if (tangent_out != NULL)
-                            {
-                                LLVector4a* tangents = face.mTangents;
-
-                                LLVector4a t1,t2,t3;
-                                t1 = tangents[idx0];
-                                t1.mul(1.f-a-b);
-
-                                t2 = tangents[idx1];
-                                t2.mul(a);
-
-                                t3 = tangents[idx2];
-                                t3.mul(b);
-
-                                t1.add(t2);
-                                t1.add(t3);
-
-                                *tangent_out = t1;
-                            }
+                            face.getBarycentricAttributes(idx0, idx1, idx2, a, b, tex_coord, normal, tangent_out);
                         }
                     }
                 }
             }
             else
             {
-                if (!face.getOctree())
+                if (!face.getBVH())
                 {
-                    face.createOctree();
+                    face.createBVH();
                 }
 
-                LLOctreeTriangleRayIntersect intersect(start, dir, &face, &closest_t, intersection, tex_coord, normal, tangent_out);
-                intersect.traverse(face.getOctree());
-                if (intersect.mHitFace)
+                F32 a, b;
+                S32 tri = face.getBVH()->lineSegmentIntersect(face.mPositions, face.mIndices, start, dir, closest_t, a, b);
+                if (tri >= 0)
                 {
                     hit_face = i;
+
+                    U16 idx0 = face.mIndices[tri*3+0];
+                    U16 idx1 = face.mIndices[tri*3+1];
+                    U16 idx2 = face.mIndices[tri*3+2];
+
+                    if (intersection != NULL)
+                    {
+                        LLVector4a intersect = dir;
+                        intersect.mul(closest_t);
+                        intersect.add(start);
+                        *intersection = intersect;
+                    }
+
+                    face.getBarycentricAttributes(idx0, idx1, idx2, a, b, tex_coord, normal, tangent_out);
                 }
             }
         }
@@ -4959,6 +4928,8 @@ LLVolumeFace::LLVolumeFace() :
     mWeightsScrubbed(false),
     mOctree(NULL),
     mOctreeTriangles(NULL),
+    mBVH(NULL),
+    mSharedData(NULL),
     mOptimized(false)
 {
     mExtents = (LLVector4a*) ll_aligned_malloc_16(sizeof(LLVector4a)*3);
@@ -4989,7 +4960,9 @@ LLVolumeFace::LLVolumeFace(const LLVolumeFace& src)
 #endif
     mWeightsScrubbed(false),
     mOctree(NULL),
-    mOctreeTriangles(NULL)
+    mOctreeTriangles(NULL),
+    mBVH(NULL),
+    mSharedData(NULL)
 {
     mExtents = (LLVector4a*) ll_aligned_malloc_16(sizeof(LLVector4a)*3);
     mCenter = mExtents+2;
@@ -5110,6 +5083,17 @@ LLVolumeFace::~LLVolumeFace()
 
 void LLVolumeFace::freeData()
 {
+    if (mSharedData)
+    {
+        // these point into the shared data, which this face does not own
+        mNormals = NULL;
+        mTexCoords = NULL;
+        mTangents = NULL;
+        mIndices = NULL;
+        LLVolumeFaceSharedData::release(mSharedData);
+        mSharedData = NULL;
+    }
+
     ll_aligned_free<64>(mPositions);
     mPositions = NULL;
 
@@ -5132,6 +5116,7 @@ void LLVolumeFace::freeData()
 #endif
 
     destroyOctree();
+    destroyBVH();
 }
 
 bool LLVolumeFace::create(LLVolume* volume, bool partial_build)
@@ -5140,6 +5125,7 @@ bool LLVolumeFace::create(LLVolume* volume, bool partial_build)
 
     //tree for this face is no longer valid
     destroyOctree();
+    destroyBVH();
 
     LL_CHECK_MEMORY
     bool ret = false ;
@@ -5207,6 +5193,8 @@ bool LLVolumeFace::VertexMapData::ComparePosition::operator()(const LLVector3& a
 
 void LLVolumeFace::remap()
 {
+    unshareData();
+
     // Generate a remap buffer
     // Documentation for meshopt_generateVertexRemapMulti claims that remap should use vertice count
     // but all examples use indice count. There are out of bounds crashes when using vertice count.
@@ -5254,14 +5242,41 @@ void LLVolumeFace::remap()
 
 void LLVolumeFace::optimize(F32 angle_cutoff)
 {
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    unshareData();
+
     LLVolumeFace new_face;
+    new_face.resizeIndices(mNumIndices);
+    if (mNumIndices && !new_face.mIndices)
+    {
+        return;
+    }
 
-    //map of points to vector of vertices at that point
-    std::map<U64, std::vector<VertexMapData> > point_map;
+    // Points are bucketed on their position quantized to 16 bits per axis
+    // within the face's extents. Each bucket chains the new vertices that
+    // landed in it through next_vertex, oldest first, and a point is welded
+    // to the first vertex in the chain compareNormal() would accept.
+    struct Bucket
+    {
+        S32 mFirst;
+        S32 mLast;
+    };
+    std::unordered_map<U64, Bucket> point_map;
+    point_map.reserve(mNumVertices);
+    std::vector<S32> next_vertex;
+    next_vertex.reserve(mNumVertices);
+
+    const F32 epsilon = 0.00001f;
+    const bool exact_normals = angle_cutoff > 1.f;
 
     LLVector4a range;
     range.setSub(mExtents[1],mExtents[0]);
 
+    LLVector4a zero;
+    zero.clear();
+    LLVector2 zero_tc;
+
     //remove redundant vertices
     for (S32 i = 0; i < mNumIndices; ++i)
     {
@@ -5278,13 +5293,12 @@ void LLVolumeFace::optimize(F32 angle_cutoff)
             LL_DEBUGS_ONCE("LLVOLUME") << "Invalid index, substituting" << LL_ENDL;
         }
 
-        LLVolumeFace::VertexData cv;
-        getVertexData(index, cv);
-
-        bool found = false;
+        const LLVector4a& cv_pos = mPositions[index];
+        const LLVector4a& cv_norm = mNormals ? mNormals[index] : zero;
+        const LLVector2& cv_tc = mTexCoords ? mTexCoords[index] : zero_tc;
 
         LLVector4a pos;
-        pos.setSub(mPositions[index], mExtents[0]);
+        pos.setSub(cv_pos, mExtents[0]);
         pos.div(range);
 
         U64 pos64 = 0;
@@ -5293,42 +5307,45 @@ void LLVolumeFace::optimize(F32 angle_cutoff)
         pos64 = pos64 | (((U64) (pos[1]*65535)) << 16);
         pos64 = pos64 | (((U64) (pos[2]*65535)) << 32);
 
-        std::map<U64, std::vector<VertexMapData> >::iterator point_iter = point_map.find(pos64);
+        auto point_iter = point_map.find(pos64);
 
+        S32 found = -1;
         if (point_iter != point_map.end())
         { //duplicate point might exist
-            for (U32 j = 0; j < point_iter->second.size(); ++j)
+            for (S32 j = point_iter->second.mFirst; j != -1; j = next_vertex[j])
             {
-                LLVolumeFace::VertexData& tv = (point_iter->second)[j];
-                if (tv.compareNormal(cv, angle_cutoff))
+                // same tests as VertexData::compareNormal(), on the new
+                // face's arrays rather than on copies of each vertex
+                if (cv_pos.equals3(new_face.mPositions[j], epsilon) &&
+                    fabs(cv_tc[0] - new_face.mTexCoords[j][0]) < epsilon &&
+                    fabs(cv_tc[1] - new_face.mTexCoords[j][1]) < epsilon &&
+                    (exact_normals ? new_face.mNormals[j].equals3(cv_norm, epsilon)
+                                   : cv_norm.dot3(new_face.mNormals[j]).getF32() > angle_cutoff))
                 {
-                    found = true;
-                    new_face.pushIndex((point_iter->second)[j].mIndex);
+                    found = j;
                     break;
                 }
             }
         }
 
-        if (!found)
+        if (found == -1)
         {
-            new_face.pushVertex(cv);
-            U16 index = (U16) new_face.mNumVertices-1;
-            new_face.pushIndex(index);
+            new_face.pushVertex(cv_pos, cv_norm, cv_tc);
+            found = new_face.mNumVertices - 1;
+            next_vertex.push_back(-1);
 
-            VertexMapData d;
-            d.setPosition(cv.getPosition());
-            d.mTexCoord = cv.mTexCoord;
-            d.setNormal(cv.getNormal());
-            d.mIndex = index;
             if (point_iter != point_map.end())
             {
-                point_iter->second.push_back(d);
+                next_vertex[point_iter->second.mLast] = found;
+                point_iter->second.mLast = found;
             }
             else
             {
-                point_map[pos64].push_back(d);
+                point_map.emplace(pos64, Bucket{ found, found });
             }
         }
+
+        new_face.mIndices[i] = (U16) found;
     }
 
 
@@ -5708,6 +5725,8 @@ bool LLVolumeFace::cacheOptimize(bool gen_tangents)
     llassert(!mOptimized);
     mOptimized = true;
 
+    unshareData();
+
     if (gen_tangents && mNormals && mTexCoords)
     { // generate mikkt space tangents before cache optimizing since the index buffer may change
         // a bit of a hack to do this here, but this function gets called exactly once for the lifetime of a mesh
@@ -5914,6 +5933,29 @@ const LLVolumeOctree* LLVolumeFace::getOctree() const
     return mOctree;
 }
 
+void LLVolumeFace::createBVH()
+{
+    if (!mBVH)
+    {
+        mBVH = new LLVolumeBVH();
+        mBVH->build(mPositions, mIndices, mNumIndices);
+    }
+}
+
+void LLVolumeFace::destroyBVH()
+{
+    delete mBVH;
+    mBVH = nullptr;
+}
+
+void LLVolumeFace::refitBVH()
+{
+    if (mBVH)
+    {
+        mBVH->refit(mPositions, mIndices);
+    }
+}
+
 
 void LLVolumeFace::swapData(LLVolumeFace& rhs)
 {
@@ -5924,6 +5966,340 @@ void LLVolumeFace::swapData(LLVolumeFace& rhs)
     llswap(rhs.mIndices,mIndices);
     llswap(rhs.mNumVertices, mNumVertices);
     llswap(rhs.mNumIndices, mNumIndices);
+    llswap(rhs.mBVH, mBVH);
+    llswap(rhs.mSharedData, mSharedData);
+}
+
+void LLVolumeFace::getBarycentricAttributes(U32 idx0, U32 idx1, U32 idx2, F32 a, F32 b,
+                                            LLVector2* tex_coord, LLVector4a* normal, LLVector4a* tangent) const
+{
+    const F32 c = 1.f - a - b;
+
+    if (tex_coord != NULL && mTexCoords)
+    {
+        *tex_coord = c * mTexCoords[idx0] + a * mTexCoords[idx1] + b * mTexCoords[idx2];
+    }
+
+    if (normal != NULL && mNormals)
+    {
+        LLVector4a n1, n2, n3;
+        n1 = mNormals[idx0];
+        n1.mul(c);
+        n2 = mNormals[idx1];
+        n2.mul(a);
+        n3 = mNormals[idx2];
+        n3.mul(b);
+        n1.add(n2);
+        n1.add(n3);
+        *normal = n1;
+    }
+
+    if (tangent != NULL && mTangents)
+    {
+        LLVector4a t1, t2, t3;
+        t1 = mTangents[idx0];
+        t1.mul(c);
+        t2 = mTangents[idx1];
+        t2.mul(a);
+        t3 = mTangents[idx2];
+        t3.mul(b);
+        t1.add(t2);
+        t1.add(t3);
+        *tangent = t1;
+    }
+}
+
+void LLVolumeFace::copyWithSharedData(const LLVolumeFace& src, const LLUUID& mesh_id)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    if (&src == this)
+    {
+        return;
+    }
+
+    if (!src.mNumVertices)
+    {
+        *this = src;
+        return;
+    }
+
+    // acquired before freeData() so data this face already shares with src
+    // is not thrown away and rebuilt
+    const LLVolumeFaceSharedData* shared = LLVolumeFaceSharedData::acquire(src, mesh_id);
+
+    mID = src.mID;
+    mTypeMask = src.mTypeMask;
+    mBeginS = src.mBeginS;
+    mBeginT = src.mBeginT;
+    mNumS = src.mNumS;
+    mNumT = src.mNumT;
+
+    mExtents[0] = src.mExtents[0];
+    mExtents[1] = src.mExtents[1];
+    *mCenter = *src.mCenter;
+
+    mNumVertices = 0;
+    mNumAllocatedVertices = 0;
+    mNumIndices = 0;
+
+    freeData();
+
+    mPositions = (LLVector4a*) ll_aligned_malloc<64>(sizeof(LLVector4a)*src.mNumVertices);
+    if (!mPositions)
+    {
+        LLVolumeFaceSharedData::release(shared);
+        return;
+    }
+    LLVector4a::memcpyNonAliased16((F32*) mPositions, (F32*) src.mPositions, src.mNumVertices*sizeof(LLVector4a));
+
+    mSharedData = shared;
+    mNormals = shared->mNormals;
+    mTangents = shared->mTangents;
+    mTexCoords = shared->mTexCoords;
+    mIndices = shared->mIndices;
+    mNumVertices = src.mNumVertices;
+    mNumAllocatedVertices = src.mNumVertices;
+    mNumIndices = src.mNumIndices;
+
+    mWeightsScrubbed = false;
+    mOptimized = src.mOptimized;
+    mNormalizedScale = src.mNormalizedScale;
+}
+
+void LLVolumeFace::unshareData()
+{
+    if (!mSharedData)
+    {
+        return;
+    }
+
+    const LLVolumeFaceSharedData* shared = mSharedData;
+    LLVector4a* positions = mPositions;
+    const S32 num_verts = mNumVertices;
+    const S32 num_indices = mNumIndices;
+
+    mSharedData = NULL;
+    mTangents = NULL;
+
+    // same layout as resizeVertices()
+    S32 tc_size = ((num_verts*sizeof(LLVector2)) + 0xF) & ~0xF;
+    mPositions = (LLVector4a*) ll_aligned_malloc<64>(sizeof(LLVector4a)*2*num_verts+tc_size);
+    if (mPositions)
+    {
+        mNormals = mPositions+num_verts;
+        mTexCoords = (LLVector2*) (mNormals+num_verts);
+
+        LLVector4a::memcpyNonAliased16((F32*) mPositions, (F32*) positions, num_verts*sizeof(LLVector4a));
+        LLVector4a::memcpyNonAliased16((F32*) mNormals, (F32*) shared->mNormals, num_verts*sizeof(LLVector4a));
+        LLVector4a::memcpyNonAliased16((F32*) mTexCoords, (F32*) shared->mTexCoords, tc_size);
+
+        if (shared->mTangents)
+        {
+            mTangents = (LLVector4a*) ll_aligned_malloc_16(sizeof(LLVector4a)*num_verts);
+            LLVector4a::memcpyNonAliased16((F32*) mTangents, (F32*) shared->mTangents, num_verts*sizeof(LLVector4a));
+        }
+        mNumAllocatedVertices = num_verts;
+    }
+    else
+    {
+        mNormals = NULL;
+        mTexCoords = NULL;
+        mNumVertices = 0;
+        mNumAllocatedVertices = 0;
+    }
+
+    S32 idx_size = ((num_indices*sizeof(U16)) + 0xF) & ~0xF;
+    mIndices = num_indices ? (U16*) ll_aligned_malloc_16(idx_size) : NULL;
+    if (mIndices)
+    {
+        LLVector4a::memcpyNonAliased16((F32*) mIndices, (F32*) shared->mIndices, idx_size);
+    }
+    else
+    {
+        mNumIndices = 0;
+    }
+
+    ll_aligned_free<64>(positions);
+    LLVolumeFaceSharedData::release(shared);
+}
+
+namespace
+{
+    // every LLVolumeFaceSharedData by content hash. Never destroyed, faces
+    // may still release data during static destruction.
+    struct SharedFaceDataStore
+    {
+        LLMutex mMutex;
+        std::unordered_map<LLUUID, LLVolumeFaceSharedData*> mData;
+    };
+
+    SharedFaceDataStore& shared_face_data()
+    {
+        static SharedFaceDataStore* store = new SharedFaceDataStore;
+        return *store;
+    }
+
+    LLUUID hash_face_data(const LLVolumeFace& face)
+    {
+        HBXXH128 hash_obj;
+        hash_obj.update(&face.mNumVertices, sizeof(face.mNumVertices));
+        hash_obj.update(&face.mNumIndices, sizeof(face.mNumIndices));
+        hash_obj.update(face.mNormals, face.mNumVertices * sizeof(LLVector4a));
+        hash_obj.update(face.mTexCoords, face.mNumVertices * sizeof(LLVector2));
+        const U8 has_tangents = face.mTangents ? 1 : 0;
+        hash_obj.update(&has_tangents, sizeof(has_tangents));
+        if (face.mTangents)
+        {
+            hash_obj.update(face.mTangents, face.mNumVertices * sizeof(LLVector4a));
+        }
+        hash_obj.update(face.mIndices, face.mNumIndices * sizeof(U16));
+        return hash_obj.digest();
+    }
+}
+
+LLVolumeFaceSharedData::LLVolumeFaceSharedData(const LLVolumeFace& face, const LLUUID& hash, const LLUUID& mesh_id)
+:   mHash(hash),
+    mMeshID(mesh_id),
+    mNumVertices(face.mNumVertices),
+    mNumIndices(face.mNumIndices),
+    mNormals(NULL),
+    mTangents(NULL),
+    mTexCoords(NULL),
+    mIndices(NULL),
+    mUsers(0)
+{
+    // same layout and padding as LLVolumeFace, minus the positions
+    const S32 vert_size = mNumVertices * sizeof(LLVector4a);
+    const S32 tc_size = ((mNumVertices * sizeof(LLVector2)) + 0xF) & ~0xF;
+    mNormals = (LLVector4a*) ll_aligned_malloc<64>(vert_size + tc_size);
+    mTexCoords = (LLVector2*) (mNormals + mNumVertices);
+    LLVector4a::memcpyNonAliased16((F32*) mNormals, (F32*) face.mNormals, vert_size);
+    LLVector4a::memcpyNonAliased16((F32*) mTexCoords, (F32*) face.mTexCoords, tc_size);
+
+    if (face.mTangents)
+    {
+        mTangents = (LLVector4a*) ll_aligned_malloc_16(vert_size);
+        LLVector4a::memcpyNonAliased16((F32*) mTangents, (F32*) face.mTangents, vert_size);
+    }
+
+    if (mNumIndices)
+    {
+        const S32 idx_size = ((mNumIndices * sizeof(U16)) + 0xF) & ~0xF;
+        mIndices = (U16*) ll_aligned_malloc_16(idx_size);
+        LLVector4a::memcpyNonAliased16((F32*) mIndices, (F32*) face.mIndices, idx_size);
+    }
+}
+
+LLVolumeFaceSharedData::~LLVolumeFaceSharedData()
+{
+    ll_aligned_free<64>(mNormals);
+    ll_aligned_free_16(mTangents);
+    ll_aligned_free_16(mIndices);
+}
+
+S64 LLVolumeFaceSharedData::getSize() const
+{
+    S64 size = (S64)mNumVertices * sizeof(LLVector4a) + (((mNumVertices * sizeof(LLVector2)) + 0xF) & ~0xF);
+    if (mTangents)
+    {
+        size += (S64)mNumVertices * sizeof(LLVector4a);
+    }
+    size += ((mNumIndices * sizeof(U16)) + 0xF) & ~0xF;
+    return size;
+}
+
+// static
+const LLVolumeFaceSharedData* LLVolumeFaceSharedData::acquire(const LLVolumeFace& face, const LLUUID& mesh_id)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    const LLUUID hash = hash_face_data(face);
+
+    SharedFaceDataStore& store = shared_face_data();
+    LLMutexLock lock(&store.mMutex);
+
+    LLVolumeFaceSharedData*& data = store.mData[hash];
+    if (!data)
+    {
+        data = new LLVolumeFaceSharedData(face, hash, mesh_id);
+    }
+    ++data->mUsers;
+    return data;
+}
+
+// static
+void LLVolumeFaceSharedData::release(const LLVolumeFaceSharedData* data)
+{
+    if (!data)
+    {
+        return;
+    }
+
+    SharedFaceDataStore& store = shared_face_data();
+    LLMutexLock lock(&store.mMutex);
+
+    auto it = store.mData.find(data->mHash);
+    llassert(it != store.mData.end() && it->second == data);
+    if (it != store.mData.end() && --it->second->mUsers == 0)
+    {
+        delete it->second;
+        store.mData.erase(it);
+    }
+}
+
+// static
+void LLVolumeFaceSharedData::getStats(S32& num_blocks, S64& bytes_saved)
+{
+    SharedFaceDataStore& store = shared_face_data();
+    LLMutexLock lock(&store.mMutex);
+
+    num_blocks = (S32)store.mData.size();
+    bytes_saved = 0;
+    for (const auto& entry : store.mData)
+    {
+        bytes_saved += entry.second->getSize() * (entry.second->mUsers - 1);
+    }
+}
+
+// static
+void LLVolumeFaceSharedData::dump()
+{
+    struct MeshTotals
+    {
+        S32 mBlocks = 0;
+        S32 mUsers = 0;
+        S64 mBytes = 0;
+        S64 mSaved = 0;
+    };
+    std::map<LLUUID, MeshTotals> meshes;
+    MeshTotals total;
+
+    {
+        SharedFaceDataStore& store = shared_face_data();
+        LLMutexLock lock(&store.mMutex);
+
+        for (const auto& entry : store.mData)
+        {
+            const LLVolumeFaceSharedData* data = entry.second;
+            const S64 size = data->getSize();
+            for (MeshTotals* totals : { &meshes[data->mMeshID], &total })
+            {
+                totals->mBlocks++;
+                totals->mUsers += data->mUsers;
+                totals->mBytes += size;
+                totals->mSaved += size * (data->mUsers - 1);
+            }
+        }
+    }
+
+    for (const auto& mesh : meshes)
+    {
+        LL_INFOS() << "Mesh " << mesh.first << ": " << mesh.second.mBlocks << " shared faces, " << mesh.second.mUsers
+                   << " users, " << mesh.second.mBytes << " bytes stored, " << mesh.second.mSaved << " bytes saved" << LL_ENDL;
+    }
+    LL_INFOS() << "Shared face data: " << total.mBlocks << " blocks for " << total.mUsers << " faces, " << total.mBytes
+               << " bytes stored, " << total.mSaved << " bytes saved" << LL_ENDL;
 }
 
 void    LerpPlanarVertex(LLVolumeFace::VertexData& v0,
@@ -6560,6 +6936,8 @@ void LLVolumeFace::resizeVertices(S32 num_verts)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
 
+    unshareData();
+
     ll_aligned_free<64>(mPositions);
     //DO NOT free mNormals and mTexCoords as they are part of mPositions buffer
     ll_aligned_free_16(mTangents);
@@ -6608,6 +6986,8 @@ void LLVolumeFace::pushVertex(const LLVolumeFace::VertexData& cv)
 
 void LLVolumeFace::pushVertex(const LLVector4a& pos, const LLVector4a& norm, const LLVector2& tc)
 {
+    unshareData();
+
     S32 new_verts = mNumVertices+1;
 
     if (new_verts > mNumAllocatedVertices)
@@ -6658,6 +7038,8 @@ void LLVolumeFace::pushVertex(const LLVector4a& pos, const LLVector4a& norm, con
 
 void LLVolumeFace::allocateTangents(S32 num_verts)
 {
+    unshareData();
+
     ll_aligned_free_16(mTangents);
     mTangents = (LLVector4a*) ll_aligned_malloc_16(sizeof(LLVector4a)*num_verts);
 }
@@ -6684,6 +7066,8 @@ void LLVolumeFace::resizeIndices(S32 num_indices)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
 
+    unshareData();
+
     ll_aligned_free_16(mIndices);
     llassert(num_indices % 3 == 0);
 
@@ -6712,6 +7096,8 @@ void LLVolumeFace::resizeIndices(S32 num_indices)
 
 void LLVolumeFace::pushIndex(const U16& idx)
 {
+    unshareData();
+
     S32 new_count = mNumIndices + 1;
     S32 new_size = ((new_count*2)+0xF) & ~0xF;
 
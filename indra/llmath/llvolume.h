@@ -42,6 +42,8 @@ class LLVolumeFace;
 class LLVolume;
 class LLVolumeTriangle;
 class LLVolumeOctree;
+class LLVolumeBVH;
+class LLVolumeFaceSharedData;
 
 #include "lluuid.h"
 #include "v4color.h"
@@ -892,8 +894,24 @@ public:
 
     void swapData(LLVolumeFace& rhs);
 
+    // Copies src's positions and bounds and points this face's normals,
+    // tangents, texture coordinates and indices at the read only copy of
+    // that content shared by every face made this way. Skin weights are
+    // not copied. Only positions and bounds may be written in place after
+    // this, the resize, allocate and push functions give the face its own
+    // copy of the rest first. mesh_id names the data in memory reports.
+    void copyWithSharedData(const LLVolumeFace& src, const LLUUID& mesh_id);
+    bool hasSharedData() const { return mSharedData != NULL; }
+
     void getVertexData(U16 indx, LLVolumeFace::VertexData& cv);
 
+    // Texture coordinate, normal and tangent at barycentric coordinates
+    // (a, b) of the triangle idx0, idx1, idx2, as returned by
+    // LLTriangleRayIntersect(). Null outputs and missing attributes are
+    // skipped.
+    void getBarycentricAttributes(U32 idx0, U32 idx1, U32 idx2, F32 a, F32 b,
+                                  LLVector2* tex_coord, LLVector4a* normal, LLVector4a* tangent) const;
+
     class VertexMapData : public LLVolumeFace::VertexData
     {
     public:
@@ -921,6 +939,13 @@ public:
     // Get a reference to the octree, which may be null
     const LLVolumeOctree* getOctree() const;
 
+    // Flat BVH used for raycasts, built on demand
+    void createBVH();
+    void destroyBVH();
+    // Update BVH bounds after positions changed with the same indices
+    void refitBVH();
+    const LLVolumeBVH* getBVH() const { return mBVH; }
+
     // Part of silhouette generation (used by selection outlines)
     // Populates the provided edge array with numbers corresponding to
     // *partial* logic of whether a particular index should be rendered
@@ -1000,14 +1025,58 @@ public:
     LLVector3 mNormalizedScale = LLVector3(1,1,1);
 
 private:
+    // Replaces shared normals, tangents, texture coordinates and indices
+    // with copies owned by this face
+    void unshareData();
+
     LLVolumeOctree* mOctree;
     LLVolumeTriangle* mOctreeTriangles;
+    LLVolumeBVH* mBVH;
+    const LLVolumeFaceSharedData* mSharedData;
 
     bool createUnCutCubeCap(LLVolume* volume, bool partial_build = false);
     bool createCap(LLVolume* volume, bool partial_build = false);
     bool createSide(LLVolume* volume, bool partial_build = false);
 };
 
+// Normals, tangents, texture coordinates and indices of a face, stored once
+// per distinct content and keyed by a hash of it. Faces that only rewrite
+// their positions, like the posed copies LLRiggedVolume keeps per object,
+// refer to one of these instead of copying the rest of their source face.
+class LLVolumeFaceSharedData
+{
+public:
+    // The shared data with face's content, created if nothing uses it yet.
+    // Each acquire() must be matched by a release().
+    static const LLVolumeFaceSharedData* acquire(const LLVolumeFace& face, const LLUUID& mesh_id);
+    static void release(const LLVolumeFaceSharedData* data);
+
+    // Number of distinct blocks, and bytes saved over every user having
+    // its own copy
+    static void getStats(S32& num_blocks, S64& bytes_saved);
+
+    // Logs the faces sharing data and the bytes saved, per mesh
+    static void dump();
+
+    // Bytes held by this block
+    S64 getSize() const;
+
+    LLUUID      mHash;
+    LLUUID      mMeshID;        // mesh of the face that created the block
+    S32         mNumVertices;
+    S32         mNumIndices;
+    LLVector4a* mNormals;       // mTexCoords are in the same allocation
+    LLVector4a* mTangents;      // may be null
+    LLVector2*  mTexCoords;
+    U16*        mIndices;
+
+private:
+    LLVolumeFaceSharedData(const LLVolumeFace& face, const LLUUID& hash, const LLUUID& mesh_id);
+    ~LLVolumeFaceSharedData();
+
+    S32         mUsers;
+};
+
 class LLVolume : public LLRefCount
 {
     friend class LLVolumeLODGroup;
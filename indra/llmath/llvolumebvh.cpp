@@ -0,0 +1,321 @@
+/**
+ * @file llvolumebvh.cpp
+ * @brief Flat bounding volume hierarchy over the triangles of a volume face.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llvolumebvh.h"
+
+#include "llvolume.h"
+
+#include <algorithm>
+
+namespace
+{
+    // slack on the slab test so triangles touching a node boundary are never
+    // rejected by rounding differences between the box and triangle tests
+    constexpr F32 BOX_EPSILON = 1.0e-5f;
+
+    // Returns the parametric entry distance of the segment into the node's
+    // box, or -1 if the segment misses the box before max_t
+    inline F32 segment_box_entry(const LLVolumeBVH::Node& node, const LLVector4a& start,
+                                 const LLVector4a& inv_dir, F32 max_t)
+    {
+        LLVector4a t0;
+        t0.setSub(node.mMin, start);
+        t0.mul(inv_dir);
+
+        LLVector4a t1;
+        t1.setSub(node.mMax, start);
+        t1.mul(inv_dir);
+
+        LLVector4a near_t;
+        near_t.setMin(t0, t1);
+        LLVector4a far_t;
+        far_t.setMax(t0, t1);
+
+        const F32* n = near_t.getF32ptr();
+        const F32* f = far_t.getF32ptr();
+
+        F32 entry = llmax(llmax(n[0], n[1]), llmax(n[2], 0.f));
+        F32 exit = llmin(llmin(f[0], f[1]), llmin(f[2], max_t));
+
+        return entry <= exit + BOX_EPSILON ? entry : -1.f;
+    }
+}
+
+void LLVolumeBVH::clear()
+{
+    mNodes.clear();
+    mTriangles.clear();
+}
+
+void LLVolumeBVH::build(const LLVector4a* positions, const U16* indices, U32 num_indices)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    clear();
+
+    const U32 num_triangles = num_indices / 3;
+    if (num_triangles == 0)
+    {
+        return;
+    }
+
+    std::vector<LLVector4a> tri_min(num_triangles);
+    std::vector<LLVector4a> tri_max(num_triangles);
+    std::vector<LLVector4a> centers(num_triangles);
+
+    mTriangles.resize(num_triangles);
+    for (U32 i = 0; i < num_triangles; ++i)
+    {
+        const LLVector4a& v0 = positions[indices[i * 3 + 0]];
+        const LLVector4a& v1 = positions[indices[i * 3 + 1]];
+        const LLVector4a& v2 = positions[indices[i * 3 + 2]];
+
+        tri_min[i].setMin(v0, v1);
+        tri_min[i].setMin(tri_min[i], v2);
+        tri_max[i].setMax(v0, v1);
+        tri_max[i].setMax(tri_max[i], v2);
+
+        centers[i].setAdd(tri_min[i], tri_max[i]);
+        centers[i].mul(0.5f);
+
+        mTriangles[i] = i;
+    }
+
+    // a binary tree with at most MAX_LEAF_TRIANGLES per leaf
+    mNodes.reserve(2 * (num_triangles / MAX_LEAF_TRIANGLES + 1));
+    buildNode(tri_min.data(), tri_max.data(), centers.data(), 0, num_triangles, 0);
+}
+
+U32 LLVolumeBVH::buildNode(const LLVector4a* tri_min, const LLVector4a* tri_max, const LLVector4a* centers,
+                           U32 begin, U32 end, U32 depth)
+{
+    const U32 index = (U32)mNodes.size();
+    mNodes.emplace_back();
+
+    LLVector4a node_min = tri_min[mTriangles[begin]];
+    LLVector4a node_max = tri_max[mTriangles[begin]];
+    LLVector4a center_min = centers[mTriangles[begin]];
+    LLVector4a center_max = center_min;
+
+    for (U32 i = begin + 1; i < end; ++i)
+    {
+        const U32 tri = mTriangles[i];
+        node_min.setMin(node_min, tri_min[tri]);
+        node_max.setMax(node_max, tri_max[tri]);
+        center_min.setMin(center_min, centers[tri]);
+        center_max.setMax(center_max, centers[tri]);
+    }
+
+    mNodes[index].mMin = node_min;
+    mNodes[index].mMax = node_max;
+
+    const U32 count = end - begin;
+    // median splits halve the range every level, so this only triggers on
+    // absurd triangle counts; keep the stack bound in traverse() valid anyway
+    if (count <= MAX_LEAF_TRIANGLES || depth >= MAX_DEPTH - 2)
+    {
+        mNodes[index].mFirst = begin;
+        mNodes[index].mCount = count;
+        return index;
+    }
+
+    // split at the median centroid along the axis with the largest centroid spread
+    LLVector4a spread;
+    spread.setSub(center_max, center_min);
+    const F32* s = spread.getF32ptr();
+    S32 axis = 0;
+    if (s[1] > s[axis])
+    {
+        axis = 1;
+    }
+    if (s[2] > s[axis])
+    {
+        axis = 2;
+    }
+
+    const U32 mid = begin + count / 2;
+    std::nth_element(mTriangles.begin() + begin, mTriangles.begin() + mid, mTriangles.begin() + end,
+        [centers, axis](U32 lhs, U32 rhs)
+        {
+            return centers[lhs][axis] < centers[rhs][axis];
+        });
+
+    mNodes[index].mCount = 0;
+    buildNode(tri_min, tri_max, centers, begin, mid, depth + 1);
+    // don't hold a reference across the recursion, mNodes may grow
+    const U32 second = buildNode(tri_min, tri_max, centers, mid, end, depth + 1);
+    mNodes[index].mFirst = second;
+
+    return index;
+}
+
+void LLVolumeBVH::computeLeafBounds(Node& node, const LLVector4a* positions, const U16* indices) const
+{
+    const U32 first_tri = mTriangles[node.mFirst];
+    node.mMin = positions[indices[first_tri * 3]];
+    node.mMax = node.mMin;
+
+    for (U32 i = node.mFirst; i < node.mFirst + node.mCount; ++i)
+    {
+        const U32 tri = mTriangles[i];
+        for (U32 j = 0; j < 3; ++j)
+        {
+            const LLVector4a& v = positions[indices[tri * 3 + j]];
+            node.mMin.setMin(node.mMin, v);
+            node.mMax.setMax(node.mMax, v);
+        }
+    }
+}
+
+void LLVolumeBVH::refit(const LLVector4a* positions, const U16* indices)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    // children are always stored after their parent, so a reverse walk
+    // visits every node after both of its children
+    for (size_t i = mNodes.size(); i-- > 0; )
+    {
+        Node& node = mNodes[i];
+        if (node.isLeaf())
+        {
+            computeLeafBounds(node, positions, indices);
+        }
+        else
+        {
+            const Node& left = mNodes[i + 1];
+            const Node& right = mNodes[node.mFirst];
+            node.mMin.setMin(left.mMin, right.mMin);
+            node.mMax.setMax(left.mMax, right.mMax);
+        }
+    }
+}
+
+S32 LLVolumeBVH::lineSegmentIntersect(const LLVector4a* positions, const U16* indices,
+                                      const LLVector4a& start, const LLVector4a& dir,
+                                      F32& closest_t, F32& a, F32& b) const
+{
+    if (mNodes.empty())
+    {
+        return -1;
+    }
+
+    // reciprocal direction for the slab tests, with axis parallel segments
+    // mapped to a huge finite value so 0 * inv never produces a NaN
+    LL_ALIGN_16(F32 inv[4]);
+    for (U32 i = 0; i < 4; ++i)
+    {
+        const F32 d = dir[i];
+        inv[i] = fabsf(d) > 1.0e-20f ? 1.f / d : (d < 0.f ? -1.0e20f : 1.0e20f);
+    }
+    LLVector4a inv_dir;
+    inv_dir.load4a(inv);
+
+    struct Entry
+    {
+        U32 mNode;
+        F32 mT;
+    };
+
+    Entry stack[MAX_DEPTH];
+    U32 depth = 0;
+
+    S32 hit_tri = -1;
+    F32 max_t = llmin(closest_t, 1.f);
+
+    F32 root_t = segment_box_entry(mNodes[0], start, inv_dir, max_t);
+    if (root_t < 0.f)
+    {
+        return -1;
+    }
+    stack[depth++] = { 0, root_t };
+
+    while (depth > 0)
+    {
+        const Entry entry = stack[--depth];
+        if (entry.mT > max_t)
+        { // a closer hit was found since this node was pushed
+            continue;
+        }
+
+        const Node& node = mNodes[entry.mNode];
+        if (node.isLeaf())
+        {
+            for (U32 i = node.mFirst; i < node.mFirst + node.mCount; ++i)
+            {
+                const U32 tri = mTriangles[i];
+                const U16 idx0 = indices[tri * 3 + 0];
+                const U16 idx1 = indices[tri * 3 + 1];
+                const U16 idx2 = indices[tri * 3 + 2];
+
+                F32 ta, tb, t;
+                if (LLTriangleRayIntersect(positions[idx0], positions[idx1], positions[idx2], start, dir, ta, tb, t))
+                {
+                    if (t >= 0.f && t <= 1.f && t < closest_t)
+                    {
+                        closest_t = t;
+                        max_t = t;
+                        a = ta;
+                        b = tb;
+                        hit_tri = (S32)tri;
+                    }
+                }
+            }
+            continue;
+        }
+
+        // visit the nearer child first so later subtrees can be rejected by max_t
+        const U32 left = entry.mNode + 1;
+        const U32 right = node.mFirst;
+        const F32 left_t = segment_box_entry(mNodes[left], start, inv_dir, max_t);
+        const F32 right_t = segment_box_entry(mNodes[right], start, inv_dir, max_t);
+
+        if (left_t >= 0.f && right_t >= 0.f)
+        {
+            if (left_t <= right_t)
+            {
+                stack[depth++] = { right, right_t };
+                stack[depth++] = { left, left_t };
+            }
+            else
+            {
+                stack[depth++] = { left, left_t };
+                stack[depth++] = { right, right_t };
+            }
+        }
+        else if (left_t >= 0.f)
+        {
+            stack[depth++] = { left, left_t };
+        }
+        else if (right_t >= 0.f)
+        {
+            stack[depth++] = { right, right_t };
+        }
+    }
+
+    return hit_tri;
+}
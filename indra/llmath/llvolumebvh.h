@@ -0,0 +1,138 @@
+/**
+ * @file llvolumebvh.h
+ * @brief Flat bounding volume hierarchy over the triangles of a volume face.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLVOLUMEBVH_H
+#define LL_LLVOLUMEBVH_H
+
+#include "llmath.h"
+#include "llvector4a.h"
+
+#include <vector>
+
+// Linear BVH over an indexed triangle list.
+//
+// Nodes are stored depth first in a single array: the first child of an
+// inner node immediately follows it and the index of the second child is
+// stored in the node, so traversal walks contiguous memory and needs no
+// per-node allocations or reference counting like LLOctreeNode does.
+// The BVH does not own the vertex data; positions and indices are passed to
+// every call and must be the same arrays (same topology) it was built from.
+class LLVolumeBVH
+{
+public:
+    enum
+    {
+        MAX_LEAF_TRIANGLES = 4,
+        MAX_DEPTH = 64
+    };
+
+    class alignas(16) Node
+    {
+    public:
+        bool isLeaf() const { return mCount != 0; }
+
+        LLVector4a mMin;
+        LLVector4a mMax;
+        // leaf: first entry in mTriangles, inner: index of the second child
+        U32 mFirst;
+        // leaf: number of triangles, inner: 0
+        U32 mCount;
+    };
+
+    LLVolumeBVH() = default;
+
+    // (Re)build the hierarchy for num_indices/3 triangles
+    void build(const LLVector4a* positions, const U16* indices, U32 num_indices);
+
+    // Recompute node bounds after vertex positions moved without changing
+    // topology (e.g. rigged meshes).  Much cheaper than a rebuild, but tree
+    // quality degrades if the deformation is large.
+    void refit(const LLVector4a* positions, const U16* indices);
+
+    void clear();
+    bool isEmpty() const { return mNodes.empty(); }
+
+    // Intersect the segment start + t * dir against the triangles, for
+    // 0 <= t <= 1 and t < closest_t.  On a hit, closest_t, a and b (the
+    // barycentric coordinates of the hit) are updated and the index of the
+    // hit triangle is returned, otherwise returns -1.
+    S32 lineSegmentIntersect(const LLVector4a* positions, const U16* indices,
+                             const LLVector4a& start, const LLVector4a& dir,
+                             F32& closest_t, F32& a, F32& b) const;
+
+    // Non recursive traversal for arbitrary queries (e.g. frustum culling).
+    // node_test(const Node&) returns false to skip a subtree, leaf_visit is
+    // called with each triangle index of every leaf that passes node_test.
+    template <typename NODE_TEST, typename LEAF_VISIT>
+    void traverse(NODE_TEST&& node_test, LEAF_VISIT&& leaf_visit) const
+    {
+        if (mNodes.empty())
+        {
+            return;
+        }
+
+        U32 stack[MAX_DEPTH];
+        U32 depth = 0;
+        stack[depth++] = 0;
+
+        while (depth > 0)
+        {
+            const Node& node = mNodes[stack[--depth]];
+            if (!node_test(node))
+            {
+                continue;
+            }
+
+            if (node.isLeaf())
+            {
+                for (U32 i = node.mFirst; i < node.mFirst + node.mCount; ++i)
+                {
+                    leaf_visit(mTriangles[i]);
+                }
+            }
+            else
+            {
+                U32 first_child = (U32)(&node - mNodes.data()) + 1;
+                stack[depth++] = node.mFirst;
+                stack[depth++] = first_child;
+            }
+        }
+    }
+
+    const std::vector<Node>& getNodes() const { return mNodes; }
+    U32 getNumTriangles() const { return (U32)mTriangles.size(); }
+
+private:
+    U32 buildNode(const LLVector4a* tri_min, const LLVector4a* tri_max, const LLVector4a* centers,
+                  U32 begin, U32 end, U32 depth);
+    void computeLeafBounds(Node& node, const LLVector4a* positions, const U16* indices) const;
+
+    std::vector<Node> mNodes;
+    // triangle indices, permuted so every leaf references a contiguous range
+    std::vector<U32> mTriangles;
+};
+
+#endif // LL_LLVOLUMEBVH_H
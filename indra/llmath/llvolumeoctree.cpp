@@ -151,54 +151,7 @@ void LLOctreeTriangleRayIntersect::visit(const LLOctreeNode<LLVolumeTriangle, LL
                 U32 idx1 = tri->mIndex[1];
                 U32 idx2 = tri->mIndex[2];
 
-                if (mTexCoord != NULL && mFace->mTexCoords)
-                {
-                    LLVector2* tc = (LLVector2*) mFace->mTexCoords;
-                    *mTexCoord = ((1.f - a - b)  * tc[idx0] +
-                        a              * tc[idx1] +
-                        b              * tc[idx2]);
-
-                }
-
-                if (mNormal != NULL && mFace->mNormals)
-                {
-                    LLVector4a* norm = mFace->mNormals;
-
-                    LLVector4a n1,n2,n3;
-                    n1 = norm[idx0];
-                    n1.mul(1.f-a-b);
-
-                    n2 = norm[idx1];
-                    n2.mul(a);
-
-                    n3 = norm[idx2];
-                    n3.mul(b);
-
-                    n1.add(n2);
-                    n1.add(n3);
-
-                    *mNormal        = n1;
-                }
-
-                if (mTangent != NULL && mFace->mTangents)
-                {
-                    LLVector4a* tangents = mFace->mTangents;
-
-                    LLVector4a t1,t2,t3;
-                    t1 = tangents[idx0];
-                    t1.mul(1.f-a-b);
-
-                    t2 = tangents[idx1];
-                    t2.mul(a);
-
-                    t3 = tangents[idx2];
-                    t3.mul(b);
-
-                    t1.add(t2);
-                    t1.add(t3);
-
-                    *mTangent = t1;
-                }
+                mFace->getBarycentricAttributes(idx0, idx1, idx2, a, b, mTexCoord, mNormal, mTangent);
             }
         }
     }
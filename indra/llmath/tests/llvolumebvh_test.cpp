@@ -0,0 +1,346 @@
+/**
+ * @file llvolumebvh_test.cpp
+ * @brief LLVolumeBVH test cases.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llvolumebvh.h"
+#include "../llvolume.h"
+#include "../llvolumeoctree.h"
+#include "llrand.h"
+#include "lltimer.h"
+
+#include "../test/lltut.h"
+
+#include <vector>
+
+namespace
+{
+    F32 rand_range(F32 lo, F32 hi)
+    {
+        return lo + ll_frand(hi - lo);
+    }
+
+    // closest hit by testing every triangle, the reference for the BVH
+    S32 brute_force_intersect(const LLVector4a* positions, const U16* indices, U32 num_indices,
+                              const LLVector4a& start, const LLVector4a& dir, F32& closest_t)
+    {
+        S32 hit = -1;
+        for (U32 i = 0; i < num_indices / 3; ++i)
+        {
+            F32 a, b, t;
+            if (LLTriangleRayIntersect(positions[indices[i * 3]], positions[indices[i * 3 + 1]], positions[indices[i * 3 + 2]],
+                    start, dir, a, b, t))
+            {
+                if (t >= 0.f && t <= 1.f && t < closest_t)
+                {
+                    closest_t = t;
+                    hit = (S32)i;
+                }
+            }
+        }
+        return hit;
+    }
+
+    // height field of (res x res) vertices spanning the unit cube in x and y
+    void make_grid(LLVolumeFace& face, U32 res)
+    {
+        face.resizeVertices(res * res);
+        face.resizeIndices((res - 1) * (res - 1) * 6);
+
+        for (U32 y = 0; y < res; ++y)
+        {
+            for (U32 x = 0; x < res; ++x)
+            {
+                F32 fx = (F32)x / (res - 1) - 0.5f;
+                F32 fy = (F32)y / (res - 1) - 0.5f;
+                face.mPositions[y * res + x].set(fx, fy, 0.1f * sinf(fx * 12.f) * cosf(fy * 9.f));
+                face.mNormals[y * res + x].set(0.f, 0.f, 1.f);
+                face.mTexCoords[y * res + x].set(fx + 0.5f, fy + 0.5f);
+            }
+        }
+
+        U16* idx = face.mIndices;
+        for (U32 y = 0; y < res - 1; ++y)
+        {
+            for (U32 x = 0; x < res - 1; ++x)
+            {
+                U16 i0 = (U16)(y * res + x);
+                U16 i1 = (U16)(i0 + 1);
+                U16 i2 = (U16)(i0 + res);
+                U16 i3 = (U16)(i2 + 1);
+                *idx++ = i0; *idx++ = i1; *idx++ = i3;
+                *idx++ = i0; *idx++ = i3; *idx++ = i2;
+            }
+        }
+
+        face.mExtents[0].set(-0.5f, -0.5f, -0.1f);
+        face.mExtents[1].set(0.5f, 0.5f, 0.1f);
+    }
+
+    struct TriangleSoup
+    {
+        std::vector<LLVector4a> mPositions;
+        std::vector<U16> mIndices;
+
+        TriangleSoup(U32 count)
+        {
+            for (U32 i = 0; i < count; ++i)
+            {
+                LLVector4a center;
+                center.set(rand_range(-10.f, 10.f), rand_range(-10.f, 10.f), rand_range(-10.f, 10.f));
+                for (U32 j = 0; j < 3; ++j)
+                {
+                    LLVector4a v;
+                    v.set(rand_range(-1.f, 1.f), rand_range(-1.f, 1.f), rand_range(-1.f, 1.f));
+                    v.add(center);
+                    mIndices.push_back((U16)mPositions.size());
+                    mPositions.push_back(v);
+                }
+            }
+        }
+    };
+}
+
+namespace tut
+{
+    struct llvolumebvh_data
+    {
+        void check_segments(const LLVolumeBVH& bvh, const LLVector4a* positions, const U16* indices, U32 num_indices,
+                            U32 segments, F32 range)
+        {
+            for (U32 i = 0; i < segments; ++i)
+            {
+                LLVector4a start;
+                start.set(rand_range(-range, range), rand_range(-range, range), rand_range(-range, range));
+                LLVector4a end;
+                end.set(rand_range(-range, range), rand_range(-range, range), rand_range(-range, range));
+                LLVector4a dir;
+                dir.setSub(end, start);
+
+                F32 expected_t = 2.f;
+                S32 expected = brute_force_intersect(positions, indices, num_indices, start, dir, expected_t);
+
+                F32 t = 2.f;
+                F32 a, b;
+                S32 hit = bvh.lineSegmentIntersect(positions, indices, start, dir, t, a, b);
+
+                ensure_equals("hit/miss matches brute force", hit >= 0, expected >= 0);
+                if (hit >= 0)
+                {
+                    // coplanar or shared edge hits may pick a different triangle at the same distance
+                    ensure_approximately_equals("closest hit distance", t, expected_t, 16);
+                }
+            }
+        }
+    };
+    typedef test_group<llvolumebvh_data> llvolumebvh_test;
+    typedef llvolumebvh_test::object llvolumebvh_object;
+    tut::llvolumebvh_test tllvolumebvh("LLVolumeBVH");
+
+    template<> template<>
+    void llvolumebvh_object::test<1>()
+    {
+        set_test_name("segment intersections match brute force");
+
+        TriangleSoup soup(2000);
+        LLVolumeBVH bvh;
+        bvh.build(soup.mPositions.data(), soup.mIndices.data(), (U32)soup.mIndices.size());
+
+        ensure_equals("all triangles referenced", bvh.getNumTriangles(), (U32)2000);
+        check_segments(bvh, soup.mPositions.data(), soup.mIndices.data(), (U32)soup.mIndices.size(), 1000, 12.f);
+    }
+
+    template<> template<>
+    void llvolumebvh_object::test<2>()
+    {
+        set_test_name("refit after moving vertices");
+
+        TriangleSoup soup(1000);
+        LLVolumeBVH bvh;
+        bvh.build(soup.mPositions.data(), soup.mIndices.data(), (U32)soup.mIndices.size());
+
+        // deform the soup the way skinning would, keeping the topology
+        for (LLVector4a& v : soup.mPositions)
+        {
+            LLVector4a offset;
+            offset.set(v[1] * 0.3f, -v[0] * 0.2f, rand_range(-2.f, 2.f));
+            v.add(offset);
+        }
+        bvh.refit(soup.mPositions.data(), soup.mIndices.data());
+
+        // every node must bound its children after a refit
+        const std::vector<LLVolumeBVH::Node>& nodes = bvh.getNodes();
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            if (!nodes[i].isLeaf())
+            {
+                const LLVolumeBVH::Node* children[] = { &nodes[i + 1], &nodes[nodes[i].mFirst] };
+                for (const LLVolumeBVH::Node* child : children)
+                {
+                    LLVector4a lo;
+                    lo.setMin(nodes[i].mMin, child->mMin);
+                    LLVector4a hi;
+                    hi.setMax(nodes[i].mMax, child->mMax);
+                    ensure("parent min bounds child", lo.equals3(nodes[i].mMin));
+                    ensure("parent max bounds child", hi.equals3(nodes[i].mMax));
+                }
+            }
+        }
+
+        check_segments(bvh, soup.mPositions.data(), soup.mIndices.data(), (U32)soup.mIndices.size(), 500, 14.f);
+    }
+
+    template<> template<>
+    void llvolumebvh_object::test<3>()
+    {
+        set_test_name("box query traversal");
+
+        TriangleSoup soup(1500);
+        LLVolumeBVH bvh;
+        bvh.build(soup.mPositions.data(), soup.mIndices.data(), (U32)soup.mIndices.size());
+
+        LLVector4a box_min;
+        box_min.set(-3.f, -2.f, -4.f);
+        LLVector4a box_max;
+        box_max.set(4.f, 5.f, 1.f);
+
+        auto overlaps = [&](const LLVector4a& lo, const LLVector4a& hi)
+        {
+            return !(lo.greaterThan(box_max).getGatheredBits() & 0x7) &&
+                   !(hi.lessThan(box_min).getGatheredBits() & 0x7);
+        };
+
+        U32 expected = 0;
+        for (U32 i = 0; i < 1500; ++i)
+        {
+            LLVector4a lo = soup.mPositions[i * 3];
+            LLVector4a hi = lo;
+            for (U32 j = 1; j < 3; ++j)
+            {
+                lo.setMin(lo, soup.mPositions[i * 3 + j]);
+                hi.setMax(hi, soup.mPositions[i * 3 + j]);
+            }
+            expected += overlaps(lo, hi) ? 1 : 0;
+        }
+
+        U32 found = 0;
+        bvh.traverse(
+            [&](const LLVolumeBVH::Node& node) { return overlaps(node.mMin, node.mMax); },
+            [&](U32 tri)
+            {
+                LLVector4a lo = soup.mPositions[tri * 3];
+                LLVector4a hi = lo;
+                for (U32 j = 1; j < 3; ++j)
+                {
+                    lo.setMin(lo, soup.mPositions[tri * 3 + j]);
+                    hi.setMax(hi, soup.mPositions[tri * 3 + j]);
+                }
+                found += overlaps(lo, hi) ? 1 : 0;
+            });
+
+        ensure_equals("traversal finds every overlapping triangle", found, expected);
+    }
+
+    template<> template<>
+    void llvolumebvh_object::test<4>()
+    {
+        set_test_name("face raycast against octree");
+
+        LLVolumeFace face;
+        make_grid(face, 128);
+        face.createOctree();
+        face.createBVH();
+
+        for (U32 i = 0; i < 500; ++i)
+        {
+            LLVector4a start;
+            start.set(rand_range(-0.6f, 0.6f), rand_range(-0.6f, 0.6f), 1.f);
+            LLVector4a end;
+            end.set(rand_range(-0.6f, 0.6f), rand_range(-0.6f, 0.6f), -1.f);
+            LLVector4a dir;
+            dir.setSub(end, start);
+
+            F32 octree_t = 2.f;
+            LLOctreeTriangleRayIntersect intersect(start, dir, &face, &octree_t, NULL, NULL, NULL, NULL);
+            intersect.traverse(face.getOctree());
+
+            F32 bvh_t = 2.f;
+            F32 a, b;
+            face.getBVH()->lineSegmentIntersect(face.mPositions, face.mIndices, start, dir, bvh_t, a, b);
+
+            ensure_approximately_equals("bvh and octree agree", bvh_t, octree_t, 16);
+        }
+    }
+
+#if LL_BENCHMARK
+    template<> template<>
+    void llvolumebvh_object::test<5>()
+    {
+        set_test_name("face raycast time, octree and bvh");
+
+        LLVolumeFace face;
+        make_grid(face, 128);
+        face.createOctree();
+
+        LLTimer timer;
+        face.createBVH();
+        F64 bvh_build = timer.getElapsedTimeF64();
+
+        const U32 segments = 2000;
+        std::vector<LLVector4a> starts(segments);
+        std::vector<LLVector4a> dirs(segments);
+        for (U32 i = 0; i < segments; ++i)
+        {
+            starts[i].set(rand_range(-0.6f, 0.6f), rand_range(-0.6f, 0.6f), 1.f);
+            LLVector4a end;
+            end.set(rand_range(-0.6f, 0.6f), rand_range(-0.6f, 0.6f), -1.f);
+            dirs[i].setSub(end, starts[i]);
+        }
+
+        timer.reset();
+        for (U32 i = 0; i < segments; ++i)
+        {
+            F32 t = 2.f;
+            LLOctreeTriangleRayIntersect intersect(starts[i], dirs[i], &face, &t, NULL, NULL, NULL, NULL);
+            intersect.traverse(face.getOctree());
+        }
+        F64 octree_time = timer.getElapsedTimeF64();
+
+        timer.reset();
+        for (U32 i = 0; i < segments; ++i)
+        {
+            F32 t = 2.f;
+            F32 a, b;
+            face.getBVH()->lineSegmentIntersect(face.mPositions, face.mIndices, starts[i], dirs[i], t, a, b);
+        }
+        F64 bvh_time = timer.getElapsedTimeF64();
+
+        LL_INFOS() << face.mNumIndices / 3 << " triangles, " << segments << " segments: octree "
+                   << octree_time * 1000.0 << " ms, bvh " << bvh_time * 1000.0 << " ms (build "
+                   << bvh_build * 1000.0 << " ms, " << face.getBVH()->getNodes().size() << " nodes)" << LL_ENDL;
+    }
+#endif // LL_BENCHMARK
+}
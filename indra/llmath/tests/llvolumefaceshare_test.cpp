@@ -0,0 +1,200 @@
+/**
+ * @file llvolumefaceshare_test.cpp
+ * @brief LLVolumeFace shared data test cases.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llvolume.h"
+
+#include "../test/lltut.h"
+
+#include <vector>
+
+namespace
+{
+    // a strip of (count - 2) triangles with distinct attributes per vertex,
+    // offset so faces made with different offsets differ everywhere
+    void make_face(LLVolumeFace& face, S32 count, F32 offset, bool tangents)
+    {
+        face.resizeVertices(count);
+        face.resizeIndices((count - 2) * 3);
+        for (S32 i = 0; i < count; ++i)
+        {
+            face.mPositions[i].set((F32)i, offset, 0.f);
+            face.mNormals[i].set(0.f, offset, 1.f);
+            face.mTexCoords[i].set((F32)i / count, offset);
+        }
+        for (S32 i = 0; i < count - 2; ++i)
+        {
+            face.mIndices[i * 3 + 0] = (U16)i;
+            face.mIndices[i * 3 + 1] = (U16)(i + 1);
+            face.mIndices[i * 3 + 2] = (U16)(i + 2);
+        }
+        if (tangents)
+        {
+            face.allocateTangents(count);
+            for (S32 i = 0; i < count; ++i)
+            {
+                face.mTangents[i].set(1.f, 0.f, offset, 1.f);
+            }
+        }
+        face.mExtents[0].set(0.f, offset, 0.f);
+        face.mExtents[1].set((F32)(count - 1), offset, 0.f);
+    }
+
+    bool same_face(const LLVolumeFace& a, const LLVolumeFace& b)
+    {
+        return a.mNumVertices == b.mNumVertices && a.mNumIndices == b.mNumIndices &&
+               !memcmp(a.mPositions, b.mPositions, a.mNumVertices * sizeof(LLVector4a)) &&
+               !memcmp(a.mNormals, b.mNormals, a.mNumVertices * sizeof(LLVector4a)) &&
+               !memcmp(a.mTexCoords, b.mTexCoords, a.mNumVertices * sizeof(LLVector2)) &&
+               !memcmp(a.mIndices, b.mIndices, a.mNumIndices * sizeof(U16)) &&
+               (a.mTangents != NULL) == (b.mTangents != NULL) &&
+               (!a.mTangents || !memcmp(a.mTangents, b.mTangents, a.mNumVertices * sizeof(LLVector4a)));
+    }
+}
+
+namespace tut
+{
+    struct llvolumefaceshare_data
+    {
+        LLUUID mMeshID = LLUUID("a5b3f0d4-6c9e-4b2e-9d4f-1e2c3b4a5d6e");
+
+        S32 numBlocks()
+        {
+            S32 blocks;
+            S64 saved;
+            LLVolumeFaceSharedData::getStats(blocks, saved);
+            return blocks;
+        }
+    };
+    typedef test_group<llvolumefaceshare_data> llvolumefaceshare_test;
+    typedef llvolumefaceshare_test::object llvolumefaceshare_object;
+    tut::llvolumefaceshare_test tllvolumefaceshare("LLVolumeFaceShare");
+
+    template<> template<>
+    void llvolumefaceshare_object::test<1>()
+    {
+        set_test_name("copies of the same face share one block");
+
+        LLVolumeFace src;
+        make_face(src, 300, 1.f, true);
+        {
+            std::vector<LLVolumeFace> copies(4);
+            for (LLVolumeFace& copy : copies)
+            {
+                copy.copyWithSharedData(src, mMeshID);
+            }
+
+            S32 blocks;
+            S64 saved;
+            LLVolumeFaceSharedData::getStats(blocks, saved);
+            ensure_equals("one block", blocks, 1);
+
+            const S64 block_size = (S64)300 * (sizeof(LLVector4a) * 2 + sizeof(LLVector2)) + ((298 * 3 * sizeof(U16) + 0xF) & ~0xF);
+            ensure_equals("three copies saved", saved, block_size * 3);
+
+            for (const LLVolumeFace& copy : copies)
+            {
+                ensure("shared", copy.hasSharedData());
+                ensure("same content", same_face(copy, src));
+                ensure("own positions", copy.mPositions != src.mPositions);
+                ensure("indices shared", copy.mIndices == copies[0].mIndices);
+                ensure("weights not copied", copy.mWeights == NULL);
+            }
+        }
+        ensure_equals("released with the last copy", numBlocks(), 0);
+    }
+
+    template<> template<>
+    void llvolumefaceshare_object::test<2>()
+    {
+        set_test_name("different content gets different blocks");
+
+        LLVolumeFace a, b, c;
+        make_face(a, 40, 1.f, false);
+        make_face(b, 40, 2.f, false);
+        make_face(c, 40, 1.f, false);
+        c.mIndices[3] = 5; // same attributes, different triangles
+
+        std::vector<LLVolumeFace> copies(4);
+        copies[0].copyWithSharedData(a, mMeshID);
+        copies[1].copyWithSharedData(b, mMeshID);
+        copies[2].copyWithSharedData(c, mMeshID);
+        copies[3].copyWithSharedData(a, LLUUID::null);
+
+        ensure_equals("three blocks", numBlocks(), 3);
+        ensure("a", same_face(copies[0], a));
+        ensure("b", same_face(copies[1], b));
+        ensure("c", same_face(copies[2], c));
+        ensure("identical content from another mesh shares", copies[3].mIndices == copies[0].mIndices);
+
+        // copying over a shared face releases what it shared before
+        copies[2].copyWithSharedData(a, mMeshID);
+        ensure_equals("c released", numBlocks(), 2);
+        ensure("recopied", same_face(copies[2], a));
+    }
+
+    template<> template<>
+    void llvolumefaceshare_object::test<3>()
+    {
+        set_test_name("writes go to a private copy");
+
+        LLVolumeFace src;
+        make_face(src, 64, 3.f, true);
+        LLVolumeFace expected(src);
+
+        LLVolumeFace first, second;
+        first.copyWithSharedData(src, mMeshID);
+        second.copyWithSharedData(src, mMeshID);
+
+        first.mPositions[2].set(9.f, 9.f, 9.f); // positions are always private
+        first.pushIndex(0);
+        first.pushIndex(1);
+        first.pushIndex(2);
+        ensure("pushIndex unshares", !first.hasSharedData());
+        ensure_equals("indices kept", first.mNumIndices, expected.mNumIndices + 3);
+        ensure("old indices kept", !memcmp(first.mIndices, expected.mIndices, expected.mNumIndices * sizeof(U16)));
+        ensure("normals kept", !memcmp(first.mNormals, expected.mNormals, expected.mNumVertices * sizeof(LLVector4a)));
+        ensure("tangents kept", !memcmp(first.mTangents, expected.mTangents, expected.mNumVertices * sizeof(LLVector4a)));
+        ensure("position kept", first.mPositions[2].equals3(LLVector4a(9.f, 9.f, 9.f)));
+
+        first.mNormals[0].set(0.f, 0.f, -1.f);
+        ensure("other copy untouched", same_face(second, expected));
+        ensure("source untouched", same_face(src, expected));
+        ensure("still shared", second.hasSharedData());
+
+        // a plain copy of a shared face owns its data
+        LLVolumeFace third(second);
+        ensure("copy owns", !third.hasSharedData());
+        ensure("copy content", same_face(third, expected));
+
+        second.resizeVertices(10);
+        ensure("resize unshares", !second.hasSharedData());
+        ensure_equals("resize keeps indices", second.mNumIndices, expected.mNumIndices);
+        ensure("indices intact", !memcmp(second.mIndices, expected.mIndices, expected.mNumIndices * sizeof(U16)));
+        ensure_equals("released", numBlocks(), 0);
+    }
+}
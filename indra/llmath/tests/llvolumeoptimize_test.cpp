@@ -0,0 +1,311 @@
+/**
+ * @file llvolumeoptimize_test.cpp
+ * @brief LLVolumeFace::optimize() test cases.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llvolume.h"
+#include "llrand.h"
+#include "lltimer.h"
+#include "stringize.h"
+
+#include "../test/lltut.h"
+
+#include <map>
+#include <vector>
+
+namespace
+{
+    // the welder LLVolumeFace::optimize() used to run, kept as the
+    // reference the current one has to match index for index
+    void legacy_optimize(LLVolumeFace& face, F32 angle_cutoff)
+    {
+        LLVolumeFace new_face;
+
+        std::map<U64, std::vector<LLVolumeFace::VertexMapData> > point_map;
+
+        LLVector4a range;
+        range.setSub(face.mExtents[1], face.mExtents[0]);
+
+        for (S32 i = 0; i < face.mNumIndices; ++i)
+        {
+            U16 index = face.mIndices[i];
+
+            if (index >= face.mNumVertices)
+            {
+                index = face.mNumVertices - 1;
+                face.mIndices[i] = index;
+            }
+
+            LLVolumeFace::VertexData cv;
+            face.getVertexData(index, cv);
+
+            bool found = false;
+
+            LLVector4a pos;
+            pos.setSub(face.mPositions[index], face.mExtents[0]);
+            pos.div(range);
+
+            U64 pos64 = 0;
+
+            pos64 = (U16) (pos[0]*65535);
+            pos64 = pos64 | (((U64) (pos[1]*65535)) << 16);
+            pos64 = pos64 | (((U64) (pos[2]*65535)) << 32);
+
+            auto point_iter = point_map.find(pos64);
+
+            if (point_iter != point_map.end())
+            {
+                for (U32 j = 0; j < point_iter->second.size(); ++j)
+                {
+                    LLVolumeFace::VertexData& tv = (point_iter->second)[j];
+                    if (tv.compareNormal(cv, angle_cutoff))
+                    {
+                        found = true;
+                        new_face.pushIndex((point_iter->second)[j].mIndex);
+                        break;
+                    }
+                }
+            }
+
+            if (!found)
+            {
+                new_face.pushVertex(cv);
+                U16 index = (U16) new_face.mNumVertices-1;
+                new_face.pushIndex(index);
+
+                LLVolumeFace::VertexMapData d;
+                d.setPosition(cv.getPosition());
+                d.mTexCoord = cv.mTexCoord;
+                d.setNormal(cv.getNormal());
+                d.mIndex = index;
+                if (point_iter != point_map.end())
+                {
+                    point_iter->second.push_back(d);
+                }
+                else
+                {
+                    point_map[pos64].push_back(d);
+                }
+            }
+        }
+
+        if (new_face.mNumVertices <= face.mNumVertices)
+        {
+            face.swapData(new_face);
+        }
+    }
+
+    enum MeshKind
+    {
+        SMOOTH,         // shared normals and uvs, welds back into a grid
+        FLAT,           // a normal per triangle
+        UV_SEAMS,       // uvs jump every few quads
+        JITTER,         // positions moved by less than the weld epsilon
+        NOISY_NORMALS,  // normals a few degrees apart
+        BAD_INDICES,    // a few indices past the last vertex
+        NUM_KINDS
+    };
+
+    // the unwelded triangles of a (res x res) height field, three vertices
+    // per triangle the way a model comes out of the importer
+    void make_soup(LLVolumeFace& face, U32 res, U32 kind)
+    {
+        const U32 num_triangles = (res - 1) * (res - 1) * 2;
+        face.resizeVertices(num_triangles * 3);
+        face.resizeIndices(num_triangles * 3);
+
+        auto grid_point = [res](U32 x, U32 y, LLVector4a& pos, LLVector4a& normal, LLVector2& tc)
+        {
+            F32 fx = (F32)x / (res - 1) - 0.5f;
+            F32 fy = (F32)y / (res - 1) - 0.5f;
+            pos.set(fx, fy, 0.1f * sinf(fx * 12.f) * cosf(fy * 9.f));
+            normal.set(-cosf(fx * 12.f) * cosf(fy * 9.f), sinf(fx * 12.f) * sinf(fy * 9.f), 1.f);
+            normal.normalize3fast();
+            tc.set(fx + 0.5f, fy + 0.5f);
+        };
+
+        S32 v = 0;
+        for (U32 y = 0; y < res - 1; ++y)
+        {
+            for (U32 x = 0; x < res - 1; ++x)
+            {
+                const U32 corners[2][3][2] = { { { x, y }, { x + 1, y }, { x + 1, y + 1 } },
+                                               { { x, y }, { x + 1, y + 1 }, { x, y + 1 } } };
+                for (U32 t = 0; t < 2; ++t)
+                {
+                    LLVector4a flat_normal;
+                    flat_normal.set(ll_frand(2.f) - 1.f, ll_frand(2.f) - 1.f, 1.f);
+                    flat_normal.normalize3fast();
+
+                    for (U32 c = 0; c < 3; ++c, ++v)
+                    {
+                        LLVector4a& pos = face.mPositions[v];
+                        LLVector4a& normal = face.mNormals[v];
+                        LLVector2& tc = face.mTexCoords[v];
+                        grid_point(corners[t][c][0], corners[t][c][1], pos, normal, tc);
+
+                        switch (kind)
+                        {
+                        case FLAT:
+                            normal = flat_normal;
+                            break;
+                        case UV_SEAMS:
+                            tc.mV[0] += (F32)((x / 4) % 2);
+                            break;
+                        case JITTER:
+                        {
+                            LLVector4a offset;
+                            offset.set(ll_frand(8e-6f) - 4e-6f, ll_frand(8e-6f) - 4e-6f, ll_frand(8e-6f) - 4e-6f);
+                            pos.add(offset);
+                            break;
+                        }
+                        case NOISY_NORMALS:
+                        {
+                            LLVector4a offset;
+                            offset.set(ll_frand(0.2f) - 0.1f, ll_frand(0.2f) - 0.1f, 0.f);
+                            normal.add(offset);
+                            normal.normalize3fast();
+                            break;
+                        }
+                        default:
+                            break;
+                        }
+
+                        face.mIndices[v] = (U16)v;
+                    }
+                }
+            }
+        }
+
+        if (kind == BAD_INDICES)
+        {
+            for (S32 i = 0; i < face.mNumIndices; i += 97)
+            {
+                face.mIndices[i] = (U16)(face.mNumVertices + i % 5);
+            }
+        }
+
+        face.mExtents[0].set(-0.5f, -0.5f, -0.1f);
+        face.mExtents[1].set(0.5f, 0.5f, 0.1f);
+    }
+
+    bool same_face(const LLVolumeFace& a, const LLVolumeFace& b)
+    {
+        return a.mNumVertices == b.mNumVertices && a.mNumIndices == b.mNumIndices &&
+               !memcmp(a.mIndices, b.mIndices, a.mNumIndices * sizeof(U16)) &&
+               !memcmp(a.mPositions, b.mPositions, a.mNumVertices * sizeof(LLVector4a)) &&
+               !memcmp(a.mNormals, b.mNormals, a.mNumVertices * sizeof(LLVector4a)) &&
+               !memcmp(a.mTexCoords, b.mTexCoords, a.mNumVertices * sizeof(LLVector2));
+    }
+}
+
+namespace tut
+{
+    struct llvolumeoptimize_data
+    {
+    };
+    typedef test_group<llvolumeoptimize_data> llvolumeoptimize_test;
+    typedef llvolumeoptimize_test::object llvolumeoptimize_object;
+    tut::llvolumeoptimize_test tllvolumeoptimize("LLVolumeFaceOptimize");
+
+    template<> template<>
+    void llvolumeoptimize_object::test<1>()
+    {
+        set_test_name("optimize matches the ordered map welder");
+
+        const F32 cutoffs[] = { 2.f, cosf(10.f * DEG_TO_RAD), cosf(60.f * DEG_TO_RAD) };
+        const U32 sizes[] = { 2, 3, 17, 40 };
+        for (U32 res : sizes)
+        {
+            for (U32 kind = 0; kind < NUM_KINDS; ++kind)
+            {
+                for (F32 cutoff : cutoffs)
+                {
+                    LLVolumeFace expected;
+                    make_soup(expected, res, kind);
+                    LLVolumeFace face(expected);
+
+                    legacy_optimize(expected, cutoff);
+                    face.optimize(cutoff);
+
+                    ensure(STRINGIZE("res " << res << " kind " << kind << " cutoff " << cutoff), same_face(face, expected));
+                }
+            }
+        }
+    }
+
+    template<> template<>
+    void llvolumeoptimize_object::test<2>()
+    {
+        set_test_name("optimize welds shared corners");
+
+        LLVolumeFace face;
+        make_soup(face, 17, SMOOTH);
+        face.optimize();
+
+        ensure_equals("one vertex per grid point", face.mNumVertices, 17 * 17);
+        ensure_equals("indices kept", face.mNumIndices, 16 * 16 * 6);
+    }
+
+#if LL_BENCHMARK
+    template<> template<>
+    void llvolumeoptimize_object::test<3>()
+    {
+        set_test_name("ordered map and hashed welder time per face");
+
+        // 104 x 104 grids make 63654 unwelded vertices, about the most a
+        // face's 16 bit indices allow
+        const U32 runs = 4;
+        for (U32 kind : { (U32)SMOOTH, (U32)FLAT, (U32)NOISY_NORMALS })
+        {
+            std::vector<LLVolumeFace> faces(runs);
+            for (LLVolumeFace& face : faces)
+            {
+                make_soup(face, 104, kind);
+            }
+            std::vector<LLVolumeFace> legacy_faces(faces);
+
+            LLTimer timer;
+            for (LLVolumeFace& face : legacy_faces)
+            {
+                legacy_optimize(face, 2.f);
+            }
+            F64 legacy_time = timer.getElapsedTimeF64() / runs;
+
+            timer.reset();
+            for (LLVolumeFace& face : faces)
+            {
+                face.optimize(2.f);
+            }
+            F64 hashed_time = timer.getElapsedTimeF64() / runs;
+
+            LL_INFOS() << "mesh kind " << kind << ", " << legacy_faces[0].mNumIndices << " indices to "
+                       << faces[0].mNumVertices << " vertices: ordered map " << legacy_time * 1000.0
+                       << " ms, hashed " << hashed_time * 1000.0 << " ms" << LL_ENDL;
+        }
+    }
+#endif // LL_BENCHMARK
+}
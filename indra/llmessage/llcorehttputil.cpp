@@ -105,10 +105,14 @@ private:
 
 
 //=========================================================================
+// Smaller replies gain too little from an arena to be worth it, see
+// responseToLLSD() and LLSDParser::setUseArena().
+static const size_t LLSD_ARENA_BODY_SIZE = 256 * 1024;
+
 // *TODO:  Currently converts only from XML content.  A mode
 // to convert using fromBinary() might be useful as well.  Mesh
 // headers could use it.
-bool responseToLLSD(HttpResponse * response, bool log, LLSD & out_llsd)
+bool responseToLLSD(HttpResponse * response, bool log, LLSD & out_llsd, bool use_arena)
 {
     // Convert response to LLSD
     BufferArray * body(response->getBody());
@@ -119,7 +123,9 @@ bool responseToLLSD(HttpResponse * response, bool log, LLSD & out_llsd)
 
     LLCore::BufferArrayStream bas(body);
     LLSD body_llsd;
-    S32 parse_status(LLSDSerialize::fromXML(body_llsd, bas, log));
+    LLPointer<LLSDXMLParser> parser = new LLSDXMLParser(log);
+    parser->setUseArena(use_arena && body->size() >= LLSD_ARENA_BODY_SIZE);
+    S32 parse_status(parser->parse(bas, body_llsd, LLSDSerialize::SIZE_UNLIMITED));
     if (LLSDParser::PARSE_FAILURE == parse_status){
         return false;
     }
@@ -82,13 +82,18 @@ extern const F32 HTTP_REQUEST_EXPIRY_SECS;
 ///                     Otherwise, it *should* be a quiet parse.
 /// @arg    out_llsd    Output LLSD object written only upon
 ///                     successful parse of the response object.
+/// @arg    use_arena   If true, a large body is parsed into a
+///                     per-document arena.  Only for callers that
+///                     consume the result and drop it as a whole:
+///                     any value kept from it keeps the arena alive.
 ///
 /// @return             Returns true (and writes to out_llsd) if
 ///                     parse was successful.  False otherwise.
 ///
 bool responseToLLSD(LLCore::HttpResponse * response,
                     bool log,
-                    LLSD & out_llsd);
+                    LLSD & out_llsd,
+                    bool use_arena = false);
 
 /// Create a std::string representation of a response object
 /// suitable for logging.  Mainly intended for logging of
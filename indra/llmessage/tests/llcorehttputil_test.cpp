@@ -0,0 +1,110 @@
+/**
+ * @file llcorehttputil_test.cpp
+ * @brief LLCoreHttpUtil response parsing test cases.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llcorehttputil.h"
+
+#include "bufferarray.h"
+#include "httpresponse.h"
+#include "llsdserialize.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+    struct corehttputil_data
+    {
+        // An XML reply large enough to be parsed into an arena if asked
+        LLCore::HttpResponse* makeResponse()
+        {
+            LLSD items;
+            for (S32 i = 0; i < 2000; ++i)
+            {
+                LLSD item;
+                item["item_id"] = LLUUID::generateNewID();
+                item["name"] = llformat("Inventory item %d", i);
+                item["type"] = i % 8;
+                item["desc"] = "(No Description)";
+                items.append(item);
+            }
+
+            std::ostringstream ostr;
+            LLSDSerialize::toXML(items, ostr);
+            const std::string xml = ostr.str();
+            ensure("body is large", xml.size() >= 256 * 1024);
+
+            LLCore::BufferArray* body = new LLCore::BufferArray;
+            body->append(xml.data(), xml.size());
+            LLCore::HttpResponse* response = new LLCore::HttpResponse;
+            response->setBody(body);
+            body->release();
+            return response;
+        }
+    };
+    typedef test_group<corehttputil_data> corehttputil_test;
+    typedef corehttputil_test::object corehttputil_object;
+    tut::corehttputil_test corehttputil_testcase("LLCoreHttpUtil");
+
+    template<> template<>
+    void corehttputil_object::test<1>()
+        // a value kept from a default parse holds no arena
+    {
+        const U32 blocks_before = llsd::arenaBlockCount();
+        LLCore::HttpResponse* response = makeResponse();
+
+        LLSD parsed;
+        ensure("parsed", LLCoreHttpUtil::responseToLLSD(response, false, parsed));
+        response->release();
+        ensure_equals("no arena blocks", llsd::arenaBlockCount(), blocks_before);
+
+        LLSD kept = parsed[42];
+        parsed.clear();
+        ensure_equals("kept value intact", kept["name"].asString(), std::string("Inventory item 42"));
+        ensure_equals("nothing pinned", llsd::arenaBlockCount(), blocks_before);
+    }
+
+    template<> template<>
+    void corehttputil_object::test<2>()
+        // an arena parse pins its blocks only while a value from it is kept
+    {
+        const U32 blocks_before = llsd::arenaBlockCount();
+        LLCore::HttpResponse* response = makeResponse();
+
+        LLSD parsed;
+        ensure("parsed", LLCoreHttpUtil::responseToLLSD(response, false, parsed, true));
+        response->release();
+        ensure("arena parse took blocks", llsd::arenaBlockCount() > blocks_before);
+
+        LLSD kept = parsed[42];
+        parsed.clear();
+        ensure("kept value pins the arena", llsd::arenaBlockCount() > blocks_before);
+        ensure_equals("kept value intact", kept["type"].asInteger(), 42 % 8);
+
+        kept.clear();
+        ensure_equals("blocks released", llsd::arenaBlockCount(), blocks_before);
+    }
+}
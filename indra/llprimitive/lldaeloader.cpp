@@ -56,6 +56,7 @@
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/type_ptr.hpp"
 #include "llmatrix4a.h"
+#include "parallelfor.h"
 
 #include <boost/regex.hpp>
 #include <boost/algorithm/string/replace.hpp>
@@ -1107,23 +1108,55 @@ bool LLDAELoader::OpenFile(const std::string& filename)
     mTransform.condition();
 
     U32 submodel_limit = count > 0 ? mGeneratedModelLimit/count : 0;
-    for (daeInt idx = 0; idx < count; ++idx)
-    { //build map of domEntities to LLModel
-        domMesh* mesh = NULL;
-        db->getElement((daeElement**) &mesh, idx, NULL, COLLADA_TYPE_MESH);
-
-        if (mesh)
-        {
 
-            std::vector<LLModel*> models;
+    // Reading faces out of the DOM has to stay on this thread, collada
+    // resolves references lazily and isn't thread safe. Normalizing,
+    // splitting and remapping only touch each mesh's own models, so they are
+    // spread over the parallel pool. Meshes go through both steps a batch at
+    // a time, so a big import doesn't hold every unsplit mesh at once.
+    const size_t batch_size = 32;
+    std::vector<domMesh*> meshes;
+    std::vector<LLModel*> loaded;
+    std::vector<std::string> model_names;
+    std::vector<model_list> split;
+    meshes.reserve(batch_size);
+    loaded.reserve(batch_size);
+    model_names.reserve(batch_size);
+    for (daeInt idx = 0; idx < count; )
+    {
+        meshes.clear();
+        loaded.clear();
+        model_names.clear();
+        for (; idx < count && meshes.size() < batch_size; ++idx)
+        {
+            domMesh* mesh = NULL;
+            db->getElement((daeElement**) &mesh, idx, NULL, COLLADA_TYPE_MESH);
+
+            if (mesh)
+            {
+                meshes.push_back(mesh);
+                loaded.push_back(loadModelFromDomMesh(mesh));
+                model_names.push_back(getLodlessLabel(mesh));
+            }
+        }
 
-            loadModelsFromDomMesh(mesh, models, submodel_limit);
+        split.clear();
+        split.resize(meshes.size());
+        LL::parallel_for(meshes.size(), 1,
+            [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    splitModel(loaded[i], model_names[i], split[i], submodel_limit);
+                }
+            });
 
-            std::vector<LLModel*>::iterator i;
-            i = models.begin();
-            while (i != models.end())
+        // build map of domEntities to LLModel, in document order whatever
+        // order the meshes finished in
+        for (size_t i = 0; i < meshes.size(); ++i)
+        {
+            for (LLModel* mdl : split[i])
             {
-                LLModel* mdl = *i;
                 if(mdl->getStatus() != LLModel::NO_ERRORS)
                 {
                     setLoadState(ERROR_MODEL + mdl->getStatus()) ;
@@ -1133,9 +1166,8 @@ bool LLDAELoader::OpenFile(const std::string& filename)
                 if (mdl && validate_model(mdl))
                 {
                     mModelList.push_back(mdl);
-                    mModelsMap[mesh].push_back(mdl);
+                    mModelsMap[meshes[i]].push_back(mdl);
                 }
-                i++;
             }
         }
     }
@@ -2622,17 +2654,13 @@ bool LLDAELoader::addVolumeFacesFromDomMesh(LLModel* pModel,domMesh* mesh, LLSD&
     return (status == LLModel::NO_ERRORS);
 }
 
-//static diff version supports creating multiple models when material counts spill
-// over the 8 face server-side limit
-//
-bool LLDAELoader::loadModelsFromDomMesh(domMesh* mesh, std::vector<LLModel*>& models_out, U32 submodel_limit)
+LLModel* LLDAELoader::loadModelFromDomMesh(domMesh* mesh)
 {
+    LL_PROFILE_ZONE_SCOPED;
 
     LLVolumeParams volume_params;
     volume_params.setType(LL_PCODE_PROFILE_SQUARE, LL_PCODE_PATH_LINE);
 
-    models_out.clear();
-
     LLModel* ret = new LLModel(volume_params, 0.f);
 
     std::string model_name = getLodlessLabel(mesh);
@@ -2657,6 +2685,21 @@ bool LLDAELoader::loadModelsFromDomMesh(domMesh* mesh, std::vector<LLModel*>& mo
     //
     addVolumeFacesFromDomMesh(ret, mesh, mWarningsArray);
 
+    return ret;
+}
+
+//static diff version supports creating multiple models when material counts spill
+// over the 8 face server-side limit
+//
+void LLDAELoader::splitModel(LLModel* ret, const std::string& model_name, model_list& models_out, U32 submodel_limit) const
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    LLVolumeParams volume_params;
+    volume_params.setType(LL_PCODE_PROFILE_SQUARE, LL_PCODE_PATH_LINE);
+
+    models_out.clear();
+
     U32 volume_faces = ret->getNumVolumeFaces();
 
     // Side-steps all manner of issues when splitting models
@@ -2723,6 +2766,4 @@ bool LLDAELoader::loadModelsFromDomMesh(domMesh* mesh, std::vector<LLModel*>& mo
         remainder.clear();
 
     } while (volume_faces);
-
-    return true;
 }
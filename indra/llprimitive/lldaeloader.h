@@ -97,10 +97,17 @@ protected:
 
     static bool addVolumeFacesFromDomMesh(LLModel* model, domMesh* mesh, LLSD& log_msg);
 
-    // Loads a mesh breaking it into one or more models as necessary
-    // to get around volume face limitations while retaining >8 materials
+    // Reads all the faces of a mesh into a new model. Goes through the DOM,
+    // so it has to run on the loading thread.
     //
-    bool loadModelsFromDomMesh(domMesh* mesh, std::vector<LLModel*>& models_out, U32 submodel_limit);
+    LLModel* loadModelFromDomMesh(domMesh* mesh);
+
+    // Normalizes a loaded model and breaks it into one or more models named
+    // after model_name, as necessary to get around volume face limitations
+    // while retaining >8 materials. Touches nothing but the model, so meshes
+    // can be split in parallel.
+    //
+    void splitModel(LLModel* model, const std::string& model_name, model_list& models_out, U32 submodel_limit) const;
 
     static std::string getElementLabel(daeElement *element);
     static size_t getSuffixPosition(std::string label);
@@ -0,0 +1,289 @@
+/**
+ * @file lldaeloader_test.cpp
+ * @brief LLDAELoader and model processing serial vs. parallel test cases.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../lldaeloader.h"
+
+#include "llfile.h"
+#include "llmeshoptimizer.h"
+#include "llmodel.h"
+#include "namedtempfile.h"
+#include "parallelfor.h"
+#include "stringize.h"
+#include "threadpool.h"
+
+#include "../test/lltut.h"
+
+#include <cmath>
+
+namespace
+{
+    const U32 NUM_MESHES = 40;
+    const U32 GRID = 6; // vertices per side of each material's patch
+
+    // materials of mesh m, some meshes have more than the 8 faces a model
+    // can hold and get split
+    U32 material_count(U32 m)
+    {
+        return 1 + (m * 3) % 11;
+    }
+
+    // A COLLADA document with NUM_MESHES meshes, each a row of bumpy grid
+    // patches, one per material.
+    std::string make_dae()
+    {
+        std::ostringstream out;
+        out << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+               "<COLLADA xmlns=\"http://www.collada.org/2005/11/COLLADASchema\" version=\"1.4.1\">\n"
+               "<asset><unit name=\"meter\" meter=\"1\"/><up_axis>Z_UP</up_axis></asset>\n";
+
+        const U32 max_materials = 11;
+        out << "<library_effects>\n";
+        for (U32 j = 0; j < max_materials; ++j)
+        {
+            out << "<effect id=\"effect" << j << "\"><profile_COMMON><technique sid=\"common\"><lambert><diffuse><color>"
+                << (j % 3) * 0.5f << " " << (j % 2) << " " << j / 11.f << " 1</color></diffuse></lambert></technique>"
+                   "</profile_COMMON></effect>\n";
+        }
+        out << "</library_effects>\n<library_materials>\n";
+        for (U32 j = 0; j < max_materials; ++j)
+        {
+            out << "<material id=\"material" << j << "\" name=\"material" << j << "\"><instance_effect url=\"#effect" << j
+                << "\"/></material>\n";
+        }
+        out << "</library_materials>\n<library_geometries>\n";
+
+        for (U32 m = 0; m < NUM_MESHES; ++m)
+        {
+            const U32 materials = material_count(m);
+            const U32 verts = materials * GRID * GRID;
+            std::ostringstream pos, norm, uv;
+            for (U32 j = 0; j < materials; ++j)
+            {
+                for (U32 y = 0; y < GRID; ++y)
+                {
+                    for (U32 x = 0; x < GRID; ++x)
+                    {
+                        const F32 fx = j + (F32)x / (GRID - 1);
+                        const F32 fy = (F32)y / (GRID - 1);
+                        pos << fx << " " << fy << " " << 0.1f * sinf(fx * 3.f + m) * cosf(fy * 2.f) << " ";
+                        norm << "0 0 1 ";
+                        uv << (F32)x / (GRID - 1) << " " << fy << " ";
+                    }
+                }
+            }
+
+            out << "<geometry id=\"geom" << m << "\" name=\"part" << m << "\"><mesh>\n"
+                << "<source id=\"geom" << m << "-pos\"><float_array id=\"geom" << m << "-pos-array\" count=\"" << verts * 3
+                << "\">" << pos.str() << "</float_array><technique_common><accessor source=\"#geom" << m
+                << "-pos-array\" count=\"" << verts << "\" stride=\"3\"><param name=\"X\" type=\"float\"/>"
+                   "<param name=\"Y\" type=\"float\"/><param name=\"Z\" type=\"float\"/></accessor></technique_common></source>\n"
+                << "<source id=\"geom" << m << "-norm\"><float_array id=\"geom" << m << "-norm-array\" count=\"" << verts * 3
+                << "\">" << norm.str() << "</float_array><technique_common><accessor source=\"#geom" << m
+                << "-norm-array\" count=\"" << verts << "\" stride=\"3\"><param name=\"X\" type=\"float\"/>"
+                   "<param name=\"Y\" type=\"float\"/><param name=\"Z\" type=\"float\"/></accessor></technique_common></source>\n"
+                << "<source id=\"geom" << m << "-uv\"><float_array id=\"geom" << m << "-uv-array\" count=\"" << verts * 2
+                << "\">" << uv.str() << "</float_array><technique_common><accessor source=\"#geom" << m
+                << "-uv-array\" count=\"" << verts << "\" stride=\"2\"><param name=\"S\" type=\"float\"/>"
+                   "<param name=\"T\" type=\"float\"/></accessor></technique_common></source>\n"
+                << "<vertices id=\"geom" << m << "-verts\"><input semantic=\"POSITION\" source=\"#geom" << m << "-pos\"/></vertices>\n";
+
+            for (U32 j = 0; j < materials; ++j)
+            {
+                out << "<triangles material=\"material" << j << "\" count=\"" << (GRID - 1) * (GRID - 1) * 2 << "\">"
+                    << "<input semantic=\"VERTEX\" source=\"#geom" << m << "-verts\" offset=\"0\"/>"
+                    << "<input semantic=\"NORMAL\" source=\"#geom" << m << "-norm\" offset=\"1\"/>"
+                    << "<input semantic=\"TEXCOORD\" source=\"#geom" << m << "-uv\" offset=\"2\" set=\"0\"/><p>";
+                const U32 base = j * GRID * GRID;
+                for (U32 y = 0; y + 1 < GRID; ++y)
+                {
+                    for (U32 x = 0; x + 1 < GRID; ++x)
+                    {
+                        const U32 v0 = base + y * GRID + x;
+                        const U32 corners[] = { v0, v0 + 1, v0 + GRID + 1, v0, v0 + GRID + 1, v0 + GRID };
+                        for (U32 v : corners)
+                        {
+                            out << v << " " << v << " " << v << " ";
+                        }
+                    }
+                }
+                out << "</p></triangles>\n";
+            }
+            out << "</mesh></geometry>\n";
+        }
+
+        out << "</library_geometries>\n<library_visual_scenes><visual_scene id=\"Scene\" name=\"Scene\">\n";
+        for (U32 m = 0; m < NUM_MESHES; ++m)
+        {
+            out << "<node id=\"node" << m << "\" name=\"part" << m << "\"><matrix>1 0 0 " << m * 12 << " 0 1 0 0 0 0 1 0 0 0 0 1</matrix>"
+                << "<instance_geometry url=\"#geom" << m << "\"><bind_material><technique_common>";
+            for (U32 j = 0; j < material_count(m); ++j)
+            {
+                out << "<instance_material symbol=\"material" << j << "\" target=\"#material" << j << "\"/>";
+            }
+            out << "</technique_common></bind_material></instance_geometry></node>\n";
+        }
+        out << "</visual_scene></library_visual_scenes>\n"
+               "<scene><instance_visual_scene url=\"#Scene\"/></scene>\n</COLLADA>\n";
+        return out.str();
+    }
+
+    void ensure_same_face(const std::string& msg, const LLVolumeFace& a, const LLVolumeFace& b)
+    {
+        tut::ensure_equals(msg + " vertices", a.mNumVertices, b.mNumVertices);
+        tut::ensure_equals(msg + " indices", a.mNumIndices, b.mNumIndices);
+        tut::ensure(msg + " positions", !memcmp(a.mPositions, b.mPositions, a.mNumVertices * sizeof(LLVector4a)));
+        tut::ensure(msg + " normals", !memcmp(a.mNormals, b.mNormals, a.mNumVertices * sizeof(LLVector4a)));
+        tut::ensure(msg + " texture coordinates", !memcmp(a.mTexCoords, b.mTexCoords, a.mNumVertices * sizeof(LLVector2)));
+        tut::ensure(msg + " index data", !memcmp(a.mIndices, b.mIndices, a.mNumIndices * sizeof(U16)));
+    }
+
+    void ensure_same_models(const LLModelLoader::model_list& a, const LLModelLoader::model_list& b)
+    {
+        tut::ensure_equals("model count", a.size(), b.size());
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            const std::string msg = STRINGIZE("model " << i << " (" << a[i]->mLabel << ")");
+            tut::ensure_equals(msg + " label", a[i]->mLabel, b[i]->mLabel);
+            tut::ensure_equals(msg + " submodel", a[i]->mSubmodelID, b[i]->mSubmodelID);
+            tut::ensure(msg + " materials", a[i]->mMaterialList == b[i]->mMaterialList);
+            tut::ensure_equals(msg + " faces", a[i]->getNumVolumeFaces(), b[i]->getNumVolumeFaces());
+            for (S32 f = 0; f < a[i]->getNumVolumeFaces(); ++f)
+            {
+                ensure_same_face(STRINGIZE(msg << " face " << f), a[i]->getVolumeFace(f), b[i]->getVolumeFace(f));
+            }
+        }
+    }
+}
+
+namespace tut
+{
+    struct lldaeloader_data
+    {
+        std::string mFilename;
+
+        lldaeloader_data()
+        :   mFilename(NamedTempFile::temp_path("lldaeloader", ".dae").string())
+        {
+            llofstream out(mFilename.c_str());
+            out << make_dae();
+        }
+
+        ~lldaeloader_data()
+        {
+            LLFile::remove(mFilename);
+        }
+
+        // Loads the document like the upload floater does, splitting the
+        // meshes on the parallel pool if one is running.
+        void load(LLModelLoader::model_list& models)
+        {
+            JointTransformMap joint_transforms;
+            JointNameSet joints_from_nodes;
+            std::map<std::string, std::string> joint_aliases;
+            LODSuffixArray lod_suffix;
+            LLDAELoader loader(mFilename, LLModel::LOD_HIGH,
+                               LLModelLoader::load_callback_t(),
+                               LLModelLoader::joint_lookup_func_t(),
+                               LLModelLoader::texture_load_func_t(),
+                               [](U32, void*) {},
+                               NULL, joint_transforms, joints_from_nodes, joint_aliases, 110, 768, false, lod_suffix);
+            ensure("document loaded", loader.OpenFile(mFilename));
+            models = loader.mModelList;
+        }
+    };
+    typedef test_group<lldaeloader_data> lldaeloader_test;
+    typedef lldaeloader_test::object lldaeloader_object;
+    tut::lldaeloader_test tlldaeloader("LLDAELoader");
+
+    template<> template<>
+    void lldaeloader_object::test<1>()
+    {
+        set_test_name("meshes split in parallel come out like serial ones");
+
+        // without a pool parallel_for() runs everything on this thread
+        LLModelLoader::model_list serial;
+        load(serial);
+        ensure("meshes were split", serial.size() > NUM_MESHES);
+
+        LL::ThreadPool pool(LL::PARALLEL_POOL_NAME, 3);
+        pool.start();
+        LLModelLoader::model_list parallel;
+        load(parallel);
+
+        ensure_same_models(serial, parallel);
+    }
+
+    template<> template<>
+    void lldaeloader_object::test<2>()
+    {
+        set_test_name("normals and LODs generated in parallel come out like serial ones");
+
+        LLModelLoader::model_list serial, parallel;
+        load(serial);
+        load(parallel);
+
+        // what LLModelPreview::generateNormals() and the meshoptimizer LOD
+        // pass do to each model
+        const F32 angle_cutoff = 75.f * DEG_TO_RAD;
+        auto process = [angle_cutoff](LLModel* model, std::vector<std::vector<U16>>& lods)
+        {
+            model->generateNormals(angle_cutoff);
+            for (S32 f = 0; f < model->getNumVolumeFaces(); ++f)
+            {
+                const LLVolumeFace& face = model->getVolumeFace(f);
+                std::vector<U16> lod(face.mNumIndices);
+                F32 error = 0.f;
+                U64 count = LLMeshOptimizer::simplify(lod.data(), face.mIndices, face.mNumIndices, face.mPositions,
+                                                      face.mNumVertices, sizeof(LLVector4a), face.mNumIndices / 2, 0.01f,
+                                                      false, &error);
+                lod.resize(count);
+                lods.push_back(lod);
+            }
+        };
+
+        std::vector<std::vector<std::vector<U16>>> serial_lods(serial.size()), parallel_lods(parallel.size());
+        for (size_t i = 0; i < serial.size(); ++i)
+        {
+            process(serial[i], serial_lods[i]);
+        }
+
+        LL::ThreadPool pool(LL::PARALLEL_POOL_NAME, 3);
+        pool.start();
+        LL::parallel_for(parallel.size(), 1,
+            [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    process(parallel[i], parallel_lods[i]);
+                }
+            });
+
+        ensure_same_models(serial, parallel);
+        ensure("lods", serial_lods == parallel_lods);
+    }
+}
@@ -34,6 +34,7 @@
 #include "llerror.h"
 #include "llfasttimer.h"
 #include "llimage.h"
+#include "llimagealpha.h"
 
 #include "llmath.h"
 #include "llgl.h"
@@ -541,6 +542,7 @@ void LLImageGL::init(bool usemipmaps, bool allow_compression)
     mNeedsAlphaAndPickMask = true ;
     mAlphaStride = 0 ;
     mAlphaOffset = 0 ;
+    mRawAlphaInfo = NULL;
 
     mGLTextureCreated = false ;
     mTexName = 0;
@@ -735,7 +737,9 @@ void LLImageGL::setImage(const LLImageRaw* imageraw)
              (imageraw->getHeight() == getHeight(mCurrentDiscardLevel)) &&
              (imageraw->getComponents() == getComponents()));
     const U8* rawdata = imageraw->getData();
+    mRawAlphaInfo = imageraw->getAlphaInfo();
     setImage(rawdata, false);
+    mRawAlphaInfo = NULL;
 }
 
 bool LLImageGL::setImage(const U8* data_in, bool data_hasmips /* = false */, S32 usename /* = 0 */)
@@ -1613,7 +1617,10 @@ bool LLImageGL::createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S
 
     setCategory(category);
     const U8* rawdata = imageraw->getData();
-    return createGLTexture(discard_level, rawdata, false, usename, defer_copy, tex_name);
+    mRawAlphaInfo = imageraw->getAlphaInfo();
+    bool res = createGLTexture(discard_level, rawdata, false, usename, defer_copy, tex_name);
+    mRawAlphaInfo = NULL;
+    return res;
 }
 
 bool LLImageGL::createGLTexture(S32 discard_level, const U8* data_in, bool data_hasmips, S32 usename, bool defer_copy, LLGLuint* tex_name)
@@ -2169,97 +2176,27 @@ void LLImageGL::analyzeAlpha(const void* data_in, U32 w, U32 h)
 
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
 
-    U32 length = w * h;
-    U32 alphatotal = 0;
-
-    U32 sample[16];
-    memset(sample, 0, sizeof(U32)*16);
-
-    // generate histogram of quantized alpha.
-    // also add-in the histogram of a 2x2 box-sampled version.  The idea is
-    // this will mid-skew the data (and thus increase the chances of not
-    // being used as a mask) from high-frequency alpha maps which
-    // suffer the worst from aliasing when used as alpha masks.
-    if (w >= 2 && h >= 2)
-    {
-        llassert(w % 2 == 0);
-        llassert(h % 2 == 0);
-        const GLubyte* rowstart = ((const GLubyte*) data_in) + mAlphaOffset;
-        for (U32 y = 0; y < h; y += 2)
-        {
-            const GLubyte* current = rowstart;
-            for (U32 x = 0; x < w; x += 2)
-            {
-                const U32 s1 = current[0];
-                alphatotal += s1;
-                const U32 s2 = current[w * mAlphaStride];
-                alphatotal += s2;
-                current += mAlphaStride;
-                const U32 s3 = current[0];
-                alphatotal += s3;
-                const U32 s4 = current[w * mAlphaStride];
-                alphatotal += s4;
-                current += mAlphaStride;
-
-                ++sample[s1/16];
-                ++sample[s2/16];
-                ++sample[s3/16];
-                ++sample[s4/16];
-
-                const U32 asum = (s1+s2+s3+s4);
-                alphatotal += asum;
-                sample[asum/(16*4)] += 4;
-            }
-
-            rowstart += 2 * w * mAlphaStride;
-        }
-        length *= 2; // we sampled everything twice, essentially
-    }
-    else
+    if (const LLImageAlphaInfo* info = getRawAlphaInfo(data_in, w, h))
     {
-        const GLubyte* current = ((const GLubyte*) data_in) + mAlphaOffset;
-        for (U32 i = 0; i < length; i++)
-        {
-            const U32 s1 = *current;
-            alphatotal += s1;
-            ++sample[s1/16];
-            current += mAlphaStride;
-        }
+        mIsMask = info->mIsMask;
+        return;
     }
 
-    // if more than 1/16th of alpha samples are mid-range, this
-    // shouldn't be treated as a 1-bit mask
-
-    // also, if all of the alpha samples are clumped on one half
-    // of the range (but not at an absolute extreme), then consider
-    // this to be an intentional effect and don't treat as a mask.
-
-    U32 midrangetotal = 0;
-    for (U32 i = 2; i < 13; i++)
-    {
-        midrangetotal += sample[i];
-    }
-    U32 lowerhalftotal = 0;
-    for (U32 i = 0; i < 8; i++)
-    {
-        lowerhalftotal += sample[i];
-    }
-    U32 upperhalftotal = 0;
-    for (U32 i = 8; i < 16; i++)
-    {
-        upperhalftotal += sample[i];
-    }
+    mIsMask = LLImageAlpha::isMask((const U8*)data_in, w, h, mAlphaStride, mAlphaOffset);
+}
 
-    if (midrangetotal > length/48 || // lots of midrange, or
-        (lowerhalftotal == length && alphatotal != 0) || // all close to transparent but not all totally transparent, or
-        (upperhalftotal == length && alphatotal != 255*length)) // all close to opaque but not all totally opaque
-    {
-        mIsMask = false; // not suitable for masking
-    }
-    else
+const LLImageAlphaInfo* LLImageGL::getRawAlphaInfo(const void* data_in, S32 width, S32 height) const
+{
+    // only usable if it looked at the same texels, with alpha where we
+    // expect it
+    if (mRawAlphaInfo && mRawAlphaInfo->mData == data_in
+        && mRawAlphaInfo->mWidth == width && mRawAlphaInfo->mHeight == height
+        && mFormatType == GL_UNSIGNED_BYTE
+        && mAlphaStride == mRawAlphaInfo->mComponents && mAlphaOffset == mAlphaStride - 1)
     {
-        mIsMask = true;
+        return mRawAlphaInfo;
     }
+    return NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -2270,8 +2207,7 @@ U32 LLImageGL::createPickMask(S32 pWidth, S32 pHeight)
     U32 pick_width = pWidth/2 + 1;
     U32 pick_height = pHeight/2 + 1;
 
-    U32 size = pick_width * pick_height;
-    size = (size + 7) / 8; // pixelcount-to-bits
+    U32 size = LLImageAlpha::getPickMaskSize(pWidth, pHeight);
     mPickMask = new U8[size];
     mPickMaskWidth = pick_width - 1;
     mPickMaskHeight = pick_height - 1;
@@ -2331,31 +2267,16 @@ void LLImageGL::updatePickMask(S32 width, S32 height, const U8* data_in)
     }
 
 
-#ifdef SHOW_ASSERT
-    const U32 pickSize = createPickMask(width, height);
-#else // SHOW_ASSERT
-    createPickMask(width, height);
-#endif // SHOW_ASSERT
+    const U32 pick_size = createPickMask(width, height);
 
-    U32 pick_bit = 0;
-
-    for (S32 y = 0; y < height; y += 2)
+    const LLImageAlphaInfo* info = getRawAlphaInfo(data_in, width, height);
+    if (info && info->mPickMask.size() == pick_size)
     {
-        for (S32 x = 0; x < width; x += 2)
-        {
-            U8 alpha = data_in[(y*width+x)*4+3];
-
-            if (alpha > 32)
-            {
-                U32 pick_idx = pick_bit/8;
-                U32 pick_offset = pick_bit%8;
-                llassert(pick_idx < pickSize);
-
-                mPickMask[pick_idx] |= 1 << pick_offset;
-            }
-
-            ++pick_bit;
-        }
+        memcpy(mPickMask, info->mPickMask.data(), pick_size);
+    }
+    else
+    {
+        LLImageAlpha::createPickMask(data_in, width, height, mPickMask);
     }
 }
 
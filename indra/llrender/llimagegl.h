@@ -233,6 +233,8 @@ private:
     U32 createPickMask(S32 pWidth, S32 pHeight);
     void freePickMask();
     bool isCompressed();
+    // alpha analysis of the image at data_in done by the decode thread, if any
+    const LLImageAlphaInfo* getRawAlphaInfo(const void* data_in, S32 width, S32 height) const;
 
     LLPointer<LLImageRaw> mSaveData; // used for destroyGL/restoreGL
     LL::WorkQueue::weak_t mMainQueue;
@@ -247,6 +249,7 @@ private:
     bool mNeedsAlphaAndPickMask;
     S8   mAlphaStride ;
     S8   mAlphaOffset ;
+    const LLImageAlphaInfo* mRawAlphaInfo; // set while creating the texture from an LLImageRaw
 
     bool     mGLTextureCreated ;
     LLGLuint mTexName;
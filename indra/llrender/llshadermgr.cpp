@@ -419,21 +419,54 @@ static std::string get_object_log(GLuint ret)
 }
 
 //dump shader source for debugging
-void LLShaderMgr::dumpShaderSource(U32 shader_code_count, GLchar** shader_code_text)
+void LLShaderMgr::dumpShaderSource(const std::string& shader_code_text)
 {
     char num_str[16]; // U32 = max 10 digits
 
     LL_SHADER_LOADING_WARNS() << "\n";
 
-    for (U32 i = 0; i < shader_code_count; i++)
+    U32 line = 0;
+    for (size_t begin = 0; begin < shader_code_text.size(); )
     {
-        snprintf(num_str, sizeof(num_str), "%4d: ", i+1);
+        size_t end = shader_code_text.find('\n', begin);
+        end = (end == std::string::npos) ? shader_code_text.size() : end + 1;
+        snprintf(num_str, sizeof(num_str), "%4d: ", ++line);
         std::string line_number(num_str);
-        LL_CONT << line_number << shader_code_text[i];
+        LL_CONT << line_number << shader_code_text.substr(begin, end - begin);
+        begin = end;
     }
     LL_CONT << LL_ENDL;
 }
 
+LLShaderSourceCache::Environment LLShaderMgr::getSourceEnvironment()
+{
+    LLShaderSourceCache::Environment env;
+    env.mShaderDirPrefix = getShaderDirPrefix();
+    env.mGLSLVersionMajor = gGLManager.mGLSLVersionMajor;
+    env.mGLSLVersionMinor = gGLManager.mGLSLVersionMinor;
+    env.mIsAMD = gGLManager.mIsAMD;
+    env.mIsNVIDIA = gGLManager.mIsNVIDIA;
+    return env;
+}
+
+void LLShaderMgr::prefetchShaderSources(const std::vector<LLShaderSourceCache::Request>& requests)
+{
+    LLTimer timer;
+#if LL_DARWIN
+    // same work-around as loadShaderFile(), or none of these would be hits
+    std::vector<LLShaderSourceCache::Request> darwin_requests(requests);
+    for (auto& request : darwin_requests)
+    {
+        request.mDefines["OLD_SELECT"] = "1";
+    }
+    mSourceCache.prefetch(getSourceEnvironment(), darwin_requests);
+#else
+    mSourceCache.prefetch(getSourceEnvironment(), requests);
+#endif
+    LL_DEBUGS("ShaderLoading") << "Prefetched " << requests.size() << " shader sources in " << timer.getElapsedTimeF32() * 1000.f
+                               << " ms, " << mSourceCache.getHits() << " cache hits and " << mSourceCache.getMisses() << " misses so far" << LL_ENDL;
+}
+
 void LLShaderMgr::dumpObjectLog(GLuint ret, bool warns, const std::string& filename)
 {
     std::string log;
@@ -475,367 +508,16 @@ GLuint LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shader_lev
         return 0;
     }
 
-
-    //read in from file
-    LLFILE* file = NULL;
-
+    //look up the most relevant file and assemble its source
     S32 try_gpu_class = shader_level;
-    S32 gpu_class;
-
-    std::string open_file_name;
-
-#if 0  // WIP -- try to come up with a way to fallback to an error shader without needing debug stubs all over the place in the shader tree
-    if (shader_level == -1)
+    LLShaderSourceCache::Request request(filename, shader_level, type, defines, texture_index_channels);
+    LLShaderSourceCache::source_ptr_t source = mSourceCache.get(getSourceEnvironment(), request);
+    if (!source)
     {
-        // use "error" fallback
-        if (type == GL_VERTEX_SHADER)
-        {
-            open_file_name = gDirUtilp->getExpandedFilename(LL_PATH_APP_SETTINGS, "shaders/errorV.glsl");
-        }
-        else
-        {
-            llassert(type == GL_FRAGMENT_SHADER);  // type must be vertex or fragment shader
-            open_file_name = gDirUtilp->getExpandedFilename(LL_PATH_APP_SETTINGS, "shaders/errorF.glsl");
-        }
-
-        file = LLFile::fopen(open_file_name, "r");
-    }
-    else
-#endif
-    {
-        //find the most relevant file
-        for (gpu_class = try_gpu_class; gpu_class > 0; gpu_class--)
-        {   //search from the current gpu class down to class 1 to find the most relevant shader
-            std::stringstream fname;
-            fname << getShaderDirPrefix();
-            fname << gpu_class << "/" << filename;
-
-            open_file_name = fname.str();
-
-            /*
-            Would be awesome, if we didn't have shaders that re-use files
-            with different environments to say, add skinning, etc
-            can't depend on cached version to have evaluate ifdefs identically...
-            if we can define a deterministic hash for the shader based on
-            all the inputs, maybe we can save some time here.
-            if (mShaderObjects.count(filename) > 0)
-            {
-                return mShaderObjects[filename];
-            }
-
-            */
-
-            LL_DEBUGS("ShaderLoading") << "Looking in " << open_file_name << LL_ENDL;
-            file = LLFile::fopen(open_file_name, "r");      /* Flawfinder: ignore */
-            if (file)
-            {
-                LL_DEBUGS("ShaderLoading") << "Loading file: " << open_file_name << " (Want class " << gpu_class << ")" << LL_ENDL;
-                break; // done
-            }
-        }
-    }
-
-    if (file == NULL)
-    {
-        LL_WARNS("ShaderLoading") << "GLSL Shader file not found: " << open_file_name << LL_ENDL;
+        LL_WARNS("ShaderLoading") << "GLSL Shader file not found: " << getShaderDirPrefix() << "1/" << filename << LL_ENDL;
         return 0;
     }
-
-    //we can't have any lines longer than 1024 characters
-    //or any shaders longer than 4096 lines... deal - DaveP
-    GLchar buff[1024];
-    GLchar *extra_code_text[1024];
-    GLchar *shader_code_text[4096 + LL_ARRAY_SIZE(extra_code_text)] = { NULL };
-    GLuint extra_code_count = 0, shader_code_count = 0;
-    BOOST_STATIC_ASSERT(LL_ARRAY_SIZE(extra_code_text) < LL_ARRAY_SIZE(shader_code_text));
-
-
-    S32 major_version = gGLManager.mGLSLVersionMajor;
-    S32 minor_version = gGLManager.mGLSLVersionMinor;
-
-    if (major_version == 1 && minor_version < 30)
-    {
-        llassert(false); // GL 3.1 or later required
-    }
-    else
-    {
-        if (major_version >= 4)
-        {
-            //set version to 400 or 420
-            if (minor_version >= 20)
-            {
-                shader_code_text[shader_code_count++] = strdup("#version 420\n");
-            }
-            else
-            {
-                shader_code_text[shader_code_count++] = strdup("#version 400\n");
-            }
-        }
-        else if (major_version == 3)
-        {
-            if (minor_version <= 29)
-            {
-                // OpenGL 3.2 had GLSL version 1.50.  anything after that the version numbers match.
-                // https://www.khronos.org/opengl/wiki/Core_Language_(GLSL)#OpenGL_and_GLSL_versions
-                shader_code_text[shader_code_count++] = strdup("#version 150\n");
-            }
-            else
-            {
-                shader_code_text[shader_code_count++] = strdup("#version 330\n");
-            }
-        }
-        else
-        {
-            // OpenGL 3.2 had GLSL version 1.50.  anything after that the version numbers match.
-            if (type == GL_GEOMETRY_SHADER || minor_version >= 50)
-            {
-                //set version to 1.50
-                shader_code_text[shader_code_count++] = strdup("#version 150\n");
-                //some implementations of GLSL 1.30 require integer precision be explicitly declared
-                extra_code_text[extra_code_count++] = strdup("precision mediump int;\n");
-                extra_code_text[extra_code_count++] = strdup("precision highp float;\n");
-            }
-            else
-            {
-                //set version to 1.40
-                shader_code_text[shader_code_count++] = strdup("#version 140\n");
-                //some implementations of GLSL 1.30 require integer precision be explicitly declared
-                extra_code_text[extra_code_count++] = strdup("precision mediump int;\n");
-                extra_code_text[extra_code_count++] = strdup("precision highp float;\n");
-            }
-        }
-    }
-
-    if (type == GL_FRAGMENT_SHADER)
-    {
-        extra_code_text[extra_code_count++] = strdup("#define FRAGMENT_SHADER 1\n");
-    }
-    else
-    {
-        extra_code_text[extra_code_count++] = strdup("#define VERTEX_SHADER 1\n");
-    }
-
-    // Use alpha float to store bit flags
-    // See: C++: addDeferredAttachment(), shader: frag_data[2]
-    extra_code_text[extra_code_count++] = strdup("#define GBUFFER_FLAG_SKIP_ATMOS   0.0 \n"); // atmo kill
-    extra_code_text[extra_code_count++] = strdup("#define GBUFFER_FLAG_HAS_ATMOS    0.34\n"); // bit 0
-    extra_code_text[extra_code_count++] = strdup("#define GBUFFER_FLAG_HAS_PBR      0.67\n"); // bit 1
-    extra_code_text[extra_code_count++] = strdup("#define GBUFFER_FLAG_HAS_HDRI      1.0\n");  // bit 2
-    extra_code_text[extra_code_count++] = strdup("#define GET_GBUFFER_FLAG(data, flag)    (abs(data-flag)< 0.1)\n");
-
-    if (defines)
-    {
-        for (auto iter = defines->begin(); iter != defines->end(); ++iter)
-        {
-            std::string define = "#define " + iter->first + " " + iter->second + "\n";
-            extra_code_text[extra_code_count++] = (GLchar *) strdup(define.c_str());
-        }
-    }
-
-    if( gGLManager.mIsAMD )
-    {
-        extra_code_text[extra_code_count++] = strdup( "#define IS_AMD_CARD 1\n" );
-    }
-
-    if (texture_index_channels > 0 && type == GL_FRAGMENT_SHADER)
-    {
-        //use specified number of texture channels for indexed texture rendering
-
-        /* prepend shader code that looks like this:
-
-        uniform sampler2D tex0;
-        uniform sampler2D tex1;
-        uniform sampler2D tex2;
-        .
-        .
-        .
-        uniform sampler2D texN;
-
-        flat in int vary_texture_index;
-
-        vec4 ret = vec4(1,0,1,1);
-
-        vec4 diffuseLookup(vec2 texcoord)
-        {
-            switch (vary_texture_index)
-            {
-                case 0: ret = texture(tex0, texcoord); break;
-                case 1: ret = texture(tex1, texcoord); break;
-                case 2: ret = texture(tex2, texcoord); break;
-                .
-                .
-                .
-                case N: return texture(texN, texcoord); break;
-            }
-
-            return ret;
-        }
-        */
-
-        extra_code_text[extra_code_count++] = strdup("#define HAS_DIFFUSE_LOOKUP\n");
-
-        //uniform declartion
-        for (S32 i = 0; i < texture_index_channels; ++i)
-        {
-            std::string decl = llformat("uniform sampler2D tex%d;\n", i);
-            extra_code_text[extra_code_count++] = strdup(decl.c_str());
-        }
-
-        if (texture_index_channels > 1)
-        {
-            extra_code_text[extra_code_count++] = strdup("flat in int vary_texture_index;\n");
-        }
-
-        extra_code_text[extra_code_count++] = strdup("vec4 diffuseLookup(vec2 texcoord)\n");
-        extra_code_text[extra_code_count++] = strdup("{\n");
-
-
-        if (texture_index_channels == 1)
-        { //don't use flow control, that's silly
-            extra_code_text[extra_code_count++] = strdup("return texture(tex0, texcoord);\n");
-            extra_code_text[extra_code_count++] = strdup("}\n");
-        }
-        else if (major_version > 1 || minor_version >= 30)
-        {  //switches are supported in GLSL 1.30 and later
-            if (gGLManager.mIsNVIDIA)
-            { //switches are unreliable on some NVIDIA drivers
-                for (S32 i = 0; i < texture_index_channels; ++i)
-                {
-                    std::string if_string = llformat("\t%sif (vary_texture_index == %d) { return texture(tex%d, texcoord); }\n", i > 0 ? "else " : "", i, i);
-                    extra_code_text[extra_code_count++] = strdup(if_string.c_str());
-                }
-                extra_code_text[extra_code_count++] = strdup("\treturn vec4(1,0,1,1);\n");
-                extra_code_text[extra_code_count++] = strdup("}\n");
-            }
-            else
-            {
-                extra_code_text[extra_code_count++] = strdup("\tvec4 ret = vec4(1,0,1,1);\n");
-                extra_code_text[extra_code_count++] = strdup("\tswitch (vary_texture_index)\n");
-                extra_code_text[extra_code_count++] = strdup("\t{\n");
-
-                //switch body
-                for (S32 i = 0; i < texture_index_channels; ++i)
-                {
-                    std::string case_str = llformat("\t\tcase %d: return texture(tex%d, texcoord);\n", i, i);
-                    extra_code_text[extra_code_count++] = strdup(case_str.c_str());
-                }
-
-                extra_code_text[extra_code_count++] = strdup("\t}\n");
-                extra_code_text[extra_code_count++] = strdup("\treturn ret;\n");
-                extra_code_text[extra_code_count++] = strdup("}\n");
-            }
-        }
-        else
-        { //should never get here.  Indexed texture rendering requires GLSL 1.30 or later
-            // (for passing integers between vertex and fragment shaders)
-            LL_ERRS() << "Indexed texture rendering requires GLSL 1.30 or later." << LL_ENDL;
-        }
-    }
-
-    // Master definition can be found in deferredUtil.glsl
-    extra_code_text[extra_code_count++] = strdup("struct GBufferInfo { vec4 albedo; vec4 specular; vec3 normal; vec4 emissive; float gbufferFlag; float envIntensity; };\n");
-
-    //copy file into memory
-    enum {
-          flag_write_to_out_of_extra_block_area = 0x01
-        , flag_extra_block_marker_was_found = 0x02
-    };
-
-    unsigned char flags = flag_write_to_out_of_extra_block_area;
-
-    GLuint out_of_extra_block_counter = 0, start_shader_code = shader_code_count, file_lines_count = 0;
-
-#define TOUCH_SHADERS 0
-
-#if TOUCH_SHADERS
-    const char* marker = "// touched";
-    bool touched = false;
-#endif
-
-    while(NULL != fgets((char *)buff, 1024, file)
-          && shader_code_count < (LL_ARRAY_SIZE(shader_code_text) - LL_ARRAY_SIZE(extra_code_text)))
-    {
-        file_lines_count++;
-
-        bool extra_block_area_found = NULL != strstr((const char*)buff, "[EXTRA_CODE_HERE]");
-
-#if TOUCH_SHADERS
-        if (NULL != strstr((const char*)buff, marker))
-        {
-            touched = true;
-        }
-#endif
-
-        if(extra_block_area_found && !(flag_extra_block_marker_was_found & flags))
-        {
-            if(!(flag_write_to_out_of_extra_block_area & flags))
-            {
-                //shift
-                for(GLuint to = start_shader_code, from = extra_code_count + start_shader_code;
-                    from < shader_code_count; ++to, ++from)
-                {
-                    shader_code_text[to] = shader_code_text[from];
-                }
-
-                shader_code_count -= extra_code_count;
-            }
-
-            //copy extra code
-            for(GLuint n = 0; n < extra_code_count
-                && shader_code_count < (LL_ARRAY_SIZE(shader_code_text) - LL_ARRAY_SIZE(extra_code_text)); ++n)
-            {
-                shader_code_text[shader_code_count++] = extra_code_text[n];
-            }
-
-            extra_code_count = 0;
-
-            flags &= ~flag_write_to_out_of_extra_block_area;
-            flags |= flag_extra_block_marker_was_found;
-        }
-        else
-        {
-            shader_code_text[shader_code_count] = (GLchar *)strdup((char *)buff);
-
-            if(flag_write_to_out_of_extra_block_area & flags)
-            {
-                shader_code_text[extra_code_count + start_shader_code + out_of_extra_block_counter]
-                    = shader_code_text[shader_code_count];
-                out_of_extra_block_counter++;
-
-                if(out_of_extra_block_counter == extra_code_count)
-                {
-                    shader_code_count += extra_code_count;
-                    flags &= ~flag_write_to_out_of_extra_block_area;
-                }
-            }
-
-            ++shader_code_count;
-        }
-    } //while
-
-    if(!(flag_extra_block_marker_was_found & flags))
-    {
-        for(GLuint n = start_shader_code; n < extra_code_count + start_shader_code; ++n)
-        {
-            shader_code_text[n] = extra_code_text[n - start_shader_code];
-        }
-
-        if (file_lines_count < extra_code_count)
-        {
-            shader_code_count += extra_code_count;
-        }
-
-        extra_code_count = 0;
-    }
-
-#if TOUCH_SHADERS
-    if (!touched)
-    {
-        fprintf(file, "\n%s\n", marker);
-    }
-#endif
-
-    fclose(file);
+    const std::string& open_file_name = source->mPath;
 
     //create shader object
     GLuint ret = glCreateShader(type);
@@ -854,7 +536,8 @@ GLuint LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shader_lev
     //load source
     if (ret)
     {
-        glShaderSource(ret, shader_code_count, (const GLchar**)shader_code_text, NULL);
+        const GLchar* shader_code_text = source->mText.c_str();
+        glShaderSource(ret, 1, &shader_code_text, NULL);
 
         error = glGetError();
         if (error != GL_NO_ERROR)
@@ -891,7 +574,7 @@ GLuint LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shader_lev
             //an error occured, print log
             LL_WARNS("ShaderLoading") << "GLSL Compilation Error:" << LL_ENDL;
             dumpObjectLog(ret, true, open_file_name);
-            dumpShaderSource(shader_code_count, shader_code_text);
+            dumpShaderSource(source->mText);
             glDeleteShader(ret); //no longer need handle
             ret = 0;
         }
@@ -902,12 +585,6 @@ GLuint LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shader_lev
     }
     stop_glerror();
 
-    //free memory
-    for (GLuint i = 0; i < shader_code_count; i++)
-    {
-        free(shader_code_text[i]);
-    }
-
     //successfully loaded, save results
     if (ret)
     {
@@ -29,6 +29,7 @@
 
 #include "llgl.h"
 #include "llglslshader.h"
+#include "llshadersourcecache.h"
 
 class LLShaderMgr
 {
@@ -362,11 +363,16 @@ public:
 
     bool attachShaderFeatures(LLGLSLShader * shader);
     void dumpObjectLog(GLuint ret, bool warns = true, const std::string& filename = "");
-    void dumpShaderSource(U32 shader_code_count, GLchar** shader_code_text);
+    void dumpShaderSource(const std::string& shader_code_text);
     bool    linkProgramObject(GLuint obj, bool suppress_errors = false);
     bool    validateProgramObject(GLuint obj);
     GLuint loadShaderFile(const std::string& filename, S32 & shader_level, GLenum type, std::map<std::string, std::string>* defines = NULL, S32 texture_index_channels = -1);
 
+    // Assemble the sources of requests on the Parallel thread pool, so that
+    // the loadShaderFile() calls for them only have to compile
+    void prefetchShaderSources(const std::vector<LLShaderSourceCache::Request>& requests);
+    LLShaderSourceCache::Environment getSourceEnvironment();
+
     // Implemented in the application to actually point to the shader directory.
     virtual std::string getShaderDirPrefix(void) = 0; // Pure Virtual
 
@@ -401,6 +407,9 @@ public:
     bool mShaderCacheEnabled = false;
     std::string mShaderCacheDir;
 
+    // Assembled GLSL sources, kept across shader reloads
+    LLShaderSourceCache mSourceCache;
+
 protected:
 
     // our parameter manager singleton instance
@@ -0,0 +1,383 @@
+/**
+ * @file llshadersourcecache.cpp
+ * @brief GLSL source lookup and assembly, independent of the GL context
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llshadersourcecache.h"
+
+#include "hbxxh.h"
+#include "llfile.h"
+#include "llglheaders.h"
+#include "parallelfor.h"
+
+#include <unordered_set>
+
+namespace
+{
+    void hash_string(HBXXH64& hash_obj, const std::string& str)
+    {
+        // length first, so that "ab" + "c" and "a" + "bc" differ
+        U64 size = str.size();
+        hash_obj.update(&size, sizeof(size));
+        hash_obj.update(str);
+    }
+
+    std::string version_line(const LLShaderSourceCache::Environment& env, U32 type, std::string& extra_code)
+    {
+        S32 major_version = env.mGLSLVersionMajor;
+        S32 minor_version = env.mGLSLVersionMinor;
+
+        if (major_version == 1 && minor_version < 30)
+        {
+            llassert(false); // GL 3.1 or later required
+            return std::string();
+        }
+        if (major_version >= 4)
+        {
+            //set version to 400 or 420
+            return minor_version >= 20 ? "#version 420\n" : "#version 400\n";
+        }
+        if (major_version == 3)
+        {
+            // OpenGL 3.2 had GLSL version 1.50.  anything after that the version numbers match.
+            // https://www.khronos.org/opengl/wiki/Core_Language_(GLSL)#OpenGL_and_GLSL_versions
+            return minor_version <= 29 ? "#version 150\n" : "#version 330\n";
+        }
+
+        //some implementations of GLSL 1.30 require integer precision be explicitly declared
+        extra_code += "precision mediump int;\n";
+        extra_code += "precision highp float;\n";
+        // OpenGL 3.2 had GLSL version 1.50.  anything after that the version numbers match.
+        if (type == GL_GEOMETRY_SHADER || minor_version >= 50)
+        {
+            return "#version 150\n";
+        }
+        return "#version 140\n";
+    }
+
+    void append_diffuse_lookup(const LLShaderSourceCache::Environment& env, S32 texture_index_channels, std::string& extra_code)
+    {
+        //use specified number of texture channels for indexed texture rendering
+
+        /* prepend shader code that looks like this:
+
+        uniform sampler2D tex0;
+        uniform sampler2D tex1;
+        uniform sampler2D tex2;
+        .
+        .
+        .
+        uniform sampler2D texN;
+
+        flat in int vary_texture_index;
+
+        vec4 ret = vec4(1,0,1,1);
+
+        vec4 diffuseLookup(vec2 texcoord)
+        {
+            switch (vary_texture_index)
+            {
+                case 0: ret = texture(tex0, texcoord); break;
+                case 1: ret = texture(tex1, texcoord); break;
+                case 2: ret = texture(tex2, texcoord); break;
+                .
+                .
+                .
+                case N: return texture(texN, texcoord); break;
+            }
+
+            return ret;
+        }
+        */
+
+        extra_code += "#define HAS_DIFFUSE_LOOKUP\n";
+
+        //uniform declartion
+        for (S32 i = 0; i < texture_index_channels; ++i)
+        {
+            extra_code += llformat("uniform sampler2D tex%d;\n", i);
+        }
+
+        if (texture_index_channels > 1)
+        {
+            extra_code += "flat in int vary_texture_index;\n";
+        }
+
+        extra_code += "vec4 diffuseLookup(vec2 texcoord)\n";
+        extra_code += "{\n";
+
+        if (texture_index_channels == 1)
+        { //don't use flow control, that's silly
+            extra_code += "return texture(tex0, texcoord);\n";
+            extra_code += "}\n";
+        }
+        else if (env.mGLSLVersionMajor > 1 || env.mGLSLVersionMinor >= 30)
+        {  //switches are supported in GLSL 1.30 and later
+            if (env.mIsNVIDIA)
+            { //switches are unreliable on some NVIDIA drivers
+                for (S32 i = 0; i < texture_index_channels; ++i)
+                {
+                    extra_code += llformat("\t%sif (vary_texture_index == %d) { return texture(tex%d, texcoord); }\n", i > 0 ? "else " : "", i, i);
+                }
+                extra_code += "\treturn vec4(1,0,1,1);\n";
+                extra_code += "}\n";
+            }
+            else
+            {
+                extra_code += "\tvec4 ret = vec4(1,0,1,1);\n";
+                extra_code += "\tswitch (vary_texture_index)\n";
+                extra_code += "\t{\n";
+
+                //switch body
+                for (S32 i = 0; i < texture_index_channels; ++i)
+                {
+                    extra_code += llformat("\t\tcase %d: return texture(tex%d, texcoord);\n", i, i);
+                }
+
+                extra_code += "\t}\n";
+                extra_code += "\treturn ret;\n";
+                extra_code += "}\n";
+            }
+        }
+        else
+        { //should never get here.  Indexed texture rendering requires GLSL 1.30 or later
+            // (for passing integers between vertex and fragment shaders)
+            LL_ERRS() << "Indexed texture rendering requires GLSL 1.30 or later." << LL_ENDL;
+        }
+    }
+} // anonymous namespace
+
+//static
+bool LLShaderSourceCache::assemble(const Environment& env, const Request& request, Source& source)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_SHADER;
+
+    if (request.mFilename.empty())
+    {
+        return false;
+    }
+
+    //find the most relevant file
+    LLFILE* file = NULL;
+    S32 gpu_class;
+    for (gpu_class = request.mShaderLevel; gpu_class > 0; gpu_class--)
+    {   //search from the current gpu class down to class 1 to find the most relevant shader
+        source.mPath = env.mShaderDirPrefix + std::to_string(gpu_class) + "/" + request.mFilename;
+
+        LL_DEBUGS("ShaderLoading") << "Looking in " << source.mPath << LL_ENDL;
+        file = LLFile::fopen(source.mPath, "r");      /* Flawfinder: ignore */
+        if (file)
+        {
+            LL_DEBUGS("ShaderLoading") << "Loading file: " << source.mPath << " (Want class " << gpu_class << ")" << LL_ENDL;
+            break; // done
+        }
+    }
+
+    if (file == NULL)
+    {
+        return false;
+    }
+    source.mGPUClass = gpu_class;
+
+    llstat file_status;
+    if (LLFile::stat(source.mPath, &file_status) == 0)
+    {
+        source.mFileSize = file_status.st_size;
+        source.mFileTime = file_status.st_mtime;
+    }
+
+    std::string contents;
+    char buff[4096];
+    for (size_t read; (read = fread(buff, 1, sizeof(buff), file)) > 0; )
+    {
+        contents.append(buff, read);
+    }
+    fclose(file);
+
+    std::string extra_code;
+    std::string version = version_line(env, request.mType, extra_code);
+
+    if (request.mType == GL_FRAGMENT_SHADER)
+    {
+        extra_code += "#define FRAGMENT_SHADER 1\n";
+    }
+    else
+    {
+        extra_code += "#define VERTEX_SHADER 1\n";
+    }
+
+    // Use alpha float to store bit flags
+    // See: C++: addDeferredAttachment(), shader: frag_data[2]
+    extra_code += "#define GBUFFER_FLAG_SKIP_ATMOS   0.0 \n"; // atmo kill
+    extra_code += "#define GBUFFER_FLAG_HAS_ATMOS    0.34\n"; // bit 0
+    extra_code += "#define GBUFFER_FLAG_HAS_PBR      0.67\n"; // bit 1
+    extra_code += "#define GBUFFER_FLAG_HAS_HDRI      1.0\n";  // bit 2
+    extra_code += "#define GET_GBUFFER_FLAG(data, flag)    (abs(data-flag)< 0.1)\n";
+
+    for (const auto& [name, value] : request.mDefines)
+    {
+        extra_code += "#define " + name + " " + value + "\n";
+    }
+
+    if (env.mIsAMD)
+    {
+        extra_code += "#define IS_AMD_CARD 1\n";
+    }
+
+    if (request.mTextureIndexChannels > 0 && request.mType == GL_FRAGMENT_SHADER)
+    {
+        append_diffuse_lookup(env, request.mTextureIndexChannels, extra_code);
+    }
+
+    // Master definition can be found in deferredUtil.glsl
+    extra_code += "struct GBufferInfo { vec4 albedo; vec4 specular; vec3 normal; vec4 emissive; float gbufferFlag; float envIntensity; };\n";
+
+    // The generated code replaces the first line holding the marker, without
+    // one it goes right after the #version line.
+    size_t marker_begin = std::string::npos;
+    size_t marker_end = std::string::npos;
+    if (size_t marker = contents.find("[EXTRA_CODE_HERE]"); marker != std::string::npos)
+    {
+        size_t line_begin = contents.rfind('\n', marker);
+        marker_begin = (line_begin == std::string::npos) ? 0 : line_begin + 1;
+        marker_end = contents.find('\n', marker);
+        marker_end = (marker_end == std::string::npos) ? contents.size() : marker_end + 1;
+    }
+
+    source.mText.clear();
+    source.mText.reserve(version.size() + extra_code.size() + contents.size());
+    source.mText += version;
+    if (marker_begin == std::string::npos)
+    {
+        source.mText += extra_code;
+        source.mText += contents;
+    }
+    else
+    {
+        source.mText.append(contents, 0, marker_begin);
+        source.mText += extra_code;
+        source.mText.append(contents, marker_end, std::string::npos);
+    }
+    return true;
+}
+
+//static
+U64 LLShaderSourceCache::hash(const Environment& env, const Request& request)
+{
+    HBXXH64 hash_obj;
+    hash_string(hash_obj, env.mShaderDirPrefix);
+    hash_obj.update(&env.mGLSLVersionMajor, sizeof(env.mGLSLVersionMajor));
+    hash_obj.update(&env.mGLSLVersionMinor, sizeof(env.mGLSLVersionMinor));
+    U8 vendor = (env.mIsAMD ? 1 : 0) | (env.mIsNVIDIA ? 2 : 0);
+    hash_obj.update(&vendor, sizeof(vendor));
+
+    hash_string(hash_obj, request.mFilename);
+    hash_obj.update(&request.mShaderLevel, sizeof(request.mShaderLevel));
+    hash_obj.update(&request.mType, sizeof(request.mType));
+    for (const auto& [name, value] : request.mDefines)
+    {
+        hash_string(hash_obj, name);
+        hash_string(hash_obj, value);
+    }
+    hash_obj.update(&request.mTextureIndexChannels, sizeof(request.mTextureIndexChannels));
+    return hash_obj.digest();
+}
+
+//static
+bool LLShaderSourceCache::isCurrent(const Source& source)
+{
+    llstat file_status;
+    return LLFile::stat(source.mPath, &file_status) == 0
+        && file_status.st_size == source.mFileSize
+        && (S64)file_status.st_mtime == source.mFileTime;
+}
+
+LLShaderSourceCache::source_ptr_t LLShaderSourceCache::get(const Environment& env, const Request& request)
+{
+    const U64 key = hash(env, request);
+
+    source_ptr_t cached;
+    {
+        LLMutexLock lock(&mMutex);
+        if (source_map_t::iterator it = mSources.find(key); it != mSources.end())
+        {
+            cached = it->second;
+        }
+    }
+    if (cached && isCurrent(*cached))
+    {
+        LLMutexLock lock(&mMutex);
+        ++mHits;
+        return cached;
+    }
+
+    auto source = std::make_shared<Source>();
+    if (!assemble(env, request, *source))
+    {
+        return source_ptr_t();
+    }
+
+    LLMutexLock lock(&mMutex);
+    ++mMisses;
+    mSources[key] = source;
+    return source;
+}
+
+void LLShaderSourceCache::prefetch(const Environment& env, const std::vector<Request>& requests)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_SHADER;
+
+    std::vector<const Request*> missing;
+    {
+        std::unordered_set<U64> seen;
+        LLMutexLock lock(&mMutex);
+        for (const Request& request : requests)
+        {
+            const U64 key = hash(env, request);
+            if (!mSources.count(key) && seen.insert(key).second)
+            {
+                missing.push_back(&request);
+            }
+        }
+    }
+
+    LL::parallel_for(missing.size(), 1,
+                     [this, &env, &missing](size_t begin, size_t end)
+                     {
+                         for (size_t i = begin; i < end; ++i)
+                         {
+                             get(env, *missing[i]);
+                         }
+                     });
+}
+
+void LLShaderSourceCache::clear()
+{
+    LLMutexLock lock(&mMutex);
+    mSources.clear();
+    mHits = 0;
+    mMisses = 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file llshadersourcecache.h
+ * @brief GLSL source lookup and assembly, independent of the GL context
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_SHADERSOURCECACHE_H
+#define LL_SHADERSOURCECACHE_H
+
+#include "llmutex.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Turns a shader file name plus its defines into the complete source text
+ * handed to glShaderSource(): finds the file in the most relevant gpu class
+ * directory, prepends the #version line and injects the generated code at
+ * the [EXTRA_CODE_HERE] marker (or at the top when there is none).
+ *
+ * None of this touches GL, so it can run on any thread. Assembled sources
+ * are cached by a hash of every input; a cached source is only reused while
+ * its file keeps the same size and modification time.
+ */
+class LLShaderSourceCache
+{
+public:
+    // Everything besides the request itself that the assembled text depends on
+    struct Environment
+    {
+        std::string mShaderDirPrefix;   // gpu class number and file name are appended to this
+        S32         mGLSLVersionMajor = 0;
+        S32         mGLSLVersionMinor = 0;
+        bool        mIsAMD = false;
+        bool        mIsNVIDIA = false;
+    };
+
+    struct Request
+    {
+        Request() = default;
+        Request(const std::string& filename, S32 shader_level, U32 type,
+                const std::map<std::string, std::string>* defines = NULL, S32 texture_index_channels = -1)
+        :   mFilename(filename),
+            mShaderLevel(shader_level),
+            mType(type),
+            mTextureIndexChannels(texture_index_channels)
+        {
+            if (defines)
+            {
+                mDefines = *defines;
+            }
+        }
+
+        std::string mFilename;
+        S32         mShaderLevel = 0;               // highest gpu class to look in
+        U32         mType = 0;                      // GL_VERTEX_SHADER, GL_FRAGMENT_SHADER...
+        std::map<std::string, std::string> mDefines;
+        S32         mTextureIndexChannels = -1;
+    };
+
+    struct Source
+    {
+        std::string mText;
+        std::string mPath;          // file the text was read from
+        S32         mGPUClass = 0;  // gpu class directory the file was found in
+        S64         mFileSize = 0;
+        S64         mFileTime = 0;
+    };
+    typedef std::shared_ptr<const Source> source_ptr_t;
+
+    // Look up and assemble without the cache, false if no class has the file
+    static bool assemble(const Environment& env, const Request& request, Source& source);
+    static U64 hash(const Environment& env, const Request& request);
+
+    // Cached source for request, assembling it if needed. NULL if the file
+    // can't be found.
+    source_ptr_t get(const Environment& env, const Request& request);
+
+    // Assemble every request not already cached, spread over the Parallel
+    // thread pool, so the get() calls that follow are cache hits
+    void prefetch(const Environment& env, const std::vector<Request>& requests);
+
+    void clear();
+
+    U32 getHits() const { return mHits; }
+    U32 getMisses() const { return mMisses; }
+
+private:
+    static bool isCurrent(const Source& source);
+
+    typedef std::unordered_map<U64, source_ptr_t> source_map_t;
+    source_map_t    mSources;
+    LLMutex         mMutex;
+    U32             mHits = 0;
+    U32             mMisses = 0;
+};
+
+#endif // LL_SHADERSOURCECACHE_H
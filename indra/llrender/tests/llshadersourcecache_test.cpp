@@ -0,0 +1,417 @@
+/**
+ * @file llshadersourcecache_test.cpp
+ * @brief LLShaderSourceCache test cases.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llshadersourcecache.h"
+
+#include "llfile.h"
+#include "llglheaders.h"
+#include "lltimer.h"
+#include "parallelfor.h"
+#include "stringize.h"
+#include "threadpool.h"
+
+#include "../test/lltut.h"
+#include "../test/test.h"
+
+#include <filesystem>
+#include <set>
+
+namespace
+{
+    // The source loading of LLShaderMgr::loadShaderFile() before it moved to
+    // LLShaderSourceCache, fixed size line buffers and all. The assembled
+    // sources must come out exactly as this concatenates them.
+    bool legacy_assemble(const LLShaderSourceCache::Environment& env, const LLShaderSourceCache::Request& request, std::string& text)
+    {
+        LLFILE* file = NULL;
+        for (S32 gpu_class = request.mShaderLevel; gpu_class > 0 && !file; gpu_class--)
+        {
+            file = LLFile::fopen(STRINGIZE(env.mShaderDirPrefix << gpu_class << "/" << request.mFilename), "r");
+        }
+        if (!file)
+        {
+            return false;
+        }
+
+        char buff[1024];
+        std::vector<std::string> extra_code_text(1024);
+        std::vector<std::string> shader_code_text(4096 + 1024);
+        U32 extra_code_count = 0, shader_code_count = 0;
+
+        S32 major_version = env.mGLSLVersionMajor;
+        S32 minor_version = env.mGLSLVersionMinor;
+        if (major_version >= 4)
+        {
+            shader_code_text[shader_code_count++] = minor_version >= 20 ? "#version 420\n" : "#version 400\n";
+        }
+        else if (major_version == 3)
+        {
+            shader_code_text[shader_code_count++] = minor_version <= 29 ? "#version 150\n" : "#version 330\n";
+        }
+        else if (major_version == 1 && minor_version >= 30)
+        {
+            shader_code_text[shader_code_count++] = (request.mType == GL_GEOMETRY_SHADER || minor_version >= 50) ? "#version 150\n" : "#version 140\n";
+            extra_code_text[extra_code_count++] = "precision mediump int;\n";
+            extra_code_text[extra_code_count++] = "precision highp float;\n";
+        }
+
+        extra_code_text[extra_code_count++] = request.mType == GL_FRAGMENT_SHADER ? "#define FRAGMENT_SHADER 1\n" : "#define VERTEX_SHADER 1\n";
+        extra_code_text[extra_code_count++] = "#define GBUFFER_FLAG_SKIP_ATMOS   0.0 \n";
+        extra_code_text[extra_code_count++] = "#define GBUFFER_FLAG_HAS_ATMOS    0.34\n";
+        extra_code_text[extra_code_count++] = "#define GBUFFER_FLAG_HAS_PBR      0.67\n";
+        extra_code_text[extra_code_count++] = "#define GBUFFER_FLAG_HAS_HDRI      1.0\n";
+        extra_code_text[extra_code_count++] = "#define GET_GBUFFER_FLAG(data, flag)    (abs(data-flag)< 0.1)\n";
+        for (const auto& [name, value] : request.mDefines)
+        {
+            extra_code_text[extra_code_count++] = "#define " + name + " " + value + "\n";
+        }
+        if (env.mIsAMD)
+        {
+            extra_code_text[extra_code_count++] = "#define IS_AMD_CARD 1\n";
+        }
+        const S32 texture_index_channels = request.mTextureIndexChannels;
+        if (texture_index_channels > 0 && request.mType == GL_FRAGMENT_SHADER)
+        {
+            extra_code_text[extra_code_count++] = "#define HAS_DIFFUSE_LOOKUP\n";
+            for (S32 i = 0; i < texture_index_channels; ++i)
+            {
+                extra_code_text[extra_code_count++] = llformat("uniform sampler2D tex%d;\n", i);
+            }
+            if (texture_index_channels > 1)
+            {
+                extra_code_text[extra_code_count++] = "flat in int vary_texture_index;\n";
+            }
+            extra_code_text[extra_code_count++] = "vec4 diffuseLookup(vec2 texcoord)\n";
+            extra_code_text[extra_code_count++] = "{\n";
+            if (texture_index_channels == 1)
+            {
+                extra_code_text[extra_code_count++] = "return texture(tex0, texcoord);\n";
+                extra_code_text[extra_code_count++] = "}\n";
+            }
+            else if (env.mIsNVIDIA)
+            {
+                for (S32 i = 0; i < texture_index_channels; ++i)
+                {
+                    extra_code_text[extra_code_count++] = llformat("\t%sif (vary_texture_index == %d) { return texture(tex%d, texcoord); }\n", i > 0 ? "else " : "", i, i);
+                }
+                extra_code_text[extra_code_count++] = "\treturn vec4(1,0,1,1);\n";
+                extra_code_text[extra_code_count++] = "}\n";
+            }
+            else
+            {
+                extra_code_text[extra_code_count++] = "\tvec4 ret = vec4(1,0,1,1);\n";
+                extra_code_text[extra_code_count++] = "\tswitch (vary_texture_index)\n";
+                extra_code_text[extra_code_count++] = "\t{\n";
+                for (S32 i = 0; i < texture_index_channels; ++i)
+                {
+                    extra_code_text[extra_code_count++] = llformat("\t\tcase %d: return texture(tex%d, texcoord);\n", i, i);
+                }
+                extra_code_text[extra_code_count++] = "\t}\n";
+                extra_code_text[extra_code_count++] = "\treturn ret;\n";
+                extra_code_text[extra_code_count++] = "}\n";
+            }
+        }
+        extra_code_text[extra_code_count++] = "struct GBufferInfo { vec4 albedo; vec4 specular; vec3 normal; vec4 emissive; float gbufferFlag; float envIntensity; };\n";
+
+        enum
+        {
+              flag_write_to_out_of_extra_block_area = 0x01
+            , flag_extra_block_marker_was_found = 0x02
+        };
+        unsigned char flags = flag_write_to_out_of_extra_block_area;
+        U32 out_of_extra_block_counter = 0, start_shader_code = shader_code_count, file_lines_count = 0;
+
+        while (NULL != fgets(buff, 1024, file) && shader_code_count < 4096)
+        {
+            file_lines_count++;
+            bool extra_block_area_found = NULL != strstr(buff, "[EXTRA_CODE_HERE]");
+            if (extra_block_area_found && !(flag_extra_block_marker_was_found & flags))
+            {
+                if (!(flag_write_to_out_of_extra_block_area & flags))
+                {
+                    for (U32 to = start_shader_code, from = extra_code_count + start_shader_code; from < shader_code_count; ++to, ++from)
+                    {
+                        shader_code_text[to] = shader_code_text[from];
+                    }
+                    shader_code_count -= extra_code_count;
+                }
+                for (U32 n = 0; n < extra_code_count && shader_code_count < 4096; ++n)
+                {
+                    shader_code_text[shader_code_count++] = extra_code_text[n];
+                }
+                extra_code_count = 0;
+                flags &= ~flag_write_to_out_of_extra_block_area;
+                flags |= flag_extra_block_marker_was_found;
+            }
+            else
+            {
+                shader_code_text[shader_code_count] = buff;
+                if (flag_write_to_out_of_extra_block_area & flags)
+                {
+                    shader_code_text[extra_code_count + start_shader_code + out_of_extra_block_counter] = shader_code_text[shader_code_count];
+                    out_of_extra_block_counter++;
+                    if (out_of_extra_block_counter == extra_code_count)
+                    {
+                        shader_code_count += extra_code_count;
+                        flags &= ~flag_write_to_out_of_extra_block_area;
+                    }
+                }
+                ++shader_code_count;
+            }
+        }
+
+        if (!(flag_extra_block_marker_was_found & flags))
+        {
+            for (U32 n = start_shader_code; n < extra_code_count + start_shader_code; ++n)
+            {
+                shader_code_text[n] = extra_code_text[n - start_shader_code];
+            }
+            if (file_lines_count < extra_code_count)
+            {
+                shader_code_count += extra_code_count;
+            }
+        }
+        fclose(file);
+
+        text.clear();
+        for (U32 i = 0; i < shader_code_count; ++i)
+        {
+            text += shader_code_text[i];
+        }
+        return true;
+    }
+} // anonymous namespace
+
+namespace tut
+{
+    struct llshadersourcecache_data
+    {
+        LLShaderSourceCache::Environment mEnv;
+        std::vector<LLShaderSourceCache::Request> mRequests;
+
+        llshadersourcecache_data()
+        {
+            const std::string shader_dir = sSourceDir + "../newview/app_settings/shaders/";
+            mEnv.mShaderDirPrefix = shader_dir + "class";
+            mEnv.mGLSLVersionMajor = 4;
+            mEnv.mGLSLVersionMinor = 60;
+
+            std::map<std::string, std::string> defines;
+            defines["SUN_SHADOW"] = "1";
+            defines["REFMAP_LEVEL"] = "3";
+            defines["TERRAIN_PBR_DETAIL"] = "0";
+
+            // every shader in every gpu class, asked for at its own class and
+            // from the top so that the class fallback is covered too
+            std::set<std::string> seen;
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(shader_dir))
+            {
+                const std::string path = entry.path().generic_string();
+                if (!entry.is_regular_file() || path.size() < 5 || path.compare(path.size() - 5, 5, ".glsl"))
+                {
+                    continue;
+                }
+                size_t class_pos = path.find("/class", shader_dir.size() - 1);
+                if (class_pos == std::string::npos)
+                {
+                    continue;
+                }
+                S32 gpu_class = atoi(path.c_str() + class_pos + 6);
+                std::string filename = path.substr(path.find('/', class_pos + 6) + 1);
+                U32 type = (filename.find("V.glsl") != std::string::npos) ? GL_VERTEX_SHADER : GL_FRAGMENT_SHADER;
+                S32 channels = (type == GL_FRAGMENT_SHADER) ? 4 : -1;
+
+                mRequests.emplace_back(filename, gpu_class, type, &defines, channels);
+                if (seen.insert(filename).second)
+                {
+                    mRequests.emplace_back(filename, 3, type, &defines, channels);
+                    mRequests.emplace_back(filename, 3, GL_FRAGMENT_SHADER, nullptr, 1);
+                }
+            }
+        }
+    };
+    typedef test_group<llshadersourcecache_data> llshadersourcecache_test;
+    typedef llshadersourcecache_test::object llshadersourcecache_object;
+    tut::llshadersourcecache_test tllshadersourcecache("LLShaderSourceCache");
+
+    template<> template<>
+    void llshadersourcecache_object::test<1>()
+    {
+        set_test_name("every viewer shader assembles like the old loader");
+
+        ensure("found the viewer shaders", mRequests.size() > 200);
+
+        LLShaderSourceCache::Environment envs[4] = { mEnv, mEnv, mEnv, mEnv };
+        envs[1].mGLSLVersionMajor = 3;
+        envs[1].mGLSLVersionMinor = 30;
+        envs[1].mIsNVIDIA = true;
+        envs[2].mGLSLVersionMajor = 1;
+        envs[2].mGLSLVersionMinor = 40;
+        envs[2].mIsAMD = true;
+        envs[3].mGLSLVersionMinor = 0;
+
+        for (const LLShaderSourceCache::Environment& env : envs)
+        {
+            for (const LLShaderSourceCache::Request& request : mRequests)
+            {
+                std::string expected;
+                LLShaderSourceCache::Source source;
+                ensure(STRINGIZE("legacy " << request.mFilename), legacy_assemble(env, request, expected));
+                ensure(STRINGIZE("assemble " << request.mFilename), LLShaderSourceCache::assemble(env, request, source));
+                ensure_equals(STRINGIZE(request.mFilename << " class " << request.mShaderLevel << " GLSL "
+                                        << env.mGLSLVersionMajor << "." << env.mGLSLVersionMinor),
+                              source.mText, expected);
+            }
+        }
+
+        LLShaderSourceCache::Source source;
+        ensure("missing file", !LLShaderSourceCache::assemble(mEnv, LLShaderSourceCache::Request("nonexistentF.glsl", 3, GL_FRAGMENT_SHADER), source));
+        ensure("no class to look in", !LLShaderSourceCache::assemble(mEnv, LLShaderSourceCache::Request("deferred/globalF.glsl", 0, GL_FRAGMENT_SHADER), source));
+    }
+
+    template<> template<>
+    void llshadersourcecache_object::test<2>()
+    {
+        set_test_name("parallel prefetch matches serial assembly");
+
+        LL::ThreadPool pool(LL::PARALLEL_POOL_NAME, 3);
+        pool.start();
+
+        LLShaderSourceCache cache;
+        cache.prefetch(mEnv, mRequests);
+        const U32 assembled = cache.getMisses();
+        ensure("prefetch assembled", assembled > 0 && assembled <= mRequests.size());
+
+        for (const LLShaderSourceCache::Request& request : mRequests)
+        {
+            LLShaderSourceCache::Source expected;
+            LLShaderSourceCache::assemble(mEnv, request, expected);
+            LLShaderSourceCache::source_ptr_t source = cache.get(mEnv, request);
+            ensure(STRINGIZE("cached " << request.mFilename), source != nullptr);
+            ensure_equals(STRINGIZE("text " << request.mFilename), source->mText, expected.mText);
+            ensure_equals(STRINGIZE("path " << request.mFilename), source->mPath, expected.mPath);
+        }
+        ensure_equals("everything was prefetched", cache.getMisses(), assembled);
+        ensure_equals("every get was a hit", cache.getHits(), (U32)mRequests.size());
+
+        // a different define is a different source
+        LLShaderSourceCache::Request request = mRequests.front();
+        request.mDefines["SSR"] = "1";
+        cache.get(mEnv, request);
+        ensure_equals("new define misses", cache.getMisses(), assembled + 1);
+    }
+
+    template<> template<>
+    void llshadersourcecache_object::test<3>()
+    {
+        set_test_name("edited files are assembled again");
+
+        const std::filesystem::path dir = std::filesystem::temp_directory_path() / STRINGIZE("llshadersourcecache_" << LLTimer::getTotalTime());
+        std::filesystem::create_directories(dir / "class1");
+        const std::string path = (dir / "class1" / "testF.glsl").string();
+
+        LLShaderSourceCache::Environment env = mEnv;
+        env.mShaderDirPrefix = (dir / "class").string();
+        LLShaderSourceCache::Request request("testF.glsl", 2, GL_FRAGMENT_SHADER);
+        LLShaderSourceCache cache;
+
+        {
+            llofstream out(path.c_str());
+            out << "out vec4 frag_color;\n[EXTRA_CODE_HERE]\nvoid main() { frag_color = vec4(1); }\n";
+        }
+        LLShaderSourceCache::source_ptr_t first = cache.get(env, request);
+        ensure("first", first && first->mGPUClass == 1);
+        ensure("marker replaced", first->mText.find("[EXTRA_CODE_HERE]") == std::string::npos
+                                  && first->mText.find("frag_color;\n#define FRAGMENT_SHADER 1\n") != std::string::npos);
+        ensure("cached", cache.get(env, request) == first);
+
+        {
+            llofstream out(path.c_str());
+            out << "void main() { }\n";
+        }
+        LLShaderSourceCache::source_ptr_t second = cache.get(env, request);
+        ensure("reloaded", second && second != first);
+        ensure("new text", second->mText.find("void main() { }") != std::string::npos);
+        ensure("extra code on top", second->mText.find("#define FRAGMENT_SHADER 1") < second->mText.find("void main"));
+
+        std::filesystem::remove_all(dir);
+    }
+
+#if LL_BENCHMARK
+    template<> template<>
+    void llshadersourcecache_object::test<4>()
+    {
+        set_test_name("serial and parallel assembly time");
+
+        LLTimer timer;
+        for (const LLShaderSourceCache::Request& request : mRequests)
+        {
+            std::string text;
+            legacy_assemble(mEnv, request, text);
+        }
+        F64 legacy_time = timer.getElapsedTimeF64();
+
+        LLShaderSourceCache serial;
+        timer.reset();
+        for (const LLShaderSourceCache::Request& request : mRequests)
+        {
+            serial.get(mEnv, request);
+        }
+        F64 serial_time = timer.getElapsedTimeF64();
+
+        LL::ThreadPool pool(LL::PARALLEL_POOL_NAME, 3);
+        pool.start();
+        LLShaderSourceCache parallel;
+        timer.reset();
+        parallel.prefetch(mEnv, mRequests);
+        F64 parallel_time = timer.getElapsedTimeF64();
+
+        timer.reset();
+        for (const LLShaderSourceCache::Request& request : mRequests)
+        {
+            parallel.get(mEnv, request);
+        }
+        F64 cached_time = timer.getElapsedTimeF64();
+
+        // two files at a time, the size of a typical program
+        LLShaderSourceCache pairs;
+        timer.reset();
+        for (size_t i = 0; i < mRequests.size(); i += 2)
+        {
+            std::vector<LLShaderSourceCache::Request> pair(mRequests.begin() + i, mRequests.begin() + llmin(i + 2, mRequests.size()));
+            pairs.prefetch(mEnv, pair);
+        }
+        F64 pairs_time = timer.getElapsedTimeF64();
+
+        LL_INFOS() << mRequests.size() << " shader sources: old loader " << legacy_time * 1000.0 << " ms, serial "
+                   << serial_time * 1000.0 << " ms, prefetched on 4 threads " << parallel_time * 1000.0
+                   << " ms, prefetched two at a time " << pairs_time * 1000.0 << " ms, cached "
+                   << cached_time * 1000.0 << " ms" << LL_ENDL;
+    }
+#endif // LL_BENCHMARK
+}
@@ -418,6 +418,7 @@ LLPointer<LLControlVariable> LLControlGroup::getControl(std::string_view name)
     {
         incrCount(name);
     }
+    mNameLookups.fetch_add(1, std::memory_order_relaxed);
 
     ctrl_name_table_t::iterator iter = mNameTable.find(name);
     return iter == mNameTable.end() ? LLPointer<LLControlVariable>() : iter->second;
@@ -454,6 +455,7 @@ const std::string LLControlGroup::mSanityTypeString[SANITY_TYPE_COUNT] = { "None
 
 LLControlGroup::LLControlGroup(const std::string& name)
 :   LLInstanceTracker<LLControlGroup, std::string>(name),
+    mNameLookups(0),
     mSettingsProfile(false)
 {
 
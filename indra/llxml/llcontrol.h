@@ -34,6 +34,7 @@
 #include "llrefcount.h"
 #include "llinstancetracker.h"
 
+#include <atomic>
 #include <vector>
 
 #include <boost/bind.hpp>
@@ -204,6 +205,7 @@ class LLControlGroup : public LLInstanceTracker<LLControlGroup, std::string>
 protected:
     typedef std::map<std::string, LLControlVariablePtr, std::less<> > ctrl_name_table_t;
     ctrl_name_table_t mNameTable;
+    std::atomic<U32> mNameLookups;
     static const std::string mTypeString[TYPE_COUNT];
     static const std::string mSanityTypeString[SANITY_TYPE_COUNT];
 
@@ -218,6 +220,9 @@ public:
     void cleanup();
 
     LLControlVariablePtr getControl(std::string_view name);
+    // Number of getControl() calls so far, which includes every getter and
+    // setter taking a name.  Hot paths should read through LLCachedControl.
+    U32 getNameLookupCount() const { return mNameLookups.load(std::memory_order_relaxed); }
 
     struct ApplyFunctor
     {
@@ -28,6 +28,7 @@
 #include "linden_common.h"
 #include "llsdserialize.h"
 #include "llfile.h"
+#include "lltimer.h"
 #include "stringize.h"
 
 #include "../llcontrol.h"
@@ -151,4 +152,56 @@ namespace tut
         ensure("listener fired on changed setting", mListenerFired);
     }
 
+    //name lookup counter
+    template<> template<>
+    void control_group_t::test<5>()
+    {
+        mCG->declareF32("TestCachedF32", 1.5f, "float for lookup counter test");
+        LLCachedControl<F32> cached(*mCG, "TestCachedF32");
+
+        // by-name lookups are counted, cached reads are not
+        U32 lookups = mCG->getNameLookupCount();
+        ensure_equals("cached read", (F32)cached, 1.5f);
+        ensure_equals("cached read does no lookup", mCG->getNameLookupCount(), lookups);
+        mCG->setF32("TestCachedF32", 2.25f);
+        ensure_equals("cached read follows changes", (F32)cached, 2.25f);
+        ensure_equals("getter agrees", mCG->getF32("TestCachedF32"), 2.25f);
+        ensure_equals("setter and getter do one lookup each", mCG->getNameLookupCount(), lookups + 2);
+    }
+
+#if LL_BENCHMARK
+    //cached read cost against by-name lookup
+    template<> template<>
+    void control_group_t::test<6>()
+    {
+        // pad the table so the name lookup is representative of gSavedSettings
+        for (S32 i = 0; i < 2000; ++i)
+        {
+            mCG->declareF32(STRINGIZE("Padding" << i), (F32)i, "padding");
+        }
+        mCG->declareF32("RenderTestFloat", 0.5f, "float for benchmark");
+        LLCachedControl<F32> cached(*mCG, "RenderTestFloat");
+
+        const S32 reads = 200000;
+        F32 sum = 0.f;
+        LLTimer timer;
+        for (S32 i = 0; i < reads; ++i)
+        {
+            sum += mCG->getF32("RenderTestFloat");
+        }
+        F64 by_name = timer.getElapsedTimeF64();
+
+        timer.reset();
+        for (S32 i = 0; i < reads; ++i)
+        {
+            sum += cached;
+        }
+        F64 by_cached = timer.getElapsedTimeF64();
+
+        ensure_equals("both paths read the value", sum, 0.5f * reads * 2);
+
+        LL_INFOS() << reads << " reads: by name " << by_name * 1000.0 << " ms, cached "
+                   << by_cached * 1000.0 << " ms" << LL_ENDL;
+    }
+#endif // LL_BENCHMARK
 }
@@ -112,6 +112,7 @@ private:
         if (mAreaSearchFloater)
         {
             mAreaSearchFloater->checkRegion();
+            mAreaSearchFloater->onAgentParcelChanged();
         }
     }
 
@@ -171,6 +172,7 @@ FSAreaSearch::FSAreaSearch(const LLSD& key) :
     mExcludeNeighborRegions(true),
     mRequestQueuePause(false),
     mRequestNeedsSent(false),
+    mMatchGeneration(1),
     mRlvBehaviorCallbackConnection()
 {
     gAgent.setFSAreaSearchActive(true);
@@ -350,6 +352,8 @@ void FSAreaSearch::checkRegion()
             mLastRegion = region;
             mRequested = 0;
             mObjectDetails.clear();
+            mPendingRequests.clear();
+            mNameWaiting.clear();
             mRegionRequests.clear();
             mLastPropertiesReceivedTimer.start();
             mPanelList->getResultList()->deleteAllItems();
@@ -368,6 +372,8 @@ void FSAreaSearch::refreshList(bool cache_clear)
     {
         mRequested = 0;
         mObjectDetails.clear();
+        mPendingRequests.clear();
+        mNameWaiting.clear();
         mRegionRequests.clear();
         mLastPropertiesReceivedTimer.start();
     }
@@ -378,6 +384,9 @@ void FSAreaSearch::refreshList(bool cache_clear)
              object_it.second.listed = false;
         }
     }
+    // the list starts over, everything gets matched again
+    invalidateMatches();
+    clearNameMatches();
     mPanelList->getResultList()->deleteAllItems();
     mPanelList->setCounterText();
     mPanelList->setAgentLastPosition(gAgent.getPositionGlobal());
@@ -401,8 +410,10 @@ void FSAreaSearch::findObjects()
         return;
     }
 
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_UI;
     LL_DEBUGS("FSAreaSearch_spammy") << "Doing a FSAreaSearch::findObjects" << LL_ENDL;
 
+    LLTimer find_timer;
     mLastUpdateTimer.stop(); // stop sets getElapsedTimeF32() time to zero.
     // Pause processing of requestqueue until done adding new requests.
     mRequestQueuePause = true;
@@ -411,6 +422,14 @@ void FSAreaSearch::findObjects()
     mSearchableObjects = 0;
     S32 object_count = gObjectList.getNumObjects();
 
+    // the distance filter depends on where the agent was at the last list
+    // update, objects rejected from elsewhere need another look
+    if (mFilterDistance && mPanelList->getAgentLastPosition() != mMatchAgentPosition)
+    {
+        mMatchAgentPosition = mPanelList->getAgentLastPosition();
+        invalidateMatches();
+    }
+
     for (S32 i = 0; i < object_count; i++)
     {
         LLViewerObject* objectp = gObjectList.getObject(i);
@@ -429,32 +448,26 @@ void FSAreaSearch::findObjects()
 
         mSearchableObjects++;
 
-        if (mObjectDetails.count(object_id) == 0)
+        auto [details_it, inserted] = mObjectDetails.try_emplace(object_id);
+        FSObjectProperties& details = details_it->second;
+        if (inserted)
         {
-            FSObjectProperties& details = mObjectDetails[object_id];
             details.id = object_id;
             details.local_id = objectp->getLocalID();
             details.region_handle = objectp->getRegion()->getHandle();
-            mRequestNeedsSent = true;
-            mRequested++;
+            setRequestNeeded(details);
         }
-        else
+        else if (details.request == FSObjectProperties::FINISHED)
         {
-            FSObjectProperties& details = mObjectDetails[object_id];
-            if (details.request == FSObjectProperties::FINISHED)
-            {
-                matchObject(details, objectp);
-            }
-
-            if (details.request == FSObjectProperties::FAILED)
-            {
-                // object came back into view
-                details.request = FSObjectProperties::NEED;
-                details.local_id = objectp->getLocalID();
-                details.region_handle = objectp->getRegion()->getHandle();
-                mRequestNeedsSent = true;
-                mRequested++;
-            }
+            // cheap unless the object or the search changed since it was last rejected
+            matchObject(details, objectp);
+        }
+        else if (details.request == FSObjectProperties::FAILED)
+        {
+            // object came back into view
+            details.local_id = objectp->getLocalID();
+            details.region_handle = objectp->getRegion()->getHandle();
+            setRequestNeeded(details);
         }
     }
 
@@ -462,20 +475,18 @@ void FSAreaSearch::findObjects()
 
     S32 request_count = 0;
     // requests for non-existent objects will never arrive, check and update the queue.
-    for (auto& object_it : mObjectDetails)
+    for (auto pending_it = mPendingRequests.begin(); pending_it != mPendingRequests.end(); )
     {
-        if (object_it.second.request == FSObjectProperties::NEED || object_it.second.request == FSObjectProperties::SENT)
+        if (!gObjectList.findObject(*pending_it))
         {
-            const LLUUID& id = object_it.second.id;
-            if (LLViewerObject* objectp = gObjectList.findObject(id); !objectp)
-            {
-                object_it.second.request = FSObjectProperties::FAILED;
-                mRequested--;
-            }
-            else
-            {
-                request_count++;
-            }
+            mObjectDetails[*pending_it].request = FSObjectProperties::FAILED;
+            pending_it = mPendingRequests.erase(pending_it);
+            mRequested--;
+        }
+        else
+        {
+            request_count++;
+            ++pending_it;
         }
     }
 
@@ -488,6 +499,27 @@ void FSAreaSearch::findObjects()
     updateCounterText();
     mLastUpdateTimer.start(); // start also reset elapsed time to zero
     mRequestQueuePause = false;
+
+    LL_DEBUGS("FSAreaSearch") << "Searched " << mSearchableObjects << " of " << object_count << " objects in "
+                              << find_timer.getElapsedTimeF32() * 1000.f << " ms" << LL_ENDL;
+}
+
+void FSAreaSearch::onAgentParcelChanged()
+{
+    // the parcel filter tests against the agent's current parcel
+    if (mActive && mFilterAgentParcelOnly)
+    {
+        invalidateMatches();
+        mRefresh = true;
+    }
+}
+
+void FSAreaSearch::setRequestNeeded(FSObjectProperties& details)
+{
+    details.request = FSObjectProperties::NEED;
+    mPendingRequests.insert(details.id);
+    mRequestNeedsSent = true;
+    mRequested++;
 }
 
 bool FSAreaSearch::isSearchableObject(LLViewerObject* objectp, LLViewerRegion* our_region)
@@ -559,20 +591,15 @@ void FSAreaSearch::processRequestQueue()
     {
         LL_DEBUGS("FSAreaSearch") << "Timeout reached, resending requests."<< LL_ENDL;
         S32 request_count = 0;
-        S32 failed_count = 0;
-        for (auto& object_it : mObjectDetails)
+        for (const LLUUID& id : mPendingRequests)
         {
-            if (object_it.second.request == FSObjectProperties::SENT)
+            FSObjectProperties& details = mObjectDetails[id];
+            if (details.request == FSObjectProperties::SENT)
             {
-                object_it.second.request = FSObjectProperties::NEED;
+                details.request = FSObjectProperties::NEED;
                 mRequestNeedsSent = true;
                 request_count++;
             }
-
-            if (object_it.second.request == FSObjectProperties::FAILED)
-            {
-                failed_count++;
-            }
         }
 
         mRegionRequests.clear();
@@ -586,8 +613,6 @@ void FSAreaSearch::processRequestQueue()
         {
             LL_DEBUGS("FSAreaSearch") << request_count << " pending requests found."<< LL_ENDL;
         }
-
-        LL_DEBUGS("FSAreaSearch") << failed_count << " failed requests found."<< LL_ENDL;
     }
 
     if (!mRequestNeedsSent)
@@ -596,6 +621,17 @@ void FSAreaSearch::processRequestQueue()
     }
     mRequestNeedsSent = false;
 
+    // one pass over the pending requests instead of all objects per region
+    std::map<U64, std::vector<FSObjectProperties*>> region_queues;
+    for (const LLUUID& id : mPendingRequests)
+    {
+        FSObjectProperties& details = mObjectDetails[id];
+        if (details.request == FSObjectProperties::NEED)
+        {
+            region_queues[details.region_handle].push_back(&details);
+        }
+    }
+
     for (const auto regionp : LLWorld::getInstance()->getRegionList())
     {
         U64 region_handle = regionp->getHandle();
@@ -608,21 +644,18 @@ void FSAreaSearch::processRequestQueue()
         std::vector<U32> request_list;
         bool need_continue = false;
 
-        for (auto& object_it : mObjectDetails)
+        for (FSObjectProperties* details : region_queues[region_handle])
         {
-            if (object_it.second.request == FSObjectProperties::NEED && object_it.second.region_handle == region_handle)
+            request_list.push_back(details->local_id);
+            details->request = FSObjectProperties::SENT;
+            mRegionRequests[region_handle]++;
+            if (mRegionRequests[region_handle] >= ((MAX_OBJECTS_PER_PACKET * 3) - 3))
             {
-                request_list.push_back(object_it.second.local_id);
-                object_it.second.request = FSObjectProperties::SENT;
-                mRegionRequests[region_handle]++;
-                if (mRegionRequests[region_handle] >= ((MAX_OBJECTS_PER_PACKET * 3) - 3))
-                {
-                    requestObjectProperties(request_list, true, regionp);
-                    requestObjectProperties(request_list, false, regionp);
-                    mRequestNeedsSent = true;
-                    need_continue = true;
-                    break;
-                }
+                requestObjectProperties(request_list, true, regionp);
+                requestObjectProperties(request_list, false, regionp);
+                mRequestNeedsSent = true;
+                need_continue = true;
+                break;
             }
         }
 
@@ -719,6 +752,7 @@ void FSAreaSearch::processObjectProperties(LLMessageSystem* msg)
             // and requested objects.
 
             details.request = FSObjectProperties::FINISHED;
+            mPendingRequests.erase(object_id);
             mLastPropertiesReceivedTimer.start();
 
             if (details.id.isNull())
@@ -735,53 +769,59 @@ void FSAreaSearch::processObjectProperties(LLMessageSystem* msg)
                 mRegionRequests[details.region_handle]--;
                 counter_text_update = true;
             }
-
-            msg->getUUIDFast(_PREHASH_ObjectData, _PREHASH_CreatorID, details.creator_id, i);
-            msg->getUUIDFast(_PREHASH_ObjectData, _PREHASH_OwnerID, details.owner_id, i);
-            msg->getUUIDFast(_PREHASH_ObjectData, _PREHASH_GroupID, details.group_id, i);
-            msg->getU64Fast(_PREHASH_ObjectData, _PREHASH_CreationDate, details.creation_date, i);
-            msg->getU32Fast(_PREHASH_ObjectData, _PREHASH_BaseMask, details.base_mask, i);
-            msg->getU32Fast(_PREHASH_ObjectData, _PREHASH_OwnerMask, details.owner_mask, i);
-            msg->getU32Fast(_PREHASH_ObjectData,_PREHASH_GroupMask, details.group_mask, i);
-            msg->getU32Fast(_PREHASH_ObjectData, _PREHASH_EveryoneMask, details.everyone_mask, i);
-            msg->getU32Fast(_PREHASH_ObjectData, _PREHASH_NextOwnerMask, details.next_owner_mask, i);
-            details.sale_info.unpackMultiMessage(msg, _PREHASH_ObjectData, i);
-            details.ag_perms.unpackMessage(msg, _PREHASH_ObjectData, _PREHASH_AggregatePerms, i);
-            details.ag_texture_perms.unpackMessage(msg, _PREHASH_ObjectData, _PREHASH_AggregatePermTextures, i);
-            details.ag_texture_perms_owner.unpackMessage(msg, _PREHASH_ObjectData, _PREHASH_AggregatePermTexturesOwner, i);
-            details.category.unpackMultiMessage(msg, _PREHASH_ObjectData, i);
-            msg->getUUIDFast(_PREHASH_ObjectData, _PREHASH_LastOwnerID, details.last_owner_id, i);
-            msg->getStringFast(_PREHASH_ObjectData, _PREHASH_Name, details.name, i);
-            msg->getStringFast(_PREHASH_ObjectData, _PREHASH_Description, details.description, i);
-            msg->getStringFast(_PREHASH_ObjectData, _PREHASH_TouchName, details.touch_name, i);
-            msg->getStringFast(_PREHASH_ObjectData, _PREHASH_SitName, details.sit_name, i);
-
-            S32 size = msg->getSizeFast(_PREHASH_ObjectData, i, _PREHASH_TextureID);
-            if (size > 0)
+        }
+        else
+        {
+            // properties sent again, the object changed since it was matched
+            details.match_generation = 0;
+        }
+
+        msg->getUUIDFast(_PREHASH_ObjectData, _PREHASH_CreatorID, details.creator_id, i);
+        msg->getUUIDFast(_PREHASH_ObjectData, _PREHASH_OwnerID, details.owner_id, i);
+        msg->getUUIDFast(_PREHASH_ObjectData, _PREHASH_GroupID, details.group_id, i);
+        msg->getU64Fast(_PREHASH_ObjectData, _PREHASH_CreationDate, details.creation_date, i);
+        msg->getU32Fast(_PREHASH_ObjectData, _PREHASH_BaseMask, details.base_mask, i);
+        msg->getU32Fast(_PREHASH_ObjectData, _PREHASH_OwnerMask, details.owner_mask, i);
+        msg->getU32Fast(_PREHASH_ObjectData,_PREHASH_GroupMask, details.group_mask, i);
+        msg->getU32Fast(_PREHASH_ObjectData, _PREHASH_EveryoneMask, details.everyone_mask, i);
+        msg->getU32Fast(_PREHASH_ObjectData, _PREHASH_NextOwnerMask, details.next_owner_mask, i);
+        details.sale_info.unpackMultiMessage(msg, _PREHASH_ObjectData, i);
+        details.ag_perms.unpackMessage(msg, _PREHASH_ObjectData, _PREHASH_AggregatePerms, i);
+        details.ag_texture_perms.unpackMessage(msg, _PREHASH_ObjectData, _PREHASH_AggregatePermTextures, i);
+        details.ag_texture_perms_owner.unpackMessage(msg, _PREHASH_ObjectData, _PREHASH_AggregatePermTexturesOwner, i);
+        details.category.unpackMultiMessage(msg, _PREHASH_ObjectData, i);
+        msg->getUUIDFast(_PREHASH_ObjectData, _PREHASH_LastOwnerID, details.last_owner_id, i);
+        msg->getStringFast(_PREHASH_ObjectData, _PREHASH_Name, details.name, i);
+        msg->getStringFast(_PREHASH_ObjectData, _PREHASH_Description, details.description, i);
+        msg->getStringFast(_PREHASH_ObjectData, _PREHASH_TouchName, details.touch_name, i);
+        msg->getStringFast(_PREHASH_ObjectData, _PREHASH_SitName, details.sit_name, i);
+
+        details.texture_ids.clear();
+        S32 size = msg->getSizeFast(_PREHASH_ObjectData, i, _PREHASH_TextureID);
+        if (size > 0)
+        {
+            S8 packed_buffer[SELECT_MAX_TES * UUID_BYTES];
+            msg->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_TextureID, packed_buffer, 0, i, SELECT_MAX_TES * UUID_BYTES);
+
+            for (S32 buf_offset = 0; buf_offset < size; buf_offset += UUID_BYTES)
             {
-                S8 packed_buffer[SELECT_MAX_TES * UUID_BYTES];
-                msg->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_TextureID, packed_buffer, 0, i, SELECT_MAX_TES * UUID_BYTES);
-
-                for (S32 buf_offset = 0; buf_offset < size; buf_offset += UUID_BYTES)
-                {
-                    LLUUID tid;
-                    memcpy(tid.mData, packed_buffer + buf_offset, UUID_BYTES);      /* Flawfinder: ignore */
-                    details.texture_ids.push_back(tid);
-                }
+                LLUUID tid;
+                memcpy(tid.mData, packed_buffer + buf_offset, UUID_BYTES);      /* Flawfinder: ignore */
+                details.texture_ids.push_back(tid);
             }
+        }
 
-            details.permissions.init(details.creator_id, details.owner_id, details.last_owner_id, details.group_id);
-            details.permissions.initMasks(details.base_mask, details.owner_mask, details.everyone_mask, details.group_mask, details.next_owner_mask);
+        details.permissions.init(details.creator_id, details.owner_id, details.last_owner_id, details.group_id);
+        details.permissions.initMasks(details.base_mask, details.owner_mask, details.everyone_mask, details.group_mask, details.next_owner_mask);
 
-            // Sets the group owned bool and real owner id, group or owner depending if object is group owned.
-            details.permissions.getOwnership(details.ownership_id, details.group_owned);
+        // Sets the group owned bool and real owner id, group or owner depending if object is group owned.
+        details.permissions.getOwnership(details.ownership_id, details.group_owned);
 
-            LL_DEBUGS("FSAreaSearch_spammy") << "Got properties for object: " << object_id << LL_ENDL;
+        LL_DEBUGS("FSAreaSearch_spammy") << "Got properties for object: " << object_id << LL_ENDL;
 
-            if (isSearchableObject(objectp, our_region))
-            {
-                matchObject(details, objectp);
-            }
+        if (isSearchableObject(objectp, our_region))
+        {
+            matchObject(details, objectp);
         }
     }
 
@@ -799,6 +839,15 @@ void FSAreaSearch::matchObject(FSObjectProperties& details, LLViewerObject* obje
         return;
     }
 
+    const F64Seconds last_update = objectp->getLastMessageUpdateSecs();
+    if (details.match_generation == mMatchGeneration && details.matched_update == last_update && !details.name_requested)
+    {
+        // rejected before, and neither the object nor the search changed since
+        return;
+    }
+    details.match_generation = mMatchGeneration;
+    details.matched_update = last_update;
+
     //-----------------------------------------------------------------------
     // Filters
     //-----------------------------------------------------------------------
@@ -921,86 +970,32 @@ void FSAreaSearch::matchObject(FSObjectProperties& details, LLViewerObject* obje
     std::string object_description = details.description;
 
     details.name_requested = false;
-    getNameFromUUID(details.ownership_id, owner_name, details.group_owned, details.name_requested);
-    getNameFromUUID(details.creator_id, creator_name, false, details.name_requested);
-    getNameFromUUID(details.last_owner_id, last_owner_name, false, details.name_requested);
-    getNameFromUUID(details.group_id, group_name, true, details.name_requested);
+    const bool owner_known = getNameFromUUID(details.ownership_id, owner_name, details.group_owned, details.name_requested);
+    const bool creator_known = getNameFromUUID(details.creator_id, creator_name, false, details.name_requested);
+    const bool last_owner_known = getNameFromUUID(details.last_owner_id, last_owner_name, false, details.name_requested);
+    const bool group_known = getNameFromUUID(details.group_id, group_name, true, details.name_requested);
+    if (details.name_requested)
+    {
+        mNameWaiting.insert(object_id);
+    }
+    else
+    {
+        mNameWaiting.erase(object_id);
+    }
 
     owner_name = RLVa_hideNameIfRestricted(owner_name);
     last_owner_name = RLVa_hideNameIfRestricted(last_owner_name);
 
-    if (mRegexSearch)
+    // name and description are per object, the names are shared by many
+    // objects so their results are kept per id
+    if (!textMatches(object_name, mSearchName, mRegexSearchName)
+        || !textMatches(object_description, mSearchDescription, mRegexSearchDescription)
+        || !nameMatches(NAME_OWNER, details.ownership_id, owner_name, owner_known, mSearchOwner, mRegexSearchOwner)
+        || !nameMatches(NAME_GROUP, details.group_id, group_name, group_known, mSearchGroup, mRegexSearchGroup)
+        || !nameMatches(NAME_CREATOR, details.creator_id, creator_name, creator_known, mSearchCreator, mRegexSearchCreator)
+        || !nameMatches(NAME_LAST_OWNER, details.last_owner_id, last_owner_name, last_owner_known, mSearchLastOwner, mRegexSearchLastOwner))
     {
-        try
-        {
-            if (!mSearchName.empty() && !boost::regex_match(object_name, mRegexSearchName))
-            {
-                return;
-            }
-            if (!mSearchDescription.empty() && !boost::regex_match(object_description, mRegexSearchDescription))
-            {
-                return;
-            }
-            if (!mSearchOwner.empty() && !boost::regex_match(owner_name, mRegexSearchOwner))
-            {
-                return;
-            }
-            if (!mSearchGroup.empty() && !boost::regex_match(group_name, mRegexSearchGroup))
-            {
-                return;
-            }
-            if (!mSearchCreator.empty() && !boost::regex_match(creator_name, mRegexSearchCreator))
-            {
-                return;
-            }
-            if (!mSearchLastOwner.empty() && !boost::regex_match(last_owner_name, mRegexSearchLastOwner))
-            {
-                return;
-            }
-        }
-
-        // Should not end up here due to error checking in Find class. However, some complex regexes may
-        // cause excessive resources and boost will throw an execption.
-        // Due to the possiablitey of hitting this block a 1000 times per second, only logonce it.
-        catch(boost::regex_error& e)
-        {
-            LL_WARNS_ONCE("FSAreaSearch") << "boost::regex_error error in regex: "<< e.what() << LL_ENDL;
-        }
-        catch(const std::exception& e)
-        {
-            LL_WARNS_ONCE("FSAreaSearch") << "std::exception error in regex: "<< e.what() << LL_ENDL;
-        }
-        catch (...)
-        {
-            LL_WARNS_ONCE("FSAreaSearch") << "Unknown error in regex" << LL_ENDL;
-        }
-    }
-    else
-    {
-        if (!mSearchName.empty() && boost::ifind_first(object_name, mSearchName).empty())
-        {
-            return;
-        }
-        if (!mSearchDescription.empty() && boost::ifind_first(object_description, mSearchDescription).empty())
-        {
-            return;
-        }
-        if (!mSearchOwner.empty() && boost::ifind_first(owner_name, mSearchOwner).empty())
-        {
-            return;
-        }
-        if (!mSearchGroup.empty() && boost::ifind_first(group_name, mSearchGroup).empty())
-        {
-            return;
-        }
-        if (!mSearchCreator.empty() && boost::ifind_first(creator_name, mSearchCreator).empty())
-        {
-            return;
-        }
-        if (!mSearchLastOwner.empty() && boost::ifind_first(last_owner_name, mSearchLastOwner).empty())
-        {
-            return;
-        }
+        return;
     }
 
     //-----------------------------------------------------------------------
@@ -1008,6 +1003,8 @@ void FSAreaSearch::matchObject(FSObjectProperties& details, LLViewerObject* obje
     //-----------------------------------------------------------------------
 
     details.listed = true;
+    // once it drops off the list, match it again right away
+    details.match_generation = 0;
 
     LLScrollListCell::Params cell_params;
     cell_params.font = LLFontGL::getFontSansSerif();
@@ -1097,6 +1094,72 @@ void FSAreaSearch::matchObject(FSObjectProperties& details, LLViewerObject* obje
     mPanelList->getResultList()->refreshLineHeight();
 }
 
+bool FSAreaSearch::textMatches(const std::string& text, const std::string& search, const boost::regex& regex_search)
+{
+    if (search.empty())
+    {
+        return true;
+    }
+
+    if (!mRegexSearch)
+    {
+        return !boost::ifind_first(text, search).empty();
+    }
+
+    try
+    {
+        return boost::regex_match(text, regex_search);
+    }
+
+    // Should not end up here due to error checking in Find class. However, some complex regexes may
+    // cause excessive resources and boost will throw an execption.
+    // Due to the possiablitey of hitting this block a 1000 times per second, only logonce it.
+    catch(boost::regex_error& e)
+    {
+        LL_WARNS_ONCE("FSAreaSearch") << "boost::regex_error error in regex: "<< e.what() << LL_ENDL;
+    }
+    catch(const std::exception& e)
+    {
+        LL_WARNS_ONCE("FSAreaSearch") << "std::exception error in regex: "<< e.what() << LL_ENDL;
+    }
+    catch (...)
+    {
+        LL_WARNS_ONCE("FSAreaSearch") << "Unknown error in regex" << LL_ENDL;
+    }
+    // a failing expression does not filter anything out
+    return true;
+}
+
+bool FSAreaSearch::nameMatches(ENameField field, const LLUUID& id, const std::string& name, bool name_known,
+                               const std::string& search, const boost::regex& regex_search)
+{
+    if (search.empty())
+    {
+        return true;
+    }
+
+    if (!name_known)
+    {
+        // matched against the placeholder for now, the name callback matches again
+        return textMatches(name, search, regex_search);
+    }
+
+    auto [it, inserted] = mNameMatches[field].try_emplace(id, false);
+    if (inserted)
+    {
+        it->second = textMatches(name, search, regex_search);
+    }
+    return it->second;
+}
+
+void FSAreaSearch::clearNameMatches()
+{
+    for (auto& matches : mNameMatches)
+    {
+        matches.clear();
+    }
+}
+
 void FSAreaSearch::updateObjectCosts(const LLUUID& object_id, F32 object_cost, F32 link_cost, F32 physics_cost, F32 link_physics_cost)
 {
     if (!mActive)
@@ -1118,7 +1181,7 @@ void FSAreaSearch::updateObjectCosts(const LLUUID& object_id, F32 object_cost, F
     }
 }
 
-void FSAreaSearch::getNameFromUUID(const LLUUID& id, std::string& name, bool group, bool& name_requested)
+bool FSAreaSearch::getNameFromUUID(const LLUUID& id, std::string& name, bool group, bool& name_requested)
 {
     static const std::string unknown_name = LLTrans::getString("AvatarNameWaiting");
 
@@ -1128,13 +1191,13 @@ void FSAreaSearch::getNameFromUUID(const LLUUID& id, std::string& name, bool gro
         if (!gCacheName->getIfThere(id, name, is_group))
         {
             name = unknown_name;
-            if (std::find(mNamesRequested.begin(), mNamesRequested.end(), id) == mNamesRequested.end())
+            if (mNamesRequested.insert(id).second)
             {
-                mNamesRequested.push_back(id);
                 boost::signals2::connection cb_connection = gCacheName->get(id, group, boost::bind(&FSAreaSearch::callbackLoadFullName, this, _1, _2));
                 mNameCacheConnections.insert(std::make_pair(id, cb_connection)); // mNamesRequested will do the dupe check
             }
             name_requested = true;
+            return false;
         }
     }
     else
@@ -1143,17 +1206,18 @@ void FSAreaSearch::getNameFromUUID(const LLUUID& id, std::string& name, bool gro
         if (!LLAvatarNameCache::get(id, &av_name))
         {
             name = unknown_name;
-            if (std::find(mNamesRequested.begin(), mNamesRequested.end(), id) == mNamesRequested.end())
+            if (mNamesRequested.insert(id).second)
             {
-                mNamesRequested.push_back(id);
                 boost::signals2::connection cb_connection = LLAvatarNameCache::get(id, boost::bind(&FSAreaSearch::avatarNameCacheCallback, this, _1, _2));
                 mNameCacheConnections.insert(std::make_pair(id, cb_connection)); // mNamesRequested will do the dupe check
             }
             name_requested = true;
+            return false;
         }
         else
             name = av_name.getCompleteName();
     }
+    return true;
 }
 
 void FSAreaSearch::avatarNameCacheCallback(const LLUUID& id, const LLAvatarName& av_name)
@@ -1174,15 +1238,17 @@ void FSAreaSearch::callbackLoadFullName(const LLUUID& id, const std::string& ful
 
     LLViewerRegion* our_region = gAgent.getRegion();
 
-    for (auto& entry : mObjectDetails)
+    // matchObject() updates mNameWaiting
+    const uuid_vec_t waiting(mNameWaiting.begin(), mNameWaiting.end());
+    for (const LLUUID& object_id : waiting)
     {
-        if (entry.second.name_requested && !entry.second.listed)
+        auto details_it = mObjectDetails.find(object_id);
+        if (details_it != mObjectDetails.end() && details_it->second.name_requested && !details_it->second.listed)
         {
-            const LLUUID& object_id = entry.second.id;
             LLViewerObject* objectp = gObjectList.findObject(object_id);
             if (objectp && isSearchableObject(objectp, our_region))
             {
-                matchObject(entry.second, objectp);
+                matchObject(details_it->second, objectp);
             }
         }
     }
@@ -1207,6 +1273,8 @@ void FSAreaSearch::onCommitLine()
     mSearchGroup = mPanelFind->mGroupLineEditor->getText();
     mSearchCreator = mPanelFind->mCreatorLineEditor->getText();
     mSearchLastOwner = mPanelFind->mLastOwnerLineEditor->getText();
+    invalidateMatches();
+    clearNameMatches();
 
     if (mRegexSearch)
     {
@@ -1334,6 +1402,8 @@ void FSAreaSearch::clearSearchText()
     mSearchGroup.erase();
     mSearchCreator.erase();
     mSearchLastOwner.erase();
+    invalidateMatches();
+    clearNameMatches();
 }
 
 void FSAreaSearch::onButtonClickedSearch()
@@ -1349,6 +1419,8 @@ void FSAreaSearch::onButtonClickedSearch()
 void FSAreaSearch::onCommitCheckboxRegex()
 {
     mRegexSearch = mPanelFind->mCheckboxRegex->get();
+    invalidateMatches();
+    clearNameMatches();
 
     if (mRegexSearch)
     {
@@ -37,6 +37,8 @@
 #include "llviewerobject.h"
 #include "rlvdefines.h"
 #include <boost/regex.hpp>
+#include <unordered_map>
+#include <unordered_set>
 
 class LLAvatarName;
 class LLTextBox;
@@ -82,6 +84,12 @@ struct FSObjectProperties
     U32 local_id;
     U64 region_handle;
 
+    // FSAreaSearch::mMatchGeneration and the object's last update time at
+    // the last matchObject() run, an unlisted object is only matched again
+    // once either changes
+    U32 match_generation;
+    F64Seconds matched_update;
+
     typedef enum e_object_properties_request
     {
         NEED,
@@ -94,7 +102,8 @@ struct FSObjectProperties
     FSObjectProperties() :
         request(NEED),
         listed(false),
-        name_requested(false)
+        name_requested(false),
+        match_generation(0)
     {
     }
 };
@@ -129,50 +138,68 @@ public:
     bool isSearchableObject (LLViewerObject* objectp, LLViewerRegion* our_region);
     void setFindOwnerText(std::string value);
 
-    std::map<LLUUID, FSObjectProperties> mObjectDetails;
+    std::unordered_map<LLUUID, FSObjectProperties> mObjectDetails;
 
     FSPanelAreaSearchAdvanced* getPanelAdvanced() { return mPanelAdvanced; }
     FSPanelAreaSearchList* getPanelList() { return mPanelList; }
 
-    void setFilterForSale(bool b) { mFilterForSale = b; }
-    void setFilterLocked(bool b) { mFilterLocked = b; }
-    void setFilterPhysical(bool b) { mFilterPhysical = b; }
-    void setFilterTemporary(bool b) { mFilterTemporary = b; }
-    void setFilterPhantom(bool b) { mFilterPhantom = b; }
-    void setFilterAttachment(bool b) { mFilterAttachment = b; }
-    void setFilterMoaP(bool b) { mFilterMoaP = b; }
+    void setFilterForSale(bool b) { mFilterForSale = b; invalidateMatches(); }
+    void setFilterLocked(bool b) { mFilterLocked = b; invalidateMatches(); }
+    void setFilterPhysical(bool b) { mFilterPhysical = b; invalidateMatches(); }
+    void setFilterTemporary(bool b) { mFilterTemporary = b; invalidateMatches(); }
+    void setFilterPhantom(bool b) { mFilterPhantom = b; invalidateMatches(); }
+    void setFilterAttachment(bool b) { mFilterAttachment = b; invalidateMatches(); }
+    void setFilterMoaP(bool b) { mFilterMoaP = b; invalidateMatches(); }
 
-    void setRegexSearch(bool b) { mRegexSearch = b; }
+    void setRegexSearch(bool b) { mRegexSearch = b; invalidateMatches(); }
     void setBeacons(bool b) { mBeacons = b; }
 
-    void setExcludeAttachment(bool b) { mExcludeAttachment = b; }
-    void setExcludetemporary(bool b) { mExcludeTemporary = b; }
-    void setExcludePhysics(bool b) { mExcludePhysics = b; }
-    void setExcludeChildPrims(bool b) { mExcludeChildPrims = b; }
-    void setExcludeNeighborRegions(bool b) { mExcludeNeighborRegions = b; }
+    void setExcludeAttachment(bool b) { mExcludeAttachment = b; invalidateMatches(); }
+    void setExcludetemporary(bool b) { mExcludeTemporary = b; invalidateMatches(); }
+    void setExcludePhysics(bool b) { mExcludePhysics = b; invalidateMatches(); }
+    void setExcludeChildPrims(bool b) { mExcludeChildPrims = b; invalidateMatches(); }
+    void setExcludeNeighborRegions(bool b) { mExcludeNeighborRegions = b; invalidateMatches(); }
 
-    void setFilterForSaleMin(S32 s) { mFilterForSaleMin = s; }
-    void setFilterForSaleMax(S32 s) { mFilterForSaleMax = s; }
+    void setFilterForSaleMin(S32 s) { mFilterForSaleMin = s; invalidateMatches(); }
+    void setFilterForSaleMax(S32 s) { mFilterForSaleMax = s; invalidateMatches(); }
 
-    void setFilterClickAction(bool b) { mFilterClickAction = b; }
-    void setFilterClickActionType(U8 u) { mFilterClickActionType = u; }
+    void setFilterClickAction(bool b) { mFilterClickAction = b; invalidateMatches(); }
+    void setFilterClickActionType(U8 u) { mFilterClickActionType = u; invalidateMatches(); }
 
-    void setFilterDistance(bool b) { mFilterDistance = b; }
-    void setFilterDistanceMin(S32 s) { mFilterDistanceMin = s; }
-    void setFilterDistanceMax(S32 s) { mFilterDistanceMax = s; }
+    void setFilterDistance(bool b) { mFilterDistance = b; invalidateMatches(); }
+    void setFilterDistanceMin(S32 s) { mFilterDistanceMin = s; invalidateMatches(); }
+    void setFilterDistanceMax(S32 s) { mFilterDistanceMax = s; invalidateMatches(); }
 
-    void setFilterPermCopy(bool b) { mFilterPermCopy = b; }
-    void setFilterPermModify(bool b) { mFilterPermModify = b; }
-    void setFilterPermTransfer(bool b) { mFilterPermTransfer = b; }
+    void setFilterPermCopy(bool b) { mFilterPermCopy = b; invalidateMatches(); }
+    void setFilterPermModify(bool b) { mFilterPermModify = b; invalidateMatches(); }
+    void setFilterPermTransfer(bool b) { mFilterPermTransfer = b; invalidateMatches(); }
 
-    void setFilterAgentParcelOnly(bool b) { mFilterAgentParcelOnly = b; }
+    void setFilterAgentParcelOnly(bool b) { mFilterAgentParcelOnly = b; invalidateMatches(); }
 
     bool isActive() { return mActive; }
 
 private:
+    enum ENameField
+    {
+        NAME_OWNER,
+        NAME_GROUP,
+        NAME_CREATOR,
+        NAME_LAST_OWNER,
+        NAME_FIELD_COUNT
+    };
+
     void requestObjectProperties(const std::vector< U32 >& request_list, bool select, LLViewerRegion* regionp);
     void matchObject(FSObjectProperties& details, LLViewerObject* objectp);
-    void getNameFromUUID(const LLUUID& id, std::string& name, bool group, bool& name_requested);
+    bool getNameFromUUID(const LLUUID& id, std::string& name, bool group, bool& name_requested);
+    bool textMatches(const std::string& text, const std::string& search, const boost::regex& regex_search);
+    bool nameMatches(ENameField field, const LLUUID& id, const std::string& name, bool name_known,
+                     const std::string& search, const boost::regex& regex_search);
+
+    // Filters or search text changed, every unlisted object needs matching again
+    void invalidateMatches() { ++mMatchGeneration; }
+    void clearNameMatches();
+    void onAgentParcelChanged();
+    void setRequestNeeded(FSObjectProperties& details);
 
     void updateCounterText();
     bool regexTest(std::string_view text);
@@ -183,6 +210,14 @@ private:
     void updateRlvRestrictions(ERlvBehaviour behavior);
 
     S32 mRequested;
+    // objects whose properties are requested or still need to be, so the
+    // request queue never walks all of mObjectDetails
+    std::unordered_set<LLUUID> mPendingRequests;
+    U32 mMatchGeneration;
+    LLVector3d mMatchAgentPosition;
+    // results of the owner, group, creator and last owner tests per id,
+    // only for ids whose name is known
+    std::unordered_map<LLUUID, bool> mNameMatches[NAME_FIELD_COUNT];
     bool mRefresh;
     S32 mSearchableObjects;
     bool mActive;
@@ -208,7 +243,9 @@ private:
     LLFrameTimer mLastUpdateTimer;
     LLFrameTimer mLastPropertiesReceivedTimer;
 
-    uuid_vec_t mNamesRequested;
+    std::unordered_set<LLUUID> mNamesRequested;
+    // objects matched while one of their names was still being looked up
+    std::unordered_set<LLUUID> mNameWaiting;
 
     typedef std::map<LLUUID, boost::signals2::connection> name_cache_connection_map_t;
     name_cache_connection_map_t mNameCacheConnections;
@@ -298,169 +298,230 @@ void FSPanelRadar::requestUpdate()
 
 void FSPanelRadar::updateList(const std::vector<LLSD>& entries, const LLSD& stats)
 {
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_UI;
+
     if (!mVisibleCheckFunction.empty() && !mVisibleCheckFunction())
     {
         return;
     }
 
-    static const std::string flagsColumnType = getString("FlagsColumnType");
-    static const std::string flagsColumnValues [3] = { getString("FlagsColumnValue_0"), getString("FlagsColumnValue_1"), getString("FlagsColumnValue_2") };
-    static const std::string notesColumnIcon = getString("NotesColumnIcon");
-    static const std::string sittingColumnIcon = getString("SittingColumnIcon");
-    static const std::string typingColumnIcon = getString("TypingColumnIcon");
-
-    // Store current selection and scroll position
-    LLUUID last_selected_id;
-    if (mRadarList->getLastSelectedItem())
-    {
-        last_selected_id = mRadarList->getLastSelectedItem()->getUUID();
-    }
-    uuid_vec_t selected_ids;
-    for (auto selected_item : mRadarList->getAllSelected())
-    {
-        selected_ids.emplace_back(selected_item->getUUID());
-    }
+    // Store current scroll position
     S32 lastScroll = mRadarList->getScrollPos();
 
     // Update list
     mRadarList->setCommentText(RlvActions::canShowNearbyAgents() ? LLStringUtil::null : RlvStrings::getString("blocked_nearby"));
 
-    bool needs_sort = mRadarList->isSorted();
-    mRadarList->setNeedsSort(false);
+    // The list is patched rather than rebuilt: rows of avatars still around
+    // only get their changed cells updated, which keeps their selection too.
+    std::unordered_map<LLUUID, LLScrollListItem*, FSUUIDHash> rows;
+    for (LLScrollListItem* item : mRadarList->getAllData())
+    {
+        rows.emplace(item->getUUID(), item);
+    }
 
-    mRadarList->clearRows();
+    bool needs_sort = mRadarList->isSorted();
+    bool rows_added{ false };
+    bool rows_changed{ false };
     for (const auto& avdata : entries)
     {
-        constexpr char font_name[] = "SANSSERIF_SMALL";
-
-        LLSD entry = avdata["entry"];
-        LLSD options = avdata["options"];
+        const LLSD& entry = avdata["entry"];
+        const LLSD& options = avdata["options"];
+        const LLUUID avatar_id = entry["id"].asUUID();
 
-        LLSD row_data;
-        row_data["value"] = entry["id"];
-        row_data["columns"][0]["column"] = "name";
-        row_data["columns"][0]["value"] = entry["name"];
-        row_data["columns"][0]["font"] = font_name;
-
-        row_data["columns"][1]["column"] = "voice_level";
-        row_data["columns"][1]["type"] = "icon";
-        row_data["columns"][1]["value"] = ""; // Need to set it after the row has been created because it's to big for the row
-        row_data["columns"][1]["font"] = font_name;
+        LLScrollListItem* row{ nullptr };
+        if (auto row_it = rows.find(avatar_id); row_it != rows.end())
+        {
+            row = row_it->second;
+            rows.erase(row_it);
+        }
 
-        row_data["columns"][2]["column"] = "in_region";
-        row_data["columns"][2]["type"] = "icon";
-        if (entry["on_parcel"].asBoolean())
+        radar_row_map_t::iterator last_it = mRadarRowData.find(avatar_id);
+        if (row && last_it != mRadarRowData.end())
         {
-            row_data["columns"][2]["value"] = "avatar_on_parcel";
+            const LLSD& last_options = last_it->second["options"];
+            if (last_options.has("age_color") == options.has("age_color") && last_options.has("name_color") == options.has("name_color"))
+            {
+                rows_changed |= updateRow(row, entry, options, last_options);
+                last_it->second = avdata;
+                continue;
+            }
         }
-        else if (entry["in_region"].asBoolean())
+
+        // New avatar, or a cell color went back to the list default which needs a new row
+        bool selected{ false };
+        if (row)
         {
-            row_data["columns"][2]["value"] = "avatar_in_region";
+            selected = row->getSelected();
+            mRadarList->deleteSingleItem(mRadarList->getItemIndex(row));
         }
-        else
+        addRow(entry, options);
+        if (selected)
         {
-            row_data["columns"][2]["value"] = "";
+            mRadarList->setSelectedByValue(avatar_id, true);
         }
+        mRadarRowData[avatar_id] = avdata;
+        rows_added = true;
+    }
 
-        row_data["columns"][3]["column"] = "typing_status";
-        row_data["columns"][3]["type"] = "icon";
-        row_data["columns"][3]["value"] = (entry["typing"].asBoolean() ? typingColumnIcon : "");
+    // Whatever is left in rows has left the radar
+    for (const auto& [avatar_id, row] : rows)
+    {
+        mRadarList->deleteSingleItem(mRadarList->getItemIndex(row));
+        mRadarRowData.erase(avatar_id);
+        rows_changed = true;
+    }
 
-        row_data["columns"][4]["column"] = "sitting_status";
-        row_data["columns"][4]["type"] = "icon";
-        row_data["columns"][4]["value"] = (entry["sitting"].asBoolean() ? sittingColumnIcon : "");
+    if (rows_added || rows_changed)
+    {
+        mRadarList->setNeedsSort(needs_sort);
+        mRadarList->updateSort();
+    }
 
-        row_data["columns"][5]["column"] = "flags";
-        row_data["columns"][5]["type"] = flagsColumnType;
+    LLStringUtil::format_map_t name_count_args;
+    name_count_args["[TOTAL]"] = stats["total"].asString();
+    name_count_args["[IN_REGION]"] = stats["region"].asString();
+    name_count_args["[IN_CHAT_RANGE]"] = stats["chatrange"].asString();
+    LLScrollListColumn* column = mRadarList->getColumn("name");
+    column->mHeader->setLabel(getString("avatar_name_count", name_count_args));
+    column->mHeader->setToolTipArgs(name_count_args);
 
-        row_data["columns"][6]["column"] = "has_notes";
-        row_data["columns"][6]["type"] = "icon";
-        row_data["columns"][6]["value"] = (entry["notes"].asBoolean() ? notesColumnIcon : "");
-        row_data["columns"][6]["tool_tip"] = entry["notes"].asString();
+    if (rows_added)
+    {
+        mRadarList->refreshLineHeight();
+    }
 
-        row_data["columns"][7]["column"] = "age";
-        row_data["columns"][7]["value"] = entry["age"];
-        row_data["columns"][7]["halign"] = "right";
-        row_data["columns"][7]["font"] = font_name;
+    // Restore scroll position
+    mRadarList->setScrollPos(lastScroll);
 
-        row_data["columns"][8]["column"] = "seen";
-        row_data["columns"][8]["value"] = entry["seen"];
-        row_data["columns"][8]["halign"] = "right";
-        row_data["columns"][8]["font"] = font_name;
+    updateButtons();
+    mChangeSignal();
+}
 
-        row_data["columns"][9]["column"] = "range";
-        row_data["columns"][9]["value"] = entry["range"];
-        row_data["columns"][9]["font"] = font_name;
+void FSPanelRadar::addRow(const LLSD& entry, const LLSD& options)
+{
+    constexpr char font_name[] = "SANSSERIF_SMALL";
+    static const std::string flagsColumnType = getString("FlagsColumnType");
 
-        row_data["columns"][10]["column"] = "seen_sort";
-        row_data["columns"][10]["value"] = entry["seen"].asString() + "_" + entry["name"].asString();
+    // Only the layout of the cells is set up here, their content is filled in by updateRow()
+    LLSD row_data;
+    row_data["value"] = entry["id"];
+    row_data["columns"][0]["column"] = "name";
+    row_data["columns"][0]["font"] = font_name;
 
-        LLScrollListItem* row = mRadarList->addElement(row_data);
+    row_data["columns"][1]["column"] = "voice_level";
+    row_data["columns"][1]["type"] = "icon";
+    row_data["columns"][1]["value"] = ""; // Need to set it after the row has been created because it's to big for the row
+    row_data["columns"][1]["font"] = font_name;
 
-        static S32 rangeColumnIndex = mRadarList->getColumn("range")->mIndex;
-        static S32 nameColumnIndex = mRadarList->getColumn("name")->mIndex;
-        static S32 voiceLevelColumnIndex = mRadarList->getColumn("voice_level")->mIndex;
-        static S32 flagsColumnIndex = mRadarList->getColumn("flags")->mIndex;
-        static S32 ageColumnIndex = mRadarList->getColumn("age")->mIndex;
+    row_data["columns"][2]["column"] = "in_region";
+    row_data["columns"][2]["type"] = "icon";
 
-        LLScrollListText* radarRangeCell = (LLScrollListText*)row->getColumn(rangeColumnIndex);
-        radarRangeCell->setColor(LLColor4(options["range_color"]));
-        radarRangeCell->setFontStyle(options["range_style"].asInteger());
+    row_data["columns"][3]["column"] = "typing_status";
+    row_data["columns"][3]["type"] = "icon";
 
-        LLScrollListText* radarNameCell = (LLScrollListText*)row->getColumn(nameColumnIndex);
-        radarNameCell->setFontStyle(options["name_style"].asInteger());
-        if (options.has("name_color"))
-        {
-            radarNameCell->setColor(LLColor4(options["name_color"]));
-        }
+    row_data["columns"][4]["column"] = "sitting_status";
+    row_data["columns"][4]["type"] = "icon";
 
-        if (entry.has("voice_level_icon"))
-        {
-            LLScrollListText* voiceLevelCell = (LLScrollListText*)row->getColumn(voiceLevelColumnIndex);
-            voiceLevelCell->setValue(entry["voice_level_icon"].asString());
-        }
+    row_data["columns"][5]["column"] = "flags";
+    row_data["columns"][5]["type"] = flagsColumnType;
 
-        if (entry.has("flags"))
-        {
-            LLScrollListText* flagsCell = (LLScrollListText*)row->getColumn(flagsColumnIndex);
-            flagsCell->setValue(flagsColumnValues[entry["flags"].asInteger()]);
-        }
+    row_data["columns"][6]["column"] = "has_notes";
+    row_data["columns"][6]["type"] = "icon";
 
-        if (options.has("age_color"))
-        {
-            LLScrollListText* ageCell = (LLScrollListText*)row->getColumn(ageColumnIndex);
-            ageCell->setColor(LLColor4(options["age_color"]));
-        }
-    }
+    row_data["columns"][7]["column"] = "age";
+    row_data["columns"][7]["halign"] = "right";
+    row_data["columns"][7]["font"] = font_name;
 
-    mRadarList->setNeedsSort(needs_sort);
-    mRadarList->updateSort();
+    row_data["columns"][8]["column"] = "seen";
+    row_data["columns"][8]["halign"] = "right";
+    row_data["columns"][8]["font"] = font_name;
 
-    LLStringUtil::format_map_t name_count_args;
-    name_count_args["[TOTAL]"] = stats["total"].asString();
-    name_count_args["[IN_REGION]"] = stats["region"].asString();
-    name_count_args["[IN_CHAT_RANGE]"] = stats["chatrange"].asString();
-    LLScrollListColumn* column = mRadarList->getColumn("name");
-    column->mHeader->setLabel(getString("avatar_name_count", name_count_args));
-    column->mHeader->setToolTipArgs(name_count_args);
+    row_data["columns"][9]["column"] = "range";
+    row_data["columns"][9]["font"] = font_name;
 
-    mRadarList->refreshLineHeight();
+    row_data["columns"][10]["column"] = "seen_sort";
 
-    // Restore scroll position
-    mRadarList->setScrollPos(lastScroll);
+    if (LLScrollListItem* row = mRadarList->addElement(row_data); row)
+    {
+        updateRow(row, entry, options, LLSD());
+    }
+}
+
+bool FSPanelRadar::updateRow(LLScrollListItem* row, const LLSD& entry, const LLSD& options, const LLSD& last_options)
+{
+    static const std::string flagsColumnValues [3] = { getString("FlagsColumnValue_0"), getString("FlagsColumnValue_1"), getString("FlagsColumnValue_2") };
+    static const std::string notesColumnIcon = getString("NotesColumnIcon");
+    static const std::string sittingColumnIcon = getString("SittingColumnIcon");
+    static const std::string typingColumnIcon = getString("TypingColumnIcon");
 
-    // Restore selection list
-    if (!selected_ids.empty())
+    static S32 nameColumnIndex = mRadarList->getColumn("name")->mIndex;
+    static S32 voiceLevelColumnIndex = mRadarList->getColumn("voice_level")->mIndex;
+    static S32 inRegionColumnIndex = mRadarList->getColumn("in_region")->mIndex;
+    static S32 typingColumnIndex = mRadarList->getColumn("typing_status")->mIndex;
+    static S32 sittingColumnIndex = mRadarList->getColumn("sitting_status")->mIndex;
+    static S32 flagsColumnIndex = mRadarList->getColumn("flags")->mIndex;
+    static S32 notesColumnIndex = mRadarList->getColumn("has_notes")->mIndex;
+    static S32 ageColumnIndex = mRadarList->getColumn("age")->mIndex;
+    static S32 seenColumnIndex = mRadarList->getColumn("seen")->mIndex;
+    static S32 rangeColumnIndex = mRadarList->getColumn("range")->mIndex;
+    static S32 seenSortColumnIndex = mRadarList->getColumn("seen_sort")->mIndex;
+
+    bool changed{ false };
+    auto set_cell_value = [row, &changed](S32 index, const std::string& value) -> LLScrollListCell*
     {
-        mRadarList->selectMultiple(selected_ids);
-        if (last_selected_id.notNull())
+        LLScrollListCell* cell = row->getColumn(index);
+        if (cell->getValue().asString() != value)
         {
-            mRadarList->setLastSelectedItem(last_selected_id);
+            cell->setValue(value);
+            changed = true;
         }
+        return cell;
+    };
+
+    std::string in_region;
+    if (entry["on_parcel"].asBoolean())
+    {
+        in_region = "avatar_on_parcel";
+    }
+    else if (entry["in_region"].asBoolean())
+    {
+        in_region = "avatar_in_region";
     }
 
-    updateButtons();
-    mChangeSignal();
+    LLScrollListText* radarNameCell = (LLScrollListText*)set_cell_value(nameColumnIndex, entry["name"].asString());
+    set_cell_value(voiceLevelColumnIndex, entry["voice_level_icon"].asString());
+    set_cell_value(inRegionColumnIndex, in_region);
+    set_cell_value(typingColumnIndex, entry["typing"].asBoolean() ? typingColumnIcon : LLStringUtil::null);
+    set_cell_value(sittingColumnIndex, entry["sitting"].asBoolean() ? sittingColumnIcon : LLStringUtil::null);
+    set_cell_value(flagsColumnIndex, entry.has("flags") ? flagsColumnValues[entry["flags"].asInteger()] : LLStringUtil::null);
+    set_cell_value(notesColumnIndex, entry["notes"].asBoolean() ? notesColumnIcon : LLStringUtil::null)->setToolTip(entry["notes"].asString());
+    LLScrollListText* ageCell = (LLScrollListText*)set_cell_value(ageColumnIndex, entry["age"].asString());
+    set_cell_value(seenColumnIndex, entry["seen"].asString());
+    LLScrollListText* radarRangeCell = (LLScrollListText*)set_cell_value(rangeColumnIndex, entry["range"].asString());
+    set_cell_value(seenSortColumnIndex, entry["seen"].asString() + "_" + entry["name"].asString());
+
+    // Font changes are not free, only apply them when they differ from the last update
+    radarRangeCell->setColor(LLColor4(options["range_color"]));
+    if (last_options.isUndefined() || options["range_style"].asInteger() != last_options["range_style"].asInteger())
+    {
+        radarRangeCell->setFontStyle(options["range_style"].asInteger());
+    }
+
+    if (last_options.isUndefined() || options["name_style"].asInteger() != last_options["name_style"].asInteger())
+    {
+        radarNameCell->setFontStyle(options["name_style"].asInteger());
+    }
+    if (options.has("name_color"))
+    {
+        radarNameCell->setColor(LLColor4(options["name_color"]));
+    }
+
+    if (options.has("age_color"))
+    {
+        ageCell->setColor(LLColor4(options["age_color"]));
+    }
+
+    return changed;
 }
 
 void FSPanelRadar::onColumnDisplayModeChanged()
@@ -496,6 +557,7 @@ void FSPanelRadar::onColumnDisplayModeChanged()
     mRadarList->clearRows();
     mRadarList->clearColumns();
     mRadarList->updateLayout();
+    mRadarRowData.clear();
 
     for (const auto& p : column_params)
     {
@@ -36,6 +36,7 @@
 class LLButton;
 class LLFilterEditor;
 class LLMenuButton;
+class LLScrollListItem;
 class LLNetMap;
 
 class FSPanelRadar
@@ -71,6 +72,9 @@ public:
 private:
     void                    updateButtons();
     void                    updateList(const std::vector<LLSD>& entries, const LLSD& stats);
+    void                    addRow(const LLSD& entry, const LLSD& options);
+    // Returns true if any cell value changed
+    bool                    updateRow(LLScrollListItem* row, const LLSD& entry, const LLSD& options, const LLSD& last_options);
 
     // UI callbacks
     void                    onAddFriendButtonClicked();
@@ -98,6 +102,10 @@ private:
     std::string             mFilterSubStringOrig;
 
     std::map<std::string, U32> mColumnBits;
+
+    // Radar data each list row currently shows
+    typedef std::unordered_map<LLUUID, LLSD, FSUUIDHash> radar_row_map_t;
+    radar_row_map_t         mRadarRowData;
     S32                     mLastResizeDelta;
 
     // Slot connection for FSRadar updates
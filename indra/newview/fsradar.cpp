@@ -33,6 +33,7 @@
 #include "llanimationstates.h"
 #include "llcommonutils.h"
 #include "llnotificationsutil.h"
+#include "llregionhandle.h"
 #include "lleventtimer.h"
 
 // newview
@@ -177,6 +178,9 @@ void FSRadar::radarAlertMsg(const LLUUID& agent_id, const LLAvatarName& av_name,
 
 void FSRadar::updateRadarList()
 {
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_UI;
+    LLTimer update_timer;
+
     //Configuration
     LLWorld* world = LLWorld::getInstance();
     LLMuteList* mutelist = LLMuteList::getInstance();
@@ -237,6 +241,7 @@ void FSRadar::updateRadarList()
     mRadarOffsetRequests.clear();
     mRadarEntriesData.clear();
     mAvatarStats.clear();
+    mCellRegions.clear();
 
     //STEP 1: Update our basic data model: detect Avatars & Positions in our defined range
     std::vector<LLVector3d> positions;
@@ -262,11 +267,14 @@ void FSRadar::updateRadarList()
     }
     LLCommonUtils::computeDifference(avatar_ids, current_vec, added_vec, removed_vec);
 
-    // Remove old avatars from our list
+    // Remove old avatars from our list, keeping their last state for the leave alerts
+    std::vector<std::shared_ptr<FSRadarEntry>> removed_entries;
+    removed_entries.reserve(removed_vec.size());
     for (const auto& avid : removed_vec)
     {
         if (entry_map_t::iterator found = mEntryList.find(avid); found != mEntryList.end())
         {
+            removed_entries.emplace_back(found->second);
             mEntryList.erase(found);
         }
     }
@@ -327,13 +335,9 @@ void FSRadar::updateRadarList()
             continue;
         }
 
-        LLUUID avRegion;
-        if (LLViewerRegion* reg = world->getRegionFromPosGlobal(avPos); reg)
-        {
-            avRegion = reg->getRegionID();
-        }
+        const LLUUID& avRegion = getRegionIdAt(avPos);
         bool isInSameRegion = (avRegion == regionSelf);
-        bool isOnSameParcel = parcelmgr.inAgentParcel(avPos);
+        bool isOnSameParcel = isInSameRegion && parcelmgr.inAgentParcel(avPos);
         S32 seentime = (S32)difftime(now, ent->mFirstSeen);
         S32 hours = (S32)(seentime / 3600);
         S32 mins = (S32)((seentime - hours * 3600) / 60);
@@ -369,6 +373,11 @@ void FSRadar::updateRadarList()
             }
         }
         F32 avRange = (F32)(avPos[VZ] != AVATAR_UNKNOWN_Z_OFFSET ? dist_vec(avPos, posSelf) : AVATAR_UNKNOWN_RANGE);
+
+        // What the previous sweep saw, range crossings are computed from the difference
+        const F32 lastDistance = ent->mRange;
+        const LLUUID lastRegion = ent->mRegion;
+
         ent->mRange = avRange;
         ent->mGlobalPos = avPos;
         ent->mRegion = avRegion;
@@ -384,8 +393,7 @@ void FSRadar::updateRadarList()
         //
         //2b. Process newly detected avatars
         //
-        radarfields_map_t::iterator last_sweep_found_it = mLastRadarSweep.find(avId);
-        if (last_sweep_found_it == mLastRadarSweep.end())
+        if (!ent->mInLastSweep)
         {
             // chat alerts
             if (sRadarReportChatRangeEnter && (avRange <= chat_range_say) && avRange > AVATAR_UNKNOWN_RANGE)
@@ -442,10 +450,9 @@ void FSRadar::updateRadarList()
         //
         else
         {
-            RadarFields rf = last_sweep_found_it->second;
             if (sRadarReportChatRangeEnter || sRadarReportChatRangeLeave)
             {
-                if (sRadarReportChatRangeEnter && (avRange <= chat_range_say && avRange > AVATAR_UNKNOWN_RANGE) && (rf.lastDistance > chat_range_say || rf.lastDistance == AVATAR_UNKNOWN_RANGE))
+                if (sRadarReportChatRangeEnter && (avRange <= chat_range_say && avRange > AVATAR_UNKNOWN_RANGE) && (lastDistance > chat_range_say || lastDistance == AVATAR_UNKNOWN_RANGE))
                 {
                     LLStringUtil::format_map_t args;
                     args["DISTANCE"] = llformat("%3.2f", avRange);
@@ -453,7 +460,7 @@ void FSRadar::updateRadarList()
                     make_ui_sound("UISndRadarChatEnter"); // <FS:PP> FIRE-6069: Radar alerts sounds
                     LLAvatarNameCache::get(avId, boost::bind(&FSRadar::radarAlertMsg, this, _1, _2, message));
                 }
-                else if (sRadarReportChatRangeLeave && (avRange > chat_range_say || avRange == AVATAR_UNKNOWN_RANGE) && (rf.lastDistance <= chat_range_say && rf.lastDistance > AVATAR_UNKNOWN_RANGE))
+                else if (sRadarReportChatRangeLeave && (avRange > chat_range_say || avRange == AVATAR_UNKNOWN_RANGE) && (lastDistance <= chat_range_say && lastDistance > AVATAR_UNKNOWN_RANGE))
                 {
                     make_ui_sound("UISndRadarChatLeave"); // <FS:PP> FIRE-6069: Radar alerts sounds
                     LLAvatarNameCache::get(avId, boost::bind(&FSRadar::radarAlertMsg, this, _1, _2, str_chat_leaving));
@@ -461,7 +468,7 @@ void FSRadar::updateRadarList()
             }
             if (sRadarReportDrawRangeEnter || sRadarReportDrawRangeLeave)
             {
-                if (sRadarReportDrawRangeEnter && (avRange <= drawRadius && avRange > AVATAR_UNKNOWN_RANGE) && (rf.lastDistance > drawRadius || rf.lastDistance == AVATAR_UNKNOWN_RANGE))
+                if (sRadarReportDrawRangeEnter && (avRange <= drawRadius && avRange > AVATAR_UNKNOWN_RANGE) && (lastDistance > drawRadius || lastDistance == AVATAR_UNKNOWN_RANGE))
                 {
                     LLStringUtil::format_map_t args;
                     args["DISTANCE"] = llformat("%3.2f", avRange);
@@ -469,7 +476,7 @@ void FSRadar::updateRadarList()
                     make_ui_sound("UISndRadarDrawEnter"); // <FS:PP> FIRE-6069: Radar alerts sounds
                     LLAvatarNameCache::get(avId, boost::bind(&FSRadar::radarAlertMsg, this, _1, _2, message));
                 }
-                else if (sRadarReportDrawRangeLeave && (avRange > drawRadius || avRange == AVATAR_UNKNOWN_RANGE) && (rf.lastDistance <= drawRadius && rf.lastDistance > AVATAR_UNKNOWN_RANGE))
+                else if (sRadarReportDrawRangeLeave && (avRange > drawRadius || avRange == AVATAR_UNKNOWN_RANGE) && (lastDistance <= drawRadius && lastDistance > AVATAR_UNKNOWN_RANGE))
                 {
                     make_ui_sound("UISndRadarDrawLeave"); // <FS:PP> FIRE-6069: Radar alerts sounds
                     LLAvatarNameCache::get(avId, boost::bind(&FSRadar::radarAlertMsg, this, _1, _2, str_draw_distance_leaving));
@@ -477,7 +484,7 @@ void FSRadar::updateRadarList()
             }
             if (sRadarReportSimRangeEnter || sRadarReportSimRangeLeave)
             {
-                if (sRadarReportSimRangeEnter && isInSameRegion && avRegion != rf.lastRegion && rf.lastRegion.notNull())
+                if (sRadarReportSimRangeEnter && isInSameRegion && avRegion != lastRegion && lastRegion.notNull())
                 {
                     make_ui_sound("UISndRadarSimEnter"); // <FS:PP> FIRE-6069: Radar alerts sounds
                     if (avRange != AVATAR_UNKNOWN_RANGE) // Don't report an inaccurate range in localchat, if the true range is not known.
@@ -492,7 +499,7 @@ void FSRadar::updateRadarList()
                         LLAvatarNameCache::get(avId, boost::bind(&FSRadar::radarAlertMsg, this, _1, _2, str_region_entering));
                     }
                 }
-                else if (sRadarReportSimRangeLeave && rf.lastRegion == regionSelf && !isInSameRegion && avRegion.notNull())
+                else if (sRadarReportSimRangeLeave && lastRegion == regionSelf && !isInSameRegion && avRegion.notNull())
                 {
                     make_ui_sound("UISndRadarSimLeave"); // <FS:PP> FIRE-6069: Radar alerts sounds
                     LLAvatarNameCache::get(avId, boost::bind(&FSRadar::radarAlertMsg, this, _1, _2, str_region_leaving));
@@ -691,21 +698,24 @@ void FSRadar::updateRadarList()
     //
     if (RlvActions::canShowNearbyAgents())
     {
-        for (const auto& [prevId, rf] : mLastRadarSweep)
+        for (const auto& prev : removed_entries)
         {
-            if ((sFSRadarShowMutedAndDerendered || !rf.lastIgnore) && mEntryList.find(prevId) == mEntryList.end())
+            const LLUUID& prevId = prev->mID;
+            const F32 lastDistance = prev->mRange;
+            const LLUUID& lastRegion = prev->mRegion;
+            if (sFSRadarShowMutedAndDerendered || !prev->mIgnore)
             {
-                if (sRadarReportChatRangeLeave && (rf.lastDistance <= chat_range_say) && rf.lastDistance > AVATAR_UNKNOWN_RANGE)
+                if (sRadarReportChatRangeLeave && (lastDistance <= chat_range_say) && lastDistance > AVATAR_UNKNOWN_RANGE)
                 {
                     make_ui_sound("UISndRadarChatLeave"); // <FS:PP> FIRE-6069: Radar alerts sounds
                     LLAvatarNameCache::get(prevId, boost::bind(&FSRadar::radarAlertMsg, this, _1, _2, str_chat_leaving));
                 }
-                if (sRadarReportDrawRangeLeave && (rf.lastDistance <= drawRadius) && rf.lastDistance > AVATAR_UNKNOWN_RANGE)
+                if (sRadarReportDrawRangeLeave && (lastDistance <= drawRadius) && lastDistance > AVATAR_UNKNOWN_RANGE)
                 {
                     make_ui_sound("UISndRadarDrawLeave"); // <FS:PP> FIRE-6069: Radar alerts sounds
                     LLAvatarNameCache::get(prevId, boost::bind(&FSRadar::radarAlertMsg, this, _1, _2, str_draw_distance_leaving));
                 }
-                if (sRadarReportSimRangeLeave && (rf.lastRegion == regionSelf || rf.lastRegion.isNull()))
+                if (sRadarReportSimRangeLeave && (lastRegion == regionSelf || lastRegion.isNull()))
                 {
                     make_ui_sound("UISndRadarSimLeave"); // <FS:PP> FIRE-6069: Radar alerts sounds
                     LLAvatarNameCache::get(prevId, boost::bind(&FSRadar::radarAlertMsg, this, _1, _2, str_region_leaving));
@@ -788,23 +798,10 @@ void FSRadar::updateRadarList()
     //STEP 4: Cache our current model data, so we can compare it with the next fresh group of model data for fast change detection.
     //
 
-    mLastRadarSweep.clear();
+    // Each entry keeps its own range and region, which is all the next sweep needs
     for (const auto& [avid, entry] : mEntryList)
     {
-        RadarFields rf;
-        rf.lastDistance = entry->mRange;
-        rf.lastIgnore = entry->mIgnore;
-        rf.lastRegion = LLUUID::null;
-        if (entry->mGlobalPos != LLVector3d(0.0, 0.0, 0.0))
-        {
-            LLViewerRegion* lastRegion = world->getRegionFromPosGlobal(entry->mGlobalPos);
-            if (lastRegion)
-            {
-                rf.lastRegion = lastRegion->getRegionID();
-            }
-        }
-
-        mLastRadarSweep[entry->mID] = rf;
+        entry->mInLastSweep = true;
     }
 
     //
@@ -812,7 +809,7 @@ void FSRadar::updateRadarList()
     //
     if (RlvActions::canShowNearbyAgents())
     {
-        mAvatarStats["total"] = llformat("%d", mLastRadarSweep.size() - 1);
+        mAvatarStats["total"] = llformat("%d", mEntryList.size() - 1);
         mAvatarStats["region"] = llformat("%d", inSameRegion);
         mAvatarStats["chatrange"] = llformat("%d", inChatRange);
     }
@@ -830,6 +827,22 @@ void FSRadar::updateRadarList()
     {
         mUpdateSignal(mRadarEntriesData, mAvatarStats);
     }
+
+    LL_DEBUGS("Radar") << "Radar sweep of " << mEntryList.size() << " avatars in " << mCellRegions.size() << " grid cells took "
+                       << update_timer.getElapsedTimeF32() * 1000.f << " ms" << LL_ENDL;
+}
+
+const LLUUID& FSRadar::getRegionIdAt(const LLVector3d& pos_global)
+{
+    auto [it, inserted] = mCellRegions.try_emplace(to_region_handle(pos_global));
+    if (inserted)
+    {
+        if (LLViewerRegion* region = LLWorld::getInstance()->getRegionFromPosGlobal(pos_global); region)
+        {
+            it->second = region->getRegionID();
+        }
+    }
+    return it->second;
 }
 
 void FSRadar::requestRadarChannelAlertSync()
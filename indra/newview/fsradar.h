@@ -121,19 +121,19 @@ private:
 
     void onRegionChanged();
 
-    std::unique_ptr<Updater> mRadarListUpdater;
+    // Region containing pos_global, looked up once per 256m grid cell and sweep
+    const LLUUID& getRegionIdAt(const LLVector3d& pos_global);
 
-    struct RadarFields
-    {
-        F32         lastDistance;
-        LLUUID      lastRegion;
-        bool        lastIgnore;
-    };
+    std::unique_ptr<Updater> mRadarListUpdater;
 
-    typedef std::unordered_map<LLUUID, RadarFields, FSUUIDHash> radarfields_map_t;
-    radarfields_map_t       mLastRadarSweep;
     entry_map_t             mEntryList;
 
+    // Spatial hash of the current sweep: region handle of a grid cell -> region
+    // covering it. Regions, including var regions, are aligned to the 256m grid
+    // so a single lookup is valid for every avatar in the cell.
+    typedef std::unordered_map<U64, LLUUID> cell_region_map_t;
+    cell_region_map_t       mCellRegions;
+
     uuid_vec_t              mRadarEnterAlerts;
     uuid_vec_t              mRadarLeaveAlerts;
     uuid_vec_t              mRadarOffsetRequests;
@@ -56,6 +56,7 @@ FSRadarEntry::FSRadarEntry(const LLUUID& avid)
     mAlertAge(false),
     mAgeAlertPerformed(false),
     mPropertiesRequested(false),
+    mInLastSweep(false),
     mAvatarNameCallbackConnection()
 {
     requestProperties();
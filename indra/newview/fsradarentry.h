@@ -89,6 +89,7 @@ private:
     bool        mAlertAge;
     bool        mAgeAlertPerformed;
     bool        mPropertiesRequested;
+    bool        mInLastSweep;       // false until the radar has processed this entry once
 
     LLAvatarNameCache::callback_connection_t mAvatarNameCallbackConnection;
 };
@@ -102,10 +102,79 @@ namespace LL
     }
 }
 
+void Buffer::map(const std::shared_ptr<LLMappedFile>& file, const std::string& filename, size_t offset, S32 length)
+{
+    mData.clear();
+    mData.shrink_to_fit();
+    mMappedFile = file;
+    mMappedData = file->data() + offset;
+    mByteLength = length;
+
+    mSourceFile = filename;
+    mSourceOffset = offset;
+    llstat st;
+    if (LLFile::stat(filename, &st) == 0)
+    {
+        mSourceSize = (S64)st.st_size;
+        mSourceTime = (S64)st.st_mtime;
+    }
+}
+
+void Buffer::unmap()
+{
+    mMappedFile.reset();
+    mMappedData = nullptr;
+}
+
+bool Buffer::detach()
+{
+    if (mMappedFile)
+    {
+        mData.assign(mMappedData, mMappedData + mByteLength);
+        unmap();
+    }
+    else if (!mSourceFile.empty() && mData.empty() && mByteLength > 0)
+    {
+        // read back with plain file i/o, mapping a file that may have been
+        // rewritten or truncated since it was loaded could fault
+        llstat st;
+        if (LLFile::stat(mSourceFile, &st) != 0 || (S64)st.st_size != mSourceSize || (S64)st.st_mtime != mSourceTime)
+        {
+            LL_WARNS("GLTF") << "File changed since it was loaded: " << mSourceFile << LL_ENDL;
+            return false;
+        }
+
+        std::ifstream file(mSourceFile, std::ios::binary);
+        if (!file.is_open())
+        {
+            LL_WARNS("GLTF") << "Failed to open file: " << mSourceFile << LL_ENDL;
+            return false;
+        }
+
+        mData.resize(mByteLength);
+        file.seekg(mSourceOffset, std::ios::beg);
+        file.read((char*)mData.data(), mData.size());
+        if (file.gcount() != mByteLength)
+        {
+            LL_WARNS("GLTF") << "Failed to read buffer from: " << mSourceFile << LL_ENDL;
+            mData.clear();
+            return false;
+        }
+    }
+
+    mSourceFile.clear();
+    return true;
+}
+
 void Buffer::erase(Asset& asset, S32 offset, S32 length)
 {
     S32 idx = (S32)(this - &asset.mBuffers[0]);
 
+    if (!detach())
+    {
+        return;
+    }
+
     mData.erase(mData.begin() + offset, mData.begin() + offset + length);
 
     llassert(mData.size() <= size_t(INT_MAX));
@@ -178,8 +247,8 @@ bool Buffer::prep(Asset& asset)
         file.read((char*)mData.data(), mData.size());
     }
 
-    // POSTCONDITION: on success, mData.size == mByteLength
-    llassert(mData.size() == mByteLength);
+    // POSTCONDITION: on success, size() == mByteLength
+    llassert(size() == mByteLength);
     return true;
 }
 
@@ -208,6 +277,11 @@ bool Buffer::save(Asset& asset, const std::string& folder)
 
     bin_file += mUri;
 
+    if (!detach())
+    {
+        return false;
+    }
+
     std::ofstream file(bin_file, std::ios::binary);
     if (!file.is_open())
     {
@@ -215,7 +289,7 @@ bool Buffer::save(Asset& asset, const std::string& folder)
         return false;
     }
 
-    file.write((char*)mData.data(), mData.size());
+    file.write((const char*)data(), size());
 
     return true;
 }
@@ -296,3 +370,35 @@ const Accessor& Accessor::operator=(const Value& src)
     return *this;
 }
 
+U32 Accessor::getComponentSize() const
+{
+    switch (mComponentType)
+    {
+    case ComponentType::BYTE:
+    case ComponentType::UNSIGNED_BYTE:
+        return 1;
+    case ComponentType::SHORT:
+    case ComponentType::UNSIGNED_SHORT:
+        return 2;
+    case ComponentType::UNSIGNED_INT:
+    case ComponentType::FLOAT:
+        return 4;
+    }
+    return 0;
+}
+
+U32 Accessor::getElementSize() const
+{
+    U32 components = 0;
+    switch (mType)
+    {
+    case Type::SCALAR: components = 1; break;
+    case Type::VEC2: components = 2; break;
+    case Type::VEC3: components = 3; break;
+    case Type::VEC4: components = 4; break;
+    case Type::MAT2: components = 4; break;
+    case Type::MAT3: components = 9; break;
+    case Type::MAT4: components = 16; break;
+    }
+    return components * getComponentSize();
+}
@@ -27,6 +27,7 @@
  */
 
 #include "llstrider.h"
+#include "llmappedfile.h"
 #include "boost/json.hpp"
 
 #include "common.h"
@@ -39,11 +40,42 @@ namespace LL
         class Buffer
         {
         public:
+            // owned contents, empty while the buffer is a view of a mapped .glb
             std::vector<U8> mData;
             std::string mName;
             std::string mUri;
             S32 mByteLength = 0;
 
+            // the .glb this buffer's bytes are read from in place while the
+            // asset is prepared, if any
+            std::shared_ptr<LLMappedFile> mMappedFile;
+            const U8* mMappedData = nullptr;
+
+            // where the contents are in the .glb once unmapped, and the
+            // file's size and modification time when it was loaded
+            std::string mSourceFile;
+            size_t mSourceOffset = 0;
+            S64 mSourceSize = 0;
+            S64 mSourceTime = 0;
+
+            // contents of this buffer, wherever they live.  Empty while
+            // unmapped and not yet detached.
+            const U8* data() const { return mMappedFile ? mMappedData : mData.data(); }
+            size_t size() const { return mMappedFile ? (size_t)mByteLength : mData.size(); }
+
+            // point this buffer at length bytes found at offset in filename,
+            // which is mapped by file
+            void map(const std::shared_ptr<LLMappedFile>& file, const std::string& filename, size_t offset, S32 length);
+
+            // drop the mapping, keeping where the contents came from so
+            // detach() can read them again
+            void unmap();
+
+            // copy the contents into mData so they can be read or edited,
+            // from the mapping or from the file it was unmapped from.
+            // Fails if that file was changed since the asset was loaded.
+            bool detach();
+
             // erase the given range from this buffer.
             // also updates all buffer views in given asset that reference this buffer
             void erase(Asset& asset, S32 offset, S32 length);
@@ -107,6 +139,10 @@ namespace LL
 
             void serialize(boost::json::object& obj) const;
             const Accessor& operator=(const Value& value);
+
+            // size in bytes of one component and one element of this accessor
+            U32 getComponentSize() const;
+            U32 getElementSize() const;
         };
 
         // convert from "SCALAR", "VEC2", etc to Accessor::Type
@@ -511,6 +511,44 @@ bool Asset::prep()
         }
     }
 
+    // accessors read straight out of the buffers (possibly a mapped file),
+    // so make sure every one of them stays inside its buffer view first
+    for (auto& bufferView : mBufferViews)
+    {
+        if (bufferView.mBuffer < 0 || bufferView.mBuffer >= (S32)mBuffers.size() ||
+            bufferView.mByteOffset < 0 || bufferView.mByteLength < 0 || bufferView.mByteStride < 0 ||
+            (size_t)bufferView.mByteOffset + bufferView.mByteLength > mBuffers[bufferView.mBuffer].size())
+        {
+            LL_WARNS("GLTF") << "Buffer view out of range: " << bufferView.mName << LL_ENDL;
+            return false;
+        }
+    }
+
+    for (auto& accessor : mAccessors)
+    {
+        if (accessor.mBufferView == INVALID_INDEX || accessor.mCount == 0)
+        {
+            continue;
+        }
+
+        if (accessor.mBufferView < 0 || accessor.mBufferView >= (S32)mBufferViews.size() ||
+            accessor.mByteOffset < 0 || accessor.mCount < 0)
+        {
+            LL_WARNS("GLTF") << "Invalid accessor: " << accessor.mName << LL_ENDL;
+            return false;
+        }
+
+        const BufferView& bufferView = mBufferViews[accessor.mBufferView];
+        U64 element_size = accessor.getElementSize();
+        U64 stride = bufferView.mByteStride ? bufferView.mByteStride : element_size;
+        if (element_size == 0 ||
+            accessor.mByteOffset + stride * (accessor.mCount - 1) + element_size > (U64)bufferView.mByteLength)
+        {
+            LL_WARNS("GLTF") << "Accessor out of range: " << accessor.mName << LL_ENDL;
+            return false;
+        }
+    }
+
     for (auto& image : mImages)
     {
         if (!image.prep(*this))
@@ -678,21 +716,20 @@ bool Asset::load(std::string_view filename)
     mFilename = filename;
     std::string ext = gDirUtilp->getExtension(mFilename);
 
-    std::ifstream file(filename.data(), std::ios::binary);
-    if (file.is_open())
+    // map the file rather than reading it, a .glb's buffer is read in place
+    // while the asset is prepared and not kept in memory afterwards
+    std::shared_ptr<LLMappedFile> file = std::make_shared<LLMappedFile>();
+    if (file->open(mFilename))
     {
-        std::string str((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-        file.close();
-
         if (ext == "gltf")
         {
-            Value val = parse(str);
+            Value val = parse(std::string_view((const char*)file->data(), file->size()));
             *this = val;
             return prep();
         }
         else if (ext == "glb")
         {
-            return loadBinary(str);
+            return loadBinary(file->data(), file->size(), file);
         }
         else
         {
@@ -710,10 +747,15 @@ bool Asset::load(std::string_view filename)
 }
 
 bool Asset::loadBinary(const std::string& data)
+{
+    return loadBinary((const U8*)data.data(), data.size(), nullptr);
+}
+
+bool Asset::loadBinary(const U8* data, size_t size, const std::shared_ptr<LLMappedFile>& file)
 {
     // load from binary gltf
-    const U8* ptr = (const U8*)data.data();
-    const U8* end = ptr + data.size();
+    const U8* ptr = data;
+    const U8* end = ptr + size;
 
     if (end - ptr < 12)
     {
@@ -742,7 +784,7 @@ bool Asset::loadBinary(const std::string& data)
     U32 length = *(U32*)ptr;
     ptr += 4;
 
-    if (length != data.size())
+    if (length != size)
     {
         LL_WARNS("GLTF") << "GLB length mismatch" << LL_ENDL;
         return false;
@@ -794,10 +836,16 @@ bool Asset::loadBinary(const std::string& data)
 
         auto& buffer = mBuffers[0];
 
-        if (ptr + buffer.mByteLength <= end)
+        if (buffer.mByteLength >= 0 && end - ptr >= buffer.mByteLength)
         {
-            buffer.mData.resize(buffer.mByteLength);
-            memcpy(buffer.mData.data(), ptr, buffer.mByteLength);
+            if (file)
+            {
+                buffer.map(file, mFilename, (size_t)(ptr - data), buffer.mByteLength);
+            }
+            else
+            {
+                buffer.mData.assign(ptr, ptr + buffer.mByteLength);
+            }
             ptr += buffer.mByteLength;
         }
         else
@@ -807,7 +855,17 @@ bool Asset::loadBinary(const std::string& data)
         }
     }
 
-    return prep();
+    bool ret = prep();
+
+    // the vertex arrays and textures are built, drop the mapping so a file
+    // rewritten or truncated later can't fault.  Saving or uploading reads
+    // the buffers back from the file through Buffer::detach().
+    for (auto& buffer : mBuffers)
+    {
+        buffer.unmap();
+    }
+
+    return ret;
 }
 
 const Asset& Asset::operator=(const Value& src)
@@ -881,6 +939,16 @@ bool Asset::save(const std::string& filename)
     // get folder path
     std::string folder = gDirUtilp->getDirName(filename);
 
+    // read buffers back before anything is written, filename may be the
+    // file they were loaded from
+    for (auto& buffer : mBuffers)
+    {
+        if (!buffer.detach())
+        {
+            return false;
+        }
+    }
+
     // save images
     for (auto& image : mImages)
     {
@@ -952,7 +1020,7 @@ bool Image::prep(Asset& asset)
         BufferView& bufferView = asset.mBufferViews[mBufferView];
         Buffer& buffer = asset.mBuffers[bufferView.mBuffer];
 
-        U8* data = buffer.mData.data() + bufferView.mByteOffset;
+        const U8* data = buffer.data() + bufferView.mByteOffset;
 
         mTexture = LLViewerTextureManager::getFetchedTextureFromMemory(data, bufferView.mByteLength, mMimeType);
 
@@ -1045,6 +1113,11 @@ bool Image::save(Asset& asset, const std::string& folder)
         BufferView& bufferView = asset.mBufferViews[mBufferView];
         Buffer& buffer = asset.mBuffers[bufferView.mBuffer];
 
+        if (!buffer.detach())
+        {
+            return false;
+        }
+
         std::string extension;
 
         if (mMimeType == "image/jpeg")
@@ -1067,7 +1140,7 @@ bool Image::save(Asset& asset, const std::string& folder)
         mUri = name + extension;
 
         std::ofstream file(filename, std::ios::binary);
-        file.write((const char*)buffer.mData.data() + bufferView.mByteOffset, bufferView.mByteLength);
+        file.write((const char*)buffer.data() + bufferView.mByteOffset, bufferView.mByteLength);
     }
     else if (mTexture.notNull())
     {
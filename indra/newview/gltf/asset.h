@@ -435,6 +435,10 @@ namespace LL
             // returns result of prep() on success
             bool loadBinary(const std::string& data);
 
+            // as above, but when file is given the binary chunk stays in the
+            // mapped file instead of being copied
+            bool loadBinary(const U8* data, size_t size, const std::shared_ptr<LLMappedFile>& file);
+
             const Asset& operator=(const Value& src);
             void serialize(boost::json::object& dst) const;
 
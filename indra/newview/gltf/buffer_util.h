@@ -371,7 +371,8 @@ namespace LL
         {
             const BufferView& bufferView = asset.mBufferViews[accessor.mBufferView];
             const Buffer& buffer = asset.mBuffers[bufferView.mBuffer];
-            const U8* src = buffer.mData.data() + bufferView.mByteOffset + accessor.mByteOffset;
+            // reads in place, Asset::prep() checked the accessor fits in the buffer
+            const U8* src = buffer.data() + bufferView.mByteOffset + accessor.mByteOffset;
 
             switch (accessor.mComponentType)
             {
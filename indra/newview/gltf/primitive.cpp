@@ -419,23 +419,30 @@ bool Primitive::prep(Asset& asset)
         mask |= LLVertexBuffer::MAP_TEXCOORD1;
     }
 
-    if (mColors.empty())
-    {
-        mColors.resize(mPositions.size(), LLColor4U::white);
-    }
-
     mask |= LLVertexBuffer::MAP_COLOR;
 
     bool unlit = false;
 
+    if (mMaterial == INVALID_INDEX && mColors.empty())
+    {
+        mColors.resize(mPositions.size(), LLColor4U::white);
+    }
+
     // bake material basecolor into color array
     if (mMaterial != INVALID_INDEX)
     {
         const Material& material = asset.mMaterials[mMaterial];
         LLColor4 baseColor(glm::value_ptr(material.mPbrMetallicRoughness.mBaseColorFactor));
-        for (auto& dst : mColors)
+        if (mColors.empty())
+        { // no vertex colors, white times the base color is just the base color
+            mColors.resize(mPositions.size(), LLColor4U(baseColor));
+        }
+        else
         {
-            dst = LLColor4U(baseColor * LLColor4(dst));
+            for (auto& dst : mColors)
+            {
+                dst = LLColor4U(baseColor * LLColor4(dst));
+            }
         }
 
         if (material.mUnlit.mPresent)
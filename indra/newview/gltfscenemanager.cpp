@@ -127,6 +127,19 @@ void GLTFSceneManager::uploadSelection()
 
         GLTF::Asset& asset = *mUploadingAsset;
 
+        // the copy reads the buffers back from the file they were loaded
+        // from, the object's asset stays without them
+        for (auto& buffer : asset.mBuffers)
+        {
+            if (!buffer.detach())
+            {
+                LL_WARNS("GLTF") << "Failed to read GLTF buffers for upload" << LL_ENDL;
+                mUploadingAsset = nullptr;
+                mUploadingObject = nullptr;
+                return;
+            }
+        }
+
         for (auto& image : asset.mImages)
         {
             if (image.mTexture.notNull())
@@ -140,7 +153,7 @@ void GLTFSceneManager::uploadSelection()
                     BufferView& view = asset.mBufferViews[image.mBufferView];
                     Buffer& buffer = asset.mBuffers[view.mBuffer];
 
-                    raw = LLViewerTextureManager::getRawImageFromMemory(buffer.mData.data() + view.mByteOffset, view.mByteLength, image.mMimeType);
+                    raw = LLViewerTextureManager::getRawImageFromMemory(buffer.data() + view.mByteOffset, view.mByteLength, image.mMimeType);
 
                     image.clearData(asset);
                 }
@@ -230,7 +243,7 @@ void GLTFSceneManager::uploadSelection()
             S32 idx = (S32)(&bin - &asset.mBuffers[0]);
 
             std::string buffer;
-            buffer.assign((const char*)bin.mData.data(), bin.mData.size());
+            buffer.assign((const char*)bin.data(), bin.size());
 
             LLUUID asset_id = LLUUID::generateNewID();
 
@@ -254,10 +267,10 @@ void GLTFSceneManager::uploadSelection()
 
                         // HACK: save buffer to cache to emulate a successful download
                         LLFileSystem cache(assetId, LLAssetType::AT_GLTF_BIN, LLFileSystem::WRITE);
-                        auto& data = mUploadingAsset->mBuffers[idx].mData;
+                        const Buffer& data = mUploadingAsset->mBuffers[idx];
 
                         llassert(data.size() <= size_t(S32_MAX));
-                        cache.write((const U8 *) data.data(), S32(data.size()));
+                        cache.write(data.data(), S32(data.size()));
                     }
                 };
 #if GLTF_SIM_SUPPORT
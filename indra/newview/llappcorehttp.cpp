@@ -240,6 +240,21 @@ void LLAppCoreHttp::init()
                                                             trace_level, NULL);
     }
 
+    // Optionally share one HTTP/2 multiplexing connection pool between
+    // all policy classes.  Only read at startup.
+    static const std::string http2_multiplex("HttpHTTP2Multiplex");
+    if (gSavedSettings.controlExists(http2_multiplex) && gSavedSettings.getBOOL(http2_multiplex))
+    {
+        status = LLCore::HttpRequest::setStaticPolicyOption(LLCore::HttpRequest::PO_HTTP2_MULTIPLEX,
+                                                            LLCore::HttpRequest::GLOBAL_POLICY_ID,
+                                                            1L, NULL);
+        if (! status)
+        {
+            LL_WARNS("Init") << "Failed to enable HTTP/2 multiplexing.  Reason:  " << status.toString()
+                             << LL_ENDL;
+        }
+    }
+
     // Setup default policy and constrain if directed to
     mHttpClasses[AP_DEFAULT].mPolicy = LLCore::HttpRequest::DEFAULT_POLICY_ID;
 
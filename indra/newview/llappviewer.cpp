@@ -256,6 +256,7 @@
 #include "gltfscenemanager.h"
 
 #include "workqueue.h"
+#include "parallelfor.h"
 using namespace LL;
 
 // Include for security api initialization
@@ -703,6 +704,7 @@ LLAppViewer::LLAppViewer()
     mReportedCrash(false),
     mNumSessions(0),
     mGeneralThreadPool(nullptr),
+    mParallelThreadPool(nullptr),
     mPurgeCache(false),
     mPurgeCacheOnExit(false),
     mPurgeUserDataOnExit(false),
@@ -2410,6 +2412,10 @@ bool LLAppViewer::cleanup()
     {
         mGeneralThreadPool->close();
     }
+    if (mParallelThreadPool)
+    {
+        mParallelThreadPool->close();
+    }
 
     sTextureFetch->shutDownTextureCacheThread() ;
     LLLFSThread::sLocal->shutdown();
@@ -2441,6 +2447,8 @@ bool LLAppViewer::cleanup()
     sPurgeDiskCacheThread = NULL;
     delete mGeneralThreadPool;
     mGeneralThreadPool = NULL;
+    delete mParallelThreadPool;
+    mParallelThreadPool = NULL;
 
     if (LLFastTimerView::sAnalyzePerformance)
     {
@@ -2592,6 +2600,13 @@ bool LLAppViewer::initThreads()
     // general task background thread (LLPerfStats, etc)
     LLAppViewer::instance()->initGeneralThread();
 
+    // Helpers for LL::parallel_for() frame work (particle integration, etc).
+    // The calling thread always takes a share of the work, so leave it and
+    // the other busy viewer threads some room. A "Parallel" entry in
+    // ThreadPoolSizes overrides this default.
+    mParallelThreadPool = new LL::ThreadPool(LL::PARALLEL_POOL_NAME, llclamp(cores / 2 - 1, 1, 4));
+    mParallelThreadPool->start();
+
     LLAppViewer::sPurgeDiskCacheThread = new LLPurgeDiskCacheThread();
 
     if (LLTrace::BlockTimer::sLog || LLTrace::BlockTimer::sMetricLog)
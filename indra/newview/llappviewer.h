@@ -326,6 +326,7 @@ private:
     static LLTextureFetch* sTextureFetch;
     static LLPurgeDiskCacheThread* sPurgeDiskCacheThread;
     LL::ThreadPool* mGeneralThreadPool;
+    LL::ThreadPool* mParallelThreadPool;
 
     S32 mNumSessions;
 
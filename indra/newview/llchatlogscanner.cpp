@@ -0,0 +1,240 @@
+/**
+ * @file llchatlogscanner.cpp
+ * @brief Fast line and field scanning for plain text chat transcripts
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llchatlogscanner.h"
+
+#include <emmintrin.h>
+
+namespace
+{
+    inline bool is_digit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    // what \s matches
+    inline bool is_space(char c)
+    {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    // Skips a run of between min_count and max_count digits; the run must
+    // not be followed by another digit, like \d{min,max} followed by a
+    // literal that is not a digit.
+    bool skip_digits(const char*& pos, const char* end, int min_count, int max_count)
+    {
+        int count = 0;
+        while (pos < end && is_digit(*pos))
+        {
+            ++pos;
+            ++count;
+        }
+        return count >= min_count && count <= max_count;
+    }
+
+    bool skip_char(const char*& pos, const char* end, char c)
+    {
+        if (pos < end && *pos == c)
+        {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool skip_spaces(const char*& pos, const char* end)
+    {
+        const char* start = pos;
+        while (pos < end && is_space(*pos))
+        {
+            ++pos;
+        }
+        return pos != start;
+    }
+
+    // \d{1,2}:\d{2} and, with seconds, :\d{2}
+    bool skip_time(const char*& pos, const char* end, bool seconds)
+    {
+        return skip_digits(pos, end, 1, 2) && skip_char(pos, end, ':') && skip_digits(pos, end, 2, 2)
+            && (!seconds || (skip_char(pos, end, ':') && skip_digits(pos, end, 2, 2)));
+    }
+
+    // (\[\d{4}/\d{1,2}/\d{1,2}\s+TIME\]\s+|\[TIME\]\s+), returns the end of
+    // the match or NULL
+    const char* match_timestamp(const char* begin, const char* end, bool seconds)
+    {
+        const char* pos = begin;
+        if (skip_char(pos, end, '[') && skip_digits(pos, end, 4, 4) && skip_char(pos, end, '/')
+            && skip_digits(pos, end, 1, 2) && skip_char(pos, end, '/') && skip_digits(pos, end, 1, 2)
+            && skip_spaces(pos, end) && skip_time(pos, end, seconds) && skip_char(pos, end, ']')
+            && skip_spaces(pos, end))
+        {
+            return pos;
+        }
+        pos = begin;
+        if (skip_char(pos, end, '[') && skip_time(pos, end, seconds) && skip_char(pos, end, ']')
+            && skip_spaces(pos, end))
+        {
+            return pos;
+        }
+        return NULL;
+    }
+
+    inline bool is_message_start(char c)
+    {
+        return c != ' ' && c != '\n' && c != '\r';
+    }
+}
+
+// static
+bool LLChatLogScanner::splitTimestamp(const std::string& line, std::string& timestamp, std::string& stuff, bool& has_seconds)
+{
+    const char* begin = line.data();
+    const char* end = begin + line.size();
+    // like the patterns, try the format with seconds first
+    has_seconds = true;
+    const char* stamp_end = match_timestamp(begin, end, true);
+    if (!stamp_end)
+    {
+        has_seconds = false;
+        stamp_end = match_timestamp(begin, end, false);
+    }
+    if (!stamp_end)
+    {
+        timestamp.clear();
+        stuff = line;
+        return false;
+    }
+    timestamp.assign(begin, stamp_end);
+    stuff.assign(stamp_end, end);
+    return true;
+}
+
+// static
+bool LLChatLogScanner::splitName(const std::string& stuff, std::string& name, std::string& text)
+{
+    const size_t colon = stuff.find(':');
+    const bool has_name = colon != std::string::npos && colon != 0;
+    size_t start = 0;
+    if (has_name)
+    {
+        name.assign(stuff, 0, colon + 1);
+        start = colon + 1;
+    }
+    else
+    {
+        name.clear();
+    }
+    while (start < stuff.size() && is_space(stuff[start]))
+    {
+        ++start;
+    }
+    text.assign(stuff, start, std::string::npos);
+    return has_name;
+}
+
+// static
+const char* LLChatLogScanner::findNewline(const char* pos, const char* end)
+{
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - pos >= 16)
+    {
+        const __m128i chunk = _mm_loadu_si128((const __m128i*)pos);
+        const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+        if (mask)
+        {
+            int bit = 0;
+            while (!(mask & (1 << bit)))
+            {
+                ++bit;
+            }
+            return pos + bit;
+        }
+        pos += 16;
+    }
+    while (pos < end && *pos != '\n')
+    {
+        ++pos;
+    }
+    return pos;
+}
+
+// static
+const char* LLChatLogScanner::findPrevNewline(const char* begin, const char* pos)
+{
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (pos - begin >= 16)
+    {
+        const __m128i chunk = _mm_loadu_si128((const __m128i*)(pos - 16));
+        const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+        if (mask)
+        {
+            int bit = 15;
+            while (!(mask & (1 << bit)))
+            {
+                --bit;
+            }
+            return pos - 16 + bit;
+        }
+        pos -= 16;
+    }
+    while (pos > begin)
+    {
+        if (*--pos == '\n')
+        {
+            return pos;
+        }
+    }
+    return NULL;
+}
+
+// static
+const char* LLChatLogScanner::findMessagesStart(const char* begin, const char* end, size_t max_bytes)
+{
+    // the text before limit is only a line start if it is the beginning of
+    // the text
+    const char* limit = (max_bytes && (size_t)(end - begin) > max_bytes) ? end - max_bytes : begin;
+    if (limit == begin && begin < end && is_message_start(*begin))
+    {
+        return begin;
+    }
+
+    // lines may start anywhere from limit on; the newline before such a
+    // line can sit just in front of it
+    const char* newline = findNewline((limit > begin) ? limit - 1 : begin, end);
+    while (newline < end)
+    {
+        const char* line = newline + 1;
+        if (line < end && is_message_start(*line))
+        {
+            return line;
+        }
+        newline = findNewline(line, end);
+    }
+    return end;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file llchatlogscanner.h
+ * @brief Fast line and field scanning for plain text chat transcripts
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLCHATLOGSCANNER_H
+#define LL_LLCHATLOGSCANNER_H
+
+#include <string>
+
+/**
+ * Hand written replacements for the regular expressions that used to split
+ * chat transcript lines:
+ *  timestamp  ^(\[\d{4}/\d{1,2}/\d{1,2}\s+\d{1,2}:\d{2}(:\d{2})?\]\s+|\[\d{1,2}:\d{2}(:\d{2})?\]\s+)?(.*)$
+ *  name       ([^:]+[:]{1})?(\s*)(.*)
+ * with the same results (tests/llchatlogscanner_test.cpp keeps the patterns
+ * to check this), but without backtracking or a regex engine per line.
+ *
+ * The newline scans look at 16 bytes at a time so the tail of a transcript
+ * can be walked from the end without splitting it into lines first.
+ */
+class LLChatLogScanner
+{
+public:
+    // Splits "[2009/11/20 3:00:01]  rest" or "[3:00]  rest" into the
+    // bracketed timestamp with its trailing white space, and the rest.
+    // Without a timestamp, stuff is the whole line. has_seconds tells which
+    // of the two timestamp formats was found.
+    static bool splitTimestamp(const std::string& line, std::string& timestamp, std::string& stuff, bool& has_seconds);
+
+    // Splits "Name: text" into "Name:" and "text", white space after the
+    // colon is dropped. Returns false, with the input minus its leading
+    // white space in text, if there is no name (no colon, or nothing before
+    // the first one).
+    static bool splitName(const std::string& stuff, std::string& name, std::string& text);
+
+    // First '\n' in [pos, end), end if there is none
+    static const char* findNewline(const char* pos, const char* end);
+    // Last '\n' in [begin, pos), NULL if there is none
+    static const char* findPrevNewline(const char* begin, const char* pos);
+
+    // Start of the oldest message worth loading from the tail of a
+    // transcript: the first one that starts in the last max_bytes bytes
+    // (0 for the whole text). A message starts on a line that is not a
+    // continuation line (leading space) or an empty line. Returns end if no
+    // message qualifies.
+    static const char* findMessagesStart(const char* begin, const char* end, size_t max_bytes);
+};
+
+#endif // LL_LLCHATLOGSCANNER_H
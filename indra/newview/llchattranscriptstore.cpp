@@ -0,0 +1,388 @@
+/**
+ * @file llchattranscriptstore.cpp
+ * @brief Indexed, searchable store for chat transcripts
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llchattranscriptstore.h"
+
+#include "hbxxh.h"
+#include "llfile.h"
+
+namespace
+{
+    // bump when any on disk structure changes, older stores get rebuilt
+    const U32 STORE_VERSION = 2;
+
+    S64 file_size(const std::string& path)
+    {
+        llstat stat_data;
+        if (LLFile::stat(path, &stat_data))
+        {
+            return -1;
+        }
+        return (S64)stat_data.st_size;
+    }
+
+    // index files and transcripts of a long history can pass 2 GB
+    bool seek_to(LLFILE* file, U64 offset)
+    {
+#if LL_WINDOWS
+        return !_fseeki64(file, (__int64)offset, SEEK_SET);
+#else
+        return !fseeko(file, (off_t)offset, SEEK_SET);
+#endif
+    }
+
+    bool read_at(LLFILE* file, U64 offset, void* data, size_t size)
+    {
+        return file && seek_to(file, offset) && fread(data, 1, size, file) == size;
+    }
+
+    bool append_to(const std::string& path, const void* data, size_t size)
+    {
+        LLFILE* file = LLFile::fopen(path, "ab");
+        if (!file)
+        {
+            return false;
+        }
+        bool ok = fwrite(data, 1, size, file) == size;
+        ok = !fclose(file) && ok;
+        return ok;
+    }
+}
+
+LLChatTranscriptStore::LLChatTranscriptStore(const std::string& base_path)
+:   mBasePath(base_path),
+    mCount(0),
+    mSourceSize(0),
+    mSourceTime(0),
+    mSourceHash(0),
+    mLastTime(0),
+    mSegment(0),
+    mSegmentSize(0)
+{
+}
+
+LLChatTranscriptStore::~LLChatTranscriptStore()
+{
+}
+
+std::string LLChatTranscriptStore::getPath(const char* ext) const
+{
+    return mBasePath + ext;
+}
+
+std::string LLChatTranscriptStore::getSegmentPath(U32 segment) const
+{
+    return mBasePath + ".tdat" + std::to_string(segment);
+}
+
+// static
+U64 LLChatTranscriptStore::hashSource(const std::string& path, U64 size)
+{
+    const U64 head = llmin(size, (U64)SOURCE_BLOCK);
+    const U64 tail = llmin(size - head, (U64)SOURCE_BLOCK);
+    std::string blocks(head + tail, '\0');
+    LLFILE* file = LLFile::fopen(path, "rb");
+    bool ok = read_at(file, 0, &blocks[0], head) && (!tail || read_at(file, size - tail, &blocks[head], tail));
+    if (file)
+    {
+        fclose(file);
+    }
+    return ok ? HBXXH64::digest(blocks) : 0;
+}
+
+// static
+void LLChatTranscriptStore::removeFiles(const std::string& base_path)
+{
+    LLChatTranscriptStore store(base_path);
+    // the word index files are only left by version 1 stores
+    static const char* extensions[] = { ".thdr", ".tidx", ".twd", ".twp", ".twt", ".twd.tmp", ".twp.tmp" };
+    for (const char* ext : extensions)
+    {
+        LLFile::remove(store.getPath(ext), ENOENT);
+    }
+    for (U32 segment = 0; LLFile::isfile(store.getSegmentPath(segment)); ++segment)
+    {
+        LLFile::remove(store.getSegmentPath(segment));
+    }
+}
+
+bool LLChatTranscriptStore::clear()
+{
+    removeFiles(mBasePath);
+    mCount = 0;
+    mSourceSize = 0;
+    mSourceTime = 0;
+    mSourceHash = 0;
+    mLastTime = 0;
+    mSegment = 0;
+    mSegmentSize = 0;
+    return flush();
+}
+
+bool LLChatTranscriptStore::open()
+{
+    Header header;
+    LLFILE* file = LLFile::fopen(getPath(".thdr"), "rb");
+    bool valid = read_at(file, 0, &header, sizeof(header)) && header.mVersion == STORE_VERSION;
+    if (file)
+    {
+        fclose(file);
+    }
+
+    // Appends are only committed by flush(), anything written after the
+    // last header (or torn by a crash) makes the store unusable as is
+    if (valid)
+    {
+        mCount = header.mCount;
+        mSourceSize = header.mSourceSize;
+        mSourceTime = header.mSourceTime;
+        mSourceHash = header.mSourceHash;
+        S64 idx_size = file_size(getPath(".tidx"));
+        valid = (mCount == 0 && idx_size <= 0) || idx_size == (S64)mCount * (S64)sizeof(IndexEntry);
+    }
+    if (valid && mCount)
+    {
+        std::vector<IndexEntry> last;
+        valid = readEntries(mCount - 1, 1, last);
+        if (valid)
+        {
+            mLastTime = last[0].mTime;
+            mSegment = last[0].mSegment;
+            mSegmentSize = last[0].mOffset + last[0].mSize;
+            valid = file_size(getSegmentPath(mSegment)) == (S64)mSegmentSize;
+        }
+    }
+
+    if (!valid)
+    {
+        LL_DEBUGS("ChatHistory") << "Rebuilding transcript store " << mBasePath << LL_ENDL;
+        return clear();
+    }
+    return true;
+}
+
+bool LLChatTranscriptStore::flush()
+{
+    Header header;
+    header.mVersion = STORE_VERSION;
+    header.mCount = mCount;
+    header.mSourceSize = mSourceSize;
+    header.mSourceTime = mSourceTime;
+    header.mSourceHash = mSourceHash;
+
+    LLFILE* file = LLFile::fopen(getPath(".thdr"), "wb");
+    if (!file)
+    {
+        LL_WARNS("ChatHistory") << "Unable to write " << getPath(".thdr") << LL_ENDL;
+        return false;
+    }
+    bool ok = fwrite(&header, 1, sizeof(header), file) == sizeof(header);
+    return !fclose(file) && ok;
+}
+
+bool LLChatTranscriptStore::append(S64 time, const std::string& text)
+{
+    if (mSegmentSize && mSegmentSize + text.size() > SEGMENT_SIZE)
+    {
+        ++mSegment;
+        mSegmentSize = 0;
+    }
+
+    IndexEntry entry;
+    entry.mTime = llmax(time, mLastTime);
+    entry.mSegment = mSegment;
+    entry.mOffset = mSegmentSize;
+    entry.mSize = (U32)text.size();
+    entry.mPad = 0;
+
+    if (!append_to(getSegmentPath(mSegment), text.data(), text.size()) ||
+        !append_to(getPath(".tidx"), &entry, sizeof(entry)))
+    {
+        LL_WARNS("ChatHistory") << "Unable to append to transcript store " << mBasePath << LL_ENDL;
+        return false;
+    }
+
+    ++mCount;
+    mLastTime = entry.mTime;
+    mSegmentSize += entry.mSize;
+    return true;
+}
+
+void LLChatTranscriptStore::setSource(const std::string& path, U64 size)
+{
+    llstat stat_data;
+    mSourceSize = size;
+    mSourceTime = LLFile::stat(path, &stat_data) ? 0 : (S64)stat_data.st_mtime;
+    mSourceHash = hashSource(path, size);
+}
+
+bool LLChatTranscriptStore::matchesSource(const std::string& path) const
+{
+    if (!mSourceSize)
+    {
+        return true;
+    }
+    llstat stat_data;
+    if (LLFile::stat(path, &stat_data) || (U64)stat_data.st_size < mSourceSize)
+    {
+        return false;
+    }
+    if ((U64)stat_data.st_size == mSourceSize && (S64)stat_data.st_mtime != mSourceTime)
+    {
+        // rewritten in place, the ends may still match
+        return false;
+    }
+    return hashSource(path, mSourceSize) == mSourceHash;
+}
+
+bool LLChatTranscriptStore::readEntries(U32 first, U32 count, std::vector<IndexEntry>& entries) const
+{
+    entries.resize(count);
+    if (!count)
+    {
+        return true;
+    }
+    LLFILE* file = LLFile::fopen(getPath(".tidx"), "rb");
+    bool ok = read_at(file, (U64)first * sizeof(IndexEntry), entries.data(), count * sizeof(IndexEntry));
+    if (file)
+    {
+        fclose(file);
+    }
+    return ok;
+}
+
+bool LLChatTranscriptStore::read(U32 first, U32 count, std::vector<std::string>& texts) const
+{
+    texts.clear();
+    if (first >= mCount)
+    {
+        return true;
+    }
+    count = llmin(count, mCount - first);
+
+    std::vector<IndexEntry> entries;
+    if (!readEntries(first, count, entries))
+    {
+        return false;
+    }
+
+    // consecutive messages are contiguous within a segment, read each
+    // segment's share in one go
+    texts.resize(count);
+    for (U32 i = 0; i < count; )
+    {
+        U32 end = i + 1;
+        while (end < count && entries[end].mSegment == entries[i].mSegment)
+        {
+            ++end;
+        }
+        const U32 start = entries[i].mOffset;
+        const U32 bytes = entries[end - 1].mOffset + entries[end - 1].mSize - start;
+        std::string block(bytes, '\0');
+        LLFILE* file = LLFile::fopen(getSegmentPath(entries[i].mSegment), "rb");
+        bool ok = !bytes || read_at(file, start, &block[0], bytes);
+        if (file)
+        {
+            fclose(file);
+        }
+        if (!ok)
+        {
+            texts.clear();
+            return false;
+        }
+        for (; i < end; ++i)
+        {
+            texts[i].assign(block, entries[i].mOffset - start, entries[i].mSize);
+        }
+    }
+    return true;
+}
+
+bool LLChatTranscriptStore::getLast(U32 max_count, U32 max_bytes, std::vector<std::string>& texts) const
+{
+    U32 count = llmin(max_count, mCount);
+    if (max_bytes && count)
+    {
+        // walk the index back a chunk at a time, only as far as the byte
+        // budget reaches
+        const U32 CHUNK = 256;
+        std::vector<IndexEntry> entries;
+        U32 bytes = 0;
+        U32 keep = 0;
+        while (keep < count && bytes < max_bytes)
+        {
+            const U32 chunk = llmin(CHUNK, count - keep);
+            if (!readEntries(mCount - keep - chunk, chunk, entries))
+            {
+                return false;
+            }
+            for (U32 i = chunk; i-- > 0 && bytes < max_bytes; ++keep)
+            {
+                bytes += entries[i].mSize;
+            }
+        }
+        count = keep;
+    }
+    return read(mCount - count, count, texts);
+}
+
+S64 LLChatTranscriptStore::getTime(U32 id) const
+{
+    std::vector<IndexEntry> entries;
+    return id < mCount && readEntries(id, 1, entries) ? entries[0].mTime : 0;
+}
+
+U32 LLChatTranscriptStore::findTime(S64 time) const
+{
+    LLFILE* file = LLFile::fopen(getPath(".tidx"), "rb");
+    if (!file)
+    {
+        return mCount;
+    }
+    U32 lo = 0;
+    U32 hi = mCount;
+    while (lo < hi)
+    {
+        const U32 mid = lo + (hi - lo) / 2;
+        IndexEntry entry;
+        if (!read_at(file, (U64)mid * sizeof(IndexEntry), &entry, sizeof(entry)))
+        {
+            break;
+        }
+        if (entry.mTime < time)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    fclose(file);
+    return lo;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file llchattranscriptstore.h
+ * @brief Indexed, searchable store for chat transcripts
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLCHATTRANSCRIPTSTORE_H
+#define LL_LLCHATTRANSCRIPTSTORE_H
+
+#include <string>
+#include <vector>
+
+/**
+ * Append-only message store for one conversation, kept next to (and
+ * rebuildable from) the plain text transcript.
+ *
+ * All files share a base path:
+ *  - base.thdr    header: format version, message count, size and
+ *                 fingerprint of the source text imported so far
+ *  - base.tidx    fixed size (time, segment, offset, size) entry per message,
+ *                 so the last N messages and time lookups never touch the
+ *                 rest of the history
+ *  - base.tdatN   message text, split in segments of at most SEGMENT_SIZE
+ *
+ * Messages are stored as their raw transcript text so callers can run them
+ * through the same parser as the text files. Times must not go backwards;
+ * append() clamps them so time lookups can binary search. Nothing here is
+ * thread safe, callers serialize access to a given base path.
+ */
+class LLChatTranscriptStore
+{
+public:
+    static const U32 SEGMENT_SIZE = 32 * 1024 * 1024;
+    static const U32 SOURCE_BLOCK = 4096;   // bytes hashed at each end of the imported source
+
+    explicit LLChatTranscriptStore(const std::string& base_path);
+    ~LLChatTranscriptStore();
+
+    // Load the header and word index tail. An unreadable or inconsistent
+    // store (e.g. after a crash mid-append) is cleared, returns false only
+    // if the files cannot be created.
+    bool open();
+    // Delete every file of the store and start empty
+    bool clear();
+    static void removeFiles(const std::string& base_path);
+
+    bool append(S64 time, const std::string& text);
+    // Write the header; call after a batch of appends
+    bool flush();
+
+    U32 size() const { return mCount; }
+    bool empty() const { return mCount == 0; }
+
+    // Byte size of the source transcript already imported
+    U64 getSourceSize() const { return mSourceSize; }
+    // Record that the transcript at path is imported up to size, along with
+    // its modification time and a hash of the first and last SOURCE_BLOCK
+    // bytes before size
+    void setSource(const std::string& path, U64 size);
+    // Whether the transcript at path still holds what was imported: it is
+    // at least as long, the hash still matches and, if it did not grow, so
+    // does its modification time. Catches transcripts replaced by another
+    // file or edited outside the viewer; an empty store matches anything.
+    bool matchesSource(const std::string& path) const;
+
+    // Texts of messages [first, first + count), oldest first
+    bool read(U32 first, U32 count, std::vector<std::string>& texts) const;
+    // The newest messages, at most max_count of them and stopping once
+    // max_bytes of text have been collected (0 for no byte limit)
+    bool getLast(U32 max_count, U32 max_bytes, std::vector<std::string>& texts) const;
+    // Index of the first message at or after time, size() if none
+    U32 findTime(S64 time) const;
+    S64 getTime(U32 id) const;
+
+private:
+    struct Header
+    {
+        U32 mVersion;
+        U32 mCount;
+        U64 mSourceSize;
+        S64 mSourceTime;
+        U64 mSourceHash;
+    };
+
+    struct IndexEntry
+    {
+        S64 mTime;
+        U32 mSegment;
+        U32 mOffset;
+        U32 mSize;
+        U32 mPad;
+    };
+
+    std::string getPath(const char* ext) const;
+    std::string getSegmentPath(U32 segment) const;
+    // Hash of the first and last SOURCE_BLOCK bytes of path before size,
+    // 0 if they cannot be read
+    static U64 hashSource(const std::string& path, U64 size);
+
+    bool readEntries(U32 first, U32 count, std::vector<IndexEntry>& entries) const;
+
+    std::string mBasePath;
+    U32 mCount;
+    U64 mSourceSize;
+    S64 mSourceTime;
+    U64 mSourceHash;
+    S64 mLastTime;
+    U32 mSegment;           // segment being appended to
+    U32 mSegmentSize;
+};
+
+#endif // LL_LLCHATTRANSCRIPTSTORE_H
@@ -50,6 +50,7 @@
 #include "llglcommonfunc.h"
 #include "llvoavatar.h"
 #include "gltfscenemanager.h"
+#include "llradixsort.h"
 
 #include "llenvironment.h"
 
@@ -60,6 +61,121 @@ bool LLDrawPoolAlpha::sShowDebugAlphaRigged = false;
 
 LLVector4 LLDrawPoolAlpha::sWaterPlane;
 
+LLTrace::EventStatHandle<F64Milliseconds> LLDrawPoolAlpha::sStatSortTime("alphasorttime");
+
+namespace
+{
+    // state of the last coherent alpha group sort
+    U32 sAlphaSortGeneration = 0;
+    U32 sAlphaSortCount = 0;
+
+    std::vector<LLSpatialGroup*> sAlphaSortSlots;
+    std::vector<LLSpatialGroup*> sAlphaSortNew;
+    std::vector<std::pair<U32, LLSpatialGroup*>> sAlphaSortScratch;
+
+    // Arrange groups in the order of the previous sort, then insertion sort
+    // them.  Returns false if the order changed too much to be worth it, in
+    // which case the groups are left in an arbitrary order.
+    bool coherent_sort_alpha_groups(LLSpatialGroup** groups, U32 count)
+    {
+        const U32 prev_generation = sAlphaSortGeneration - 1;
+
+        // ranks from the previous sort are unique, so placing groups back in
+        // their old order is a scatter rather than a sort
+        sAlphaSortSlots.assign(sAlphaSortCount, nullptr);
+        sAlphaSortNew.clear();
+        for (U32 i = 0; i < count; ++i)
+        {
+            LLSpatialGroup* group = groups[i];
+            if (group->mAlphaSortGeneration == prev_generation &&
+                group->mAlphaSortRank < sAlphaSortCount &&
+                !sAlphaSortSlots[group->mAlphaSortRank])
+            {
+                sAlphaSortSlots[group->mAlphaSortRank] = group;
+            }
+            else
+            {
+                sAlphaSortNew.push_back(group);
+            }
+        }
+
+        U32 n = 0;
+        for (LLSpatialGroup* group : sAlphaSortSlots)
+        {
+            if (group)
+            {
+                groups[n++] = group;
+            }
+        }
+        for (LLSpatialGroup* group : sAlphaSortNew)
+        {
+            groups[n++] = group;
+        }
+
+        // insertion sort, farthest first, giving up once it costs more than
+        // a few passes over the list
+        const U64 max_moves = (U64)count * 8 + 64;
+        U64 moves = 0;
+        for (U32 i = 1; i < count; ++i)
+        {
+            LLSpatialGroup* group = groups[i];
+            const F32 depth = group->mDepth;
+            U32 j = i;
+            while (j > 0 && groups[j - 1]->mDepth < depth)
+            {
+                groups[j] = groups[j - 1];
+                --j;
+            }
+            groups[j] = group;
+
+            moves += i - j;
+            if (moves > max_moves)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+//static
+void LLDrawPoolAlpha::sortAlphaGroups(LLSpatialGroup** begin, LLSpatialGroup** end, bool coherent)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL;
+
+    LLTimer sort_timer;
+    const U32 count = (U32)(end - begin);
+
+    if (coherent)
+    {
+        ++sAlphaSortGeneration;
+    }
+
+    if (!coherent || !coherent_sort_alpha_groups(begin, count))
+    {
+        // stable, so groups at equal depth keep their cull order
+        ll_radix_sort(begin, count,
+            [](const LLSpatialGroup* group)
+            {
+                return ~ll_float_sort_key(group->mDepth);
+            },
+            sAlphaSortScratch);
+    }
+
+    if (coherent)
+    {
+        for (U32 i = 0; i < count; ++i)
+        {
+            begin[i]->mAlphaSortRank = i;
+            begin[i]->mAlphaSortGeneration = sAlphaSortGeneration;
+        }
+        sAlphaSortCount = count;
+    }
+
+    record(sStatSortTime, sort_timer.getElapsedTimeF64());
+}
+
 // minimum alpha before discarding a fragment
 static const F32 MINIMUM_ALPHA = 0.004f; // ~ 1/255
 
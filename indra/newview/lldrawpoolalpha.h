@@ -30,10 +30,12 @@
 #include "lldrawpool.h"
 #include "llrender.h"
 #include "llframetimer.h"
+#include "lltrace.h"
 
 class LLFace;
 class LLColor4;
 class LLGLSLShader;
+class LLSpatialGroup;
 
 class LLDrawPoolAlpha final: public LLRenderPass
 {
@@ -70,6 +72,15 @@ public:
     static bool sShowDebugAlpha;
     static bool sShowDebugAlphaRigged;
 
+    // Order alpha groups back to front by LLSpatialGroup::mDepth.
+    // When coherent, the order of the previous coherent sort seeds an
+    // insertion sort, which is close to linear while the camera moves
+    // smoothly; large reorders fall back to a radix sort on depth keys.
+    // Only pass coherent for one camera, or the seeds thrash.
+    static void sortAlphaGroups(LLSpatialGroup** begin, LLSpatialGroup** end, bool coherent);
+
+    static LLTrace::EventStatHandle<F64Milliseconds> sStatSortTime;
+
 private:
     LLGLSLShader* target_shader;
 
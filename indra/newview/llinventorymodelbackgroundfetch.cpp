@@ -1478,8 +1478,10 @@ void BGFolderHttpHandler::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRes
 
         // Convert response to LLSD
         // body->write(0, "Garbage Response", 16);      // Dev tool to force error handling
+        // processData() copies what it needs into inventory objects, no
+        // part of the reply outlives this call
         LLSD body_llsd;
-        if (! LLCoreHttpUtil::responseToLLSD(response, true, body_llsd))
+        if (! LLCoreHttpUtil::responseToLLSD(response, true, body_llsd, true))
         {
             // INFOS-level logging will occur on the parsed failure
             processFailure("HTTP response contained malformed LLSD", response);
@@ -29,6 +29,8 @@
 #include "llagent.h"
 #include "llagentui.h"
 #include "llavatarnamecache.h"
+#include "llchatlogscanner.h"
+#include "llchattranscriptstore.h"
 #include "lllogchat.h"
 #include "llregex.h"
 #include "lltrans.h"
@@ -41,6 +43,7 @@
 // </FS:CR>
 #include "llinstantmessage.h"
 #include "llsingleton.h" // for LLSingleton
+#include "workqueue.h"
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/algorithm/string/replace.hpp>
@@ -81,22 +84,14 @@ const static std::string MULTI_LINE_PREFIX(" ");
  *  [2009/11/20 3:01]  Corba ProductEngine is Offline
  *
  * Note: "You" was used as an avatar names in viewers of previous versions
+ *
+ * LLChatLogScanner splits such lines into timestamp, name and text.
  */
-const static boost::regex TIMESTAMP_AND_STUFF("^(\\[\\d{4}/\\d{1,2}/\\d{1,2}\\s+\\d{1,2}:\\d{2}\\]\\s+|\\[\\d{1,2}:\\d{2}\\]\\s+)?(.*)$");
 const static boost::regex TIMESTAMP("^(\\[\\d{4}/\\d{1,2}/\\d{1,2}\\s+\\d{1,2}:\\d{2}\\]|\\[\\d{1,2}:\\d{2}\\]).*");
 // <FS:Ansariel> Timestamps in chat
-// Note: In contrast to the TIMESTAMP_AND_STUFF regex, for the TIMESTAMP_AND_STUFF_SEC regex the match
-// on the timestamp is NOT optional. We need this to decide during parsing if we have timestamps or not.
-const static boost::regex TIMESTAMP_AND_STUFF_SEC("^(\\[\\d{4}/\\d{1,2}/\\d{1,2}\\s+\\d{1,2}:\\d{2}:\\d{2}\\]\\s+|\\[\\d{1,2}:\\d{2}:\\d{2}\\]\\s+)(.*)$");
 const static boost::regex TIMESTAMP_AND_SEC("^(\\[\\d{4}/\\d{1,2}/\\d{1,2}\\s+\\d{1,2}:\\d{2}:\\d{2}\\]|\\[\\d{1,2}:\\d{2}:\\d{2}\\]).*");
 // </FS:Ansariel>
 
-/**
- *  Regular expression suitable to match names like
- *  "You", "Second Life", "Igor ProductEngine", "Object", "Mega House"
- */
-const static boost::regex NAME_AND_TEXT("([^:]+[:]{1})?(\\s*)(.*)");
-
 /**
  * These are recognizers for matching the names of ad-hoc conferences when generating the log file name
  * On invited side, an ad-hoc is named like "<first name> <last name> Conference 2010/11/19 03:43 f0f4"
@@ -118,11 +113,6 @@ const static char* DATE_FORMAT_SEC("%Y/%m/%d %H:%M:%S");
 const static char* TIME_FORMAT_SEC("%H:%M:%S");
 // </FS:Ansariel>
 
-const static int IDX_TIMESTAMP = 1;
-const static int IDX_STUFF = 2;
-const static int IDX_NAME = 1;
-const static int IDX_TEXT = 3;
-
 using namespace boost::posix_time;
 using namespace boost::gregorian;
 
@@ -135,6 +125,31 @@ void append_to_last_message(std::list<LLSD>& messages, const std::string& line)
     messages.back()[LL_IM_TEXT] = im_text;
 }
 
+// Ordinal seconds of a "[YYYY/MM/DD HH:MM(:SS)]" line prefix for the
+// transcript time index, 0 for lines without a dated timestamp
+S64 parse_log_time(const std::string& line)
+{
+    S32 year, month, day, hour, minute, second = 0;
+    if (sscanf(line.c_str(), "[%4d/%2d/%2d %2d:%2d:%2d]", &year, &month, &day, &hour, &minute, &second) < 5)
+    {
+        return 0;
+    }
+    // days from civil, proleptic Gregorian calendar
+    year -= month <= 2;
+    const S64 era = (year >= 0 ? year : year - 399) / 400;
+    const S64 yoe = year - era * 400;
+    const S64 doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const S64 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    const S64 days = era * 146097 + doe - 719468;
+    return days * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+LLMutex& transcript_index_mutex()
+{
+    static LLMutex mutex;
+    return mutex;
+}
+
 const char* remove_utf8_bom(const char* buf)
 {
     const char* start = buf;
@@ -145,6 +160,100 @@ const char* remove_utf8_bom(const char* buf)
     return start;
 }
 
+// Read the part of a transcript load_transcript_tail() looks at: the whole
+// file for "load_all_history", otherwise the last LOG_RECALL_SIZE bytes and
+// the byte in front of them, which tells whether the first of those starts a
+// line. max_bytes is what to pass on to LLChatLogScanner::findMessagesStart().
+// This uses plain reads rather than a mapping since the transcript may be
+// appended to or truncated meanwhile.
+bool read_transcript_tail(const std::string& file_name, bool load_all_history, std::string& text, size_t& max_bytes)
+{
+    LLFILE* fptr = LLFile::fopen(file_name, "rb");     /*Flawfinder: ignore*/
+    if (!fptr)
+    {
+        return false;
+    }
+
+    text.clear();
+    max_bytes = 0;
+    long size = (fseek(fptr, 0, SEEK_END) == 0) ? ftell(fptr) : -1;
+    if (size > 0)
+    {
+        long offset = 0;
+        if (!load_all_history && size > LOG_RECALL_SIZE)
+        {
+            offset = size - LOG_RECALL_SIZE - 1;
+            max_bytes = LOG_RECALL_SIZE;
+        }
+        if (fseek(fptr, offset, SEEK_SET) == 0)
+        {
+            text.resize(size - offset);
+            text.resize(fread(&text[0], 1, text.size(), fptr));
+        }
+        if (offset && text.size() < (size_t)(size - offset))
+        {
+            // the file shrank under us: keep only the whole lines
+            size_t eol = text.find('\n');
+            text.erase(0, (eol == std::string::npos) ? text.size() : eol + 1);
+            max_bytes = 0;
+        }
+    }
+    fclose(fptr);
+    return true;
+}
+
+// Parse the newest messages of a transcript read by read_transcript_tail()
+// into messages. Lines are handled like the fgets() loop this replaces:
+// continuation lines and empty lines go to the previous message and a last
+// line without newline is left alone.
+void load_transcript_tail(const std::string& text, size_t max_bytes, std::list<LLSD>& messages, const LLSD& load_params)
+{
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    const char* last_newline = LLChatLogScanner::findPrevNewline(begin, end);
+    end = last_newline ? last_newline + 1 : begin;
+
+    // start on a message boundary instead of dropping a partial first line
+    const char* pos = LLChatLogScanner::findMessagesStart(begin, end, max_bytes);
+    std::string raw;
+    while (pos < end)
+    {
+        const char* eol = LLChatLogScanner::findNewline(pos, end);
+        const char* line_end = eol;
+        while (line_end > pos && line_end[-1] == '\r')
+        {
+            --line_end;
+        }
+        raw.assign(pos, line_end);
+        pos = eol + 1;
+
+        if (raw.empty())
+        {
+            //to support old format's multilined messages with new lines used to divide paragraphs
+            append_to_last_message(messages, NEW_LINE);
+            continue;
+        }
+
+        std::string line(remove_utf8_bom(raw.c_str()));
+
+        //updated 1.23 plain text log format requires a space added before subsequent lines in a multilined message
+        if (' ' == line[0])
+        {
+            line.erase(0, MULTI_LINE_PREFIX.length());
+            append_to_last_message(messages, '\n' + line);
+        }
+        else
+        {
+            LLSD item;
+            if (!LLChatLogParser::parse(line, item, load_params))
+            {
+                item[LL_IM_TEXT] = line;
+            }
+            messages.push_back(item);
+        }
+    }
+}
+
 class LLLogChatTimeScanner: public LLSingleton<LLLogChatTimeScanner>
 {
     LLSINGLETON(LLLogChatTimeScanner);
@@ -359,6 +468,10 @@ void LLLogChat::renameLogFile(const std::string& old_filename, const std::string
     if (!LLFile::isfile(new_name) && LLFile::isfile(old_name))
     {
         LLFile::rename(old_name, new_name);
+
+        // gets indexed again under the new name
+        LLMutexLock lock(&transcript_index_mutex());
+        LLChatTranscriptStore::removeFiles(getTranscriptIndexBase(old_name));
     }
 }
 
@@ -525,70 +638,220 @@ void LLLogChat::loadChatHistory(const std::string& file_name, std::list<LLSD>& m
     }
 
     // If we got here, we managed to stat the file.
-    // Open the file to read
-    LLFILE* fptr = LLFile::fopen(log_file_name, "r");       /*Flawfinder: ignore*/
-    if (!fptr)
+    static LLCachedControl<bool> use_index(gSavedSettings, "ChatTranscriptIndex", true);
+    if (use_index && !load_all_history && loadIndexedHistory(log_file_name, (U64)stat_data.st_size, messages, load_params))
+    {
+        return;
+    }
+
+    // Read the file
+    std::string text;
+    size_t max_bytes;
+    if (!read_transcript_tail(log_file_name, load_all_history, text, max_bytes))
     {   // Ok, this is strange but not really tragic in the big picture of things
         LL_WARNS("ChatHistory") << "Unable to read file " << log_file_name << " after stat was successful" << LL_ENDL;
         return;
     }
 
     auto save_num_messages = messages.size();
+    load_transcript_tail(text, max_bytes, messages, load_params);
 
-    char buffer[LOG_RECALL_SIZE];       /*Flawfinder: ignore*/
-    char *bptr;
-    size_t len;
-    bool firstline = true;
+    LL_DEBUGS("ChatHistory") << "Read " << (messages.size() - save_num_messages)
+        << " messages of chat history from " << log_file_name
+        << " file mod time " << (F64)stat_data.st_mtime << LL_ENDL;
+}
 
-    if (load_all_history || fseek(fptr, (LOG_RECALL_SIZE - 1) * -1  , SEEK_END))
-    {   //We need to load the whole historyFile or it's smaller than recall size, so get it all.
-        firstline = false;
-        if (fseek(fptr, 0, SEEK_SET))
-        {
-            fclose(fptr);
-            return;
-        }
+// static
+bool LLLogChat::loadIndexedHistory(const std::string& log_file_name, U64 file_size, std::list<LLSD>& messages, const LLSD& load_params)
+{
+    // Never wait for an import running in the background, the text file
+    // serves the history meanwhile
+    LLMutexTrylock lock(&transcript_index_mutex());
+    if (!lock.isLocked())
+    {
+        return false;
     }
-    while (fgets(buffer, LOG_RECALL_SIZE, fptr)  && !feof(fptr))
+
+    LLChatTranscriptStore store(getTranscriptIndexBase(log_file_name));
+    if (!store.open())
     {
-        len = strlen(buffer) - 1;       /*Flawfinder: ignore*/
-        // backfill any end of line characters with nulls
-        for (bptr = (buffer + len); (*bptr == '\n' || *bptr == '\r') && bptr>buffer; bptr--)    *bptr='\0';
+        return false;
+    }
 
-        if (firstline)
-        {
-            firstline = false;
-            continue;
-        }
+    // Catching up on a few new messages costs about as much as reading the
+    // tail of the text file, anything bigger, or a transcript that no
+    // longer matches its index, is imported in the background
+    if (!store.matchesSource(log_file_name) || file_size < store.getSourceSize() ||
+        file_size - store.getSourceSize() > LOG_RECALL_SIZE)
+    {
+        queueTranscriptIndexSync(log_file_name);
+        return false;
+    }
 
-        std::string line(remove_utf8_bom(buffer));
+    std::vector<std::string> texts;
+    if (!syncTranscriptIndex(log_file_name, store) || !store.getLast(U32_MAX, LOG_RECALL_SIZE, texts))
+    {
+        return false;
+    }
+    for (const std::string& text : texts)
+    {
+        parseTranscriptMessage(text, messages, load_params);
+    }
+    LL_DEBUGS("ChatHistory") << "Read " << texts.size() << " messages of chat history from index of "
+                             << log_file_name << LL_ENDL;
+    return true;
+}
 
-        //updated 1.23 plain text log format requires a space added before subsequent lines in a multilined message
-        if (' ' == line[0])
+// static
+void LLLogChat::queueTranscriptIndexSync(const std::string& log_file_name)
+{
+    // transcripts with an import queued or running
+    static LLMutex pending_mutex;
+    static std::set<std::string> pending;
+    {
+        LLMutexLock lock(&pending_mutex);
+        if (!pending.insert(log_file_name).second)
         {
-            line.erase(0, MULTI_LINE_PREFIX.length());
-            append_to_last_message(messages, '\n' + line);
+            return;
         }
-        else if (0 == len && ('\n' == line[0] || '\r' == line[0]))
+    }
+
+    bool posted = LL::WorkQueue::postMaybe(LL::WorkQueue::getInstance("General"),
+        [log_file_name]() // Work done on general queue
         {
-            //to support old format's multilined messages with new lines used to divide paragraphs
-            append_to_last_message(messages, line);
-        }
-        else
+            {
+                LLMutexLock lock(&transcript_index_mutex());
+                LLChatTranscriptStore store(getTranscriptIndexBase(log_file_name));
+                if (store.open())
+                {
+                    syncTranscriptIndex(log_file_name, store);
+                }
+            }
+            LLMutexLock lock(&pending_mutex);
+            pending.erase(log_file_name);
+        });
+    if (!posted)
+    {
+        LLMutexLock lock(&pending_mutex);
+        pending.erase(log_file_name);
+    }
+}
+
+// static
+std::string LLLogChat::getTranscriptIndexBase(const std::string& log_file_name)
+{
+    std::string dir = gDirUtilp->add(gDirUtilp->getDirName(log_file_name), "transcript_index");
+    LLFile::mkdir(dir);
+    return gDirUtilp->add(dir, gDirUtilp->getBaseFileName(log_file_name, true));
+}
+
+// static
+bool LLLogChat::syncTranscriptIndex(const std::string& log_file_name, LLChatTranscriptStore& store)
+{
+    llstat stat_data;
+    if (LLFile::stat(log_file_name, &stat_data))
+    {
+        return false;
+    }
+    const U64 file_size = (U64)stat_data.st_size;
+    if (!store.matchesSource(log_file_name))
+    {
+        // transcript was replaced, edited or cut down, start over
+        store.clear();
+    }
+    if (file_size == store.getSourceSize())
+    {
+        return true;
+    }
+
+    llifstream file(log_file_name.c_str(), std::ios::binary);
+    if (!file.is_open() || !file.seekg(store.getSourceSize()))
+    {
+        return false;
+    }
+
+    // Same line rules as loadChatHistory(): lines starting with a space
+    // continue the previous message, empty lines add a paragraph break.
+    // Saves write whole messages, so only complete lines are consumed and
+    // the last message of the file is final.
+    U64 consumed = store.getSourceSize();
+    const U64 first_size = store.size();
+    std::string pending;
+    S64 pending_time = 0;
+    bool have_pending = false;
+    bool ok = true;
+    std::string carry;
+    std::vector<char> buffer(1024 * 1024);
+    while (ok && (file.read(buffer.data(), buffer.size()) || file.gcount() > 0))
+    {
+        carry.append(buffer.data(), (size_t)file.gcount());
+        size_t start = 0;
+        size_t eol;
+        while (ok && (eol = carry.find('\n', start)) != std::string::npos)
         {
-            LLSD item;
-            if (!LLChatLogParser::parse(line, item, load_params))
+            size_t end = eol;
+            if (end > start && carry[end - 1] == '\r')
             {
-                item[LL_IM_TEXT] = line;
+                --end;
+            }
+            std::string line(remove_utf8_bom(carry.substr(start, end - start).c_str()));
+            consumed += eol + 1 - start;
+            start = eol + 1;
+
+            if (line.empty())
+            {
+                if (have_pending)
+                {
+                    pending += '\n';
+                }
+            }
+            else if (' ' == line[0])
+            {
+                if (have_pending)
+                {
+                    pending += '\n';
+                    pending.append(line, MULTI_LINE_PREFIX.length(), std::string::npos);
+                }
+            }
+            else
+            {
+                ok = !have_pending || store.append(pending_time, pending);
+                pending = line;
+                pending_time = parse_log_time(line);
+                have_pending = true;
             }
-            messages.push_back(item);
         }
+        carry.erase(0, start);
     }
-    fclose(fptr);
+    ok = ok && (!have_pending || store.append(pending_time, pending));
 
-    LL_DEBUGS("ChatHistory") << "Read " << (messages.size() - save_num_messages)
-        << " messages of chat history from " << log_file_name
-        << " file mod time " << (F64)stat_data.st_mtime << LL_ENDL;
+    if (!ok)
+    {
+        // a partial import cannot be resumed, rebuild next time
+        store.clear();
+        return false;
+    }
+    store.setSource(log_file_name, consumed);
+    LL_DEBUGS("ChatHistory") << "Indexed " << (store.size() - first_size) << " messages of " << log_file_name << LL_ENDL;
+    return store.flush();
+}
+
+// static
+void LLLogChat::parseTranscriptMessage(const std::string& text, std::list<LLSD>& messages, const LLSD& load_params)
+{
+    // first line carries timestamp and sender, the rest is appended as is
+    size_t eol = text.find('\n');
+    std::string line = text.substr(0, eol);
+    LLSD item;
+    if (!LLChatLogParser::parse(line, item, load_params))
+    {
+        item[LL_IM_TEXT] = line;
+    }
+    messages.push_back(item);
+    if (eol != std::string::npos)
+    {
+        append_to_last_message(messages, text.substr(eol));
+    }
 }
 
 bool LLLogChat::historyThreadsFinished(LLUUID session_id)
@@ -912,6 +1175,12 @@ void LLLogChat::deleteTranscripts()
         }
     }
 
+    {
+        LLMutexLock lock(&transcript_index_mutex());
+        gDirUtilp->deleteFilesInDir(gDirUtilp->add(gDirUtilp->getExpandedFilename(LL_PATH_PER_ACCOUNT_CHAT_LOGS, ""),
+                                                   "transcript_index"), "*");
+    }
+
     // <FS:CR> FIRE-11734 - Flush out the current histories from any open chat window
     //LLFloaterIMSessionTab::processChatHistoryStyleUpdate(true);
     FSFloaterIM::clearAllOpenHistories();
@@ -1075,33 +1344,18 @@ bool LLChatLogParser::parse(std::string& raw, LLSD& im, const LLSD& parse_params
     im = LLSD::emptyMap();
 
     //matching a timestamp
-    boost::match_results<std::string::const_iterator> matches;
     // <FS:Ansariel> Seconds in timestamps
-    // Logic here: First try to get a full match for timestamps with seconds. If we fail,
-    // this means we either have a timestamp without seconds or no timestamp at all.
-    // So we use the original regex for timestamps without seconds to find out what
-    // case it is. For this to work, the timestamp part in the TIMESTAMP_AND_STUFF_SEC
-    // regex is NOT optional!
-    //if (!ll_regex_match(raw, matches, TIMESTAMP_AND_STUFF)) return false;
+    // The scanner tries timestamps with seconds first, then without, and
+    // tells which one it found.
+    std::string timestamp;
+    std::string stuff;
     bool has_sec = false;
-    if (ll_regex_match(raw, matches, TIMESTAMP_AND_STUFF_SEC))
-    {
-        has_sec = true;
-    }
-    else
-    {
-        if (!ll_regex_match(raw, matches, TIMESTAMP_AND_STUFF))
-        {
-            return false;
-        }
-    }
+    bool has_timestamp = LLChatLogScanner::splitTimestamp(raw, timestamp, stuff, has_sec);
     // </FS:Ansariel>
 
-    bool has_timestamp = matches[IDX_TIMESTAMP].matched;
     if (has_timestamp)
     {
         //timestamp was successfully parsed
-        std::string timestamp = matches[IDX_TIMESTAMP];
         boost::trim(timestamp);
         timestamp.erase(0, 1);
         timestamp.erase(timestamp.length()-1, 1);
@@ -1131,19 +1385,11 @@ bool LLChatLogParser::parse(std::string& raw, LLSD& im, const LLSD& parse_params
         im[LL_IM_TIME] = "";
     }
 
-    bool has_stuff = matches[IDX_STUFF].matched;
-    if (!has_stuff)
-    {
-        return false;  //*TODO should return false or not?
-    }
-
     //matching a name and a text
-    std::string stuff = matches[IDX_STUFF];
-    boost::match_results<std::string::const_iterator> name_and_text;
-    if (!ll_regex_match(stuff, name_and_text, NAME_AND_TEXT)) return false;
-
-    bool has_name = name_and_text[IDX_NAME].matched;
-    std::string name = LLURI::unescape(name_and_text[IDX_NAME]);
+    std::string name;
+    std::string text;
+    bool has_name = LLChatLogScanner::splitName(stuff, name, text);
+    name = LLURI::unescape(name);
 
     // <FS:Ansariel> Handle the case an IM was stored in nearby chat history
     if (name == "IM:")
@@ -1190,9 +1436,6 @@ bool LLChatLogParser::parse(std::string& raw, LLSD& im, const LLSD& parse_params
         return true; //parse as a message from Second Life
     }
 
-    bool has_text = name_and_text[IDX_TEXT].matched;
-    if (!has_text) return false;
-
     //for parsing logs created in very old versions of a viewer
     if (name == "You")
     {
@@ -1206,7 +1449,7 @@ bool LLChatLogParser::parse(std::string& raw, LLSD& im, const LLSD& parse_params
         im[LL_IM_FROM] = name;
     }
 
-    im[LL_IM_TEXT] = name_and_text[IDX_TEXT];
+    im[LL_IM_TEXT] = text;
     return true;  //parsed name and message text, maybe have a timestamp too
 }
 
@@ -1301,9 +1544,10 @@ void LLLoadHistoryThread::loadHistory(const std::string& file_name, std::list<LL
     }
 
     bool load_all_history = load_params.has("load_all_history") ? load_params["load_all_history"].asBoolean() : false;
-    LLFILE* fptr = LLFile::fopen(LLLogChat::makeLogFileName(file_name), "r");/*Flawfinder: ignore*/
-
-    if (!fptr)
+    std::string text;
+    size_t max_bytes;
+    bool found = read_transcript_tail(LLLogChat::makeLogFileName(file_name), load_all_history, text, max_bytes);
+    if (!found)
     {
         bool is_group = load_params.has("is_group") ? load_params["is_group"].asBoolean() : false;
         if (is_group)
@@ -1316,18 +1560,15 @@ void LLLoadHistoryThread::loadHistory(const std::string& file_name, std::list<LL
                 old_name.erase(old_name.size() - GROUP_CHAT_SUFFIX.size());
             }
             // </FS:Ansariel>
-            fptr = LLFile::fopen(LLLogChat::makeLogFileName(old_name), "r");
-            if (fptr)
+            if (LLFile::isfile(LLLogChat::makeLogFileName(old_name)))
             {
-                fclose(fptr);
                 LLFile::copy(LLLogChat::makeLogFileName(old_name), LLLogChat::makeLogFileName(file_name));
             }
-            fptr = LLFile::fopen(LLLogChat::makeLogFileName(file_name), "r");
+            found = read_transcript_tail(LLLogChat::makeLogFileName(file_name), load_all_history, text, max_bytes);
         }
-        if (!fptr)
+        if (!found)
         {
-            fptr = LLFile::fopen(LLLogChat::oldLogFileName(file_name), "r");/*Flawfinder: ignore*/
-            if (!fptr)
+            if (!read_transcript_tail(LLLogChat::oldLogFileName(file_name), load_all_history, text, max_bytes))
             {
                 mNewLoad = false;
                 (*mLoadEndSignal)(messages, file_name);
@@ -1336,62 +1577,8 @@ void LLLoadHistoryThread::loadHistory(const std::string& file_name, std::list<LL
         }
     }
 
-    char buffer[LOG_RECALL_SIZE];       /*Flawfinder: ignore*/
-
-    char *bptr;
-    size_t len;
-    bool firstline = true;
-
-    if (load_all_history || fseek(fptr, (LOG_RECALL_SIZE - 1) * -1  , SEEK_END))
-    {   //We need to load the whole historyFile or it's smaller than recall size, so get it all.
-        firstline = false;
-        if (fseek(fptr, 0, SEEK_SET))
-        {
-            fclose(fptr);
-            mNewLoad = false;
-            (*mLoadEndSignal)(messages, file_name);
-            return;
-        }
-    }
-
+    load_transcript_tail(text, max_bytes, *messages, load_params);
 
-    while (fgets(buffer, LOG_RECALL_SIZE, fptr)  && !feof(fptr))
-    {
-        len = strlen(buffer) - 1;       /*Flawfinder: ignore*/
-
-        for (bptr = (buffer + len); (*bptr == '\n' || *bptr == '\r') && bptr>buffer; bptr--)    *bptr='\0';
-
-
-        if (firstline)
-        {
-            firstline = false;
-            continue;
-        }
-        std::string line(remove_utf8_bom(buffer));
-
-        //updated 1.23 plaint text log format requires a space added before subsequent lines in a multilined message
-        if (' ' == line[0])
-        {
-            line.erase(0, MULTI_LINE_PREFIX.length());
-            append_to_last_message(*messages, '\n' + line);
-        }
-        else if (0 == len && ('\n' == line[0] || '\r' == line[0]))
-        {
-            //to support old format's multilined messages with new lines used to divide paragraphs
-            append_to_last_message(*messages, line);
-        }
-        else
-        {
-            LLSD item;
-            if (!LLChatLogParser::parse(line, item, load_params))
-            {
-                item[LL_IM_TEXT] = line;
-            }
-            messages->push_back(item);
-        }
-    }
-
-    fclose(fptr);
     mNewLoad = false;
     (*mLoadEndSignal)(messages, file_name);
 }
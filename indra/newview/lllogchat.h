@@ -29,6 +29,7 @@
 #include "llthread.h"
 
 class LLChat;
+class LLChatTranscriptStore;
 
 class LLActionThread : public LLThread
 {
@@ -137,6 +138,18 @@ public:
 private:
     static std::string cleanFileName(std::string filename);
 
+    // The indexed copy of a transcript lives in a transcript_index folder
+    // next to it. syncTranscriptIndex() imports whatever the text file has
+    // gained since the last call, the whole file the first time or once it
+    // no longer matches the fingerprint kept in the index. Large
+    // imports go through queueTranscriptIndexSync() to the "General" thread
+    // pool; loadIndexedHistory() returns false until they are done.
+    static bool loadIndexedHistory(const std::string& log_file_name, U64 file_size, std::list<LLSD>& messages, const LLSD& load_params);
+    static void queueTranscriptIndexSync(const std::string& log_file_name);
+    static std::string getTranscriptIndexBase(const std::string& log_file_name);
+    static bool syncTranscriptIndex(const std::string& log_file_name, LLChatTranscriptStore& store);
+    static void parseTranscriptMessage(const std::string& text, std::list<LLSD>& messages, const LLSD& load_params);
+
     LLMutex* historyThreadsMutex();
     void triggerHistorySignal();
 
@@ -56,6 +56,7 @@
 #include "llviewermessage.h"
 #include "llviewerobjectlist.h"
 #include "llviewerregion.h"
+#include "llviewerstats.h"
 #include "llviewerstatsrecorder.h"
 #include "llviewertexturelist.h"
 #include "llvolume.h"
@@ -73,6 +74,7 @@
 #include "llfasttimer.h"
 #include "llcorehttputil.h"
 #include "lltrans.h"
+#include "threadpool.h"
 #include "llstatusbar.h"
 #include "llinventorypanel.h"
 #include "lluploaddialog.h"
@@ -256,16 +258,22 @@
 //     sActiveLODRequests       mMutex        rw.any.mMutex, ro.repo.none [1]
 //     sMaxConcurrentRequests   mMutex        wo.main.none, ro.repo.none, ro.main.mMutex
 //     mMeshHeader              mHeaderMutex  rw.repo.mHeaderMutex, ro.main.mHeaderMutex, ro.main.none [0]
-//     mSkinRequests            mMutex        rw.repo.mMutex, ro.repo.none [5]
+//     mInboundQ                none          wo.main.none, ro.repo.none (lock free queue)
+//     mSkinRequests            none          rw.repo.none
 //     mSkinInfoQ               mMutex        rw.repo.mMutex, rw.main.mMutex [5] (was:  [0])
-//     mDecompositionRequests   mMutex        rw.repo.mMutex, ro.repo.none [5]
-//     mPhysicsShapeRequests    mMutex        rw.repo.mMutex, ro.repo.none [5]
+//     mDecompositionRequests   none          rw.repo.none
+//     mPhysicsShapeRequests    none          rw.repo.none
 //     mDecompositionQ          mMutex        rw.repo.mMutex, rw.main.mMutex [5] (was:  [0])
 //     mHeaderReqQ              mMutex        ro.repo.none [5], rw.repo.mMutex, rw.any.mMutex
 //     mLODReqQ                 mMutex        ro.repo.none [5], rw.repo.mMutex, rw.any.mMutex
+//     m*Retries                mMutex        rw.repo.mMutex (LOD, header), rw.repo.none (UUID)
+//     mDeferredLODs            mMutex        rw.repo.mMutex, rw.main.mMutex
+//     mDeferredHeaders         mMutex        rw.repo.mMutex, rw.main.mMutex
+//     mWakePending, mBusy      none          atomic
 //     mUnavailableQ            mMutex        rw.repo.none [0], ro.main.none [5], rw.main.mMutex
 //     mLoadedQ                 mMutex        rw.repo.mMutex, ro.main.none [5], rw.main.mMutex
 //     mPendingLOD              mMutex        rw.repo.mMutex, rw.any.mMutex
+//     mRequestScores           mMutex        rw.main.mMutex, ro.any.mMutex
 //     mGetMeshCapability       mMutex        rw.main.mMutex, ro.repo.mMutex (was:  [0])
 //     mGetMesh2Capability      mMutex        rw.main.mMutex, ro.repo.mMutex (was:  [0])
 //     mGetMeshVersion          mMutex        rw.main.mMutex, ro.repo.mMutex
@@ -293,10 +301,6 @@
 //
 // *TODO:  Work list for followup actions:
 //   * Review anything marked as unsafe above, verify if there are real issues.
-//   * See if we can put ::run() into a hard sleep.  May not actually perform better
-//     than the current scheme so be prepared for disappointment.  You'll likely
-//     need to introduce a condition variable class that references a mutex in
-//     methods rather than derives from mutex which isn't correct.
 //   * On upload failures, make more information available to the alerting
 //     dialog.  Get the structured information going into the log into a
 //     tree there.
@@ -368,6 +372,13 @@ const long LARGE_MESH_XFER_TIMEOUT = 600L;              // Seconds to complete x
 
 const U32 DOWNLOAD_RETRY_LIMIT = 8;
 const F32 DOWNLOAD_RETRY_DELAY = 0.5f; // seconds
+const F64 RETRY_WHEEL_TICK = 0.25;                      // Seconds, retry deadlines are rounded up to this
+const U32 RETRY_WHEEL_SLOTS = 256;                      // One turn of the wheel covers the longest backoff
+const U32 INBOUND_QUEUE_SIZE = 4096;                    // Skin, decomposition and physics requests in flight to the repo thread
+const std::chrono::milliseconds REPO_BUSY_WAIT(20);     // Repo thread poll while HTTP replies or decodes are due
+const std::chrono::milliseconds REPO_IDLE_WAIT(1000);   // Repo thread sleep with nothing to do
+const F32 REQUEST_SCORE_INTERVAL = 0.25f;               // Seconds between fetch queue reprioritizations
+const F32 OFFSCREEN_SCORE_SCALE = 0.01f;                // Score of meshes only wanted by objects out of view
 
 // Would normally like to retry on uploads as some
 // retryable failures would be recoverable.  Unfortunately,
@@ -409,6 +420,10 @@ U32 LLMeshRepository::sCacheBytesDecomps = 0;
 U32 LLMeshRepository::sCacheReads = 0;
 U32 LLMeshRepository::sCacheWrites = 0;
 U32 LLMeshRepository::sMaxLockHoldoffs = 0;
+std::atomic<S32> LLMeshRepository::sLODDecodeQueued(0);
+std::atomic<U32> LLMeshRepository::sLODDecoded(0);
+std::atomic<U64> LLMeshRepository::sLODDecodeMicroseconds(0);
+F32 LLMeshRepository::sLODDecodeRate = 0.f;
 
 LLDeadmanTimer LLMeshRepository::sQuiescentTimer(15.0, false);  // true -> gather cpu metrics
 
@@ -446,6 +461,10 @@ const char * const LOG_MESH = "Mesh";
 // Static data and functions to measure mesh load
 // time metrics for a new region scene.
 static unsigned int metrics_teleport_start_count = 0;
+// Time from login or teleport until no visible object waits for a mesh
+static LLTimer metrics_visible_mesh_timer;
+static bool metrics_visible_mesh_timing = false;
+static bool metrics_visible_mesh_seen = false;
 boost::signals2::connection metrics_teleport_started_signal;
 static void teleport_started();
 
@@ -558,6 +577,11 @@ bool RequestStats::isDelayed() const
     return mTimer.getStarted() && !mTimer.hasExpired();
 }
 
+F32 RequestStats::getTimeToRetry() const
+{
+    return isDelayed() ? mTimer.getTimeToExpireF32() : 0.f;
+}
+
 LLViewerFetchedTexture* LLMeshUploadThread::FindViewerTexture(const LLImportMaterial& material)
 {
     LLPointer< LLViewerFetchedTexture > * ppTex = static_cast< LLPointer< LLViewerFetchedTexture > * >(material.mOpaqueData);
@@ -852,6 +876,12 @@ void log_upload_error(LLCore::HttpStatus status, const LLSD& content,
 
 LLMeshRepoThread::LLMeshRepoThread()
 : LLThread("mesh repo"),
+  mInboundQ(INBOUND_QUEUE_SIZE),
+  mHeaderReqQ(mRequestScores),
+  mLODReqQ(mRequestScores),
+  mLODRetries(RETRY_WHEEL_TICK, RETRY_WHEEL_SLOTS),
+  mHeaderRetries(RETRY_WHEEL_TICK, RETRY_WHEEL_SLOTS),
+  mUUIDRetries(RETRY_WHEEL_TICK, RETRY_WHEEL_SLOTS),
   mHttpRequest(NULL),
   mHttpOptions(),
   mHttpLargeOptions(),
@@ -862,7 +892,10 @@ LLMeshRepoThread::LLMeshRepoThread()
   mHttpLargePolicyClass(LLCore::HttpRequest::DEFAULT_POLICY_ID),
   mLegacyGetMeshVersion(0),
   // <FS:Ansariel> [UDP Assets]
-  mWorkQueue("MeshRepoThread", 1024*1024)
+  mWorkQueue("MeshRepoThread", 1024*1024),
+  mDecodesInFlight(0),
+  mWakePending(false),
+  mBusy(false)
 {
     LLAppCoreHttp & app_core_http(LLAppViewer::instance()->getAppCoreHttp());
 
@@ -881,6 +914,12 @@ LLMeshRepoThread::LLMeshRepoThread()
     mHttpPolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_MESH2);
     mHttpLegacyPolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_MESH1); // <FS:Ansariel> [UDP Assets]
     mHttpLargePolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_LARGE_MESH);
+
+    // Decoding is CPU bound, use a share of the cores that leaves room
+    // for image decode and the render thread.
+    S32 decode_threads = llclamp((S32)std::thread::hardware_concurrency() / 4, 1, 4);
+    mDecodePool.reset(new LL::ThreadPool("MeshDecode", decode_threads));
+    mDecodePool->start();
 }
 
 
@@ -891,6 +930,13 @@ LLMeshRepoThread::~LLMeshRepoThread()
                        << ", Max Lock Holdoffs:  " << LLMeshRepository::sMaxLockHoldoffs
                        << LL_ENDL;
 
+    // Finish decodes in flight before the queues and mutexes they use go away
+    if (mDecodePool)
+    {
+        mDecodePool->close();
+        mDecodePool.reset();
+    }
+
     mHttpRequestSet.clear();
     mHttpHeaders.reset();
 
@@ -926,20 +972,21 @@ void LLMeshRepoThread::run()
 
     while (!LLApp::isExiting())
     {
-        // *TODO:  Revise sleep/wake strategy and try to move away
-        // from polling operations in this thread.  We can sleep
-        // this thread hard when:
-        // * All Http requests are serviced
-        // * LOD request queue empty
-        // * Header request queue empty
-        // * Skin info request queue empty
-        // * Decomposition request queue empty
-        // * Physics shape request queue empty
-        // We wake the thread when any of the above become untrue.
-        // Will likely need a correctly-implemented condition variable to do this.
-        // On the other hand, this may actually be an effective and efficient scheme...
-
-        mSignal->wait();
+        // Sleep until woken by new requests or, while there are HTTP
+        // replies and decodes to collect, the main thread's per frame
+        // wake-up.  The timeouts cover retries coming due and a main
+        // thread that stalls.
+        std::chrono::milliseconds timeout = REPO_IDLE_WAIT;
+        if (mBusy)
+        {
+            timeout = REPO_BUSY_WAIT;
+        }
+        else if (!mLODRetries.empty() || !mHeaderRetries.empty() || !mUUIDRetries.empty())
+        {
+            timeout = std::chrono::milliseconds((S64)(RETRY_WHEEL_TICK * 1000.0));
+        }
+        mSignal->waitFor(timeout, [this]() { return mWakePending || LLApp::isExiting(); });
+        mWakePending = false;
 
         if (LLApp::isExiting())
         {
@@ -957,266 +1004,319 @@ void LLMeshRepoThread::run()
         }
         sRequestWaterLevel = static_cast<S32>(mHttpRequestSet.size());            // Stats data update
 
+        sortInboundRequests();
+        requeueDueRetries();
+
         // NOTE: order of queue processing intentionally favors LOD requests over header requests
-        // Todo: we are processing mLODReqQ, mHeaderReqQ, mSkinRequests, mDecompositionRequests and mPhysicsShapeRequests
-        // in relatively similar manners, remake code to simplify/unify the process,
-        // like processRequests(&requestQ, fetchFunction); which does same thing for each element
+        processLODRequests();
+        processHeaderRequests();
+        processUUIDRequests();
+
+        // For dev purposes only.  A dynamic change could make this false
+        // and that shouldn't assert.
+        // llassert_always(mHttpRequestSet.size() <= sRequestHighWater);
 
-        if (!mLODReqQ.empty() && mHttpRequestSet.size() < sRequestHighWater)
+        mBusy = !mHttpRequestSet.empty() || mDecodesInFlight > 0;
+    }
+
+    if (mSignal->isLocked())
+    { //make sure to let go of the mutex associated with the given signal before shutting down
+        mSignal->unlock();
+    }
+
+    res = LLConvexDecomposition::quitThread();
+    if (res != LLCD_OK && LLConvexDecomposition::isFunctional())
+    {
+        LL_WARNS(LOG_MESH) << "Convex decomposition unable to be quit." << LL_ENDL;
+    }
+}
+
+void LLMeshRepoThread::wake()
+{
+    if (!mWakePending.exchange(true))
+    {
+        // taking the lock orders the flag before the thread's check of
+        // it, the thread is either about to see it or already waiting
+        mSignal->lock();
+        mSignal->unlock();
+        mSignal->signal();
+    }
+}
+
+size_t LLMeshRepoThread::freeRequestSlots() const
+{
+    return mHttpRequestSet.size() < (size_t)sRequestHighWater ? sRequestHighWater - mHttpRequestSet.size() : 0;
+}
+
+bool LLMeshRepoThread::pushInbound(const LLUUID& mesh_id, InboundRequest::EKind kind)
+{
+    InboundRequest req;
+    req.mId = mesh_id;
+    req.mKind = kind;
+    if (!mInboundQ.tryPush(req))
+    {
+        return false;
+    }
+    wake();
+    return true;
+}
+
+bool LLMeshRepoThread::loadMeshSkinInfo(const LLUUID& mesh_id)
+{
+    return pushInbound(mesh_id, InboundRequest::SKIN_INFO);
+}
+
+bool LLMeshRepoThread::loadMeshDecomposition(const LLUUID& mesh_id)
+{
+    return pushInbound(mesh_id, InboundRequest::DECOMPOSITION);
+}
+
+bool LLMeshRepoThread::loadMeshPhysicsShape(const LLUUID& mesh_id)
+{
+    return pushInbound(mesh_id, InboundRequest::PHYSICS_SHAPE);
+}
+
+void LLMeshRepoThread::sortInboundRequests()
+{
+    InboundRequest req;
+    while (mInboundQ.tryPop(req))
+    {
+        switch (req.mKind)
         {
-            std::list<LODRequest> incomplete;
-            while (!mLODReqQ.empty() && mHttpRequestSet.size() < sRequestHighWater)
-            {
-                if (!mMutex)
-                {
-                    break;
-                }
+        case InboundRequest::SKIN_INFO:
+            mSkinRequests.push_back(UUIDBasedRequest(req.mId));
+            break;
+        case InboundRequest::DECOMPOSITION:
+            mDecompositionRequests.insert(UUIDBasedRequest(req.mId));
+            break;
+        case InboundRequest::PHYSICS_SHAPE:
+            mPhysicsShapeRequests.insert(UUIDBasedRequest(req.mId));
+            break;
+        }
+    }
+}
 
-                mMutex->lock();
-                LODRequest req = mLODReqQ.front();
-                mLODReqQ.pop();
-                LLMeshRepository::sLODProcessing--;
-                mMutex->unlock();
-                if (req.isDelayed())
+void LLMeshRepoThread::requeueDueRetries()
+{
+    const F64 now = LLTimer::getTotalSeconds();
+
+    if (!mLODRetries.empty() || !mHeaderRetries.empty())
+    {
+        LLMutexLock lock(mMutex);
+        mLODRetries.advance(now, [this](LODRequest&& req)
+            {
+                // still counted in sLODProcessing while waiting
+                auto deferred = mDeferredLODs.find(std::make_pair(req.mMeshParams.getSculptID(), req.mLOD));
+                if (deferred != mDeferredLODs.end())
                 {
-                    // failed to load before, wait a bit
-                    incomplete.push_front(req);
+                    mDeferredLODs.erase(deferred);
+                    mLODReqQ.push(req);
                 }
-                else if (!fetchMeshLOD(req.mMeshParams, req.mLOD, req.canRetry()))
+            });
+        mHeaderRetries.advance(now, [this](HeaderRequest&& req)
+            {
+                auto deferred = mDeferredHeaders.find(req.mMeshParams.getSculptID());
+                if (deferred != mDeferredHeaders.end())
                 {
-                    if (req.canRetry())
-                    {
-                        // failed, resubmit
-                        req.updateTime();
-                        incomplete.push_front(req);
-                    }
-                    else
-                    {
-                        // too many fails
-                        LLMutexLock lock(mMutex);
-                        mUnavailableQ.push_back(req);
-                        LL_WARNS() << "Failed to load " << req.mMeshParams << " , skip" << LL_ENDL;
-                    }
+                    mDeferredHeaders.erase(deferred);
+                    mHeaderReqQ.push(req);
                 }
-            }
+            });
+    }
 
-            if (!incomplete.empty())
+    mUUIDRetries.advance(now, [this](UUIDRetry&& retry)
+        {
+            switch (retry.mKind)
             {
-                LLMutexLock locker(mMutex);
-                for (std::list<LODRequest>::iterator iter = incomplete.begin(); iter != incomplete.end(); iter++)
-                {
-                    mLODReqQ.push(*iter);
-                    ++LLMeshRepository::sLODProcessing;
-                }
+            case InboundRequest::SKIN_INFO:
+                mSkinRequests.push_back(retry.mRequest);
+                break;
+            case InboundRequest::DECOMPOSITION:
+                mDecompositionRequests.insert(retry.mRequest);
+                break;
+            case InboundRequest::PHYSICS_SHAPE:
+                mPhysicsShapeRequests.insert(retry.mRequest);
+                break;
             }
+        });
+}
+
+void LLMeshRepoThread::processLODRequests()
+{
+    // [5] empty() is checked again under the lock
+    std::vector<LODRequest> batch;
+    while (!mLODReqQ.empty())
+    {
+        const size_t slots = freeRequestSlots();
+        if (!slots)
+        {
+            break;
         }
 
-        if (!mHeaderReqQ.empty() && mHttpRequestSet.size() < sRequestHighWater)
         {
-            std::list<HeaderRequest> incomplete;
-            while (!mHeaderReqQ.empty() && mHttpRequestSet.size() < sRequestHighWater)
+            // one lock per batch rather than per request, the main thread
+            // takes it every frame
+            LLMutexLock lock(mMutex);
+            while (batch.size() < slots && !mLODReqQ.empty())
             {
-                if (!mMutex)
-                {
-                    break;
-                }
-
-                mMutex->lock();
-                HeaderRequest req = mHeaderReqQ.front();
-                mHeaderReqQ.pop();
-                mMutex->unlock();
-                if (req.isDelayed())
-                {
-                    // failed to load before, wait a bit
-                    incomplete.push_front(req);
-                }
-                else if (!fetchMeshHeader(req.mMeshParams, req.canRetry()))
-                {
-                    if (req.canRetry())
-                    {
-                        //failed, resubmit
-                        req.updateTime();
-                        incomplete.push_front(req);
-                    }
-                    else
-                    {
-                        LL_DEBUGS() << "mHeaderReqQ failed: " << req.mMeshParams << LL_ENDL;
-                    }
-                }
+                batch.push_back(mLODReqQ.top());
+                mLODReqQ.pop();
             }
+        }
+        if (batch.empty())
+        {
+            break;
+        }
 
-            if (!incomplete.empty())
+        for (LODRequest& req : batch)
+        {
+            if (req.isDelayed())
             {
-                LLMutexLock locker(mMutex);
-                for (std::list<HeaderRequest>::iterator iter = incomplete.begin(); iter != incomplete.end(); iter++)
-                {
-                    mHeaderReqQ.push(*iter);
-                }
+                // failed to load before, wait a bit
+                LLMutexLock lock(mMutex);
+                mDeferredLODs.insert(std::make_pair(req.mMeshParams.getSculptID(), req.mLOD));
+                mLODRetries.schedule(LLTimer::getTotalSeconds() + req.getTimeToRetry(), req);
+            }
+            else if (fetchMeshLOD(req.mMeshParams, req.mLOD, req.canRetry()))
+            {
+                LLMutexLock lock(mMutex);
+                LLMeshRepository::sLODProcessing--;
+            }
+            else if (req.canRetry())
+            {
+                // failed, resubmit once the backoff passes
+                req.updateTime();
+                LLMutexLock lock(mMutex);
+                mDeferredLODs.insert(std::make_pair(req.mMeshParams.getSculptID(), req.mLOD));
+                mLODRetries.schedule(LLTimer::getTotalSeconds() + req.getTimeToRetry(), req);
+            }
+            else
+            {
+                // too many fails
+                LLMutexLock lock(mMutex);
+                LLMeshRepository::sLODProcessing--;
+                mUnavailableQ.push_back(req);
+                LL_WARNS() << "Failed to load " << req.mMeshParams << " , skip" << LL_ENDL;
             }
         }
+        batch.clear();
+    }
+}
 
-        // For the final three request lists, similar goal to above but
-        // slightly different queue structures.  Stay off the mutex when
-        // performing long-duration actions.
-
-        if (mHttpRequestSet.size() < sRequestHighWater
-            && (!mSkinRequests.empty()
-            || !mDecompositionRequests.empty()
-            || !mPhysicsShapeRequests.empty()))
+void LLMeshRepoThread::processHeaderRequests()
+{
+    std::vector<HeaderRequest> batch;
+    while (!mHeaderReqQ.empty())
+    {
+        const size_t slots = freeRequestSlots();
+        if (!slots)
         {
-            // Something to do probably, lock and double-check.  We don't want
-            // to hold the lock long here.  That will stall main thread activities
-            // so we bounce it.
+            break;
+        }
 
-            if (!mSkinRequests.empty())
+        {
+            LLMutexLock lock(mMutex);
+            while (batch.size() < slots && !mHeaderReqQ.empty())
             {
-                std::list<UUIDBasedRequest> incomplete;
-                while (!mSkinRequests.empty() && mHttpRequestSet.size() < sRequestHighWater)
-                {
-
-                    mMutex->lock();
-                    auto req = mSkinRequests.front();
-                    mSkinRequests.pop_front();
-                    mMutex->unlock();
-                    if (req.isDelayed())
-                    {
-                        incomplete.emplace_back(req);
-                    }
-                    else if (!fetchMeshSkinInfo(req.mId, req.canRetry()))
-                    {
-                        if (req.canRetry())
-                        {
-                            req.updateTime();
-                            incomplete.emplace_back(req);
-                        }
-                        else
-                        {
-                            LLMutexLock locker(mMutex);
-                            mSkinUnavailableQ.push_back(req);
-                            LL_DEBUGS() << "mSkinReqQ failed: " << req.mId << LL_ENDL;
-                        }
-                    }
-                }
-
-                if (!incomplete.empty())
-                {
-                    LLMutexLock locker(mMutex);
-                    for (const auto& req : incomplete)
-                    {
-                        mSkinRequests.push_back(req);
-                    }
-                }
+                batch.push_back(mHeaderReqQ.top());
+                mHeaderReqQ.pop();
             }
+        }
+        if (batch.empty())
+        {
+            break;
+        }
 
-            // holding lock, try next list
-            // *TODO:  For UI/debug-oriented lists, we might drop the fine-
-            // grained locking as there's a lowered expectation of smoothness
-            // in these cases.
-            if (!mDecompositionRequests.empty())
+        for (HeaderRequest& req : batch)
+        {
+            bool defer = req.isDelayed();
+            if (!defer && !fetchMeshHeader(req.mMeshParams, req.canRetry()))
             {
-                std::set<UUIDBasedRequest> incomplete;
-                while (!mDecompositionRequests.empty() && mHttpRequestSet.size() < sRequestHighWater)
+                if (req.canRetry())
                 {
-                    mMutex->lock();
-                    std::set<UUIDBasedRequest>::iterator iter = mDecompositionRequests.begin();
-                    UUIDBasedRequest req = *iter;
-                    mDecompositionRequests.erase(iter);
-                    mMutex->unlock();
-                    if (req.isDelayed())
-                    {
-                        incomplete.insert(req);
-                    }
-                    else if (!fetchMeshDecomposition(req.mId))
-                    {
-                        if (req.canRetry())
-                        {
-                            req.updateTime();
-                            incomplete.insert(req);
-                        }
-                        else
-                        {
-                            LL_DEBUGS() << "mDecompositionRequests failed: " << req.mId << LL_ENDL;
-                        }
-                    }
+                    //failed, resubmit once the backoff passes
+                    req.updateTime();
+                    defer = true;
                 }
-
-                if (!incomplete.empty())
+                else
                 {
-                    LLMutexLock locker(mMutex);
-                    mDecompositionRequests.insert(incomplete.begin(), incomplete.end());
+                    LL_DEBUGS() << "mHeaderReqQ failed: " << req.mMeshParams << LL_ENDL;
                 }
             }
 
-            // holding lock, final list
-            if (!mPhysicsShapeRequests.empty())
+            if (defer)
             {
-                std::set<UUIDBasedRequest> incomplete;
-                while (!mPhysicsShapeRequests.empty() && mHttpRequestSet.size() < sRequestHighWater)
-                {
-                    mMutex->lock();
-                    std::set<UUIDBasedRequest>::iterator iter = mPhysicsShapeRequests.begin();
-                    UUIDBasedRequest req = *iter;
-                    mPhysicsShapeRequests.erase(iter);
-                    mMutex->unlock();
-                    if (req.isDelayed())
-                    {
-                        incomplete.insert(req);
-                    }
-                    else if (!fetchMeshPhysicsShape(req.mId))
-                    {
-                        if (req.canRetry())
-                        {
-                            req.updateTime();
-                            incomplete.insert(req);
-                        }
-                        else
-                        {
-                            LL_DEBUGS() << "mPhysicsShapeRequests failed: " << req.mId << LL_ENDL;
-                        }
-                    }
-                }
-
-                if (!incomplete.empty())
-                {
-                    LLMutexLock locker(mMutex);
-                    mPhysicsShapeRequests.insert(incomplete.begin(), incomplete.end());
-                }
+                LLMutexLock lock(mMutex);
+                mDeferredHeaders.insert(req.mMeshParams.getSculptID());
+                mHeaderRetries.schedule(LLTimer::getTotalSeconds() + req.getTimeToRetry(), req);
             }
         }
-
-        // For dev purposes only.  A dynamic change could make this false
-        // and that shouldn't assert.
-        // llassert_always(mHttpRequestSet.size() <= sRequestHighWater);
+        batch.clear();
     }
+}
 
-    if (mSignal->isLocked())
-    { //make sure to let go of the mutex associated with the given signal before shutting down
-        mSignal->unlock();
-    }
+void LLMeshRepoThread::processUUIDRequests()
+{
+    // These lists belong to this thread, the main thread's requests come
+    // in through mInboundQ.  Skin info first, then the UI/debug oriented
+    // decomposition and physics shape requests.
+    auto retry_later = [this](InboundRequest::EKind kind, UUIDBasedRequest& req)
+    {
+        if (!req.canRetry())
+        {
+            return false;
+        }
+        req.updateTime();
+        mUUIDRetries.schedule(LLTimer::getTotalSeconds() + req.getTimeToRetry(), UUIDRetry{ kind, req });
+        return true;
+    };
 
-    res = LLConvexDecomposition::quitThread();
-    if (res != LLCD_OK && LLConvexDecomposition::isFunctional())
+    while (!mSkinRequests.empty() && freeRequestSlots())
     {
-        LL_WARNS(LOG_MESH) << "Convex decomposition unable to be quit." << LL_ENDL;
+        UUIDBasedRequest req = mSkinRequests.front();
+        mSkinRequests.pop_front();
+        if (req.isDelayed())
+        {
+            mUUIDRetries.schedule(LLTimer::getTotalSeconds() + req.getTimeToRetry(),
+                                  UUIDRetry{ InboundRequest::SKIN_INFO, req });
+        }
+        else if (!fetchMeshSkinInfo(req.mId, req.canRetry()) && !retry_later(InboundRequest::SKIN_INFO, req))
+        {
+            LLMutexLock locker(mMutex);
+            mSkinUnavailableQ.push_back(req);
+            LL_DEBUGS() << "mSkinReqQ failed: " << req.mId << LL_ENDL;
+        }
     }
-}
-
-// Mutex:  LLMeshRepoThread::mMutex must be held on entry
-void LLMeshRepoThread::loadMeshSkinInfo(const LLUUID& mesh_id)
-{
-    mSkinRequests.push_back(UUIDBasedRequest(mesh_id));
-}
 
-// Mutex:  LLMeshRepoThread::mMutex must be held on entry
-void LLMeshRepoThread::loadMeshDecomposition(const LLUUID& mesh_id)
-{
-    mDecompositionRequests.insert(UUIDBasedRequest(mesh_id));
-}
+    while (!mDecompositionRequests.empty() && freeRequestSlots())
+    {
+        UUIDBasedRequest req = *mDecompositionRequests.begin();
+        mDecompositionRequests.erase(mDecompositionRequests.begin());
+        if (req.isDelayed())
+        {
+            mUUIDRetries.schedule(LLTimer::getTotalSeconds() + req.getTimeToRetry(),
+                                  UUIDRetry{ InboundRequest::DECOMPOSITION, req });
+        }
+        else if (!fetchMeshDecomposition(req.mId) && !retry_later(InboundRequest::DECOMPOSITION, req))
+        {
+            LL_DEBUGS() << "mDecompositionRequests failed: " << req.mId << LL_ENDL;
+        }
+    }
 
-// Mutex:  LLMeshRepoThread::mMutex must be held on entry
-void LLMeshRepoThread::loadMeshPhysicsShape(const LLUUID& mesh_id)
-{
-    mPhysicsShapeRequests.insert(UUIDBasedRequest(mesh_id));
+    while (!mPhysicsShapeRequests.empty() && freeRequestSlots())
+    {
+        UUIDBasedRequest req = *mPhysicsShapeRequests.begin();
+        mPhysicsShapeRequests.erase(mPhysicsShapeRequests.begin());
+        if (req.isDelayed())
+        {
+            mUUIDRetries.schedule(LLTimer::getTotalSeconds() + req.getTimeToRetry(),
+                                  UUIDRetry{ InboundRequest::PHYSICS_SHAPE, req });
+        }
+        else if (!fetchMeshPhysicsShape(req.mId) && !retry_later(InboundRequest::PHYSICS_SHAPE, req))
+        {
+            LL_DEBUGS() << "mPhysicsShapeRequests failed: " << req.mId << LL_ENDL;
+        }
+    }
 }
 
 void LLMeshRepoThread::lockAndLoadMeshLOD(const LLVolumeParams& mesh_params, S32 lod)
@@ -1259,6 +1359,43 @@ void LLMeshRepoThread::loadMeshLOD(const LLVolumeParams& mesh_params, S32 lod)
             mPendingLOD[mesh_id].push_back(lod);
         }
     }
+    wake();
+}
+
+// Mutex:  must be holding mMutex when called
+void LLMeshRepoThread::updateRequestScores(request_score_map& scores)
+{
+    mRequestScores.swap(scores);
+    mLODReqQ.rescore();
+    mHeaderReqQ.rescore();
+}
+
+// Mutex:  must be holding mMutex when called
+void LLMeshRepoThread::cancelMeshLOD(const LLUUID& mesh_id, S32 lod)
+{
+    size_t removed = mLODReqQ.removeIf([&](const LODRequest& req)
+        {
+            return req.mLOD == lod && req.mMeshParams.getSculptID() == mesh_id;
+        });
+    // a retry waiting out its backoff is dropped when it comes due
+    removed += mDeferredLODs.erase(std::make_pair(mesh_id, lod));
+    LLMeshRepository::sLODProcessing -= (U32)removed;
+
+    pending_lod_map::iterator pending = mPendingLOD.find(mesh_id);
+    if (pending != mPendingLOD.end())
+    {
+        vector_replace_with_last(pending->second, lod);
+        if (pending->second.empty())
+        {
+            // nothing else waits on the header, drop it unless it is already on the wire
+            mPendingLOD.erase(pending);
+            mHeaderReqQ.removeIf([&](const HeaderRequest& req)
+                {
+                    return req.mMeshParams.getSculptID() == mesh_id;
+                });
+            mDeferredHeaders.erase(mesh_id);
+        }
+    }
 }
 
 // Mutex:  must be holding mMutex when called
@@ -1930,7 +2067,7 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
 
                 if (!zero)
                 { //attempt to parse
-                    if (lodReceived(mesh_params, lod, buffer, size) == MESH_OK)
+                    if (lodReceived(mesh_params, lod, buffer, size, true) == MESH_OK)
                     {
                         delete[] buffer;
 
@@ -2089,46 +2226,149 @@ EMeshProcessingResult LLMeshRepoThread::headerReceived(const LLVolumeParams& mes
     return MESH_OK;
 }
 
-EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size)
+EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size,
+                                                    bool from_cache, S32 cache_offset)
 {
     if (data == NULL || data_size == 0)
     {
         return MESH_NO_DATA;
     }
 
+    bool posted = false;
+    if (mDecodePool)
+    {
+        // the caller frees data on return, the pool works on a copy
+        std::shared_ptr<std::vector<U8>> buffer = std::make_shared<std::vector<U8>>(data, data + data_size);
+
+        ++LLMeshRepository::sLODDecodeQueued;
+        ++mDecodesInFlight;
+        posted = mWorkQueue.postTo(
+            mDecodePool->getQueue().getWeak(),
+            // on a decode pool thread
+            [mesh_params, lod, buffer]()
+            {
+                LLPointer<LLVolume> volume = decodeLOD(mesh_params, lod, buffer->data(), (S32)buffer->size());
+                --LLMeshRepository::sLODDecodeQueued;
+                return volume;
+            },
+            // back on the repo thread
+            [this, mesh_params, lod, buffer, from_cache, cache_offset](LLPointer<LLVolume> volume)
+            {
+                --mDecodesInFlight;
+                lodDecoded(mesh_params, lod, volume, buffer->data(), (S32)buffer->size(), from_cache, cache_offset);
+            });
+
+        if (!posted)
+        {
+            // pool already shut down
+            --LLMeshRepository::sLODDecodeQueued;
+            --mDecodesInFlight;
+        }
+    }
+
+    if (!posted)
+    {
+        LLPointer<LLVolume> volume = decodeLOD(mesh_params, lod, data, data_size);
+        if (from_cache && volume.isNull())
+        {
+            // caller falls back to fetching over HTTP
+            return MESH_UNKNOWN;
+        }
+        lodDecoded(mesh_params, lod, volume, data, data_size, from_cache, cache_offset);
+    }
+
+    return MESH_OK;
+}
+
+// static
+LLPointer<LLVolume> LLMeshRepoThread::decodeLOD(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size)
+{
+    LL_PROFILE_ZONE_SCOPED;
+    LLTimer decode_timer;
+
     LLPointer<LLVolume> volume = new LLVolume(mesh_params, LLVolumeLODGroup::getVolumeScaleFromDetail(lod));
-    if (volume->unpackVolumeFaces(data, data_size))
+    if (!volume->unpackVolumeFaces(data, data_size) || volume->getNumFaces() <= 0)
     {
-        if (volume->getNumFaces() > 0)
+        volume = NULL;
+    }
+
+    LLMeshRepository::sLODDecodeMicroseconds += (U64)(decode_timer.getElapsedTimeF64() * 1000000.0);
+    ++LLMeshRepository::sLODDecoded;
+
+    return volume;
+}
+
+void LLMeshRepoThread::lodDecoded(const LLVolumeParams& mesh_params, S32 lod, LLPointer<LLVolume>& volume,
+                                  U8* data, S32 data_size, bool from_cache, S32 cache_offset)
+{
+    const LLUUID& mesh_id = mesh_params.getSculptID();
+
+    if (volume.notNull())
+    {
+        // if we have a valid SkinInfo, cache per-joint bounding boxes for this LOD.
+        // Done here rather than on the pool as it fills in the skin's joint
+        // numbers and may add joints to the avatar.
+        skin_map::iterator skin_iter = mSkinMap.find(mesh_id);
+        LLMeshSkinInfo* skin_info = skin_iter != mSkinMap.end() ? skin_iter->second.get() : NULL;
+        if (skin_info && isAgentAvatarValid())
         {
-            // if we have a valid SkinInfo, cache per-joint bounding boxes for this LOD
-            LLMeshSkinInfo* skin_info = mSkinMap[mesh_params.getSculptID()];
-            if (skin_info && isAgentAvatarValid())
+            for (S32 i = 0; i < volume->getNumFaces(); ++i)
             {
-                for (S32 i = 0; i < volume->getNumFaces(); ++i)
-                {
-                    // NOTE: no need to lock gAgentAvatarp as the state being checked is not changed after initialization
-                    LLVolumeFace& face = volume->getVolumeFace(i);
-                    LLSkinningUtil::updateRiggingInfo(skin_info, gAgentAvatarp, face);
-                }
+                // NOTE: no need to lock gAgentAvatarp as the state being checked is not changed after initialization
+                LLVolumeFace& face = volume->getVolumeFace(i);
+                LLSkinningUtil::updateRiggingInfo(skin_info, gAgentAvatarp, face);
             }
+        }
+
+        LoadedMesh mesh(volume, mesh_params, lod);
+        {
+            LLMutexLock lock(mMutex);
+            mLoadedQ.push_back(mesh);
+            // LLPointer is not thread safe, since we added this pointer into
+            // threaded list, make sure counter gets decreased inside mutex lock
+            // and won't affect mLoadedQ processing
+            volume = NULL;
+            // might be good idea to turn mesh into pointer to avoid making a copy
+            mesh.mVolume = NULL;
+        }
 
-            LoadedMesh mesh(volume, mesh_params, lod);
+        if (!from_cache && cache_offset >= 0)
+        {
+            // good fetch from sim, write to cache
+            LLFileSystem file(mesh_id, LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
+            if (file.getSize() >= cache_offset + data_size)
             {
-                LLMutexLock lock(mMutex);
-                mLoadedQ.push_back(mesh);
-                // LLPointer is not thread safe, since we added this pointer into
-                // threaded list, make sure counter gets decreased inside mutex lock
-                // and won't affect mLoadedQ processing
-                volume = NULL;
-                // might be good idea to turn mesh into pointer to avoid making a copy
-                mesh.mVolume = NULL;
+                file.seek(cache_offset);
+                file.write(data, data_size);
+                LLMeshRepository::sCacheBytesWritten += data_size;
+                ++LLMeshRepository::sCacheWrites;
             }
-            return MESH_OK;
         }
+        return;
     }
 
-    return MESH_UNKNOWN;
+    if (from_cache)
+    {
+        // Cached body is bad.  Drop the cache entry so the refetch
+        // goes to the simulator instead of reading it again.
+        LL_WARNS(LOG_MESH) << "Failed to decode cached mesh LOD, fetching again.  ID:  " << mesh_id
+                           << " LOD: " << lod << LL_ENDL;
+        LLFileSystem::removeFile(mesh_id, LLAssetType::AT_MESH);
+
+        LLMutexLock lock(mMutex);
+        mLODReqQ.push(LODRequest(mesh_params, lod));
+        ++LLMeshRepository::sLODProcessing;
+    }
+    else
+    {
+        LL_WARNS(LOG_MESH) << "Error during mesh LOD processing.  ID:  " << mesh_id
+                           << " LOD: " << lod
+                           << " Data size: " << data_size
+                           << " Not retrying."
+                           << LL_ENDL;
+        LLMutexLock lock(mMutex);
+        mUnavailableQ.push_back(LODRequest(mesh_params, lod));
+    }
 }
 
 bool LLMeshRepoThread::skinInfoReceived(const LLUUID& mesh_id, U8* data, S32 data_size)
@@ -3506,24 +3746,10 @@ void LLMeshLODHandler::processData(LLCore::BufferArray * /* body */, S32 /* body
     if ((!MESH_LOD_PROCESS_FAILED)
         && ((data != NULL) == (data_size > 0))) // if we have data but no size or have size but no data, something is wrong
     {
-        EMeshProcessingResult result = gMeshRepo.mThread->lodReceived(mMeshParams, mLOD, data, data_size);
-        if (result == MESH_OK)
-        {
-            // good fetch from sim, write to cache
-            LLFileSystem file(mMeshParams.getSculptID(), LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
-
-            S32 offset = mOffset;
-            S32 size = mRequestedBytes;
-
-            if (file.getSize() >= offset+size)
-            {
-                file.seek(offset);
-                file.write(data, size);
-                LLMeshRepository::sCacheBytesWritten += size;
-                ++LLMeshRepository::sCacheWrites;
-            }
-        }
-        else
+        // Decoded on the decode pool, which caches the body once it
+        // decoded and reports failures itself
+        EMeshProcessingResult result = gMeshRepo.mThread->lodReceived(mMeshParams, mLOD, data, data_size, false, mOffset);
+        if (result != MESH_OK)
         {
             LL_WARNS(LOG_MESH) << "Error during mesh LOD processing.  ID:  " << mMeshParams.getSculptID()
                                << ", Reason: " << result
@@ -3785,6 +4011,17 @@ S32 LLMeshRepository::update()
     // Conditionally log a mesh metrics event
     metricsUpdate();
 
+    // Decode throughput over about the last second, for the debug display
+    static LLFrameTimer decode_rate_timer;
+    static U32 last_decoded = 0;
+    if (decode_rate_timer.getElapsedTimeF32() >= 1.f)
+    {
+        const U32 decoded = sLODDecoded;
+        sLODDecodeRate = (F32)(decoded - last_decoded) / decode_rate_timer.getElapsedTimeF32();
+        last_decoded = decoded;
+        decode_rate_timer.reset();
+    }
+
     if(mUploadWaitList.empty())
     {
         return 0 ;
@@ -3818,6 +4055,97 @@ void LLMeshRepository::unregisterMesh(LLVOVolume* vobj)
     }
 }
 
+// Mutex:  must be holding mMeshMutex and mThread->mMutex when called
+void LLMeshRepository::updateRequestScores()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
+
+    LLMeshRepoThread::request_score_map scores;
+    U32 visible_waiting = 0;
+
+    for (S32 lod = 0; lod < LLVolumeLODGroup::NUM_LODS; ++lod)
+    {
+        for (mesh_load_map::iterator iter = mLoadingMeshes[lod].begin(); iter != mLoadingMeshes[lod].end(); )
+        {
+            const LLUUID& mesh_id = iter->first;
+
+            if (iter->second.empty())
+            {
+                // every object that wanted this LOD has been unregistered, stop fetching it
+                size_t old_size = mPendingRequests.size();
+                mPendingRequests.erase(std::remove_if(mPendingRequests.begin(), mPendingRequests.end(),
+                    [&](const LLMeshRepoThread::LODRequest& req)
+                    {
+                        return req.mLOD == lod && req.mMeshParams.getSculptID() == mesh_id;
+                    }),
+                    mPendingRequests.end());
+                LLMeshRepository::sLODPending -= (U32)(old_size - mPendingRequests.size());
+
+                mThread->cancelMeshLOD(mesh_id, lod);
+                iter = mLoadingMeshes[lod].erase(iter);
+                continue;
+            }
+
+            // Screen area is what texture fetches are prioritized by as well.
+            // Objects out of view keep a small share so they still load, after
+            // everything the camera can see.
+            F32 max_score = 0.f;
+            bool visible = false;
+            for (LLVOVolume* object : iter->second)
+            {
+                LLDrawable* drawable = object ? object->mDrawable.get() : NULL;
+                if (drawable)
+                {
+                    F32 cur_score = object->getPixelArea();
+                    if (drawable->isVisible())
+                    {
+                        visible = true;
+                    }
+                    else
+                    {
+                        cur_score *= OFFSCREEN_SCORE_SCALE;
+                    }
+                    max_score = llmax(max_score, cur_score);
+                }
+            }
+
+            F32& score = scores[mesh_id];
+            score = llmax(score, max_score);
+            if (visible)
+            {
+                ++visible_waiting;
+            }
+            ++iter;
+        }
+    }
+
+    for (LLMeshRepoThread::LODRequest& request : mPendingRequests)
+    {
+        LLMeshRepoThread::request_score_map::const_iterator iter = scores.find(request.mMeshParams.getSculptID());
+        request.mScore = iter != scores.end() ? iter->second : 0.f;
+    }
+
+    mThread->updateRequestScores(scores);
+
+    // Time until visible meshes complete: stop once meshes for objects in
+    // view have been requested since login or teleport and all arrived.
+    if (metrics_visible_mesh_timing)
+    {
+        if (visible_waiting > 0)
+        {
+            metrics_visible_mesh_seen = true;
+        }
+        else if (metrics_visible_mesh_seen)
+        {
+            F64Seconds elapsed(metrics_visible_mesh_timer.getElapsedTimeF64());
+            record(LLStatViewer::MESH_VISIBLE_COMPLETE_TIME, elapsed);
+            LL_INFOS(LOG_MESH) << "Visible meshes complete " << elapsed.value() << " seconds after "
+                               << (metrics_teleport_start_count > 1 ? "teleport" : "login") << LL_ENDL;
+            metrics_visible_mesh_timing = false;
+        }
+    }
+}
+
 S32 LLMeshRepository::loadMesh(LLVOVolume* vobj, const LLVolumeParams& mesh_params, S32 detail, S32 last_lod)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK; //LL_LL_RECORD_BLOCK_TIME(FTM_MESH_FETCH);
@@ -4153,6 +4481,17 @@ void LLMeshRepository::notifyLoadedMeshes()
         }
 
         S32 active_count = LLMeshRepoThread::sActiveHeaderRequests + LLMeshRepoThread::sActiveLODRequests;
+        const bool backlogged = active_count < LLMeshRepoThread::sRequestLowWater
+            && (S32)mPendingRequests.size() > LLMeshRepoThread::sRequestHighWater - active_count;
+
+        // Rescore every frame while requests are waiting for a slot here,
+        // otherwise often enough to follow the camera
+        if (backlogged || mRequestScoreTimer.getElapsedTimeF32() > REQUEST_SCORE_INTERVAL)
+        {
+            updateRequestScores();
+            mRequestScoreTimer.reset();
+        }
+
         if (active_count < LLMeshRepoThread::sRequestLowWater)
         {
             S32 push_count = LLMeshRepoThread::sRequestHighWater - active_count;
@@ -4162,40 +4501,6 @@ void LLMeshRepository::notifyLoadedMeshes()
                 // More requests than the high-water limit allows so
                 // sort and forward the most important.
 
-                //calculate "score" for pending requests
-
-                //create score map
-                std::map<LLUUID, F32> score_map;
-
-                for (U32 i = 0; i < LLVolumeLODGroup::NUM_LODS; ++i)
-                {
-                    for (mesh_load_map::iterator iter = mLoadingMeshes[i].begin();  iter != mLoadingMeshes[i].end(); ++iter)
-                    {
-                        F32 max_score = 0.f;
-                        for (auto obj_iter = iter->second.begin(); obj_iter != iter->second.end(); ++obj_iter)
-                        {
-                            LLVOVolume* object = *obj_iter;
-                            if (object)
-                            {
-                                LLDrawable* drawable = object->mDrawable;
-                                if (drawable)
-                                {
-                                    F32 cur_score = drawable->getRadius()/llmax(drawable->mDistanceWRTCamera, 1.f);
-                                    max_score = llmax(max_score, cur_score);
-                                }
-                            }
-                        }
-
-                        score_map[iter->first] = max_score;
-                    }
-                }
-
-                //set "score" for pending requests
-                for (std::vector<LLMeshRepoThread::LODRequest>::iterator iter = mPendingRequests.begin(); iter != mPendingRequests.end(); ++iter)
-                {
-                    iter->mScore = score_map[iter->mMeshParams.getSculptID()];
-                }
-
                 //sort by "score"
                 std::partial_sort(mPendingRequests.begin(), mPendingRequests.begin() + push_count,
                                   mPendingRequests.end(), LLMeshRepoThread::CompareScoreGreater());
@@ -4212,30 +4517,33 @@ void LLMeshRepository::notifyLoadedMeshes()
         }
 
         //send skin info requests
-        while (!mPendingSkinRequests.empty())
+        //  (the rest wait for the next frame if the thread's inbound queue is full)
+        while (!mPendingSkinRequests.empty() && mThread->loadMeshSkinInfo(mPendingSkinRequests.front()))
         {
-            mThread->loadMeshSkinInfo(mPendingSkinRequests.front());
             mPendingSkinRequests.pop();
         }
 
         //send decomposition requests
-        while (!mPendingDecompositionRequests.empty())
+        while (!mPendingDecompositionRequests.empty() && mThread->loadMeshDecomposition(mPendingDecompositionRequests.front()))
         {
-            mThread->loadMeshDecomposition(mPendingDecompositionRequests.front());
             mPendingDecompositionRequests.pop();
         }
 
         //send physics shapes decomposition requests
-        while (!mPendingPhysicsShapeRequests.empty())
+        while (!mPendingPhysicsShapeRequests.empty() && mThread->loadMeshPhysicsShape(mPendingPhysicsShapeRequests.front()))
         {
-            mThread->loadMeshPhysicsShape(mPendingPhysicsShapeRequests.front());
             mPendingPhysicsShapeRequests.pop();
         }
 
         mThread->notifyLoadedMeshes();
     }
 
-    mThread->mSignal->signal();
+    // new requests wake the thread themselves, this keeps HTTP replies
+    // and decodes flowing
+    if (mThread->isBusy())
+    {
+        mThread->wake();
+    }
 }
 
 void LLMeshRepository::notifySkinInfoReceived(LLMeshSkinInfo* info)
@@ -5659,6 +5967,10 @@ void LLMeshRepository::metricsStart()
 {
     ++metrics_teleport_start_count;
     sQuiescentTimer.start(0);
+
+    metrics_visible_mesh_timer.reset();
+    metrics_visible_mesh_timing = true;
+    metrics_visible_mesh_seen = false;
 }
 
 // Threading:  main thread only
@@ -27,6 +27,9 @@
 #ifndef LL_MESH_REPOSITORY_H
 #define LL_MESH_REPOSITORY_H
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include "llassettype.h"
@@ -40,7 +43,10 @@
 #include "httpoptions.h"
 #include "httpheaders.h"
 #include "httphandler.h"
+#include "lllockfreequeue.h"
 #include "llthread.h"
+#include "lltimerwheel.h"
+#include "threadpool_fwd.h"
 
 #define LLCONVEXDECOMPINTER_STATIC 1
 
@@ -188,6 +194,7 @@ public:
     void updateTime();
     bool canRetry() const;
     bool isDelayed() const;
+    F32 getTimeToRetry() const;
     U32 getRetries() { return mRetries; }
 
 private:
@@ -318,6 +325,89 @@ public:
         }
     };
 
+    // Screen importance of meshes being loaded, by mesh id
+    typedef std::unordered_map<LLUUID, F32> request_score_map;
+
+    // Header or LOD requests ordered by the score of their mesh, highest
+    // first and in arrival order among equal scores.  Scores are read from
+    // the thread's score map on push() and again on rescore(), so a mesh
+    // moves up or down the queue as the camera moves.  Rescoring and
+    // removal rebuild the heap, linear in the queue length.
+    //
+    // Mutex:  must be holding mMutex
+    template <typename REQUEST>
+    class RequestQueue
+    {
+    public:
+        RequestQueue(const request_score_map& scores)
+            : mScores(scores), mNextSerial(0)
+        {
+        }
+
+        bool empty() const { return mHeap.empty(); }
+        size_t size() const { return mHeap.size(); }
+
+        void push(const REQUEST& req)
+        {
+            mHeap.push_back({ getScore(req), mNextSerial++, req });
+            std::push_heap(mHeap.begin(), mHeap.end());
+        }
+
+        const REQUEST& top() const { return mHeap.front().mRequest; }
+
+        void pop()
+        {
+            std::pop_heap(mHeap.begin(), mHeap.end());
+            mHeap.pop_back();
+        }
+
+        void rescore()
+        {
+            for (Entry& entry : mHeap)
+            {
+                entry.mScore = getScore(entry.mRequest);
+            }
+            std::make_heap(mHeap.begin(), mHeap.end());
+        }
+
+        // Remove queued requests for which pred(request) is true, returns
+        // the number removed
+        template <typename PRED>
+        size_t removeIf(PRED pred)
+        {
+            const size_t old_size = mHeap.size();
+            mHeap.erase(std::remove_if(mHeap.begin(), mHeap.end(),
+                                       [&pred](const Entry& entry) { return pred(entry.mRequest); }),
+                        mHeap.end());
+            std::make_heap(mHeap.begin(), mHeap.end());
+            return old_size - mHeap.size();
+        }
+
+    private:
+        struct Entry
+        {
+            F32 mScore;
+            U64 mSerial;
+            REQUEST mRequest;
+
+            // max-heap: higher score first, then the older request
+            bool operator<(const Entry& rhs) const
+            {
+                return mScore < rhs.mScore || (mScore == rhs.mScore && mSerial > rhs.mSerial);
+            }
+        };
+
+        F32 getScore(const REQUEST& req) const
+        {
+            request_score_map::const_iterator iter = mScores.find(req.mMeshParams.getSculptID());
+            return iter != mScores.end() ? iter->second : 0.f;
+        }
+
+        const request_score_map& mScores;
+        U64 mNextSerial;
+        std::vector<Entry> mHeap;
+    };
+
     class UUIDBasedRequest : public RequestStats
     {
     public:
@@ -348,6 +438,23 @@ public:
 
     };
 
+    // Skin info, decomposition and physics shape requests from the main
+    // thread.  Sorted into the request lists below by the repo thread, so
+    // neither side takes mMutex for them.
+    struct InboundRequest
+    {
+        enum EKind : U8
+        {
+            SKIN_INFO,
+            DECOMPOSITION,
+            PHYSICS_SHAPE
+        };
+
+        LLUUID mId;
+        EKind mKind = SKIN_INFO;
+    };
+    LLLockFreeQueue<InboundRequest> mInboundQ;
+
     //set of requested skin info
     std::deque<UUIDBasedRequest> mSkinRequests;
 
@@ -366,11 +473,31 @@ public:
     // list of completed Decomposition info requests
     std::list<LLModel::Decomposition*> mDecompositionQ;
 
-    //queue of requested headers
-    std::queue<HeaderRequest> mHeaderReqQ;
+    //screen importance of meshes being loaded, maintained by the main thread
+    request_score_map mRequestScores;
 
-    //queue of requested LODs
-    std::queue<LODRequest> mLODReqQ;
+    //queue of requested headers, most important mesh first
+    RequestQueue<HeaderRequest> mHeaderReqQ;
+
+    //queue of requested LODs, most important mesh first
+    RequestQueue<LODRequest> mLODReqQ;
+
+    // Requests waiting out their retry backoff, repo thread only.  They
+    // go back to their queue when due instead of being popped and pushed
+    // back on every pass.
+    struct UUIDRetry
+    {
+        InboundRequest::EKind mKind;
+        UUIDBasedRequest mRequest;
+    };
+    LLTimerWheel<LODRequest> mLODRetries;
+    LLTimerWheel<HeaderRequest> mHeaderRetries;
+    LLTimerWheel<UUIDRetry> mUUIDRetries;
+
+    // LOD and header requests sitting in the retry wheels, so a cancel
+    // can drop them before they return to their queue
+    std::multiset<std::pair<LLUUID, S32>> mDeferredLODs;
+    std::multiset<LLUUID> mDeferredHeaders;
 
     //queue of unavailable LODs (either asset doesn't exist or asset doesn't have desired LOD)
     std::deque<LODRequest> mUnavailableQ;
@@ -390,6 +517,21 @@ public:
     // workqueue for processing generic requests
     LL::WorkQueue mWorkQueue;
 
+    // Decodes LOD bodies so decoding neither delays HTTP dispatch on this
+    // thread nor is limited to one core.  Sized by the "MeshDecode" entry
+    // of ThreadPoolSizes.
+    std::unique_ptr<LL::ThreadPool> mDecodePool;
+
+    U32 mDecodesInFlight;
+
+    // Set by wake() until the thread picks it up, so a burst of wake-ups
+    // costs one pass
+    std::atomic<bool> mWakePending;
+
+    // Repo thread has HTTP replies or decodes to collect and wants the
+    // main thread's per frame wake-up
+    std::atomic<bool> mBusy;
+
     // llcorehttp library interface objects.
     LLCore::HttpStatus                  mHttpStatus;
     LLCore::HttpRequest *               mHttpRequest;
@@ -418,10 +560,30 @@ public:
     void lockAndLoadMeshLOD(const LLVolumeParams& mesh_params, S32 lod);
     void loadMeshLOD(const LLVolumeParams& mesh_params, S32 lod);
 
+    // Replace the mesh scores (swapped with @scores) and reorder the
+    // queued header and LOD requests to match.
+    //
+    // Mutex:  must be holding mMutex when called
+    void updateRequestScores(request_score_map& scores);
+
+    // Drop queued work for a mesh LOD no object wants anymore, including
+    // the header request if no other LOD of the mesh is waiting for it.
+    // Requests already on the wire complete and are ignored.
+    //
+    // Mutex:  must be holding mMutex when called
+    void cancelMeshLOD(const LLUUID& mesh_id, S32 lod);
+
     bool fetchMeshHeader(const LLVolumeParams& mesh_params, bool can_retry = true);
     bool fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool can_retry = true);
     EMeshProcessingResult headerReceived(const LLVolumeParams& mesh_params, U8* data, S32 data_size);
-    EMeshProcessingResult lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size);
+    // Hands a LOD body to the decode pool, returns MESH_OK once it is
+    // queued.  Decoded meshes arrive in mLoadedQ.  A body read from the
+    // cache that fails to decode is dropped from the cache and fetched
+    // again, one received over HTTP is written to the cache at
+    // cache_offset once it decoded.  Without a running pool the body is
+    // decoded right away and for cached bodies a failure is returned.
+    EMeshProcessingResult lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size,
+                                      bool from_cache, S32 cache_offset = -1);
     bool skinInfoReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
     bool decompositionReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
     EMeshProcessingResult physicsShapeReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
@@ -432,9 +594,17 @@ public:
     void notifyLoadedMeshes();
     S32 getActualMeshLOD(const LLVolumeParams& mesh_params, S32 lod);
 
-    void loadMeshSkinInfo(const LLUUID& mesh_id);
-    void loadMeshDecomposition(const LLUUID& mesh_id);
-    void loadMeshPhysicsShape(const LLUUID& mesh_id);
+    // Queue a request for the repo thread, false if the inbound queue is
+    // full and the caller should try again later
+    bool loadMeshSkinInfo(const LLUUID& mesh_id);
+    bool loadMeshDecomposition(const LLUUID& mesh_id);
+    bool loadMeshPhysicsShape(const LLUUID& mesh_id);
+
+    // Get the thread to run a pass.  Cheap when a wake-up is already
+    // pending, callable from any thread.
+    void wake();
+
+    bool isBusy() const { return mBusy; }
 
     //send request for skin info, returns true if header info exists
     //  (should hold onto mesh_id and try again later if header info does not exist)
@@ -472,6 +642,27 @@ public:
     LLUUID getCreatorFromHeader(const LLUUID& mesh_id);
 
 private:
+    bool pushInbound(const LLUUID& mesh_id, InboundRequest::EKind kind);
+
+    // Steps of run(), in the order they go
+    void sortInboundRequests();
+    void requeueDueRetries();
+    void processLODRequests();
+    void processHeaderRequests();
+    void processUUIDRequests();
+
+    // HTTP slots left below the high water mark
+    size_t freeRequestSlots() const;
+
+    // Decode pool half of lodReceived(), called on a pool thread.  Only
+    // unpacks the volume, returns NULL if the body is bad.
+    static LLPointer<LLVolume> decodeLOD(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size);
+
+    // Repo thread half of lodReceived(), after decodeLOD() finished.
+    // Fills in rigging info and queues the volume for the main thread.
+    void lodDecoded(const LLVolumeParams& mesh_params, S32 lod, LLPointer<LLVolume>& volume,
+                    U8* data, S32 data_size, bool from_cache, S32 cache_offset);
+
     // Issue a GET request to a URL with 'Range' header using
     // the correct policy class and other attributes.  If an invalid
     // handle is returned, the request failed and caller must retry
@@ -655,6 +846,10 @@ public:
     static U32 sCacheReads;
     static U32 sCacheWrites;
     static U32 sMaxLockHoldoffs;                // Maximum sequential locking failures
+    static std::atomic<S32> sLODDecodeQueued;  // LOD bodies waiting for or in decode
+    static std::atomic<U32> sLODDecoded;        // LOD bodies decoded, whether or not successfully
+    static std::atomic<U64> sLODDecodeMicroseconds; // Time spent decoding, all decode threads
+    static F32 sLODDecodeRate;                  // Decodes per second over the last second, main thread
 
     static LLDeadmanTimer sQuiescentTimer;      // Time-to-complete-mesh-downloads after significant events
 
@@ -715,6 +910,13 @@ public:
     static void metricsProgress(unsigned int count);
     static void metricsUpdate();
 
+    // Score loading meshes by screen area, reorder the fetch queues,
+    // cancel requests of meshes no object waits for anymore and track
+    // when every visible mesh has finished loading.
+    //
+    // Mutex:  must be holding mMeshMutex and mThread->mMutex when called
+    void updateRequestScores();
+
     typedef boost::unordered_map<LLUUID, std::vector<LLVOVolume*> > mesh_load_map;
     mesh_load_map mLoadingMeshes[4];
 
@@ -759,6 +961,7 @@ public:
     LLPhysicsDecomp* mDecompThread;
 
     LLFrameTimer     mSkinInfoCullTimer;
+    LLFrameTimer     mRequestScoreTimer;
 
     class inventory_data
     {
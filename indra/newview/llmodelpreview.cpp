@@ -43,6 +43,7 @@
 #include "llmatrix4a.h"
 #include "llmeshrepository.h"
 #include "llmeshoptimizer.h"
+#include "parallelfor.h"
 #include "llrender.h"
 #include "llsdutil_math.h"
 #include "llskinningutil.h"
@@ -127,6 +128,33 @@ bool stop_gloderror()
 }
 // </FS:Beq>
 
+namespace
+{
+    // Log lines of models simplified on the parallel pool, the floater's log
+    // can only be written from the main thread.
+    typedef std::vector<std::pair<std::string, bool>> deferred_log_t;
+    thread_local deferred_log_t* sDeferredLog = nullptr;
+
+    class DeferredLogScope
+    {
+    public:
+        DeferredLogScope(deferred_log_t& log) { sDeferredLog = &log; }
+        ~DeferredLogScope() { sDeferredLog = nullptr; }
+    };
+
+    void add_string_to_log(const std::ostringstream& strm, bool flash)
+    {
+        if (sDeferredLog)
+        {
+            sDeferredLog->emplace_back(strm.str(), flash);
+        }
+        else
+        {
+            LLFloaterModelPreview::addStringToLog(strm, flash);
+        }
+    }
+}
+
 LLViewerFetchedTexture* bindMaterialDiffuseTexture(const LLImportMaterial& material)
 {
     LLViewerFetchedTexture *texture = LLViewerTextureManager::getFetchedTexture(material.getDiffuseMap(), FTT_DEFAULT, true, LLGLTexture::BOOST_PREVIEW);
@@ -1616,10 +1644,7 @@ void LLModelPreview::generateNormals()
             }
         }
 
-        for (LLModelLoader::model_list::iterator it = mBaseModel.begin(), itE = mBaseModel.end(); it != itE; ++it)
-        {
-            (*it)->generateNormals(angle_cutoff);
-        }
+        generateNormals(mBaseModel, angle_cutoff);
 
         mVertexBuffer[LLModel::NUM_LODS].clear();
     }
@@ -1629,23 +1654,39 @@ void LLModelPreview::generateNormals()
         mModelFacesCopy[which_lod].reserve(mModel[which_lod].size());
     }
 
-    for (LLModelLoader::model_list::iterator it = mModel[which_lod].begin(), itE = mModel[which_lod].end(); it != itE; ++it)
+    if (perform_copy)
     {
-        if (perform_copy)
+        for (LLModelLoader::model_list::iterator it = mModel[which_lod].begin(), itE = mModel[which_lod].end(); it != itE; ++it)
         {
             v_LLVolumeFace_t faces;
             (*it)->copyFacesTo(faces);
             mModelFacesCopy[which_lod].push_back(faces);
         }
-
-        (*it)->generateNormals(angle_cutoff);
     }
 
+    generateNormals(mModel[which_lod], angle_cutoff);
+
     mVertexBuffer[which_lod].clear();
     refresh();
     updateStatusMessages();
 }
 
+//static
+void LLModelPreview::generateNormals(LLModelLoader::model_list& models, F32 angle_cutoff)
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    // each model only welds its own faces
+    LL::parallel_for(models.size(), 1,
+        [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                models[i]->generateNormals(angle_cutoff);
+            }
+        });
+}
+
 void LLModelPreview::restoreNormals()
 {
     S32 which_lod = mPreviewLOD;
@@ -2260,7 +2301,7 @@ F32 LLModelPreview::genMeshOptimizerPerModel(LLModel *base_model, LLModel *targe
             << " new Indices: " << size_new_indices
             << " original count: " << size_indices ;
         LL_WARNS() << out.str() << LL_ENDL;
-        LLFloaterModelPreview::addStringToLog(out, true);
+        add_string_to_log(out, true);
     }
     else
     {
@@ -2272,7 +2313,7 @@ F32 LLModelPreview::genMeshOptimizerPerModel(LLModel *base_model, LLModel *targe
                 << " new Indices: " << size_new_indices
                 << " original count: " << size_indices << " (result error:" << result_error << ")";
             LL_DEBUGS() << out.str() << LL_ENDL;
-            LLFloaterModelPreview::addStringToLog(out, true);
+            add_string_to_log(out, true);
         }
         // </FS:Beq>
     }
@@ -2361,7 +2402,7 @@ F32 LLModelPreview::genMeshOptimizerPerModel(LLModel *base_model, LLModel *targe
                                 << " original count: " << size_indices
                                 << " error treshold: " << error_threshold;
                             LL_DEBUGS() << out.str() << LL_ENDL;
-                            LLFloaterModelPreview::addStringToLog(out, true);
+                            add_string_to_log(out, true);
                         }
                         // U16 vertices overflow shouldn't happen, but just in case
                         size_new_indices = 0;
@@ -2540,7 +2581,7 @@ F32 LLModelPreview::genMeshOptimizerPerFace(LLModel *base_model, LLModel *target
             << " original count: " << size_indices
             << " error treshold: " << error_threshold;
         LL_WARNS() << out.str() << LL_ENDL;
-        LLFloaterModelPreview::addStringToLog(out, true);
+        add_string_to_log(out, true);
     }
     else
     {
@@ -2554,7 +2595,7 @@ F32 LLModelPreview::genMeshOptimizerPerFace(LLModel *base_model, LLModel *target
                 << " original count: " << size_indices
                 << " error treshold: " << error_threshold << " (result error:" << result_error << ")";
             LL_DEBUGS("MeshUpload") << out.str() << LL_ENDL;
-            LLFloaterModelPreview::addStringToLog(out, true);
+            add_string_to_log(out, true);
         }
         // </FS:Beq>
     }
@@ -2583,7 +2624,7 @@ F32 LLModelPreview::genMeshOptimizerPerFace(LLModel *base_model, LLModel *target
                 << " original count: " << size_indices
                 << " error treshold: " << error_threshold;
             LL_INFOS("MeshUpload") << out.str() << LL_ENDL;
-            LLFloaterModelPreview::addStringToLog(out, true);
+            add_string_to_log(out, true);
         }
 
         // Face got optimized away
@@ -2618,6 +2659,200 @@ F32 LLModelPreview::genMeshOptimizerPerFace(LLModel *base_model, LLModel *target
     return (F32)size_indices / (F32)size_new_indices;
 }
 
+void LLModelPreview::genMeshOptimizerModel(LLModel* base, LLModel* target_model, S32 which_lod, S32 meshopt_mode, U32 decimation,
+                                           U32 lod_mode, F32 indices_decimator, F32 lod_error_threshold)
+{
+    // carry over normalized transform into simplified model
+    for (S32 i = 0; i < base->getNumVolumeFaces(); ++i)
+    {
+        LLVolumeFace& src = base->getVolumeFace(i);
+        LLVolumeFace& dst = target_model->getVolumeFace(i);
+        dst.mNormalizedScale = src.mNormalizedScale;
+    }
+
+    S32 model_meshopt_mode = meshopt_mode;
+
+    // Ideally this should run not per model,
+    // but combine all submodels with origin model as well
+    if (model_meshopt_mode == MESH_OPTIMIZER_PRECISE)
+    {
+        // Run meshoptimizer for each face
+        for (S32 face_idx = 0; face_idx < base->getNumVolumeFaces(); ++face_idx)
+        {
+            F32 res = genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
+            if (res < 0)
+            {
+                // Mesh optimizer failed and returned an invalid model
+                const LLVolumeFace &face = base->getVolumeFace(face_idx);
+                LLVolumeFace &new_face = target_model->getVolumeFace(face_idx);
+                new_face = face;
+            }
+        }
+    }
+
+    if (model_meshopt_mode == MESH_OPTIMIZER_SLOPPY)
+    {
+        // Run meshoptimizer for each face
+        for (S32 face_idx = 0; face_idx < base->getNumVolumeFaces(); ++face_idx)
+        {
+            if (genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY) < 0)
+            {
+                // Sloppy failed and returned an invalid model
+                genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
+            }
+        }
+    }
+
+    if (model_meshopt_mode == MESH_OPTIMIZER_AUTO)
+    {
+        // Remove progressively more data if we can't reach the target.
+        F32 allowed_ratio_drift = 1.8f;
+        F32 precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
+
+        if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
+        {
+            precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_NORMALS);
+        }
+
+        if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
+        {
+            precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_UVS);
+        }
+
+        if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
+        {
+            // Try sloppy variant if normal one failed to simplify model enough.
+            // Sloppy variant can fail entirely and has issues with precision,
+            // so code needs to do multiple attempts with different decimators.
+            // Todo: this is a bit of a mess, needs to be refined and improved
+
+            F32 last_working_decimator = 0.f;
+            F32 last_working_ratio = F32_MAX;
+
+            F32 sloppy_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
+
+            if (sloppy_ratio > 0)
+            {
+                // Would be better to do a copy of target_model here, but if
+                // we need to use sloppy decimation, model should be cheap
+                // and fast to generate and it won't affect end result
+                last_working_decimator = indices_decimator;
+                last_working_ratio = sloppy_ratio;
+            }
+
+            // Sloppy has a tendecy to error into lower side, so a request for 100
+            // triangles turns into ~70, so check for significant difference from target decimation
+            F32 sloppy_ratio_drift = 1.4f;
+            if (lod_mode == LIMIT_TRIANGLES
+                && (sloppy_ratio > indices_decimator * sloppy_ratio_drift || sloppy_ratio < 0))
+            {
+                // Apply a correction to compensate.
+
+                // (indices_decimator / res_ratio) by itself is likely to overshoot to a differend
+                // side due to overal lack of precision, and we don't need an ideal result, which
+                // likely does not exist, just a better one, so a partial correction is enough.
+                F32 sloppy_decimator{indices_decimator};
+                // if(sloppy_ratio > 0)
+                // {
+                sloppy_decimator = indices_decimator * (indices_decimator / sloppy_ratio + 1) / 2;
+                // }
+                sloppy_ratio = genMeshOptimizerPerModel(base, target_model, sloppy_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
+            }
+
+            if (last_working_decimator > 0 && sloppy_ratio < last_working_ratio)
+            {
+                // Compensation didn't work, return back to previous decimator
+                sloppy_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
+            }
+
+            if (sloppy_ratio < 0)
+            {
+                // Sloppy method didn't work, try with smaller decimation values
+                {
+                    // Find a decimator that does work
+                    F32 sloppy_decimation_step = sqrt((F32)decimation); // example: 27->15->9->5->3
+                    F32 sloppy_decimator = indices_decimator / sloppy_decimation_step;
+                    U64Microseconds end_time = LLTimer::getTotalTime() + U64Seconds(5);
+
+                    while (sloppy_ratio < 0
+                        && sloppy_decimator > precise_ratio
+                        && sloppy_decimator > 1 // precise_ratio isn't supposed to be below 1, but check just in case
+                        && end_time > LLTimer::getTotalTime())
+                    {
+                        sloppy_ratio = genMeshOptimizerPerModel(base, target_model, sloppy_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
+                        sloppy_decimator = sloppy_decimator / sloppy_decimation_step;
+                    }
+                }
+            }
+
+            if (sloppy_ratio < 0 || sloppy_ratio < precise_ratio)
+            {
+                // Sloppy variant failed to generate triangles or is worse.
+                // Can happen with models that are too simple as is.
+
+                if (precise_ratio < 0)
+                {
+                    // Precise method failed as well, just copy face over
+                    target_model->copyVolumeFaces(base);
+                    precise_ratio = 1.f;
+                }
+                else
+                {
+                    // Fallback to normal method
+                    precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
+                }
+                // <FS:Beq> Log stuff properly
+                // LL_INFOS() << "Model " << target_model->getName()
+                //     << " lod " << which_lod
+                //     << " resulting ratio " << precise_ratio
+                //     << " simplified using per model method." << LL_ENDL;
+                {
+                    std::ostringstream out;
+                    out << "Model " << target_model->getName()
+                        << " lod " << which_lod
+                        << " resulting ratio " << precise_ratio
+                        << " simplified using per model method.";
+                    LL_INFOS() << out.str() << LL_ENDL;
+                    add_string_to_log(out, false);
+                }
+                // </FS:Beq>
+            }
+            else
+            {
+                // <FS:Beq> Log stuff properly
+                // LL_INFOS() << "Model " << target_model->getName()
+                //     << " lod " << which_lod
+                //     << " resulting ratio " << sloppy_ratio
+                //     << " sloppily simplified using per model method." << LL_ENDL;
+                std::ostringstream out;
+                out << "Model " << target_model->getName()
+                    << " lod " << which_lod
+                    << " resulting ratio " << sloppy_ratio
+                    << " sloppily simplified using per model method.";
+                LL_INFOS() << out.str() << LL_ENDL;
+                add_string_to_log(out, false);
+                // </FS:Beq>
+            }
+        }
+        else
+        {
+                // <FS:Beq> Log stuff properly
+                // LL_INFOS() << "Model " << target_model->getName()
+                //     << " lod " << which_lod
+                //     << " resulting ratio " << precise_ratio
+                //     << " simplified using per model method." << LL_ENDL;
+                std::ostringstream out;
+                out << "Bad MeshOptimisation result for Model " << target_model->getName()
+                    << " lod " << which_lod
+                    << " resulting ratio " << precise_ratio
+                    << " simplified using per model method.";
+                LL_WARNS() << out.str() << LL_ENDL;
+                add_string_to_log(out, true);
+                // </FS:Beq>
+        }
+    }
+}
+
 void LLModelPreview::genMeshOptimizerLODs(S32 which_lod, S32 meshopt_mode, U32 decimation, bool enforce_tri_limit)
 {
     // <FS:Beq> Log things properly
@@ -2758,198 +2993,32 @@ void LLModelPreview::genMeshOptimizerLODs(S32 which_lod, S32 meshopt_mode, U32 d
             mModel[lod][mdl_idx]->mLabel = name;
             mModel[lod][mdl_idx]->mSubmodelID = base->mSubmodelID;
             mModel[lod][mdl_idx]->setNumVolumeFaces(base->getNumVolumeFaces());
+        }
 
-            LLModel* target_model = mModel[lod][mdl_idx];
-
-            // carry over normalized transform into simplified model
-            for (S32 i = 0; i < base->getNumVolumeFaces(); ++i)
-            {
-                LLVolumeFace& src = base->getVolumeFace(i);
-                LLVolumeFace& dst = target_model->getVolumeFace(i);
-                dst.mNormalizedScale = src.mNormalizedScale;
-            }
-
-            S32 model_meshopt_mode = meshopt_mode;
-
-            // Ideally this should run not per model,
-            // but combine all submodels with origin model as well
-            if (model_meshopt_mode == MESH_OPTIMIZER_PRECISE)
+        // Simplifying only touches each model's own LOD, spread the models
+        // over the parallel pool. Whatever they log is kept per model and
+        // passed on in model order afterwards.
+        std::vector<deferred_log_t> logs(mBaseModel.size());
+        LL::parallel_for(mBaseModel.size(), 1,
+            [&](size_t begin, size_t end)
             {
-                // Run meshoptimizer for each face
-                for (S32 face_idx = 0; face_idx < base->getNumVolumeFaces(); ++face_idx)
+                for (size_t mdl_idx = begin; mdl_idx < end; ++mdl_idx)
                 {
-                    F32 res = genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
-                    if (res < 0)
-                    {
-                        // Mesh optimizer failed and returned an invalid model
-                        const LLVolumeFace &face = base->getVolumeFace(face_idx);
-                        LLVolumeFace &new_face = target_model->getVolumeFace(face_idx);
-                        new_face = face;
-                    }
+                    DeferredLogScope scope(logs[mdl_idx]);
+                    genMeshOptimizerModel(mBaseModel[mdl_idx], mModel[lod][mdl_idx], which_lod, meshopt_mode, decimation,
+                                          lod_mode, indices_decimator, lod_error_threshold);
                 }
-            }
+            });
 
-            if (model_meshopt_mode == MESH_OPTIMIZER_SLOPPY)
+        for (U32 mdl_idx = 0; mdl_idx < mBaseModel.size(); ++mdl_idx)
+        {
+            for (const auto& line : logs[mdl_idx])
             {
-                // Run meshoptimizer for each face
-                for (S32 face_idx = 0; face_idx < base->getNumVolumeFaces(); ++face_idx)
-                {
-                    if (genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY) < 0)
-                    {
-                        // Sloppy failed and returned an invalid model
-                        genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
-                    }
-                }
+                LLFloaterModelPreview::addStringToLog(line.first, line.second);
             }
 
-            if (model_meshopt_mode == MESH_OPTIMIZER_AUTO)
-            {
-                // Remove progressively more data if we can't reach the target.
-                F32 allowed_ratio_drift = 1.8f;
-                F32 precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
-
-                if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
-                {
-                    precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_NORMALS);
-                }
-
-                if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
-                {
-                    precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_UVS);
-                }
-
-                if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
-                {
-                    // Try sloppy variant if normal one failed to simplify model enough.
-                    // Sloppy variant can fail entirely and has issues with precision,
-                    // so code needs to do multiple attempts with different decimators.
-                    // Todo: this is a bit of a mess, needs to be refined and improved
-
-                    F32 last_working_decimator = 0.f;
-                    F32 last_working_ratio = F32_MAX;
-
-                    F32 sloppy_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
-
-                    if (sloppy_ratio > 0)
-                    {
-                        // Would be better to do a copy of target_model here, but if
-                        // we need to use sloppy decimation, model should be cheap
-                        // and fast to generate and it won't affect end result
-                        last_working_decimator = indices_decimator;
-                        last_working_ratio = sloppy_ratio;
-                    }
-
-                    // Sloppy has a tendecy to error into lower side, so a request for 100
-                    // triangles turns into ~70, so check for significant difference from target decimation
-                    F32 sloppy_ratio_drift = 1.4f;
-                    if (lod_mode == LIMIT_TRIANGLES
-                        && (sloppy_ratio > indices_decimator * sloppy_ratio_drift || sloppy_ratio < 0))
-                    {
-                        // Apply a correction to compensate.
-
-                        // (indices_decimator / res_ratio) by itself is likely to overshoot to a differend
-                        // side due to overal lack of precision, and we don't need an ideal result, which
-                        // likely does not exist, just a better one, so a partial correction is enough.
-                        F32 sloppy_decimator{indices_decimator};
-                        // if(sloppy_ratio > 0)
-                        // {
-                        sloppy_decimator = indices_decimator * (indices_decimator / sloppy_ratio + 1) / 2;
-                        // }
-                        sloppy_ratio = genMeshOptimizerPerModel(base, target_model, sloppy_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
-                    }
-
-                    if (last_working_decimator > 0 && sloppy_ratio < last_working_ratio)
-                    {
-                        // Compensation didn't work, return back to previous decimator
-                        sloppy_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
-                    }
-
-                    if (sloppy_ratio < 0)
-                    {
-                        // Sloppy method didn't work, try with smaller decimation values
-                        {
-                            // Find a decimator that does work
-                            F32 sloppy_decimation_step = sqrt((F32)decimation); // example: 27->15->9->5->3
-                            F32 sloppy_decimator = indices_decimator / sloppy_decimation_step;
-                            U64Microseconds end_time = LLTimer::getTotalTime() + U64Seconds(5);
-
-                            while (sloppy_ratio < 0
-                                && sloppy_decimator > precise_ratio
-                                && sloppy_decimator > 1 // precise_ratio isn't supposed to be below 1, but check just in case
-                                && end_time > LLTimer::getTotalTime())
-                            {
-                                sloppy_ratio = genMeshOptimizerPerModel(base, target_model, sloppy_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
-                                sloppy_decimator = sloppy_decimator / sloppy_decimation_step;
-                            }
-                        }
-                    }
-
-                    if (sloppy_ratio < 0 || sloppy_ratio < precise_ratio)
-                    {
-                        // Sloppy variant failed to generate triangles or is worse.
-                        // Can happen with models that are too simple as is.
-
-                        if (precise_ratio < 0)
-                        {
-                            // Precise method failed as well, just copy face over
-                            target_model->copyVolumeFaces(base);
-                            precise_ratio = 1.f;
-                        }
-                        else
-                        {
-                            // Fallback to normal method
-                            precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
-                        }
-                        // <FS:Beq> Log stuff properly
-                        // LL_INFOS() << "Model " << target_model->getName()
-                        //     << " lod " << which_lod
-                        //     << " resulting ratio " << precise_ratio
-                        //     << " simplified using per model method." << LL_ENDL;
-                        {
-                            std::ostringstream out;
-                            out << "Model " << target_model->getName()
-                                << " lod " << which_lod
-                                << " resulting ratio " << precise_ratio
-                                << " simplified using per model method.";
-                            LL_INFOS() << out.str() << LL_ENDL;
-                            LLFloaterModelPreview::addStringToLog(out, false);
-                        }
-                        // </FS:Beq>
-                    }
-                    else
-                    {
-                        // <FS:Beq> Log stuff properly
-                        // LL_INFOS() << "Model " << target_model->getName()
-                        //     << " lod " << which_lod
-                        //     << " resulting ratio " << sloppy_ratio
-                        //     << " sloppily simplified using per model method." << LL_ENDL;
-                        std::ostringstream out;
-                        out << "Model " << target_model->getName()
-                            << " lod " << which_lod
-                            << " resulting ratio " << sloppy_ratio
-                            << " sloppily simplified using per model method.";
-                        LL_INFOS() << out.str() << LL_ENDL;
-                        LLFloaterModelPreview::addStringToLog(out, false);
-                        // </FS:Beq>
-                    }
-                }
-                else
-                {
-                        // <FS:Beq> Log stuff properly
-                        // LL_INFOS() << "Model " << target_model->getName()
-                        //     << " lod " << which_lod
-                        //     << " resulting ratio " << precise_ratio
-                        //     << " simplified using per model method." << LL_ENDL;
-                        std::ostringstream out;
-                        out << "Bad MeshOptimisation result for Model " << target_model->getName()
-                            << " lod " << which_lod
-                            << " resulting ratio " << precise_ratio
-                            << " simplified using per model method.";
-                        LL_WARNS() << out.str() << LL_ENDL;
-                        LLFloaterModelPreview::addStringToLog(out, true);
-                        // </FS:Beq>
-                }
-            }
+            LLModel* base = mBaseModel[mdl_idx];
+            LLModel* target_model = mModel[lod][mdl_idx];
 
             //blind copy skin weights and just take closest skin weight to point on
             //decimated mesh for now (auto-generating LODs with skin weights is still a bit
@@ -256,6 +256,9 @@ private:
         MESH_OPTIMIZER_NO_TOPOLOGY,
     } eSimplificationMode;
 
+    // Runs LLModel::generateNormals() over a model list on the parallel pool
+    static void generateNormals(LLModelLoader::model_list& models, F32 angle_cutoff);
+
     // Merges faces into single mesh, simplifies using mesh optimizer,
     // then splits back into faces.
     // Returns reached simplification ratio. -1 in case of a failure.
@@ -263,6 +266,11 @@ private:
     // Simplifies specified face using mesh optimizer.
     // Returns reached simplification ratio. -1 in case of a failure.
     F32 genMeshOptimizerPerFace(LLModel *base_model, LLModel *target_model, U32 face_idx, F32 indices_ratio, F32 error_threshold, eSimplificationMode simplification_mode);
+    // Simplifies base_model into target_model with the given meshopt_mode,
+    // falling back to cruder modes when the target can't be reached.
+    // Doesn't touch the preview's state, so models can be done in parallel.
+    void genMeshOptimizerModel(LLModel* base_model, LLModel* target_model, S32 which_lod, S32 meshopt_mode, U32 decimation,
+                               U32 lod_mode, F32 indices_decimator, F32 error_threshold);
 
 protected:
     friend class LLModelLoader;
@@ -587,6 +587,8 @@ LLSpatialGroup::LLSpatialGroup(OctreeNode* node, LLSpatialPartition* part) : LLO
     mVertexBuffer(NULL),
     mDistance(0.f),
     mDepth(0.f),
+    mAlphaSortRank(0),
+    mAlphaSortGeneration(0),
     mLastUpdateDistance(-1.f),
     mLastUpdateTime(gFrameTimeSeconds)
 {
@@ -1144,6 +1146,51 @@ public:
     }
 };
 
+// Worker thread flavor of the cullers above for LLSpatialPartition::cullDeferred().
+// Visible and occluded groups are recorded instead of being handed to the
+// pipeline, and occlusion queries are only listed for read back on the main
+// thread, since that needs the GL context.
+template <class CULLER>
+class LLOctreeCullDeferred : public CULLER
+{
+public:
+    LLOctreeCullDeferred(LLCamera* camera, LLSpatialPartition::DeferredCull& result)
+        : CULLER(camera), mResult(result) { }
+
+    virtual bool earlyFail(LLViewerOctreeGroup* base_group)
+    {
+        if (LLPipeline::sReflectionRender)
+        {
+            return false;
+        }
+
+        LLSpatialGroup* group = (LLSpatialGroup*)base_group;
+        if (LLPipeline::sUseOcclusion > 1)
+        {
+            mResult.mOcclusionChecks.push_back(group);
+        }
+
+        if (group->getOctreeNode() &&
+            group->getOctreeNode()->getParent() &&  //never occlusion cull the root node
+            LLPipeline::sUseOcclusion &&            //ignore occlusion if disabled
+            group->isOcclusionState(LLSpatialGroup::OCCLUDED))
+        {
+            mResult.mGroups.emplace_back(group, LLSpatialPartition::DeferredCull::OCCLUDED);
+            return true;
+        }
+
+        return false;
+    }
+
+    virtual void processGroup(LLViewerOctreeGroup* base_group)
+    {
+        mResult.mGroups.emplace_back((LLSpatialGroup*)base_group, LLSpatialPartition::DeferredCull::VISIBLE);
+    }
+
+private:
+    LLSpatialPartition::DeferredCull& mResult;
+};
+
 class LLOctreeCullVisExtents: public LLOctreeCullShadow
 {
 public:
@@ -1476,6 +1523,66 @@ S32 LLSpatialPartition::cull(LLCamera &camera, bool do_occlusion)
     return 0;
 }
 
+void LLSpatialPartition::prepareDeferredCull()
+{
+#if LL_OCTREE_PARANOIA_CHECK
+    ((LLSpatialGroup*)mOctree->getListener(0))->checkStates();
+#endif
+    LLSpatialGroup* group = (LLSpatialGroup*) mOctree->getListener(0);
+    group->rebound();
+
+#if LL_OCTREE_PARANOIA_CHECK
+    ((LLSpatialGroup*)mOctree->getListener(0))->validate();
+#endif
+}
+
+void LLSpatialPartition::cullDeferred(LLCamera& camera, DeferredCull& result)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_SPATIAL;
+
+    result.clear();
+
+    if (LLPipeline::sShadowRender)
+    {
+        LLOctreeCullDeferred<LLOctreeCullShadow> culler(&camera, result);
+        culler.traverse(mOctree);
+    }
+    else if (mInfiniteFarClip || (!LLPipeline::sUseFarClip && !gCubeSnapshot))
+    {
+        LLOctreeCullDeferred<LLOctreeCullNoFarClip> culler(&camera, result);
+        culler.traverse(mOctree);
+    }
+    else
+    {
+        LLOctreeCullDeferred<LLOctreeCull> culler(&camera, result);
+        culler.traverse(mOctree);
+    }
+}
+
+void LLSpatialPartition::applyDeferredCull(LLCamera& camera, const DeferredCull& result)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_SPATIAL;
+
+    for (const auto& entry : result.mGroups)
+    {
+        if (entry.second == DeferredCull::OCCLUDED)
+        {
+            gPipeline.markOccluder(entry.first);
+        }
+        else
+        {
+            gPipeline.markNotCulled(entry.first, camera);
+        }
+    }
+
+    // The traversal used last frame's occlusion state; pick up whatever
+    // queries have completed for the next one.
+    for (LLSpatialGroup* group : result.mOcclusionChecks)
+    {
+        group->checkOcclusion();
+    }
+}
+
 void pushVerts(LLDrawInfo* params)
 {
     LLRenderPass::applyModelMatrix(*params);
@@ -371,6 +371,9 @@ public:
 
     F32 mDistance;
     F32 mDepth;
+    // position in the last coherent alpha sort, see LLDrawPoolAlpha::sortAlphaGroups
+    U32 mAlphaSortRank;
+    U32 mAlphaSortGeneration;
     F32 mLastUpdateDistance;
     F32 mLastUpdateTime;
 
@@ -431,6 +434,30 @@ public:
     /*virtual*/ S32 cull(LLCamera &camera, bool do_occlusion=false); // Cull on arbitrary frustum
     S32 cull(LLCamera &camera, std::vector<LLDrawable *>* results, bool for_select); // Cull on arbitrary frustum
 
+    // Groups found by a deferred cull, in the order the serial cull would
+    // have handed them to the pipeline.
+    struct DeferredCull
+    {
+        enum EResult : U8
+        {
+            VISIBLE,    // gPipeline.markNotCulled()
+            OCCLUDED    // gPipeline.markOccluder()
+        };
+
+        std::vector<std::pair<LLSpatialGroup*, EResult> > mGroups;
+        std::vector<LLSpatialGroup*> mOcclusionChecks; // groups whose occlusion query should be read back
+
+        void clear() { mGroups.clear(); mOcclusionChecks.clear(); }
+    };
+
+    // Split version of cull() for parallel culling. prepareDeferredCull()
+    // and applyDeferredCull() must run on the main thread. cullDeferred()
+    // only reads the octree, so different partitions may be culled
+    // concurrently in between.
+    void prepareDeferredCull();
+    void cullDeferred(LLCamera& camera, DeferredCull& result);
+    void applyDeferredCull(LLCamera& camera, const DeferredCull& result);
+
     bool isVisible(const LLVector3& v);
     bool isHUDPartition() ;
 
@@ -73,6 +73,7 @@ LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sCacheReadLatency("texture
 LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sTexDecodeLatency("texture_decode_latency");
 LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sCacheWriteLatency("texture_write_latency");
 LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sTexFetchLatency("texture_fetch_latency");
+LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sTexFirstPixelLatency("texture_first_pixel_latency");
 
 LLTextureFetchTester* LLTextureFetch::sTesterp = NULL ;
 const std::string sTesterName("TextureFetchTester");
@@ -246,6 +247,9 @@ static const S32 HTTP_REQUESTS_RANGE_END_MAX = 20000000;
 static const S32 MAX_CAP_MISSING_RETRIES = 720;
 static const S32 CAP_MISSING_EXPIRATION_DELAY = 1; // seconds
 
+// Progressive fetches first request this many discard levels coarser than desired
+static const S32 PROGRESSIVE_FETCH_DISCARD_STEPS = 2;
+
 //////////////////////////////////////////////////////////////////////////////
 namespace
 {
@@ -366,6 +370,31 @@ private:
         LLUUID mID;
     };
 
+    class PreviewDecodeResponder : public LLImageDecodeThread::Responder
+    {
+    public:
+
+        // Threads:  Ttf
+        PreviewDecodeResponder(LLTextureFetch* fetcher, const LLUUID& id)
+            : mFetcher(fetcher), mID(id)
+        {
+        }
+
+        // Threads:  Tid
+        virtual void completed(bool success, const std::string& error_message, LLImageRaw* raw, LLImageRaw* aux, U32 request_id)
+        {
+            LL_PROFILE_ZONE_SCOPED;
+            LLTextureFetchWorker* worker = mFetcher->getWorker(mID);
+            if (worker)
+            {
+                worker->callbackPreviewDecoded(success, raw, aux, request_id);
+            }
+        }
+    private:
+        LLTextureFetch* mFetcher;
+        LLUUID mID;
+    };
+
     struct Compare
     {
         // lhs < rhs
@@ -404,6 +433,17 @@ public:
     // Threads:  Tid
     void callbackDecoded(bool success, const std::string& error_message, LLImageRaw* raw, LLImageRaw* aux, S32 decode_id);
 
+    // Threads:  Tid
+    void callbackPreviewDecoded(bool success, LLImageRaw* raw, LLImageRaw* aux, S32 decode_id);
+
+    // Threads:  T*
+    // Locks:  Mw
+    void setPreviewRange(S32 discard, S32 size)
+    {
+        mPreviewFetchDiscard = discard;
+        mPreviewFetchSize = size;
+    }
+
     // Threads:  T*
     void setGetStatus(LLCore::HttpStatus status, const std::string& reason)
     {
@@ -571,6 +611,8 @@ private:
     LLTimer mCacheWriteTimer;
     LLTimer mFetchTimer;
     LLTimer mStateTimer;
+    LLTimer mFirstPixelTimer;   // runs from worker creation until the first published image
+    bool mFirstPixelSampled;
     F32 mCacheReadTime; // time for cache read only
     F32 mDecodeTime;    // time for decode only
     F32 mCacheWriteTime;
@@ -597,6 +639,18 @@ private:
                                 mCanUseNET ; //can get from asset server. // <FS:Ansariel> OpenSim compatibility
     S32 mRetryAttempt;
     S32 mActiveCount;
+
+    // Progressive fetch: a fresh J2C fetch first asks for the bytes of a
+    // coarser discard level, decodes them from a copy while the remainder
+    // downloads and publishes the result as an intermediate image.
+    S32 mPreviewFetchDiscard;       // discard level of the first range, -1 for none
+    S32 mPreviewFetchSize;          // estimated bytes for mPreviewFetchDiscard
+    bool mPreviewRequest;           // in-flight HTTP request is the preview range
+    LLPointer<LLImageFormatted> mPreviewImage;
+    LLPointer<LLImageRaw>       mPreviewRaw,
+                                mPreviewAux;
+    S32 mPreviewDiscard;            // discard of mPreviewRaw, -1 until decoded
+    handle_t mPreviewDecodeHandle;
     LLCore::HttpStatus mGetStatus;
     std::string mGetReason;
     LLAdaptiveRetryPolicy mFetchRetryPolicy;
@@ -920,6 +974,7 @@ LLTextureFetchWorker::LLTextureFetchWorker(LLTextureFetch* fetcher,
       mCacheWriteTime(0.f),
       mDecodeTime(0.f),
       mFetchTime(0.f),
+      mFirstPixelSampled(false),
       mCacheReadHandle(LLTextureCache::nullHandle()),
       mCacheWriteHandle(LLTextureCache::nullHandle()),
       mRequestedSize(0),
@@ -940,6 +995,11 @@ LLTextureFetchWorker::LLTextureFetchWorker(LLTextureFetch* fetcher,
       mCanUseHTTP(true),
       mRetryAttempt(0),
       mActiveCount(0),
+      mPreviewFetchDiscard(-1),
+      mPreviewFetchSize(0),
+      mPreviewRequest(false),
+      mPreviewDiscard(-1),
+      mPreviewDecodeHandle(0),
       mWorkMutex(),
       // <FS:Ansariel> OpenSim compatibility
       mFirstPacket(0),
@@ -1231,6 +1291,12 @@ bool LLTextureFetchWorker::doWork(S32 param)
         mSentRequest = UNSENT;
         mDecoded  = false;
         mWritten  = false;
+        mPreviewRequest = false;
+        mPreviewImage = NULL;
+        mPreviewRaw = NULL;
+        mPreviewAux = NULL;
+        mPreviewDiscard = -1;
+        mPreviewDecodeHandle = 0;
         if (mHttpBufferArray)
         {
             mHttpBufferArray->release();
@@ -1598,6 +1664,18 @@ bool LLTextureFetchWorker::doWork(S32 param)
         }
         mRequestedSize = mDesiredSize;
         mRequestedDiscard = mDesiredDiscard;
+        mPreviewRequest = false;
+        static LLCachedControl<bool> progressive_fetch(gSavedSettings, "TextureFetchProgressive", true);
+        if (progressive_fetch && !disable_range_req &&
+            mPreviewFetchDiscard > mDesiredDiscard &&
+            cur_size < mPreviewFetchSize && mPreviewFetchSize < mDesiredSize / 2)
+        {
+            // Ask for the coarse layers first, they get decoded while the
+            // rest of the file is requested (see WAIT_HTTP_REQ)
+            mRequestedSize = mPreviewFetchSize;
+            mRequestedDiscard = mPreviewFetchDiscard;
+            mPreviewRequest = true;
+        }
         mRequestedSize -= cur_size;
         mRequestedOffset = cur_size;
         if (mRequestedOffset)
@@ -1692,6 +1770,10 @@ bool LLTextureFetchWorker::doWork(S32 param)
         if (mLoaded)
         {
             S32 cur_size = mFormattedImage.notNull() ? mFormattedImage->getDataSize() : 0;
+            // a short preview reply is the whole file, finish it as usual
+            const bool preview_request = mPreviewRequest;
+            const bool preview_pass = preview_request && !mHaveAllData && mRequestedSize >= 0;
+            mPreviewRequest = false;
             if (mRequestedSize < 0)
             {
                 if (http_not_found == mGetStatus)
@@ -1802,7 +1884,7 @@ bool LLTextureFetchWorker::doWork(S32 param)
             // Clear the url since we're done with the fetch
             // Note: mUrl is used to check is fetching is required so failure to clear it will force an http fetch
             // next time the texture is requested, even if the data have already been fetched.
-            if(mWriteToCacheState != NOT_WRITE && mFTType != FTT_SERVER_BAKE)
+            if(mWriteToCacheState != NOT_WRITE && mFTType != FTT_SERVER_BAKE && !preview_pass)
             {
                 // Why do we want to keep url if NOT_WRITE - is this a proxy for map tiles?
                 mUrl.clear();
@@ -1896,7 +1978,30 @@ bool LLTextureFetchWorker::doWork(S32 param)
             mHttpReplySize = 0;
             mHttpReplyOffset = 0;
 
-            mLoadedDiscard = mRequestedDiscard;
+            if (preview_pass)
+            {
+                // Decode the coarse layers from a copy, the formatted image
+                // keeps growing while the decode thread works on it
+                LLPointer<LLImageFormatted> preview = LLImageFormatted::createFromType(mFormattedImage->getCodec());
+                U8* preview_data = preview.notNull() ? (U8*)ll_aligned_malloc_16(total_size) : NULL;
+                if (preview_data)
+                {
+                    memcpy(preview_data, mFormattedImage->getData(), total_size);
+                    preview->setData(preview_data, total_size);
+                    mPreviewImage = preview;
+                    mPreviewDecodeHandle = LLAppViewer::getImageDecodeThread()->decodeImage(preview,
+                                                                                          mRequestedDiscard,
+                                                                                          mNeedsAux,
+                                                                                          new PreviewDecodeResponder(mFetcher, mID));
+                }
+                LL_DEBUGS(LOG_TXT) << mID << ": Preview decode. Bytes: " << total_size << " Discard: " << mRequestedDiscard << LL_ENDL;
+
+                // Still holding the HTTP resource, go straight back for the rest
+                setState(SEND_HTTP_REQ);
+                return false;
+            }
+
+            mLoadedDiscard = preview_request ? mDesiredDiscard : mRequestedDiscard;
             if (mLoadedDiscard < 0)
             {
                 LL_WARNS(LOG_TXT) << mID << " mLoadedDiscard is " << mLoadedDiscard
@@ -2607,6 +2712,27 @@ void LLTextureFetchWorker::callbackDecoded(bool success, const std::string &erro
 //  LL_INFOS(LOG_TXT) << mID << " : DECODE COMPLETE " << LL_ENDL;
 }                                                                       // -Mw
 
+// Threads:  Tid
+void LLTextureFetchWorker::callbackPreviewDecoded(bool success, LLImageRaw* raw, LLImageRaw* aux, S32 decode_id)
+{
+    LLMutexLock lock(&mWorkMutex);                                      // +Mw
+    if (mPreviewDecodeHandle == 0 || mPreviewDecodeHandle != decode_id)
+    {
+        return; // reset or superseded, ignore
+    }
+    mPreviewDecodeHandle = 0;
+    if (success && raw && mPreviewImage.notNull())
+    {
+        mPreviewRaw = raw;
+        mPreviewAux = aux;
+        mPreviewDiscard = mPreviewImage->getDiscardLevel();
+        LL_DEBUGS(LOG_TXT) << mID << ": Preview Decode Finished. Discard: " << mPreviewDiscard
+                           << " Raw Image: " << llformat("%dx%d", raw->getWidth(), raw->getHeight()) << LL_ENDL;
+    }
+    // a failed preview is not fatal, the full decode follows
+    mPreviewImage = NULL;
+}                                                                       // -Mw
+
 //////////////////////////////////////////////////////////////////////////////
 
 // Threads:  Ttf
@@ -2823,6 +2949,17 @@ S32 LLTextureFetch::createRequest(FTType f_type, const std::string& url, const L
         desired_discard = MAX_DISCARD_LEVEL;
     }
 
+    // With known dimensions, a large J2C fetch can be split so a coarse
+    // version shows up while the rest downloads
+    S32 preview_discard = -1;
+    S32 preview_size = 0;
+    if (w*h*c > 0 && desired_discard + PROGRESSIVE_FETCH_DISCARD_STEPS <= MAX_DISCARD_LEVEL &&
+        f_type == FTT_DEFAULT && (exten.empty() || LLImageBase::getCodecFromExtension(exten) == IMG_CODEC_J2C))
+    {
+        preview_discard = desired_discard + PROGRESSIVE_FETCH_DISCARD_STEPS;
+        preview_size = LLImageJ2C::calcDataSizeJ2C(w, h, c, preview_discard);
+    }
+
 
     if (worker)
     {
@@ -2840,6 +2977,7 @@ S32 LLTextureFetch::createRequest(FTType f_type, const std::string& url, const L
         worker->mNeedsAux = needs_aux;
         worker->setImagePriority(priority);
         worker->setDesiredDiscard(desired_discard, desired_size);
+        worker->setPreviewRange(preview_discard, preview_size);
         worker->setCanUseHTTP(can_use_http);
 
         //MAINT-4184 url is always empty.  Do not set with it.
@@ -2867,6 +3005,7 @@ S32 LLTextureFetch::createRequest(FTType f_type, const std::string& url, const L
         worker->mActiveCount++;
         worker->mNeedsAux = needs_aux;
         worker->setCanUseHTTP(can_use_http) ;
+        worker->setPreviewRange(preview_discard, preview_size);
         worker->unlockWorkMutex();                                      // -Mw
     }
 
@@ -3085,6 +3224,7 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level, S3
         {
             F32 decode_time;
             F32 fetch_time;
+            F32 first_pixel_time = -1.f;
             F32 cache_read_time;
             F32 cache_write_time;
             S32 file_size;
@@ -3095,6 +3235,14 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level, S3
             discard_level = worker->mDecodedDiscard;
             raw = worker->mRawImage;
             aux = worker->mAuxImage;
+            worker->mPreviewRaw = NULL;
+            worker->mPreviewAux = NULL;
+            worker->mPreviewDiscard = -1;
+            if (raw.notNull() && !worker->mFirstPixelSampled)
+            {
+                worker->mFirstPixelSampled = true;
+                first_pixel_time = worker->mFirstPixelTimer.getElapsedTimeF32();
+            }
 
             decode_time = worker->mDecodeTime;
             fetch_time = worker->mFetchTime;
@@ -3116,6 +3264,10 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level, S3
             sample(sTexFetchLatency, fetch_time);
             sample(sCacheReadLatency, cache_read_time);
             sample(sCacheWriteLatency, cache_write_time);
+            if (first_pixel_time >= 0.f)
+            {
+                sample(sTexFirstPixelLatency, first_pixel_time);
+            }
 
             static LLCachedControl<F32> min_time_to_log(gSavedSettings, "TextureFetchMinTimeToLog", 2.f);
             if (fetch_time > min_time_to_log)
@@ -3131,6 +3283,7 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level, S3
         }
         else
         {
+            F32 first_pixel_time = -1.f;
             worker->lockWorkMutex();                                    // +Mw
             if ((worker->mDecodedDiscard >= 0) &&
                 (worker->mDecodedDiscard < discard_level || discard_level < 0) &&
@@ -3141,7 +3294,25 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level, S3
                 raw = worker->mRawImage;
                 aux = worker->mAuxImage;
             }
+            else if ((worker->mPreviewDiscard >= 0) &&
+                     (worker->mPreviewDiscard < discard_level || discard_level < 0))
+            {
+                // Still downloading, but the coarse layers are decoded
+                discard_level = worker->mPreviewDiscard;
+                raw = worker->mPreviewRaw;
+                aux = worker->mPreviewAux;
+            }
+            if (raw.notNull() && !worker->mFirstPixelSampled)
+            {
+                worker->mFirstPixelSampled = true;
+                first_pixel_time = worker->mFirstPixelTimer.getElapsedTimeF32();
+            }
             worker->unlockWorkMutex();                                  // -Mw
+
+            if (first_pixel_time >= 0.f)
+            {
+                sample(sTexFirstPixelLatency, first_pixel_time);
+            }
         }
     }
     else
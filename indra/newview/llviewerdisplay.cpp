@@ -224,7 +224,8 @@ void display_update_camera()
     F32 final_far = gAgentCamera.mDrawDistance;
     if (gCubeSnapshot)
     {
-        final_far = gSavedSettings.getF32("RenderReflectionProbeDrawDistance");
+        static LLCachedControl<F32> probe_draw_distance(gSavedSettings, "RenderReflectionProbeDrawDistance");
+        final_far = probe_draw_distance;
     }
     else if (CAMERA_MODE_CUSTOMIZE_AVATAR == gAgentCamera.getCameraMode())
 
@@ -312,6 +313,7 @@ static void update_tp_display(bool minimized)
         gViewerWindow->setShowProgress(false, false);
     }
 
+    static LLCachedControl<bool> disable_teleport_screens(gSavedSettings, "FSDisableTeleportScreens");
     const std::string& message = gAgent.getTeleportMessage();
     switch (gAgent.getTeleportState())
     {
@@ -321,7 +323,7 @@ static void update_tp_display(bool minimized)
             const std::string& msg = LLAgent::sTeleportProgressMessages["pending"];
             if (!minimized)
             {
-                gViewerWindow->setShowProgress(true, !gSavedSettings.getBOOL("FSDisableTeleportScreens"));
+                gViewerWindow->setShowProgress(true, !disable_teleport_screens);
                 gViewerWindow->setProgressPercent(llmin(teleport_percent, 0.0f));
                 gViewerWindow->setProgressString(msg);
             }
@@ -358,7 +360,7 @@ static void update_tp_display(bool minimized)
             FSData::instance().selectNextMOTD();
             if (!minimized)
             {
-                gViewerWindow->setShowProgress(true, !gSavedSettings.getBOOL("FSDisableTeleportScreens"));
+                gViewerWindow->setShowProgress(true, !disable_teleport_screens);
                 gViewerWindow->setProgressPercent(llmin(teleport_percent, 0.0f));
                 gViewerWindow->setProgressString(msg);
                 gViewerWindow->setProgressMessage(gAgent.mMOTD);
@@ -712,11 +714,12 @@ void display(bool rebuild, F32 zoom_factor, int subfield, bool for_snapshot)
             gSavedSettings.setF32("FSSavedRenderFarClip", 0.0f);
         }
 
-        if (gTeleportArrivalTimer.getElapsedTimeF32() >=
-            (F32)gSavedSettings.getU32("FSRenderFarClipSteppingInterval"))
+        static LLCachedControl<U32> stepping_interval(gSavedSettings, "FSRenderFarClipSteppingInterval");
+        static LLCachedControl<F32> render_far_clip(gSavedSettings, "RenderFarClip");
+        if (gTeleportArrivalTimer.getElapsedTimeF32() >= (F32)stepping_interval())
         {
             gTeleportArrivalTimer.reset();
-            F32 current = gSavedSettings.getF32("RenderFarClip");
+            F32 current = render_far_clip;
             if (gSavedDrawDistance > current)
             {
                 current *= 2.0f;
@@ -1500,6 +1500,21 @@ class LLAdvancedDumpRegionObjectCache : public view_listener_t
     }
 };
 
+
+///////////////////////////////
+// DUMP SHARED VOLUME DATA   //
+///////////////////////////////
+
+
+class LLAdvancedDumpSharedVolumeData : public view_listener_t
+{
+    bool handleEvent(const LLSD& userdata)
+    {
+        LLVolumeFaceSharedData::dump();
+        return true;
+    }
+};
+
 class LLAdvancedToggleInterestList360Mode : public view_listener_t
 {
 public:
@@ -12601,6 +12616,7 @@ void initialize_menus()
     // Advanced > World
     view_listener_t::addMenu(new LLAdvancedDumpScriptedCamera(), "Advanced.DumpScriptedCamera");
     view_listener_t::addMenu(new LLAdvancedDumpRegionObjectCache(), "Advanced.DumpRegionObjectCache");
+    view_listener_t::addMenu(new LLAdvancedDumpSharedVolumeData(), "Advanced.DumpSharedVolumeData");
     view_listener_t::addMenu(new LLAdvancedToggleStatsRecorder(), "Advanced.ToggleStatsRecorder");
     view_listener_t::addMenu(new LLAdvancedCheckStatsRecorder(), "Advanced.CheckStatsRecorder");
     view_listener_t::addMenu(new LLAdvancedToggleInterestList360Mode(), "Advanced.ToggleInterestList360Mode");
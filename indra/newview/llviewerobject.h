@@ -981,6 +981,7 @@ public:
     void setLastUpdateType(EObjectUpdateType last_update_type);
     bool getLastUpdateCached() const;
     void setLastUpdateCached(bool last_update_cached);
+    F64Seconds getLastMessageUpdateSecs() const { return mLastMessageUpdateSecs; }
 
     virtual void updateRiggingInfo() {}
 
@@ -42,9 +42,14 @@
 #include "llspatialpartition.h"
 #include "llvoavatarself.h"
 #include "llvovolume.h"
+#include "parallelfor.h"
 
 const F32 PART_SIM_BOX_SIDE = 16.f;
 
+// Groups with at least twice this many particles have their integration pass
+// split across the LL::parallel_for() worker pool.
+const size_t PART_PARALLEL_CHUNK_SIZE = 512;
+
 //static
 S32 LLViewerPartSim::sMaxParticleCount = 0;
 std::atomic<S32> LLViewerPartSim::sParticleCount{0}; // <FS:Beq/> FIRE-34600 - bugsplat AVX2 particle count mismatch
@@ -65,9 +70,9 @@ const F32 LLViewerPartSim::PART_ADAPT_RATE_MULT_RECIP = 1.0f/PART_ADAPT_RATE_MUL
 
 U32 LLViewerPart::sNextPartID = 1;
 
-F32 calc_desired_size(LLViewerCamera* camera, LLVector3 pos, LLVector2 scale)
+F32 calc_desired_size(const LLVector3& camera_origin, const LLVector3& pos, const LLVector2& scale)
 {
-    F32 desired_size = (pos - camera->getOrigin()).magVec();
+    F32 desired_size = (pos - camera_origin).magVec();
     desired_size /= 4;
     return llclamp(desired_size, scale.magVec()*0.5f, PART_SIM_BOX_SIDE*2);
 }
@@ -275,29 +280,28 @@ bool LLViewerPartGroup::addPart(LLViewerPart* part, F32 desired_size)
 
 void LLViewerPartGroup::updateParticles(const F32 lastdt)
 {
-    F32 dt;
-
-    LLVector3 gravity(0.f, 0.f, GRAVITY);
+    LL_PROFILE_ZONE_SCOPED;
 
     LLViewerPartSim::checkParticleCount(static_cast<U32>(mParticles.size()));
 
     LLViewerCamera* camera = LLViewerCamera::getInstance();
     LLViewerRegion *regionp = getRegion();
-    // <FS:Beq> FIRE-34600 - Bugsplat AVX2 particle count mismatch    
-    // S32 end = (S32) mParticles.size();
-    bool changed = false;
-    // </FS:Beq>
-    for (S32 i = 0 ; i < (S32)mParticles.size();)
+
+    const S32 count = (S32) mParticles.size();
+    mPartDt.resize(count);
+    mPartSourcePos.resize(count);
+    mPartFate.resize(count);
+
+    // First pass: everything that touches state outside of the particle
+    // itself (sources, callbacks, region wind) stays serial. Its results are
+    // gathered into the per-group arrays read by the integration pass.
+    for (S32 i = 0; i < count; i++)
     {
-        LLVector3 a(0.f, 0.f, 0.f);
-        LLViewerPart* part = mParticles[i] ;
+        LLViewerPart* part = mParticles[i];
 
-        dt = lastdt + mSkippedTime - part->mSkipOffset;
+        const F32 dt = lastdt + mSkippedTime - part->mSkipOffset;
         part->mSkipOffset = 0.f;
-
-        // Update current time
-        const F32 cur_time = part->mLastUpdateTime + dt;
-        const F32 frac = cur_time / part->mMaxAge;
+        mPartDt[i] = dt;
 
         // "Drift" the object based on the source object
         if (part->mFlags & LLPartData::LL_PART_FOLLOW_SRC_MASK)
@@ -336,52 +340,165 @@ void LLViewerPartGroup::updateParticles(const F32 lastdt)
             part->mVelocity += step*delta_pos;
         }
 
-
         if (part->mFlags & LLPartData::LL_PART_TARGET_LINEAR_MASK)
         {
+            const F32 frac = (part->mLastUpdateTime + dt) / part->mMaxAge;
             LLVector3 delta_pos = part->mPartSourcep->mTargetPosAgent - part->mPartSourcep->mPosAgent;
             part->mPosAgent = part->mPartSourcep->mPosAgent;
             part->mPosAgent += frac*delta_pos;
             part->mVelocity = delta_pos;
         }
-        else
+
+        if (part->mFlags & (LLPartData::LL_PART_BOUNCE_MASK | LLPartData::LL_PART_FOLLOW_SRC_MASK))
         {
-            // Do velocity interpolation
-            part->mPosAgent += dt*part->mVelocity;
-            part->mPosAgent += 0.5f*dt*dt*part->mAccel;
-            part->mVelocity += part->mAccel*dt;
+            mPartSourcePos[i].load3(part->mPartSourcep->mPosAgent.mV);
+        }
+    }
+
+    // Second pass: integration, bounce and color/scale/glow interpolation
+    // only read and write the particle itself, so large groups are split
+    // across the worker pool.
+    LLVector3 camera_origin = camera->getOrigin();
+    LL::parallel_for(count, PART_PARALLEL_CHUNK_SIZE,
+                     [this, &camera_origin](size_t begin, size_t end)
+                     {
+                         integrateParticles((S32) begin, (S32) end, camera_origin);
+                     });
+
+    // Last pass: drop dead particles and hand off the ones that left the
+    // group, keeping the survivors in their current order.
+    bool changed = false;
+    S32 kept = 0;
+    std::vector<LLViewerPart*> transfers;
+    for (S32 i = 0; i < count; i++)
+    {
+        LLViewerPart* part = mParticles[i];
+        switch (mPartFate[i])
+        {
+        case PART_FATE_DEAD:
+            --LLViewerPartSim::sParticleCount;
+            delete part;
+            changed = true;
+            break;
+        case PART_FATE_TRANSFER:
+            // put() uses addPart() when successful, which increases
+            // sParticleCount by 1 even though it has stayed the same. If it
+            // is not successful then we need to decrease by 1, so a decrement
+            // here works for both cases.
+            --LLViewerPartSim::sParticleCount;
+            transfers.push_back(part);
+            changed = true;
+            break;
+        default:
+            mParticles[kept++] = part;
+            break;
         }
+    }
+    mParticles.resize(kept);
+
+    for (LLViewerPart* part : transfers)
+    {
+        // Transfer particles between groups
+        LLViewerPartSim::getInstance()->put(part);
+    }
 
-        // Do a bounce test
-        if (part->mFlags & LLPartData::LL_PART_BOUNCE_MASK)
+    if (changed)
+    {
+        if (mVOPartGroupp.notNull())
         {
-            // Need to do point vs. plane check...
-            // For now, just check relative to object height...
-            F32 dz = part->mPosAgent.mV[VZ] - part->mPartSourcep->mPosAgent.mV[VZ];
+            gPipeline.markRebuild(mVOPartGroupp->mDrawable, LLDrawable::REBUILD_ALL);
+        }
+    }
+
+    // Kill the viewer object if this particle group is empty
+    if (mParticles.empty())
+    {
+        gObjectList.killObject(mVOPartGroupp);
+        mVOPartGroupp = NULL;
+    }
+
+    LLViewerPartSim::checkParticleCount() ;
+}
+
+void LLViewerPartGroup::integrateParticles(S32 begin, S32 end, const LLVector3& camera_origin)
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    LLVector4a pos;
+    LLVector4a vel;
+    LLVector4a accel;
+    LLVector4a tmp;
+    LLVector4a color;
+    LLVector4a end_color;
+
+    for (S32 i = begin; i < end; i++)
+    {
+        LLViewerPart* part = mParticles[i];
+
+        const F32 dt = mPartDt[i];
+        const F32 cur_time = part->mLastUpdateTime + dt;
+        const F32 frac = cur_time / part->mMaxAge;
+
+        pos.load3(part->mPosAgent.mV);
+
+        if (!(part->mFlags & LLPartData::LL_PART_TARGET_LINEAR_MASK))
+        {
+            // Do velocity interpolation
+            vel.load3(part->mVelocity.mV);
+            accel.load3(part->mAccel.mV);
+
+            // pos += dt*vel + 0.5*dt*dt*accel
+            tmp.setMul(vel, dt);
+            pos.add(tmp);
+            tmp.setMul(accel, 0.5f*dt*dt);
+            pos.add(tmp);
+
+            // vel += accel*dt
+            tmp.setMul(accel, dt);
+            vel.add(tmp);
+
+            // Do a bounce test
+            if (part->mFlags & LLPartData::LL_PART_BOUNCE_MASK)
+            {
+                // Need to do point vs. plane check...
+                // For now, just check relative to object height...
+                F32 dz = pos[VZ] - mPartSourcePos[i][VZ];
+                if (dz < 0)
+                {
+                    pos.getF32ptr()[VZ] += -2.f*dz;
+                    vel.getF32ptr()[VZ] *= -0.75f;
+                }
+            }
+
+            part->mVelocity.set(vel.getF32ptr());
+        }
+        else if (part->mFlags & LLPartData::LL_PART_BOUNCE_MASK)
+        {
+            F32 dz = pos[VZ] - mPartSourcePos[i][VZ];
             if (dz < 0)
             {
-                part->mPosAgent.mV[VZ] += -2.f*dz;
+                pos.getF32ptr()[VZ] += -2.f*dz;
                 part->mVelocity.mV[VZ] *= -0.75f;
             }
         }
 
+        part->mPosAgent.set(pos.getF32ptr());
 
         // Reset the offset from the source position
         if (part->mFlags & LLPartData::LL_PART_FOLLOW_SRC_MASK)
         {
-            part->mPosOffset = part->mPosAgent;
-            part->mPosOffset -= part->mPartSourcep->mPosAgent;
+            tmp.setSub(pos, mPartSourcePos[i]);
+            part->mPosOffset.set(tmp.getF32ptr());
         }
 
         // Do color interpolation
         if (part->mFlags & LLPartData::LL_PART_INTERP_COLOR_MASK)
         {
-            part->mColor.setVec(part->mStartColor);
-            // note: LLColor4's v%k means multiply-alpha-only,
-            //       LLColor4's v*k means multiply-rgb-only
-            part->mColor *= 1.f - frac; // rgb*k
-            part->mColor %= 1.f - frac; // alpha*k
-            part->mColor += frac%(frac*part->mEndColor); // rgb,alpha
+            // rgb and alpha both lerp from start to end color
+            color.loadua(part->mStartColor.mV);
+            end_color.loadua(part->mEndColor.mV);
+            color.setLerp(color, end_color, frac);
+            part->mColor.set(color.getF32ptr());
         }
 
         // Do scale interpolation
@@ -398,77 +515,19 @@ void LLViewerPartGroup::updateParticles(const F32 lastdt)
         // Set the last update time to now.
         part->mLastUpdateTime = cur_time;
 
-
         // Kill dead particles (either flagged dead, or too old)
         if ((part->mLastUpdateTime > part->mMaxAge) || (LLViewerPart::LL_PART_DEAD_MASK == part->mFlags))
         {
-            // <FS:Beq> FIRE-34600 - Bugsplat AVX2 particle count mismatch
-            // mParticles[i] = mParticles.back() ;
-            // mParticles.pop_back() ;
-            // delete part ;
-            vector_replace_with_last(mParticles, mParticles.begin() + i);
-            --LLViewerPartSim::sParticleCount; 
-            delete part ;
-            changed = true; 
-            // </FS:Beq>
+            mPartFate[i] = PART_FATE_DEAD;
         }
         else
         {
-            F32 desired_size = calc_desired_size(camera, part->mPosAgent, part->mScale);
-            if (!posInGroup(part->mPosAgent, desired_size))
-            {
-                // Transfer particles between groups
-                // <FS:Beq> FIRE-34600 - Bugsplat AVX2 particle count mismatch
-                // LLViewerPartSim::getInstance()->put(part) ;
-                // mParticles[i] = mParticles.back() ;
-                // mParticles.pop_back() ;                
-                vector_replace_with_last(mParticles, mParticles.begin() + i); 
-                LLViewerPartSim::getInstance()->put(part) ; 
-                // Note: put() uses addpart when succesful, this increase sParticleCount by 1
-                // even though it has stayed the same. If it is not succesful then we need to decrease by 1
-                // so a decrement here works for both cases.
-                --LLViewerPartSim::sParticleCount; 
-                changed = true;
-                // </FS:Beq>
-            }
-            else
-            {
-                i++ ;
-            }
-        }
-    }
-
-    // <FS:Beq> FIRE-34600 - Bugsplat AVX2 particle count mismatch
-    // S32 removed = end - (S32)mParticles.size();
-    // if (removed > 0)
-    // {
-    //     // we removed one or more particles, so flag this group for update
-    //     if (mVOPartGroupp.notNull())
-    //     {
-    //         gPipeline.markRebuild(mVOPartGroupp->mDrawable, LLDrawable::REBUILD_ALL);
-    //     }
-    //     LLViewerPartSim::decPartCount(removed);
-    // }    
-    if (changed)
-    {
-        if (mVOPartGroupp.notNull())
-        {
-            gPipeline.markRebuild(mVOPartGroupp->mDrawable, LLDrawable::REBUILD_ALL);
+            F32 desired_size = calc_desired_size(camera_origin, part->mPosAgent, part->mScale);
+            mPartFate[i] = posInGroup(part->mPosAgent, desired_size) ? PART_FATE_KEEP : PART_FATE_TRANSFER;
         }
     }
-    // </FS:Beq>
-
-    // Kill the viewer object if this particle group is empty
-    if (mParticles.empty())
-    {
-        gObjectList.killObject(mVOPartGroupp);
-        mVOPartGroupp = NULL;
-    }
-
-    LLViewerPartSim::checkParticleCount() ;
 }
 
-
 void LLViewerPartGroup::shift(const LLVector3 &offset)
 {
     mCenterAgent += offset;
@@ -639,7 +698,7 @@ LLViewerPartGroup *LLViewerPartSim::put(LLViewerPart* part)
     else
     {
         LLViewerCamera* camera = LLViewerCamera::getInstance();
-        F32 desired_size = calc_desired_size(camera, part->mPosAgent, part->mScale);
+        F32 desired_size = calc_desired_size(camera->getOrigin(), part->mPosAgent, part->mScale);
 
         S32 count = (S32) mViewerPartGroups.size();
         for (S32 i = 0; i < count; i++)
@@ -30,6 +30,7 @@
 #include "llframetimer.h"
 #include "llpointer.h"
 #include "llpartdata.h"
+#include "llvector4a.h"
 #include "llviewerpartsource.h"
 
 class LLViewerTexture;
@@ -124,6 +125,24 @@ public:
     bool mHud;
 
 protected:
+    // Integrate, bounce and interpolate particles [begin, end). Only touches
+    // the particles themselves and the per-particle arrays below, so disjoint
+    // ranges may run concurrently.
+    void integrateParticles(S32 begin, S32 end, const LLVector3& camera_origin);
+
+    enum EPartFate : U8
+    {
+        PART_FATE_KEEP,
+        PART_FATE_DEAD,
+        PART_FATE_TRANSFER
+    };
+
+    // Per-particle frame state, indexed like mParticles and refilled by each
+    // updateParticles() pass.
+    std::vector<F32>        mPartDt;            // time step including skipped time
+    std::vector<LLVector4a> mPartSourcePos;     // source position, for bounce and follow-source particles
+    std::vector<U8>         mPartFate;          // EPartFate after integration
+
     LLVector3 mCenterAgent;
     F32 mBoxRadius;
     F32 mBoxSide;
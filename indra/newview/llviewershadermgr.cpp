@@ -841,6 +841,13 @@ std::string LLViewerShaderMgr::loadBasicShaders()
 
     LLGLSLShader::sGlobalDefines = attribs;
 
+    std::vector<LLShaderSourceCache::Request> requests;
+    for (const auto& [filename, level] : shaders)
+    {
+        requests.emplace_back(filename, level, GL_VERTEX_SHADER, &attribs);
+    }
+    prefetchShaderSources(requests);
+
     // We no longer have to bind the shaders to global glhandles, they are automatically added to a map now.
     for (U32 i = 0; i < shaders.size(); i++)
     {
@@ -885,6 +892,13 @@ std::string LLViewerShaderMgr::loadBasicShaders()
     index_channels.push_back(ch);    shaders.push_back( make_pair( "lighting/lightF.glsl",                  mShaderLevel[SHADER_LIGHTING] ) );
     index_channels.push_back(ch);    shaders.push_back( make_pair( "lighting/lightAlphaMaskF.glsl",                 mShaderLevel[SHADER_LIGHTING] ) );
 
+    requests.clear();
+    for (U32 i = 0; i < shaders.size(); i++)
+    {
+        requests.emplace_back(shaders[i].first, shaders[i].second, GL_FRAGMENT_SHADER, &attribs, index_channels[i]);
+    }
+    prefetchShaderSources(requests);
+
     for (U32 i = 0; i < shaders.size(); i++)
     {
         // Note usage of GL_FRAGMENT_SHADER
@@ -230,7 +230,8 @@ LLTrace::SampleStatHandle<F64Milliseconds > FRAMETIME_JITTER("frametimejitter",
 
 LLTrace::EventStatHandle<LLUnit<F64, LLUnits::Meters> > AGENT_POSITION_SNAP("agentpositionsnap", "agent position corrections");
 
-LLTrace::EventStatHandle<>  LOADING_WEARABLES_LONG_DELAY("loadingwearableslongdelay", "Wearables took too long to load");
+LLTrace::EventStatHandle<>  LOADING_WEARABLES_LONG_DELAY("loadingwearableslongdelay", "Wearables took too long to load"),
+                            SETTINGS_NAME_LOOKUPS("settingsnamelookups", "Settings looked up by name per frame");
 
 LLTrace::EventStatHandle<F64Milliseconds >  REGION_CROSSING_TIME("regioncrossingtime", "CROSSING_AVG"),
                                                                 FRAME_STACKTIME("framestacktime", "FRAME_SECS"),
@@ -242,7 +243,8 @@ LLTrace::EventStatHandle<F64Milliseconds >  REGION_CROSSING_TIME("regioncrossing
 
 LLTrace::EventStatHandle<F64Seconds >   AVATAR_EDIT_TIME("avataredittime", "Seconds in Edit Appearance"),
                                                             TOOLBOX_TIME("toolboxtime", "Seconds using Toolbox"),
-                                                            MOUSELOOK_TIME("mouselooktime", "Seconds in Mouselook");
+                                                            MOUSELOOK_TIME("mouselooktime", "Seconds in Mouselook"),
+                                                            MESH_VISIBLE_COMPLETE_TIME("meshvisiblecompletetime", "Seconds after login or teleport until every visible mesh had loaded");
 
 LLTrace::EventStatHandle<LLUnit<F32, LLUnits::Percent> > OBJECT_CACHE_HIT_RATE("object_cache_hits");
 
@@ -281,6 +283,12 @@ void LLViewerStats::updateFrameStats(const F64Seconds time_diff)
     }
 
     mLastTimeDiff = time_diff;
+
+    // settings read through getters instead of an LLCachedControl
+    static U32 last_lookups = 0;
+    const U32 lookups = gSavedSettings.getNameLookupCount();
+    record(LLStatViewer::SETTINGS_NAME_LOOKUPS, lookups - last_lookups);
+    last_lookups = lookups;
 }
 
 void LLViewerStats::addToMessage(LLSD &body)
@@ -218,7 +218,8 @@ extern LLTrace::SampleStatHandle<F64Milliseconds >  FRAMETIME_JITTER,
 
 extern LLTrace::EventStatHandle<LLUnit<F64, LLUnits::Meters> > AGENT_POSITION_SNAP;
 
-extern LLTrace::EventStatHandle<>   LOADING_WEARABLES_LONG_DELAY;
+extern LLTrace::EventStatHandle<>   LOADING_WEARABLES_LONG_DELAY,
+                                    SETTINGS_NAME_LOOKUPS;
 
 extern LLTrace::EventStatHandle<F64Milliseconds >   REGION_CROSSING_TIME,
                                                         FRAME_STACKTIME,
@@ -230,7 +231,8 @@ extern LLTrace::EventStatHandle<F64Milliseconds >   REGION_CROSSING_TIME,
 
 extern LLTrace::EventStatHandle<F64Seconds >    AVATAR_EDIT_TIME,
                                                                 TOOLBOX_TIME,
-                                                                MOUSELOOK_TIME;
+                                                                MOUSELOOK_TIME,
+                                                                MESH_VISIBLE_COMPLETE_TIME;
 
 extern LLTrace::EventStatHandle<LLUnit<F32, LLUnits::Percent> > OBJECT_CACHE_HIT_RATE;
 
@@ -723,6 +723,24 @@ public:
             addText(xpos, ypos, llformat("%d/%d Objects Active", gObjectList.getNumActiveObjects(), gObjectList.getNumObjects()));
             ypos += y_inc;
 
+            if (last_frame_recording.getSampleCount(LLPipeline::sStatCullTime) > 0)
+            {
+                addText(xpos, ypos, llformat("Cull: %.2f ms (%d passes)", last_frame_recording.getSum(LLPipeline::sStatCullTime).value(), (U32)last_frame_recording.getSampleCount(LLPipeline::sStatCullTime)));
+                ypos += y_inc;
+            }
+
+            if (last_frame_recording.getSampleCount(LLDrawPoolAlpha::sStatSortTime) > 0)
+            {
+                addText(xpos, ypos, llformat("Alpha Sort: %.3f ms", last_frame_recording.getSum(LLDrawPoolAlpha::sStatSortTime).value()));
+                ypos += y_inc;
+            }
+
+            if (last_frame_recording.getSampleCount(LLPipeline::sStatMovedListSize) > 0)
+            {
+                addText(xpos, ypos, llformat("%d Drawables Moving", (U32)last_frame_recording.getMax(LLPipeline::sStatMovedListSize)));
+                ypos += y_inc;
+            }
+
             addText(xpos, ypos, llformat("%d Matrix Ops", gPipeline.mMatrixOpCount));
             ypos += y_inc;
 
@@ -774,6 +792,12 @@ public:
                 addText(xpos, ypos, llformat("%d/%d Mesh LOD Pending/Processing", LLMeshRepository::sLODPending, LLMeshRepository::sLODProcessing));
                 ypos += y_inc;
 
+                U32 lod_decoded = LLMeshRepository::sLODDecoded;
+                addText(xpos, ypos, llformat("%d Mesh LOD Decoding, %.1f/s, %.2f ms avg", (S32)LLMeshRepository::sLODDecodeQueued,
+                    LLMeshRepository::sLODDecodeRate,
+                    lod_decoded ? LLMeshRepository::sLODDecodeMicroseconds / (1000.f * lod_decoded) : 0.f));
+                ypos += y_inc;
+
                 // <FS:Ansariel> Mesh debugging
                 addText(xpos, ypos, llformat("%d Mesh Active LOD Requests", LLMeshRepoThread::sActiveLODRequests));
                 ypos += y_inc;
@@ -5189,7 +5189,7 @@ void LLRiggedVolume::update(
 
     if (copy)
     {
-        copyVolumeFaces(volume);
+        copySkinnedFaces(volume);
     }
     else
     {
@@ -5319,6 +5319,10 @@ void LLRiggedVolume::update(
                 dst_face.mCenter->setAdd(dst_face.mExtents[0], dst_face.mExtents[1]);
                 dst_face.mCenter->mul(0.5f);
 
+                // picking goes through the face BVH; refitting keeps it valid
+                // for the new pose without rebuilding the hierarchy
+                dst_face.refitBVH();
+
             }
 
             if (rebuild_face_octrees)
@@ -5346,6 +5350,27 @@ void LLRiggedVolume::update(
                                box_max[0], box_max[1], box_max[2]);
 }
 
+void LLRiggedVolume::copySkinnedFaces(const LLVolume* volume)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    // identical attachments worn by many avatars keep one copy of their
+    // normals, texture coordinates and indices between them. Weights are
+    // always read from the source volume and not copied at all.
+    const LLUUID& mesh_id = volume->getParams().getSculptID();
+    const S32 num_faces = volume->getNumVolumeFaces();
+
+    // faces are filled in place, growing the vector would copy shared
+    // faces into unshared ones
+    mVolumeFaces.clear();
+    mVolumeFaces.resize(num_faces);
+    for (S32 i = 0; i < num_faces; ++i)
+    {
+        mVolumeFaces[i].copyWithSharedData(volume->getVolumeFace(i), mesh_id);
+    }
+    mSculptLevel = 0;
+}
+
 U32 LLVOVolume::getPartitionType() const
 {
     if (isHUDAttachment())
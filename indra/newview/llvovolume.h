@@ -78,6 +78,11 @@ public:
         bool rebuild_face_octrees = true);
 
     std::string mExtraDebugText;
+
+private:
+    // Copies the faces of src_volume that update() poses. Only positions
+    // are per object, the rest is shared with every copy of the same face.
+    void copySkinnedFaces(const LLVolume* src_volume);
 };
 
 // Base class for implementations of the volume - Primitive, Flexible Object, etc.
@@ -115,6 +115,7 @@
 #include "llprogressview.h"
 #include "llcleanup.h"
 #include "gltfscenemanager.h"
+#include "parallelfor.h"
 // [RLVa:KB] - Checked: RLVa-2.0.0
 #include "llvisualeffect.h"
 #include "rlvactions.h"
@@ -234,6 +235,8 @@ bool LLPipeline::RenderMirrors;
 S32 LLPipeline::RenderHeroProbeUpdateRate;
 S32 LLPipeline::RenderHeroProbeConservativeUpdateMultiplier;
 LLTrace::EventStatHandle<S64> LLPipeline::sStatBatchSize("renderbatchsize");
+LLTrace::EventStatHandle<S64> LLPipeline::sStatMovedListSize("movedlistsize");
+LLTrace::EventStatHandle<F64Milliseconds> LLPipeline::sStatCullTime("culltime");
 
 // const U32 LLPipeline::MAX_PREVIEW_WIDTH = 512;
 constexpr U32 LLPipeline::MAX_PREVIEW_WIDTH = 2048;
@@ -290,6 +293,7 @@ LLTrace::BlockTimerStatHandle FTM_RENDER_UI_3D("3D");
 LLTrace::BlockTimerStatHandle FTM_RENDER_UI_2D("2D");
 
 static LLTrace::BlockTimerStatHandle FTM_STATESORT_DRAWABLE("Sort Drawables");
+static LLTrace::BlockTimerStatHandle FTM_UPDATE_MOVED_LIST("Update Moved List");
 
 static LLStaticHashedString sTint("tint");
 static LLStaticHashedString sAmbiance("ambiance");
@@ -2133,14 +2137,20 @@ void LLPipeline::updateMoveNormalAsync(LLDrawable* drawablep)
 void LLPipeline::updateMovedList(LLDrawable::drawable_vector_t& moved_list)
 {
     LL_PROFILE_ZONE_SCOPED;
-    for (LLDrawable::drawable_vector_t::iterator iter = moved_list.begin();
-         iter != moved_list.end(); )
+    LL_RECORD_BLOCK_TIME(FTM_UPDATE_MOVED_LIST);
+
+    record(sStatMovedListSize, (S64)moved_list.size());
+
+    // Drawables that are still moving are compacted towards the front of the
+    // list, keeping their order (parents are queued ahead of their children).
+    // Erasing finished entries in place made this quadratic in crowds.
+    // Index based, since updateMove() may queue further drawables.
+    size_t kept = 0;
+    for (size_t i = 0; i < moved_list.size(); ++i)
     {
-        LLDrawable::drawable_vector_t::iterator curiter = iter++;
-        LLDrawable *drawablep = *curiter;
+        LLDrawable *drawablep = moved_list[i];
         if (!drawablep)
         {
-            iter = moved_list.erase(curiter);
             continue;
         }
         bool done = true;
@@ -2166,9 +2176,17 @@ void LLPipeline::updateMovedList(LLDrawable::drawable_vector_t& moved_list)
                     drawablep->getVObj()->dirtySpatialGroup();
                 }
             }
-            iter = moved_list.erase(curiter);
+        }
+        else
+        {
+            if (kept != i)
+            {
+                moved_list[kept] = std::move(moved_list[i]);
+            }
+            ++kept;
         }
     }
+    moved_list.resize(kept);
 }
 
 void LLPipeline::updateMove()
@@ -2569,33 +2587,45 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result, bool hud_att
 
     sCull->clear();
 
-    for (LLWorld::region_list_t::const_iterator iter = LLWorld::getInstance()->getRegionList().begin();
-            iter != LLWorld::getInstance()->getRegionList().end(); ++iter)
-    {
-        LLViewerRegion* region = *iter;
+    LLTimer cull_timer;
 
-        for (U32 i = 0; i < LLViewerRegion::NUM_PARTITIONS; i++)
+    static LLCachedControl<bool> parallel_cull(gSavedSettings, "RenderParallelCull", false);
+    if (parallel_cull)
+    {
+        cullPartitionsParallel(camera, hud_attachments);
+    }
+    else
+    {
+        for (LLWorld::region_list_t::const_iterator iter = LLWorld::getInstance()->getRegionList().begin();
+                iter != LLWorld::getInstance()->getRegionList().end(); ++iter)
         {
-            LLSpatialPartition* part = region->getSpatialPartition(i);
-            if (part)
+            LLViewerRegion* region = *iter;
+
+            for (U32 i = 0; i < LLViewerRegion::NUM_PARTITIONS; i++)
             {
-                if (!hud_attachments ? LLViewerRegion::PARTITION_BRIDGE == i || hasRenderType(part->mDrawableType) : hasRenderType(part->mDrawableType))
+                LLSpatialPartition* part = region->getSpatialPartition(i);
+                if (part)
                 {
-                    part->cull(camera);
+                    if (!hud_attachments ? LLViewerRegion::PARTITION_BRIDGE == i || hasRenderType(part->mDrawableType) : hasRenderType(part->mDrawableType))
+                    {
+                        part->cull(camera);
+                    }
                 }
             }
-        }
 
-        //scan the VO Cache tree
-        LLVOCachePartition* vo_part = region->getVOCachePartition();
-        if(vo_part)
-        {
-            // <FS:Beq> Fix area search again
-            //vo_part->cull(camera, sUseOcclusion > 0);
-            vo_part->cull(camera, sUseOcclusion > 0 && !gAgent.getFSAreaSearchActive());
+            //scan the VO Cache tree
+            LLVOCachePartition* vo_part = region->getVOCachePartition();
+            if(vo_part)
+            {
+                // <FS:Beq> Fix area search again
+                //vo_part->cull(camera, sUseOcclusion > 0);
+                vo_part->cull(camera, sUseOcclusion > 0 && !gAgent.getFSAreaSearchActive());
+            }
         }
     }
 
+    record(sStatCullTime, cull_timer.getElapsedTimeF64());
+
     if (hasRenderType(LLPipeline::RENDER_TYPE_SKY) &&
         gSky.mVOSkyp.notNull() &&
         gSky.mVOSkyp->mDrawable.notNull())
@@ -2616,6 +2646,62 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result, bool hud_att
     }
 }
 
+void LLPipeline::cullPartitionsParallel(LLCamera& camera, bool hud_attachments)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+
+    // Same partitions, in the same order, as the serial path in updateCull()
+    mParallelCullPartitions.clear();
+    for (LLViewerRegion* region : LLWorld::getInstance()->getRegionList())
+    {
+        for (U32 i = 0; i < LLViewerRegion::NUM_PARTITIONS; i++)
+        {
+            LLSpatialPartition* part = region->getSpatialPartition(i);
+            if (part)
+            {
+                if (!hud_attachments ? LLViewerRegion::PARTITION_BRIDGE == i || hasRenderType(part->mDrawableType) : hasRenderType(part->mDrawableType))
+                {
+                    part->prepareDeferredCull();
+                    mParallelCullPartitions.push_back(part);
+                }
+            }
+        }
+    }
+
+    const size_t count = mParallelCullPartitions.size();
+    if (mParallelCullResults.size() < count)
+    {
+        mParallelCullResults.resize(count);
+    }
+
+    LL::parallel_for(count, 1,
+                     [this, &camera](size_t begin, size_t end)
+                     {
+                         for (size_t i = begin; i < end; ++i)
+                         {
+                             mParallelCullPartitions[i]->cullDeferred(camera, mParallelCullResults[i]);
+                         }
+                     });
+
+    // Merge in partition order so the cull result doesn't depend on which
+    // thread finished first.
+    for (size_t i = 0; i < count; ++i)
+    {
+        mParallelCullPartitions[i]->applyDeferredCull(camera, mParallelCullResults[i]);
+    }
+
+    // The object cache cull feeds its region's visible lists and object
+    // requests, so it stays on this thread.
+    for (LLViewerRegion* region : LLWorld::getInstance()->getRegionList())
+    {
+        LLVOCachePartition* vo_part = region->getVOCachePartition();
+        if (vo_part)
+        {
+            vo_part->cull(camera, sUseOcclusion > 0 && !gAgent.getFSAreaSearchActive());
+        }
+    }
+}
+
 void LLPipeline::markNotCulled(LLSpatialGroup* group, LLCamera& camera)
 {
     if (group->isEmpty())
@@ -3793,8 +3879,9 @@ void LLPipeline::postSort(LLCamera &camera)
         LL_PROFILE_ZONE_NAMED_CATEGORY_PIPELINE("sort alpha groups");
     if (!sShadowRender)
     {
-        // order alpha groups by distance
-        std::sort(sCull->beginAlphaGroups(), sCull->endAlphaGroups(), LLSpatialGroup::CompareDepthGreater());
+        // order alpha groups by distance, reusing last frame's order for the world camera
+        bool coherent = LLViewerCamera::sCurCameraID == LLViewerCamera::CAMERA_WORLD && !gCubeSnapshot;
+        LLDrawPoolAlpha::sortAlphaGroups(sCull->beginAlphaGroups(), sCull->endAlphaGroups(), coherent);
 
         // order rigged alpha groups by avatar attachment order
         std::sort(sCull->beginRiggedAlphaGroups(), sCull->endRiggedAlphaGroups(), LLSpatialGroup::CompareRenderOrder());
@@ -4536,10 +4623,16 @@ void LLPipeline::renderDebug()
             if (!pathfindingConsoleHandle.isDead())
             {
                 LLFloaterPathfindingConsole *pathfindingConsole = pathfindingConsoleHandle.get();
+                static LLCachedControl<F32> ambiance_setting(gSavedSettings, "PathfindingAmbiance");
+                static LLCachedControl<F32> line_offset(gSavedSettings, "PathfindingLineOffset");
+                static LLCachedControl<F32> xray_tint(gSavedSettings, "PathfindingXRayTint");
+                static LLCachedControl<F32> xray_opacity(gSavedSettings, "PathfindingXRayOpacity");
+                static LLCachedControl<bool> xray_wireframe(gSavedSettings, "PathfindingXRayWireframe");
+                static LLCachedControl<F32> line_width(gSavedSettings, "PathfindingLineWidth");
 
                 if ( pathfindingConsole->getVisible() || gAgentCamera.cameraMouselook() )
                 {
-                    F32 ambiance = gSavedSettings.getF32("PathfindingAmbiance");
+                    F32 ambiance = ambiance_setting();
 
                     gPathfindingProgram.bind();
 
@@ -4669,18 +4762,18 @@ void LLPipeline::renderDebug()
                                 LLGLEnable lineOffset(GL_POLYGON_OFFSET_LINE);
                                 glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
 
-                                F32 offset = gSavedSettings.getF32("PathfindingLineOffset");
+                                F32 offset = line_offset();
 
                                 if (pathfindingConsole->isRenderXRay())
                                 {
-                                    gPathfindingProgram.uniform1f(sTint, gSavedSettings.getF32("PathfindingXRayTint"));
-                                    gPathfindingProgram.uniform1f(sAlphaScale, gSavedSettings.getF32("PathfindingXRayOpacity"));
+                                    gPathfindingProgram.uniform1f(sTint, xray_tint());
+                                    gPathfindingProgram.uniform1f(sAlphaScale, xray_opacity());
                                     LLGLEnable blend(GL_BLEND);
                                     LLGLDepthTest depth(GL_TRUE, GL_FALSE, GL_GREATER);
 
                                     glPolygonOffset(offset, -offset);
 
-                                    if (gSavedSettings.getBOOL("PathfindingXRayWireframe"))
+                                    if (xray_wireframe())
                                     { //draw hidden wireframe as darker and less opaque
                                         gPathfindingProgram.uniform1f(sAmbiance, 1.f);
                                         llPathingLibInstance->renderNavMeshShapesVBO( render_order[i] );
@@ -4700,7 +4793,7 @@ void LLPipeline::renderDebug()
                                     gPathfindingProgram.uniform1f(sTint, 1.f);
                                     gPathfindingProgram.uniform1f(sAlphaScale, 1.f);
 
-                                    gGL.setLineWidth(gSavedSettings.getF32("PathfindingLineWidth")); // <FS> Line width OGL core profile fix by Rye Mutt
+                                    gGL.setLineWidth(line_width()); // <FS> Line width OGL core profile fix by Rye Mutt
                                     LLGLDisable blendOut(GL_BLEND);
                                     llPathingLibInstance->renderNavMeshShapesVBO( render_order[i] );
                                     gGL.flush();
@@ -4716,12 +4809,12 @@ void LLPipeline::renderDebug()
 
                     if ( pathfindingConsole->isRenderNavMesh() && pathfindingConsole->isRenderXRay() )
                     {   //render navmesh xray
-                        F32 ambiance = gSavedSettings.getF32("PathfindingAmbiance");
+                        F32 ambiance = ambiance_setting();
 
                         LLGLEnable lineOffset(GL_POLYGON_OFFSET_LINE);
                         LLGLEnable polyOffset(GL_POLYGON_OFFSET_FILL);
 
-                        F32 offset = gSavedSettings.getF32("PathfindingLineOffset");
+                        F32 offset = line_offset();
                         glPolygonOffset(offset, -offset);
 
                         LLGLEnable blend(GL_BLEND);
@@ -4730,10 +4823,10 @@ void LLPipeline::renderDebug()
                         gGL.setLineWidth(2.0f); // <FS> Line width OGL core profile fix by Rye Mutt
                         LLGLEnable cull(GL_CULL_FACE);
 
-                        gPathfindingProgram.uniform1f(sTint, gSavedSettings.getF32("PathfindingXRayTint"));
-                        gPathfindingProgram.uniform1f(sAlphaScale, gSavedSettings.getF32("PathfindingXRayOpacity"));
+                        gPathfindingProgram.uniform1f(sTint, xray_tint());
+                        gPathfindingProgram.uniform1f(sAlphaScale, xray_opacity());
 
-                        if (gSavedSettings.getBOOL("PathfindingXRayWireframe"))
+                        if (xray_wireframe())
                         { //draw hidden wireframe as darker and less opaque
                             glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
                             gPathfindingProgram.uniform1f(sAmbiance, 1.f);
@@ -4748,8 +4841,8 @@ void LLPipeline::renderDebug()
 
                         //render edges
                         gPathfindingNoNormalsProgram.bind();
-                        gPathfindingNoNormalsProgram.uniform1f(sTint, gSavedSettings.getF32("PathfindingXRayTint"));
-                        gPathfindingNoNormalsProgram.uniform1f(sAlphaScale, gSavedSettings.getF32("PathfindingXRayOpacity"));
+                        gPathfindingNoNormalsProgram.uniform1f(sTint, xray_tint());
+                        gPathfindingNoNormalsProgram.uniform1f(sAlphaScale, xray_opacity());
                         llPathingLibInstance->renderNavMeshEdges();
                         gPathfindingProgram.bind();
 
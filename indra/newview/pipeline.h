@@ -265,6 +265,9 @@ public:
 
     // Populate given LLCullResult with results of a frustum cull of the entire scene against the given LLCamera
     void updateCull(LLCamera& camera, LLCullResult& result, bool hud_attachments = false);
+    // updateCull() helper for RenderParallelCull: spatial partitions are
+    // traversed on the Parallel thread pool and merged in region order
+    void cullPartitionsParallel(LLCamera& camera, bool hud_attachments);
     void createObjects(F32 max_dtime);
     void createObject(LLViewerObject* vobj);
     void processPartitionQ();
@@ -695,6 +698,8 @@ public:
 // [/SL:KB]
 
     static LLTrace::EventStatHandle<S64> sStatBatchSize;
+    static LLTrace::EventStatHandle<S64> sStatMovedListSize;
+    static LLTrace::EventStatHandle<F64Milliseconds> sStatCullTime;
 
     class RenderTargetPack
     {
@@ -841,6 +846,8 @@ protected:
     /////////////////////////////////////////////
     //
     //
+    std::vector<LLSpatialPartition*> mParallelCullPartitions;
+    std::vector<LLSpatialPartition::DeferredCull> mParallelCullResults;
     LLDrawable::drawable_vector_t   mMovedList;
     LLDrawable::drawable_vector_t mMovedBridge;
     LLDrawable::drawable_vector_t   mShiftList;
@@ -0,0 +1,318 @@
+/**
+ * @file llchatlogscanner_test.cpp
+ * @brief LLChatLogScanner test cases.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llchatlogscanner.h"
+
+#include "lltut.h"
+#include "llregex.h"
+#include "lltimer.h"
+#include "stringize.h"
+
+#include <vector>
+
+namespace
+{
+    // the patterns LLChatLogParser::parse() used before the scanner
+    const boost::regex TIMESTAMP_AND_STUFF("^(\\[\\d{4}/\\d{1,2}/\\d{1,2}\\s+\\d{1,2}:\\d{2}\\]\\s+|\\[\\d{1,2}:\\d{2}\\]\\s+)?(.*)$");
+    const boost::regex TIMESTAMP_AND_STUFF_SEC("^(\\[\\d{4}/\\d{1,2}/\\d{1,2}\\s+\\d{1,2}:\\d{2}:\\d{2}\\]\\s+|\\[\\d{1,2}:\\d{2}:\\d{2}\\]\\s+)(.*)$");
+    const boost::regex NAME_AND_TEXT("([^:]+[:]{1})?(\\s*)(.*)");
+
+    const char* FIXTURES[] =
+    {
+        "SuperCar: You aren't the owner",
+        "[2:59]  SuperCar: You aren't the owner",
+        "[2009/11/20 3:00]  SuperCar: You aren't the owner",
+        "Katar Ivercourt is Offline",
+        "[3:00]  Katar Ivercourt is Offline",
+        "[2009/11/20 3:01]  Corba ProductEngine is Offline",
+        "[2024/03/05 12:34:56]  Resident: with seconds",
+        "[12:34:56]\tResident:\ttabs",
+        "[2024/3/5\t1:02]\r\x0b\x0c Second Life: odd white space",
+        "[12:34]",
+        "[12:34] ",
+        "[12:34]x no space after the bracket",
+        "[12:34:56]x no space after the bracket",
+        "[1:2] too short",
+        "[123:45] too long",
+        "[12:345] too long",
+        "[12:34:5] short seconds",
+        "[12:34:567] long seconds",
+        "[2024/03/05 12:34]  ",
+        "[24/03/05 12:34] short year",
+        "[20245/03/05 12:34] long year",
+        "[2024/003/05 12:34] long month",
+        "[2024/03/05 123:34] long hour",
+        "[2024/03/0512:34] no space",
+        "[2024/03/05 12:34:56:78] extra field",
+        "[2024/03/05 12:34]  IM: Someone: hello",
+        "[[12:34]  nested",
+        "[12:34]  :leading colon",
+        "[12:34]  Name:",
+        "[12:34]  Name:   ",
+        "[12:34]  Name:text:more:colons",
+        "[12:34]  a: \t b",
+        "",
+        " ",
+        ":",
+        "::",
+        "no colon at all",
+        "\xEF\xBB\xBF[12:34]  after a byte order mark",
+        "[\xD9\xA1\xD9\xA2:34] arabic digits",
+        "[12:34]\xC2\xA0no-break space",
+        "Object name with: colon",
+    };
+
+    struct RegexSplit
+    {
+        bool mHasTimestamp;
+        bool mHasSeconds;
+        std::string mTimestamp;
+        std::string mStuff;
+        bool mHasName;
+        std::string mName;
+        std::string mText;
+    };
+
+    // what LLChatLogParser::parse() used to do with the patterns
+    RegexSplit regex_split(const std::string& line)
+    {
+        RegexSplit split;
+        boost::match_results<std::string::const_iterator> matches;
+        split.mHasSeconds = ll_regex_match(line, matches, TIMESTAMP_AND_STUFF_SEC);
+        if (!split.mHasSeconds)
+        {
+            tut::ensure(STRINGIZE("no timestamp match '" << line << "'"), ll_regex_match(line, matches, TIMESTAMP_AND_STUFF));
+        }
+        split.mHasTimestamp = matches[1].matched;
+        split.mTimestamp = matches[1];
+        split.mStuff = matches[2];
+
+        boost::match_results<std::string::const_iterator> name_and_text;
+        tut::ensure(STRINGIZE("no name match '" << line << "'"), ll_regex_match(split.mStuff, name_and_text, NAME_AND_TEXT));
+        split.mHasName = name_and_text[1].matched;
+        split.mName = name_and_text[1];
+        split.mText = name_and_text[3];
+        return split;
+    }
+}
+
+namespace tut
+{
+    struct llchatlogscanner_data
+    {
+        void checkLine(const std::string& line)
+        {
+            const RegexSplit expected = regex_split(line);
+            std::string timestamp, stuff, name, text;
+            bool has_seconds = false;
+            const bool has_timestamp = LLChatLogScanner::splitTimestamp(line, timestamp, stuff, has_seconds);
+            ensure_equals(STRINGIZE("has timestamp '" << line << "'"), has_timestamp, expected.mHasTimestamp);
+            if (has_timestamp)
+            {
+                ensure_equals(STRINGIZE("has seconds '" << line << "'"), has_seconds, expected.mHasSeconds);
+            }
+            ensure_equals(STRINGIZE("timestamp '" << line << "'"), timestamp, expected.mTimestamp);
+            ensure_equals(STRINGIZE("stuff '" << line << "'"), stuff, expected.mStuff);
+
+            const bool has_name = LLChatLogScanner::splitName(stuff, name, text);
+            ensure_equals(STRINGIZE("has name '" << line << "'"), has_name, expected.mHasName);
+            ensure_equals(STRINGIZE("name '" << line << "'"), name, expected.mName);
+            ensure_equals(STRINGIZE("text '" << line << "'"), text, expected.mText);
+        }
+
+        std::string makeTranscript(U32 lines)
+        {
+            std::string transcript;
+            for (U32 i = 0; i < lines; ++i)
+            {
+                switch ((i * 5) % 8)
+                {
+                case 0:
+                    transcript += " continued line\n";
+                    break;
+                case 1:
+                    transcript += (i % 3) ? "\n" : "\r\n";
+                    break;
+                default:
+                    transcript += STRINGIZE("[2024/03/05 12:" << (10 + i % 50) << "]  Resident " << i % 7 << ": message " << i);
+                    for (U32 n = (i * 13) % 40; n; --n)
+                    {
+                        transcript += " word";
+                    }
+                    transcript += '\n';
+                    break;
+                }
+            }
+            return transcript;
+        }
+    };
+    typedef test_group<llchatlogscanner_data> llchatlogscanner_test;
+    typedef llchatlogscanner_test::object llchatlogscanner_object;
+    tut::llchatlogscanner_test tllchatlogscanner("LLChatLogScanner");
+
+    template<> template<>
+    void llchatlogscanner_object::test<1>()
+    {
+        set_test_name("fixture lines split like the regular expressions");
+        for (const char* line : FIXTURES)
+        {
+            checkLine(line);
+        }
+    }
+
+    template<> template<>
+    void llchatlogscanner_object::test<2>()
+    {
+        set_test_name("generated lines split like the regular expressions");
+
+        // every timestamp form followed by every string of up to three of
+        // the characters the patterns care about, with and without a name
+        static const char* prefixes[] = { "", "[2024/03/05 12:34]  ", "[2024/03/05 12:34:56]  ", "[12:34]", "[12:34:56]  ",
+                                          "[2024/03/05 12:34" };
+        static const char* names[] = { "", "Resident" };
+        static const char pieces[] = "[]/: \t\r0123456789aZ\xC2";
+        const U32 num_pieces = sizeof(pieces) - 1;
+        for (const char* prefix : prefixes)
+        {
+            for (const char* name : names)
+            {
+                for (U32 length = 0, combos = 1; length <= 3; ++length, combos *= num_pieces)
+                {
+                    for (U32 combo = 0; combo < combos; ++combo)
+                    {
+                        std::string line = std::string(prefix) + name;
+                        for (U32 n = length, k = combo; n; --n, k /= num_pieces)
+                        {
+                            line += pieces[k % num_pieces];
+                        }
+                        checkLine(line);
+                    }
+                }
+            }
+        }
+    }
+
+    template<> template<>
+    void llchatlogscanner_object::test<3>()
+    {
+        set_test_name("newline scans and message boundaries");
+        const std::string transcript = makeTranscript(2000);
+        const char* begin = transcript.data();
+        const char* end = begin + transcript.size();
+
+        // every offset and a few unaligned ranges
+        for (size_t from = 0; from < 300; ++from)
+        {
+            const char* pos = begin + from;
+            const size_t expected = transcript.find('\n', from);
+            ensure_equals(STRINGIZE("next newline from " << from),
+                          (size_t)(LLChatLogScanner::findNewline(pos, end) - begin),
+                          expected == std::string::npos ? transcript.size() : expected);
+            const size_t expected_prev = from ? transcript.rfind('\n', from - 1) : std::string::npos;
+            const char* prev = LLChatLogScanner::findPrevNewline(begin + 3, pos);
+            ensure(STRINGIZE("previous newline before " << from),
+                   (expected_prev == std::string::npos || expected_prev < 3) ? !prev : prev == begin + expected_prev);
+        }
+
+        // the message starts, oldest first
+        std::vector<size_t> starts;
+        for (size_t line = 0; line < transcript.size(); line = transcript.find('\n', line) + 1)
+        {
+            const char c = transcript[line];
+            if (c != ' ' && c != '\n' && c != '\r')
+            {
+                starts.push_back(line);
+            }
+        }
+
+        const size_t budgets[] = { 0, 1, 100, 4096, 20480, transcript.size(), transcript.size() + 1 };
+        for (size_t max_bytes : budgets)
+        {
+            const size_t limit = (max_bytes && max_bytes < transcript.size()) ? transcript.size() - max_bytes : 0;
+            size_t expected = transcript.size();
+            for (size_t i = starts.size(); i-- > 0 && starts[i] >= limit; )
+            {
+                expected = starts[i];
+            }
+            const char* start = LLChatLogScanner::findMessagesStart(begin, end, max_bytes);
+            ensure_equals(STRINGIZE("messages start, " << max_bytes << " bytes"),
+                          (size_t)(start - begin), expected);
+        }
+    }
+
+#if LL_BENCHMARK
+    template<> template<>
+    void llchatlogscanner_object::test<4>()
+    {
+        set_test_name("scanner and regular expression speed");
+
+        const std::string transcript = makeTranscript(50000);
+        const char* begin = transcript.data();
+        const char* end = begin + transcript.size();
+
+        LLTimer timer;
+        size_t regex_names = 0;
+        for (const char* pos = begin; pos < end; )
+        {
+            const char* eol = (const char*)memchr(pos, '\n', end - pos);
+            const RegexSplit split = regex_split(std::string(pos, eol));
+            regex_names += split.mHasName;
+            pos = eol + 1;
+        }
+        F64 regex_time = timer.getElapsedTimeF64();
+
+        timer.reset();
+        size_t scanner_names = 0;
+        std::string line, timestamp, stuff, name, text;
+        bool has_seconds;
+        for (const char* pos = begin; pos < end; )
+        {
+            const char* eol = LLChatLogScanner::findNewline(pos, end);
+            line.assign(pos, eol);
+            LLChatLogScanner::splitTimestamp(line, timestamp, stuff, has_seconds);
+            scanner_names += LLChatLogScanner::splitName(stuff, name, text);
+            pos = eol + 1;
+        }
+        F64 scanner_time = timer.getElapsedTimeF64();
+        ensure_equals("same names", scanner_names, regex_names);
+
+        timer.reset();
+        size_t newlines = 0;
+        for (const char* pos = end; (pos = LLChatLogScanner::findPrevNewline(begin, pos)); )
+        {
+            ++newlines;
+        }
+        F64 backwards_time = timer.getElapsedTimeF64();
+        ensure("found newlines", newlines > 0);
+
+        LL_INFOS() << transcript.size() / 1024 << " KB transcript: regular expressions " << regex_time * 1000.0
+                   << " ms, scanner " << scanner_time * 1000.0 << " ms, every newline from the end "
+                   << backwards_time * 1000.0 << " ms" << LL_ENDL;
+    }
+#endif // LL_BENCHMARK
+}
@@ -0,0 +1,269 @@
+/**
+ * @file llchattranscriptstore_test.cpp
+ * @brief LLChatTranscriptStore test cases.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llchattranscriptstore.h"
+
+#include "llfile.h"
+
+#include "lltut.h"
+#include "lltimer.h"
+#include "namedtempfile.h"
+#include "stringize.h"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace tut
+{
+    struct llchattranscriptstore_data
+    {
+        std::string mBase;
+        std::vector<std::string> mTexts;
+        std::vector<S64> mTimes;
+
+        llchattranscriptstore_data()
+        :   mBase(NamedTempFile::temp_path("transcript").string())
+        {
+        }
+
+        ~llchattranscriptstore_data()
+        {
+            LLChatTranscriptStore::removeFiles(mBase);
+            LLFile::remove(getSourcePath(), ENOENT);
+        }
+
+        std::string getSourcePath() const
+        {
+            return mBase + ".txt";
+        }
+
+        void writeSource(const std::string& text, bool append)
+        {
+            std::ofstream file(getSourcePath().c_str(), append ? std::ios::binary | std::ios::app : std::ios::binary);
+            file << text;
+        }
+
+        std::string makeMessage(U32 i)
+        {
+            static const char* words[] = { "hello", "world", "apple", "banana", "cherry", "sim", "region",
+                                           "teleport", "landmark", "mesh", "avatar", "group", "notice" };
+            std::string text = STRINGIZE("[2024/03/" << (1 + i / 50000) << " 12:00]  Resident " << (i % 17) << ": ");
+            for (U32 n = 1 + (i * 5) % 8; n; --n)
+            {
+                text += words[(i * 7 + n * 11) % LL_ARRAY_SIZE(words)];
+                text += (n % 3) ? " " : ", ";
+            }
+            text += STRINGIZE("m" << i);
+            if (i % 40 == 0)
+            {
+                text += "\nsecond line with an Apple";
+            }
+            return text;
+        }
+
+        void fill(LLChatTranscriptStore& store, U32 count)
+        {
+            for (U32 i = 0; i < count; ++i)
+            {
+                // every seventh message claims an earlier time than the one before
+                S64 time = 1000 + i * 10 - ((i % 7 == 3) ? 25 : 0);
+                mTexts.push_back(makeMessage(i));
+                mTimes.push_back(mTimes.empty() ? time : llmax(time, mTimes.back()));
+                ensure(STRINGIZE("append " << i), store.append(time, mTexts.back()));
+            }
+            ensure("flush", store.flush());
+        }
+    };
+    typedef test_group<llchattranscriptstore_data> llchattranscriptstore_test;
+    typedef llchattranscriptstore_test::object llchattranscriptstore_object;
+    tut::llchattranscriptstore_test tllchattranscriptstore("LLChatTranscriptStore");
+
+    template<> template<>
+    void llchattranscriptstore_object::test<1>()
+    {
+        set_test_name("append, reopen, last messages and time lookup");
+
+        {
+            LLChatTranscriptStore store(mBase);
+            ensure("open new", store.open());
+            ensure("starts empty", store.empty());
+            fill(store, 5000);
+            writeSource(std::string(12345, 'x'), false);
+            store.setSource(getSourcePath(), 12345);
+            ensure("flush source size", store.flush());
+        }
+
+        LLChatTranscriptStore store(mBase);
+        ensure("reopen", store.open());
+        ensure_equals("count survives reopen", store.size(), (U32)5000);
+        ensure_equals("source size survives reopen", store.getSourceSize(), (U64)12345);
+
+        std::vector<std::string> texts;
+        ensure("last 10", store.getLast(10, 0, texts));
+        ensure_equals("last 10 count", texts.size(), (size_t)10);
+        for (size_t i = 0; i < texts.size(); ++i)
+        {
+            ensure_equals(STRINGIZE("last 10 text " << i), texts[i], mTexts[4990 + i]);
+        }
+
+        ensure("byte budget", store.getLast(U32_MAX, 500, texts));
+        size_t bytes = 0;
+        for (const std::string& text : texts)
+        {
+            bytes += text.size();
+        }
+        ensure("covers the budget", bytes >= 500);
+        ensure("stops once the budget is covered", bytes - texts.front().size() < 500);
+        ensure_equals("newest is last", texts.back(), mTexts.back());
+
+        ensure("range", store.read(1234, 3, texts));
+        ensure_equals("range text", texts[1], mTexts[1235]);
+
+        for (U32 i = 0; i < 500; ++i)
+        {
+            const S64 time = (S64)i * 104 - 7; // below, between and on stored times
+            const U32 expected = (U32)(std::lower_bound(mTimes.begin(), mTimes.end(), time) - mTimes.begin());
+            ensure_equals(STRINGIZE("find time " << time), store.findTime(time), expected);
+        }
+    }
+
+    template<> template<>
+    void llchattranscriptstore_object::test<2>()
+    {
+        set_test_name("source fingerprint");
+
+        std::string text;
+        for (U32 i = 0; i < 2000; ++i)
+        {
+            text += makeMessage(i) + "\n";
+        }
+        writeSource(text, false);
+
+        LLChatTranscriptStore store(mBase);
+        ensure("open", store.open());
+        ensure("empty store matches anything", store.matchesSource(getSourcePath()));
+        store.setSource(getSourcePath(), text.size());
+        ensure("flush", store.flush());
+
+        LLChatTranscriptStore reopened(mBase);
+        ensure("reopen", reopened.open());
+        ensure("unchanged", reopened.matchesSource(getSourcePath()));
+
+        writeSource("[2024/03/09 12:00]  Resident 1: appended\n", true);
+        ensure("appended to", reopened.matchesSource(getSourcePath()));
+
+        // another transcript moved into place, same length up to the
+        // imported size but different text at the end
+        std::string other(text);
+        other[other.size() - 3] = '#';
+        writeSource(other + "more\n", false);
+        ensure("other file", !reopened.matchesSource(getSourcePath()));
+
+        writeSource(text.substr(0, text.size() / 2), false);
+        ensure("cut down", !reopened.matchesSource(getSourcePath()));
+    }
+
+    template<> template<>
+    void llchattranscriptstore_object::test<3>()
+    {
+        set_test_name("unflushed appends are discarded on open");
+
+        {
+            LLChatTranscriptStore store(mBase);
+            ensure("open", store.open());
+            fill(store, 100);
+            writeSource(std::string(100, 'x'), false);
+            store.setSource(getSourcePath(), 100);
+            ensure("flush", store.flush());
+            // simulate a crash between appending and committing the header
+            ensure("append", store.append(0, "lost"));
+        }
+
+        LLChatTranscriptStore store(mBase);
+        ensure("reopen", store.open());
+        ensure("rebuilt from scratch", store.empty());
+        ensure_equals("source imported again", store.getSourceSize(), (U64)0);
+    }
+
+#if LL_BENCHMARK
+    template<> template<>
+    void llchattranscriptstore_object::test<4>()
+    {
+        set_test_name("open latency, index and text file");
+
+        // LL_TRANSCRIPT_BENCH_MB sizes the transcript, e.g. 5120 for 5 GB
+        const char* bench_mb = getenv("LL_TRANSCRIPT_BENCH_MB");
+        const U64 corpus_bytes = (U64)(bench_mb ? atoi(bench_mb) : 16) * 1024 * 1024;
+
+        LLTimer timer;
+        std::string text;
+        U32 count = 0;
+        {
+            LLChatTranscriptStore store(mBase);
+            ensure("open", store.open());
+            std::ofstream file(getSourcePath().c_str(), std::ios::binary);
+            for (U64 bytes = 0; bytes < corpus_bytes; ++count)
+            {
+                text = makeMessage(count) + "\n";
+                bytes += text.size();
+                file << text;
+                store.append(count, text);
+            }
+            file.close();
+            store.setSource(getSourcePath(), corpus_bytes);
+            ensure("flush", store.flush());
+        }
+        F64 import_time = timer.getElapsedTimeF64();
+
+        // what loadChatHistory() does with a current index
+        timer.reset();
+        LLChatTranscriptStore store(mBase);
+        store.open();
+        ensure("still matches", store.matchesSource(getSourcePath()));
+        std::vector<std::string> texts;
+        store.getLast(U32_MAX, 20480, texts);
+        F64 open_time = timer.getElapsedTimeF64();
+
+        // and what it does for "load_all_history" without one
+        timer.reset();
+        std::ifstream file(getSourcePath().c_str(), std::ios::binary);
+        U32 lines = 0;
+        while (std::getline(file, text))
+        {
+            ++lines;
+        }
+        F64 text_time = timer.getElapsedTimeF64();
+        ensure("read every line", lines >= count);
+
+        LL_INFOS() << count << " messages, " << corpus_bytes / (1024 * 1024) << " MB: import " << import_time * 1000.0
+                   << " ms; open, check and read the last 20 KB " << open_time * 1000.0
+                   << " ms; read the whole text file " << text_time * 1000.0 << " ms" << LL_ENDL;
+    }
+#endif // LL_BENCHMARK
+}
@@ -30,8 +30,13 @@
 #include "linden_common.h"
 #include "lltut.h"
 
+#include "llsdserialize.h"
 #include "llsdtraits.h"
+#include "llsdutil.h"
 #include "llstring.h"
+#include "llformat.h"
+#include "llmemory.h"
+#include "lltimer.h"
 
 using std::fpclassify;
 
@@ -811,6 +816,241 @@ namespace tut
         ensure("type is a string", v.isString());
     }
 
+    // sets llsd::sMapIndexThreshold for one test and restores it even when
+    // an ensure fails
+    class MapIndexThreshold
+    {
+    public:
+        MapIndexThreshold(U32 threshold): mSaved(llsd::sMapIndexThreshold)
+        {
+            llsd::sMapIndexThreshold = threshold;
+        }
+        ~MapIndexThreshold()
+        {
+            llsd::sMapIndexThreshold = mSaved;
+        }
+
+    private:
+        U32 mSaved;
+    };
+
+    template<> template<>
+    void SDTestObject::test<15>()
+        // large maps switch to a hash index without changing behaviour
+    {
+        MapIndexThreshold threshold(8);
+
+        LLSD m;
+        std::map<std::string, S32> expected;
+        for (S32 i = 0; i < 500; ++i)
+        {
+            std::string key = llformat("key%03d", (i * 7919) % 500);
+            if (i % 3 == 0)
+            {
+                m.insert(key, i);
+            }
+            else
+            {
+                m[key] = i;
+            }
+            expected.emplace(key, i);
+        }
+        for (S32 i = 0; i < 500; i += 4)
+        {
+            std::string key = llformat("key%03d", i);
+            m.erase(key);
+            expected.erase(key);
+        }
+        // insert() does not replace, like std::map::emplace
+        m.insert("key001", -1);
+
+        ensure_equals("size", m.size(), expected.size());
+        for (S32 i = 0; i < 500; ++i)
+        {
+            std::string key = llformat("key%03d", i);
+            auto it = expected.find(key);
+            ensure_equals(key + " present", m.has(key), it != expected.end());
+            if (it != expected.end())
+            {
+                ensure_equals(key + " value", m[key].asInteger(), it->second);
+                ensure_equals(key + " get", m.get(key).asInteger(), it->second);
+            }
+        }
+
+        // iteration is still in key order
+        auto exp_it = expected.begin();
+        for (LLSD::map_const_iterator it = m.beginMap(); it != m.endMap(); ++it, ++exp_it)
+        {
+            ensure_equals("iteration order", it->first, exp_it->first);
+        }
+
+        // copy on write keeps both maps' indexes consistent
+        LLSD copy = m;
+        copy["key001"] = 1001;
+        copy.erase("key002");
+        ensure_equals("original unchanged", m["key001"].asInteger(), expected["key001"]);
+        ensure("original keeps erased key", m.has("key002"));
+        ensure_equals("copy changed", copy["key001"].asInteger(), 1001);
+        ensure("copy erased key", !copy.has("key002"));
+    }
+
+    // a document shaped like an inventory or object properties reply
+    static LLSD make_document(S32 items)
+    {
+        LLSD doc;
+        for (S32 i = 0; i < items; ++i)
+        {
+            LLSD item;
+            item["name"] = llformat("Item number %d with a longer name", i);
+            item["desc"] = "(No Description)";
+            item["item_id"] = LLUUID::generateNewID();
+            item["type"] = i % 7;
+            item["created_at"] = LLDate(1700000000.0 + i);
+            item["scale"] = 0.5 * i;
+            item["flags"].append(i);
+            item["flags"].append(true);
+            doc.append(item);
+        }
+        return doc;
+    }
+
+    static LLSD parse_binary(const std::string& bytes, bool use_arena)
+    {
+        LLSD parsed;
+        std::istringstream istr(bytes);
+        LLPointer<LLSDParser> parser = new LLSDBinaryParser();
+        parser->setUseArena(use_arena);
+        parser->parse(istr, parsed, bytes.size());
+        return parsed;
+    }
+
+    template<> template<>
+    void SDTestObject::test<16>()
+        // arena parse gives the same values and frees its blocks
+    {
+        std::ostringstream ostr;
+        LLSDSerialize::toBinary(make_document(500), ostr);
+        const std::string bytes = ostr.str();
+        const U32 blocks_before = llsd::arenaBlockCount();
+
+        LLSD expected = parse_binary(bytes, false);
+        ensure_equals("heap parse uses no blocks", llsd::arenaBlockCount(), blocks_before);
+        LLSD parsed = parse_binary(bytes, true);
+        ensure("arena parse took blocks", llsd::arenaBlockCount() > blocks_before);
+        ensure("arena parse matches heap parse", llsd_equals(parsed, expected));
+
+        // values kept from the document, including modified ones, pin its blocks
+        LLSD kept = parsed[42];
+        kept["name"] = "renamed";
+        parsed.clear();
+        ensure("kept value pins the arena", llsd::arenaBlockCount() > blocks_before);
+        ensure_equals("kept value intact", kept["type"].asInteger(), 0);
+        ensure_equals("kept value modified", kept["name"].asString(), std::string("renamed"));
+        kept.clear();
+        ensure_equals("blocks released", llsd::arenaBlockCount(), blocks_before);
+
+        {
+            // nodes made directly inside a scope outlive it
+            LLSD value;
+            {
+                llsd::ArenaScope arena;
+                value["key"] = "value";
+                llsd::ArenaScope disabled(false);
+                value["other"] = 2;
+            }
+            ensure_equals("value outlives scope", value["key"].asString(), std::string("value"));
+            ensure_equals("nested disabled scope", value["other"].asInteger(), 2);
+        }
+        ensure_equals("scope blocks released", llsd::arenaBlockCount(), blocks_before);
+    }
+
+#if LL_BENCHMARK
+    template<> template<>
+    void SDTestObject::test<17>()
+        // map lookup and memory cost with and without the hash index
+    {
+        const S32 keys = 5000;
+        const S32 lookups = 200000;
+
+        std::vector<std::string> names;
+        for (S32 i = 0; i < keys; ++i)
+        {
+            // shared prefixes like inventory and capability names
+            names.push_back(llformat("item_%08x_%d", i * 2654435761u, i));
+        }
+
+        F64 lookup_ms[2];
+        S64 rss_kb[2];
+        for (S32 indexed = 0; indexed < 2; ++indexed)
+        {
+            MapIndexThreshold threshold(indexed ? 32 : 0);
+
+            U64 rss_before = LLMemory::getCurrentRSS();
+            std::vector<LLSD> maps(20);
+            for (LLSD& map : maps)
+            {
+                for (S32 i = 0; i < keys; ++i)
+                {
+                    map[names[i]] = i;
+                }
+            }
+            rss_kb[indexed] = ((S64)LLMemory::getCurrentRSS() - (S64)rss_before) / 1024;
+
+            S64 sum = 0;
+            LLTimer timer;
+            for (S32 i = 0; i < lookups; ++i)
+            {
+                sum += maps[0][names[(i * 31) % keys]].asInteger();
+            }
+            lookup_ms[indexed] = timer.getElapsedTimeF64() * 1000.0;
+            ensure("lookups found every key", sum > 0);
+        }
+
+        LL_INFOS() << lookups << " lookups in a " << keys << " key map: tree " << lookup_ms[0]
+                   << " ms, indexed " << lookup_ms[1] << " ms; 20 maps RSS growth: tree " << rss_kb[0]
+                   << " KB, indexed " << rss_kb[1] << " KB" << LL_ENDL;
+    }
+
+    template<> template<>
+    void SDTestObject::test<18>()
+        // parse and destroy cost with and without an arena
+    {
+        std::ostringstream ostr;
+        LLSDSerialize::toBinary(make_document(20000), ostr);
+        const std::string bytes = ostr.str();
+
+        F64 parse_ms[2];
+        F64 destroy_ms[2];
+        S64 rss_kb[2];
+        U32 allocations[2];
+        for (S32 use_arena = 0; use_arena < 2; ++use_arena)
+        {
+            const U32 impls_before = llsd::allocationCount();
+            const U32 blocks_before = llsd::arenaBlockCount();
+            U64 rss_before = LLMemory::getCurrentRSS();
+
+            LLTimer timer;
+            LLSD parsed = parse_binary(bytes, use_arena != 0);
+            parse_ms[use_arena] = timer.getElapsedTimeF64() * 1000.0;
+            rss_kb[use_arena] = ((S64)LLMemory::getCurrentRSS() - (S64)rss_before) / 1024;
+            ensure_equals("parsed every item", parsed.size(), (size_t)20000);
+
+            // node allocations only, the strings and containers are the same either way
+            allocations[use_arena] = use_arena ? llsd::arenaBlockCount() - blocks_before
+                                               : llsd::allocationCount() - impls_before;
+
+            timer.reset();
+            parsed.clear();
+            destroy_ms[use_arena] = timer.getElapsedTimeF64() * 1000.0;
+        }
+
+        LL_INFOS() << bytes.size() / 1024 << " KB binary LLSD: node allocations heap " << allocations[0]
+                   << ", arena " << allocations[1] << "; parse heap " << parse_ms[0] << " ms, arena "
+                   << parse_ms[1] << " ms; destroy heap " << destroy_ms[0] << " ms, arena " << destroy_ms[1]
+                   << " ms; RSS growth heap " << rss_kb[0] << " KB, arena " << rss_kb[1] << " KB" << LL_ENDL;
+    }
+#endif // LL_BENCHMARK
+
     /* TO DO:
         conversion of undefined to UUID, Date, URI and Binary
         conversion of undefined to map and array